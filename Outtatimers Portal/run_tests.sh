@@ -67,6 +67,320 @@ else
     ((FAILED++))
 fi
 
+# Test 4: LED Driver Span Test
+echo -e "\n${YELLOW}Running native_led_driver_test...${NC}"
+if g++ -std=c++17 \
+    -DUNIT_TEST \
+    -I src \
+    "test/native_led_driver_test.cpp" \
+    -o /tmp/native_led_driver_test 2>/dev/null && /tmp/native_led_driver_test; then
+    echo -e "${GREEN}✅ native_led_driver_test PASSED${NC}"
+    ((PASSED++))
+else
+    echo -e "${RED}❌ native_led_driver_test FAILED${NC}"
+    ((FAILED++))
+fi
+
+# Test 5: Fixed-Point Color Math Golden Test
+echo -e "\n${YELLOW}Running native_color_math_test...${NC}"
+if g++ -std=c++17 \
+    -DUNIT_TEST \
+    -I src \
+    "test/native_color_math_test.cpp" \
+    src/effects.cpp \
+    -o /tmp/native_color_math_test 2>/dev/null && /tmp/native_color_math_test; then
+    echo -e "${GREEN}✅ native_color_math_test PASSED${NC}"
+    ((PASSED++))
+else
+    echo -e "${RED}❌ native_color_math_test FAILED${NC}"
+    ((FAILED++))
+fi
+
+# Test 6: Dirty-Frame Skip Test
+echo -e "\n${YELLOW}Running native_frame_skip_test...${NC}"
+if g++ -std=c++17 \
+    -DUNIT_TEST \
+    -I src \
+    -I test/mocks \
+    "test/native_frame_skip_test.cpp" \
+    src/effects.cpp \
+    src/config_manager.cpp \
+    -o /tmp/native_frame_skip_test 2>/dev/null && /tmp/native_frame_skip_test; then
+    echo -e "${GREEN}✅ native_frame_skip_test PASSED${NC}"
+    ((PASSED++))
+else
+    echo -e "${RED}❌ native_frame_skip_test FAILED${NC}"
+    ((FAILED++))
+fi
+
+# Test 7: Frame Pacer Test
+echo -e "\n${YELLOW}Running native_frame_pacer_test...${NC}"
+if g++ -std=c++17 \
+    -DUNIT_TEST \
+    -I src \
+    "test/native_frame_pacer_test.cpp" \
+    -o /tmp/native_frame_pacer_test 2>/dev/null && /tmp/native_frame_pacer_test; then
+    echo -e "${GREEN}✅ native_frame_pacer_test PASSED${NC}"
+    ((PASSED++))
+else
+    echo -e "${RED}❌ native_frame_pacer_test FAILED${NC}"
+    ((FAILED++))
+fi
+
+# Test 8: Time-Based Motion Test
+echo -e "\n${YELLOW}Running native_motion_test...${NC}"
+if g++ -std=c++17 \
+    -DUNIT_TEST \
+    -I src \
+    -I test/mocks \
+    "test/native_motion_test.cpp" \
+    src/effects.cpp \
+    src/config_manager.cpp \
+    -o /tmp/native_motion_test 2>/dev/null && /tmp/native_motion_test; then
+    echo -e "${GREEN}✅ native_motion_test PASSED${NC}"
+    ((PASSED++))
+else
+    echo -e "${RED}❌ native_motion_test FAILED${NC}"
+    ((FAILED++))
+fi
+
+# Test 9: Ring Buffer Layout Test
+echo -e "\n${YELLOW}Running native_ring_buffer_test...${NC}"
+if g++ -std=c++17 \
+    -DUNIT_TEST \
+    -I src \
+    "test/native_ring_buffer_test.cpp" \
+    -o /tmp/native_ring_buffer_test 2>/dev/null && /tmp/native_ring_buffer_test; then
+    echo -e "${GREEN}✅ native_ring_buffer_test PASSED${NC}"
+    ((PASSED++))
+else
+    echo -e "${RED}❌ native_ring_buffer_test FAILED${NC}"
+    ((FAILED++))
+fi
+
+# Test 10: Stack High-Water Test
+echo -e "\n${YELLOW}Running native_stack_test...${NC}"
+if g++ -std=c++17 \
+    -DUNIT_TEST \
+    -I src \
+    -I test/mocks \
+    "test/native_stack_test.cpp" \
+    src/effects.cpp \
+    src/config_manager.cpp \
+    -o /tmp/native_stack_test 2>/dev/null && /tmp/native_stack_test; then
+    echo -e "${GREEN}✅ native_stack_test PASSED${NC}"
+    ((PASSED++))
+else
+    echo -e "${RED}❌ native_stack_test FAILED${NC}"
+    ((FAILED++))
+fi
+
+# Test 11: Background Generation Test
+echo -e "\n${YELLOW}Running native_generation_test...${NC}"
+if g++ -std=c++17 \
+    -DUNIT_TEST \
+    -I src \
+    -I test/mocks \
+    "test/native_generation_test.cpp" \
+    src/effects.cpp \
+    src/config_manager.cpp \
+    -o /tmp/native_generation_test 2>/dev/null && /tmp/native_generation_test; then
+    echo -e "${GREEN}✅ native_generation_test PASSED${NC}"
+    ((PASSED++))
+else
+    echo -e "${RED}❌ native_generation_test FAILED${NC}"
+    ((FAILED++))
+fi
+
+# Test 12: Config Snapshot Test
+echo -e "\n${YELLOW}Running native_config_test...${NC}"
+if g++ -std=c++17 \
+    -DUNIT_TEST \
+    -I src \
+    -I test/mocks \
+    "test/native_config_test.cpp" \
+    src/effects.cpp \
+    src/config_manager.cpp \
+    -o /tmp/native_config_test 2>/dev/null && /tmp/native_config_test; then
+    echo -e "${GREEN}✅ native_config_test PASSED${NC}"
+    ((PASSED++))
+else
+    echo -e "${RED}❌ native_config_test FAILED${NC}"
+    ((FAILED++))
+fi
+
+# Test 13: Config Batch Test
+echo -e "\n${YELLOW}Running native_config_batch_test...${NC}"
+if g++ -std=c++17 \
+    -DUNIT_TEST \
+    -I src \
+    -I test/mocks \
+    "test/native_config_batch_test.cpp" \
+    src/config_manager.cpp \
+    -o /tmp/native_config_batch_test 2>/dev/null && /tmp/native_config_batch_test; then
+    echo -e "${GREEN}✅ native_config_batch_test PASSED${NC}"
+    ((PASSED++))
+else
+    echo -e "${RED}❌ native_config_batch_test FAILED${NC}"
+    ((FAILED++))
+fi
+
+# Test 14: Config Store Test
+echo -e "\n${YELLOW}Running native_config_store_test...${NC}"
+if g++ -std=c++17 \
+    -DUNIT_TEST \
+    -I src \
+    -I test/mocks \
+    "test/native_config_store_test.cpp" \
+    src/config_manager.cpp \
+    -o /tmp/native_config_store_test 2>/dev/null && /tmp/native_config_store_test; then
+    echo -e "${GREEN}✅ native_config_store_test PASSED${NC}"
+    ((PASSED++))
+else
+    echo -e "${RED}❌ native_config_store_test FAILED${NC}"
+    ((FAILED++))
+fi
+
+# Test 15: Preset Test
+echo -e "\n${YELLOW}Running native_preset_test...${NC}"
+if g++ -std=c++17 \
+    -DUNIT_TEST \
+    -I src \
+    -I test/mocks \
+    "test/native_preset_test.cpp" \
+    src/effects.cpp \
+    src/config_manager.cpp \
+    -o /tmp/native_preset_test 2>/dev/null && /tmp/native_preset_test; then
+    echo -e "${GREEN}✅ native_preset_test PASSED${NC}"
+    ((PASSED++))
+else
+    echo -e "${RED}❌ native_preset_test FAILED${NC}"
+    ((FAILED++))
+fi
+
+# Test 16: Static Assets Test
+echo -e "\n${YELLOW}Running native_static_assets_test...${NC}"
+if g++ -std=c++17 \
+    -DUNIT_TEST \
+    -I src \
+    -I test/mocks \
+    "test/native_static_assets_test.cpp" \
+    -o /tmp/native_static_assets_test 2>/dev/null && /tmp/native_static_assets_test; then
+    echo -e "${GREEN}✅ native_static_assets_test PASSED${NC}"
+    ((PASSED++))
+else
+    echo -e "${RED}❌ native_static_assets_test FAILED${NC}"
+    ((FAILED++))
+fi
+
+# Test 17: Response Writer Test
+echo -e "\n${YELLOW}Running native_response_writer_test...${NC}"
+if g++ -std=c++17 \
+    -DUNIT_TEST \
+    -I src \
+    -I test/mocks \
+    "test/native_response_writer_test.cpp" \
+    -o /tmp/native_response_writer_test 2>/dev/null && /tmp/native_response_writer_test; then
+    echo -e "${GREEN}✅ native_response_writer_test PASSED${NC}"
+    ((PASSED++))
+else
+    echo -e "${RED}❌ native_response_writer_test FAILED${NC}"
+    ((FAILED++))
+fi
+
+# Test 18: Async HTTP Server Test
+echo -e "\n${YELLOW}Running native_async_http_test...${NC}"
+if g++ -std=c++17 \
+    -DUNIT_TEST \
+    -I src \
+    -I test/mocks \
+    "test/native_async_http_test.cpp" \
+    -o /tmp/native_async_http_test 2>/dev/null && /tmp/native_async_http_test; then
+    echo -e "${GREEN}✅ native_async_http_test PASSED${NC}"
+    ((PASSED++))
+else
+    echo -e "${RED}❌ native_async_http_test FAILED${NC}"
+    ((FAILED++))
+fi
+
+# Test 19: WebSocket Test
+echo -e "\n${YELLOW}Running native_websocket_test...${NC}"
+if g++ -std=c++17 \
+    -DUNIT_TEST \
+    -I src \
+    -I test/mocks \
+    "test/native_websocket_test.cpp" \
+    -o /tmp/native_websocket_test 2>/dev/null && /tmp/native_websocket_test; then
+    echo -e "${GREEN}✅ native_websocket_test PASSED${NC}"
+    ((PASSED++))
+else
+    echo -e "${RED}❌ native_websocket_test FAILED${NC}"
+    ((FAILED++))
+fi
+
+# Test 20: Realtime Input Test
+echo -e "\n${YELLOW}Running native_realtime_test...${NC}"
+if g++ -std=c++17 \
+    -DUNIT_TEST \
+    -I src \
+    -I test/mocks \
+    "test/native_realtime_test.cpp" \
+    src/effects.cpp \
+    src/config_manager.cpp \
+    -o /tmp/native_realtime_test 2>/dev/null && /tmp/native_realtime_test; then
+    echo -e "${GREEN}✅ native_realtime_test PASSED${NC}"
+    ((PASSED++))
+else
+    echo -e "${RED}❌ native_realtime_test FAILED${NC}"
+    ((FAILED++))
+fi
+
+# Test 21: Show Sync Test
+echo -e "\n${YELLOW}Running native_show_sync_test...${NC}"
+if g++ -std=c++17 \
+    -DUNIT_TEST \
+    -I src \
+    -I test/mocks \
+    "test/native_show_sync_test.cpp" \
+    -o /tmp/native_show_sync_test 2>/dev/null && /tmp/native_show_sync_test; then
+    echo -e "${GREEN}✅ native_show_sync_test PASSED${NC}"
+    ((PASSED++))
+else
+    echo -e "${RED}❌ native_show_sync_test FAILED${NC}"
+    ((FAILED++))
+fi
+
+# Test 22: Cue Input Test
+echo -e "\n${YELLOW}Running native_cue_input_test...${NC}"
+if g++ -std=c++17 \
+    -DUNIT_TEST \
+    -I src \
+    -I test/mocks \
+    "test/native_cue_input_test.cpp" \
+    -o /tmp/native_cue_input_test 2>/dev/null && /tmp/native_cue_input_test; then
+    echo -e "${GREEN}✅ native_cue_input_test PASSED${NC}"
+    ((PASSED++))
+else
+    echo -e "${RED}❌ native_cue_input_test FAILED${NC}"
+    ((FAILED++))
+fi
+
+# Test 23: Interrupt Buttons Test
+echo -e "\n${YELLOW}Running native_interrupt_buttons_test...${NC}"
+if g++ -std=c++17 \
+    -DUNIT_TEST \
+    -pthread \
+    -I src \
+    -I test/mocks \
+    "test/native_interrupt_buttons_test.cpp" \
+    -o /tmp/native_interrupt_buttons_test 2>/dev/null && /tmp/native_interrupt_buttons_test; then
+    echo -e "${GREEN}✅ native_interrupt_buttons_test PASSED${NC}"
+    ((PASSED++))
+else
+    echo -e "${RED}❌ native_interrupt_buttons_test FAILED${NC}"
+    ((FAILED++))
+fi
+
 # Summary
 echo -e "\n======================================"
 echo -e "🧪 Test Summary:"
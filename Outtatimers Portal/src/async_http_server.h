@@ -0,0 +1,1142 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <functional>
+#include "config.h"
+#include "response_writer.h"
+#include "websocket.h"
+#ifndef UNIT_TEST
+#include <lwip/tcp.h>
+#endif
+
+/**
+ * @brief Receives a TCP transport's connection events
+ *
+ * Calls come from the transport's own context: lwIP callbacks on the
+ * device, ITcpTransport::poll() on the host. They only move bytes and must
+ * return at once.
+ */
+class ITcpHandler
+{
+public:
+  virtual ~ITcpHandler() = default;
+  virtual void onConnect(int id) = 0;
+  virtual void onData(int id, const uint8_t *data, size_t length) = 0;
+  virtual void onWritable(int id) = 0; // Sent data was acknowledged: the window has room again
+  virtual void onClose(int id) = 0;    // Closed by the peer or lost; the id is free again
+};
+
+/**
+ * @brief Non-blocking TCP listener with a fixed table of connections
+ *
+ * Connection ids are table slots, 0 to WiFi::HTTP_MAX_CONNECTIONS - 1;
+ * a connection arriving when the table is full is refused.
+ */
+class ITcpTransport
+{
+public:
+  virtual ~ITcpTransport() = default;
+  virtual bool begin(uint16_t port, ITcpHandler *handler) = 0;
+
+  /**
+   * @brief Queue bytes for sending without waiting
+   * @return Bytes taken (copied); fewer than @p length when the send window is full
+   */
+  virtual size_t write(int id, const char *data, size_t length) = 0;
+
+  virtual void close(int id) = 0; // After what was written; no onClose follows
+  virtual void abort(int id) = 0; // At once, with a reset; no onClose follows
+
+  /**
+   * @brief Deliver pending events; transports driven by callbacks need not
+   */
+  virtual void poll() {}
+};
+
+/**
+ * @brief Response body produced a piece at a time, e.g. a file
+ *
+ * Keyed by connection id, so one source can serve several connections.
+ */
+class IBodySource
+{
+public:
+  virtual ~IBodySource() = default;
+  virtual size_t read(int connection, uint8_t *data, size_t length) = 0;
+  virtual void close(int connection) = 0;
+};
+
+/**
+ * @brief Receives the messages of AsyncHttpServer's WebSocket clients
+ *
+ * Called from AsyncHttpServer::service(), like HTTP handlers.
+ */
+class IWebSocketHandler
+{
+public:
+  virtual ~IWebSocketHandler() = default;
+  virtual void onOpen(int id) = 0;
+
+  /**
+   * @brief A text or binary message; @p data is terminated and may be
+   *        modified in place, but only lasts for the call
+   */
+  virtual void onMessage(int id, char *data, size_t length) = 0;
+
+  virtual void onClose(int id) = 0; // Closed by either side or lost
+};
+
+/**
+ * @brief Event-driven HTTP/1.1 server on an ITcpTransport
+ *
+ * Nothing here waits on a client. The transport's callbacks only copy
+ * request bytes into a connection's buffer and push out buffered response
+ * bytes as the send window opens. Requests are parsed and handled in
+ * service(), called from the frame loop, which never blocks either. A
+ * stalled client costs a connection slot until its timeout, not frames.
+ *
+ * Memory is fixed: WiFi::HTTP_MAX_CONNECTIONS connections, each with a
+ * request buffer and a transmit buffer for whatever the TCP window cannot
+ * take yet. A request that does not fit is answered 431. A response body
+ * longer than the transmit buffer must come from an IBodySource, which is
+ * read only as the window drains. Each connection carries one request and
+ * is closed after the response (Connection: close).
+ *
+ * One path may instead upgrade to a WebSocket (onWebSocket()). Such a
+ * connection keeps its slot and buffers: incoming frames collect in the
+ * request buffer and go to the IWebSocketHandler from service(); outgoing
+ * messages go through the transmit buffer, and one that does not fit is
+ * refused rather than waited for. Quiet clients are pinged, and dropped if
+ * they stay silent.
+ *
+ * Handlers run one at a time and read the request through the accessors
+ * (arg(), header(), ...). They answer with send(), sendBody(), or a
+ * ResponseWriter on this server, which is its IResponseSink.
+ *
+ * @example
+ * ```cpp
+ * AsyncHttpServer server(&transport);
+ * server.on("/config", [&]() { ResponseWriter(server, buffer, sizeof(buffer), 200, "text/plain").print("ok"); });
+ * server.begin(80);
+ * // In loop():
+ * server.service(millis());
+ * ```
+ */
+class AsyncHttpServer : public ITcpHandler, public IResponseSink
+{
+public:
+  using Handler = std::function<void()>;
+
+  static constexpr int MAX_CONNECTIONS = PortalConfig::WiFi::HTTP_MAX_CONNECTIONS;
+  static constexpr size_t REQUEST_BUFFER = PortalConfig::WiFi::HTTP_REQUEST_BUFFER;
+  static constexpr size_t TX_BUFFER = PortalConfig::WiFi::HTTP_TX_BUFFER;
+  static constexpr int MAX_ROUTES = 24;
+  static constexpr int MAX_ARGS = 12;
+  static constexpr int MAX_HEADERS = 4; // Collected request headers, and extra response headers
+
+  enum Method : uint8_t
+  {
+    GET,
+    POST,
+    OPTIONS,
+    OTHER
+  };
+
+  explicit AsyncHttpServer(ITcpTransport *transport)
+      : transport_(transport), routeCount_(0), collectedCount_(0), defaultHeaders_(""), current_(-1),
+        extraHeaderCount_(0), webSocketPath_(nullptr), webSocketHandler_(nullptr)
+  {
+    for (Connection &c : connections_)
+      c.state = FREE;
+  }
+
+  bool begin(uint16_t port) { return transport_->begin(port, this); }
+
+  /**
+   * @brief Route a path, for any method
+   * @return false if the route table is full
+   */
+  bool on(const char *path, Handler handler)
+  {
+    if (routeCount_ >= MAX_ROUTES)
+      return false;
+    routes_[routeCount_++] = {path, handler};
+    return true;
+  }
+
+  void onNotFound(Handler handler) { notFound_ = handler; }
+
+  /**
+   * @brief Accept WebSocket upgrades on @p path, up to WiFi::WS_MAX_CLIENTS
+   */
+  void onWebSocket(const char *path, IWebSocketHandler *handler)
+  {
+    webSocketPath_ = path;
+    webSocketHandler_ = handler;
+  }
+
+  /**
+   * @brief Request headers kept for header(); all others are skipped
+   */
+  void collectHeaders(const char *const names[], int count)
+  {
+    collectedCount_ = count < MAX_HEADERS ? count : MAX_HEADERS;
+    for (int i = 0; i < collectedCount_; i++)
+      collected_[i] = names[i];
+  }
+
+  /**
+   * @brief Header lines ("Name: value\r\n") added to every response,
+   *        including the automatic OPTIONS answer
+   */
+  void setDefaultHeaders(const char *headers) { defaultHeaders_ = headers; }
+
+  /**
+   * @brief Dispatch complete requests and advance responses; call every loop
+   */
+  void service(unsigned long now)
+  {
+    transport_->poll();
+    for (int id = 0; id < MAX_CONNECTIONS; id++)
+    {
+      Connection &c = connections_[id];
+      if (c.state == FREE)
+        continue;
+      if (c.state == READY)
+        dispatch(id);
+      if (c.state == WEBSOCKET)
+        receiveFrames(id);
+      if (c.state == SENDING || c.state == WEBSOCKET)
+        pump(id, c.state == SENDING);
+      if (c.active)
+      {
+        c.since = now;
+        c.active = false;
+        c.pinged = false;
+      }
+      if (c.state == READING && now - c.since > PortalConfig::WiFi::HTTP_REQUEST_TIMEOUT_MS)
+        drop(id);
+      else if (c.state == WEBSOCKET)
+      {
+        if (c.failed || now - c.since > 2 * PortalConfig::WiFi::WS_PING_INTERVAL_MS)
+          drop(id);
+        else if (!c.pinged && now - c.since > PortalConfig::WiFi::WS_PING_INTERVAL_MS)
+        {
+          sendFrame(c, WebSocket::PING, nullptr, 0);
+          c.pinged = true;
+        }
+      }
+      else if (c.state == SENDING)
+      {
+        if (c.failed || now - c.since > PortalConfig::WiFi::HTTP_SEND_TIMEOUT_MS)
+          drop(id);
+        else if (c.txStart == c.txEnd && !c.source)
+          finish(id);
+      }
+    }
+  }
+
+  int activeConnections() const
+  {
+    int n = 0;
+    for (const Connection &c : connections_)
+      n += c.state != FREE;
+    return n;
+  }
+
+  int webSocketClients() const
+  {
+    int n = 0;
+    for (const Connection &c : connections_)
+      n += c.state == WEBSOCKET;
+    return n;
+  }
+
+  // ---- WebSocket messages ----
+
+  /**
+   * @brief Send a text message to one WebSocket client
+   * @return false if @p id is not an open WebSocket or its transmit buffer
+   *         has no room for the message; it is not queued for later
+   */
+  bool sendText(int id, const char *data, size_t length)
+  {
+    Connection &c = connections_[id];
+    if (c.state != WEBSOCKET || c.failed || !hasRoom(c, WebSocket::MAX_HEADER + length))
+      return false;
+    sendFrame(c, WebSocket::TEXT, data, length);
+    return true;
+  }
+
+  /**
+   * @brief Send a text message to every WebSocket client
+   * @return Clients that could not take it
+   */
+  int broadcastText(const char *data, size_t length)
+  {
+    int missed = 0;
+    for (int id = 0; id < MAX_CONNECTIONS; id++)
+      if (connections_[id].state == WEBSOCKET)
+        missed += !sendText(id, data, length);
+    return missed;
+  }
+
+  // ---- The request being handled ----
+
+  Method method() const { return connections_[current_].method; }
+  const char *uri() const { return connections_[current_].path; }
+  int args() const { return connections_[current_].argCount; }
+  const char *argName(int i) const { return connections_[current_].args[i][0]; }
+  const char *arg(int i) const { return connections_[current_].args[i][1]; }
+  bool hasArg(const char *name) const { return findArg(name) != nullptr; }
+
+  /**
+   * @brief Value of a query or form argument, "" if absent
+   */
+  const char *arg(const char *name) const
+  {
+    const char *value = findArg(name);
+    return value ? value : "";
+  }
+
+  /**
+   * @brief Value of a collected request header, nullptr if absent
+   */
+  const char *header(const char *name) const
+  {
+    const Connection &c = connections_[current_];
+    for (int i = 0; i < collectedCount_; i++)
+      if (strcasecmp(collected_[i], name) == 0)
+        return c.headers[i];
+    return nullptr;
+  }
+
+  /**
+   * @brief Connection of the request being handled, the key for an IBodySource
+   */
+  int connection() const { return current_; }
+
+  // ---- Its response ----
+
+  /**
+   * @brief Add a response header; both strings must last until the response starts
+   */
+  void sendHeader(const char *name, const char *value)
+  {
+    if (extraHeaderCount_ < MAX_HEADERS)
+      extraHeaders_[extraHeaderCount_++] = {name, value};
+  }
+
+  void send(int code)
+  {
+    begin(code, nullptr, 0);
+    end();
+  }
+
+  /**
+   * @brief Answer with a body read from @p source as the connection drains
+   *
+   * The source is closed for this connection when the response is done or
+   * the connection is lost.
+   */
+  void sendBody(int code, const char *contentType, size_t length, IBodySource *source)
+  {
+    begin(code, contentType, length);
+    Connection &c = connections_[current_];
+    c.source = source;
+    c.sourceLeft = length;
+    end();
+  }
+
+  void begin(int code, const char *contentType, size_t length) override
+  {
+    Connection &c = connections_[current_];
+    char line[48];
+    queue(c, line, snprintf(line, sizeof(line), "HTTP/1.1 %d %s\r\n", code, reason(code)));
+    if (contentType)
+      queueHeader(c, "Content-Type", contentType);
+    if (length != UNKNOWN_LENGTH && code != 204 && code != 304)
+    {
+      snprintf(line, sizeof(line), "%lu", (unsigned long)length);
+      queueHeader(c, "Content-Length", line);
+    }
+    queue(c, defaultHeaders_, strlen(defaultHeaders_));
+    for (int i = 0; i < extraHeaderCount_; i++)
+      queueHeader(c, extraHeaders_[i].name, extraHeaders_[i].value);
+    queue(c, "Connection: close\r\n\r\n", 21);
+    c.responding = true;
+  }
+
+  void write(const char *data, size_t length) override { queue(connections_[current_], data, length); }
+
+  void end() override { connections_[current_].state = SENDING; }
+
+  // ---- ITcpHandler ----
+
+  void onConnect(int id) override
+  {
+    Connection &c = connections_[id];
+    c.state = READING;
+    c.active = true;
+    c.received = 0;
+    c.overflow = false;
+    c.failed = false;
+    c.responding = false;
+    c.pinged = false;
+    c.webSocket = false;
+    c.txStart = c.txEnd = 0;
+    c.source = nullptr;
+  }
+
+  void onData(int id, const uint8_t *data, size_t length) override
+  {
+    Connection &c = connections_[id];
+    if (c.state != READING && c.state != WEBSOCKET)
+      return; // One request per connection
+    c.active = true;
+    size_t n = length < REQUEST_BUFFER - c.received ? length : REQUEST_BUFFER - c.received;
+    memcpy(c.request + c.received, data, n);
+    c.received += n;
+    c.overflow |= n < length;
+    if (c.state == READING && (c.overflow || requestComplete(c)))
+      c.state = READY;
+  }
+
+  void onWritable(int id) override
+  {
+    Connection &c = connections_[id];
+    if (c.state == SENDING)
+      c.active = true; // A WebSocket's timeout counts only what it hears
+    else if (c.state != WEBSOCKET)
+      return;
+    pump(id, false); // File reads wait for service()
+  }
+
+  void onClose(int id) override { release(id); }
+
+private:
+  enum State : uint8_t
+  {
+    FREE,
+    READING, // Receiving the request
+    READY,   // Request complete (or too large), waiting for service()
+    SENDING,  // Response handled (or WebSocket closing), draining to the client
+    WEBSOCKET // Upgraded: exchanging frames
+  };
+
+  struct Connection
+  {
+    State state;
+    bool active; // Progress since the last service(): restarts the timeout
+    bool overflow;
+    bool failed; // Response outgrew the transmit buffer
+    bool responding;
+    bool pinged;    // WebSocket ping sent since the client was last heard
+    bool webSocket; // Upgraded, until released
+    Method method;
+    unsigned long since;
+    size_t received;
+    char request[REQUEST_BUFFER + 1]; // Parsed in place; + 1 for a terminator
+    char *path;
+    char *args[MAX_ARGS][2];
+    int argCount;
+    const char *headers[MAX_HEADERS];
+    const char *upgrade; // Upgrade and Sec-WebSocket-Key headers
+    const char *key;
+    char tx[TX_BUFFER];
+    size_t txStart, txEnd;
+    IBodySource *source;
+    size_t sourceLeft;
+  };
+
+  struct Route
+  {
+    const char *path;
+    Handler handler;
+  };
+
+  struct Header
+  {
+    const char *name;
+    const char *value;
+  };
+
+  ITcpTransport *transport_;
+  Connection connections_[MAX_CONNECTIONS];
+  Route routes_[MAX_ROUTES];
+  int routeCount_;
+  Handler notFound_;
+  const char *collected_[MAX_HEADERS];
+  int collectedCount_;
+  const char *defaultHeaders_;
+  int current_;
+  Header extraHeaders_[MAX_HEADERS];
+  int extraHeaderCount_;
+  const char *webSocketPath_;
+  IWebSocketHandler *webSocketHandler_;
+
+  const char *findArg(const char *name) const
+  {
+    const Connection &c = connections_[current_];
+    for (int i = 0; i < c.argCount; i++)
+      if (strcmp(c.args[i][0], name) == 0)
+        return c.args[i][1];
+    return nullptr;
+  }
+
+  static const char *reason(int code)
+  {
+    switch (code)
+    {
+    case 200:
+      return "OK";
+    case 204:
+      return "No Content";
+    case 304:
+      return "Not Modified";
+    case 400:
+      return "Bad Request";
+    case 404:
+      return "Not Found";
+    case 426:
+      return "Upgrade Required";
+    case 431:
+      return "Request Header Fields Too Large";
+    case 500:
+      return "Internal Server Error";
+    case 503:
+      return "Service Unavailable";
+    default:
+      return "";
+    }
+  }
+
+  /**
+   * @brief Find a header line's value in [line, end), case-insensitively
+   */
+  static const char *headerValue(const char *line, const char *end, const char *name)
+  {
+    size_t length = strlen(name);
+    if ((size_t)(end - line) <= length || strncasecmp(line, name, length) != 0 || line[length] != ':')
+      return nullptr;
+    line += length + 1;
+    while (line < end && *line == ' ')
+      line++;
+    return line;
+  }
+
+  /**
+   * @brief True once the headers, and the body they announce, have arrived
+   */
+  static bool requestComplete(const Connection &c)
+  {
+    const char *end = nullptr;
+    for (size_t i = 3; i < c.received && !end; i++)
+      if (memcmp(c.request + i - 3, "\r\n\r\n", 4) == 0)
+        end = c.request + i + 1;
+    if (!end)
+      return false;
+    size_t body = 0;
+    for (const char *line = c.request; line < end;)
+    {
+      const char *eol = (const char *)memchr(line, '\n', end - line);
+      const char *value = headerValue(line, eol, "Content-Length");
+      if (value)
+        body = strtoul(value, nullptr, 10);
+      line = eol + 1;
+    }
+    return (size_t)(c.request + c.received - end) >= body;
+  }
+
+  static int hexDigit(char c)
+  {
+    if (c >= '0' && c <= '9')
+      return c - '0';
+    c |= 0x20;
+    return c >= 'a' && c <= 'f' ? c - 'a' + 10 : -1;
+  }
+
+  /**
+   * @brief Undo URL encoding in place
+   */
+  static void decode(char *s)
+  {
+    char *out = s;
+    for (; *s; s++)
+    {
+      if (*s == '+')
+        *out++ = ' ';
+      else if (*s == '%' && hexDigit(s[1]) >= 0 && hexDigit(s[2]) >= 0)
+      {
+        *out++ = (char)(hexDigit(s[1]) << 4 | hexDigit(s[2]));
+        s += 2;
+      }
+      else
+        *out++ = *s;
+    }
+    *out = '\0';
+  }
+
+  /**
+   * @brief Split name=value&... into the argument table
+   * @return false if there are more than MAX_ARGS
+   */
+  static bool parseArgs(Connection &c, char *s)
+  {
+    while (*s)
+    {
+      char *next = strchr(s, '&');
+      if (next)
+        *next++ = '\0';
+      if (*s)
+      {
+        if (c.argCount == MAX_ARGS)
+          return false;
+        char *value = strchr(s, '=');
+        if (value)
+          *value++ = '\0';
+        decode(s);
+        if (value)
+          decode(value);
+        c.args[c.argCount][0] = s;
+        c.args[c.argCount++][1] = value ? value : s + strlen(s);
+      }
+      s = next ? next : s + strlen(s);
+    }
+    return true;
+  }
+
+  /**
+   * @brief Parse the request line, collected headers, query and form body
+   */
+  bool parse(Connection &c)
+  {
+    c.request[c.received] = '\0';
+    c.argCount = 0;
+    for (int i = 0; i < MAX_HEADERS; i++)
+      c.headers[i] = nullptr;
+    c.upgrade = c.key = nullptr;
+
+    char *line = c.request;
+    char *eol = strstr(line, "\r\n");
+    char *target = strchr(line, ' ');
+    if (!eol || !target || target > eol)
+      return false;
+    *target++ = '\0';
+    char *version = strchr(target, ' ');
+    if (!version || version > eol || strncmp(version + 1, "HTTP/1.", 7) != 0)
+      return false;
+    *version = '\0';
+    *eol = '\0';
+    c.method = strcmp(line, "GET") == 0 ? GET : strcmp(line, "POST") == 0 ? POST
+                                          : strcmp(line, "OPTIONS") == 0 ? OPTIONS
+                                                                         : OTHER;
+    c.path = target;
+    char *query = strchr(target, '?');
+    if (query)
+      *query++ = '\0';
+
+    bool form = false;
+    char *body = nullptr;
+    for (line = eol + 2; (eol = strstr(line, "\r\n")) != nullptr; line = eol + 2)
+    {
+      if (eol == line)
+      {
+        body = eol + 2;
+        break;
+      }
+      *eol = '\0';
+      const char *type = headerValue(line, eol, "Content-Type");
+      if (type)
+        form = strncmp(type, "application/x-www-form-urlencoded", 33) == 0;
+      if (const char *value = headerValue(line, eol, "Upgrade"))
+        c.upgrade = value;
+      if (const char *value = headerValue(line, eol, "Sec-WebSocket-Key"))
+        c.key = value;
+      for (int i = 0; i < collectedCount_; i++)
+      {
+        const char *value = headerValue(line, eol, collected_[i]);
+        if (value)
+          c.headers[i] = value;
+      }
+    }
+    if (query && !parseArgs(c, query))
+      return false;
+    return !(form && body && !parseArgs(c, body));
+  }
+
+  void dispatch(int id)
+  {
+    Connection &c = connections_[id];
+    current_ = id;
+    extraHeaderCount_ = 0;
+    if (c.overflow)
+      send(431);
+    else if (!parse(c))
+      send(400);
+    else if (c.method == OPTIONS)
+      send(204); // CORS preflight: the default headers answer it
+    else if (webSocketPath_ && strcmp(c.path, webSocketPath_) == 0)
+    {
+      if (upgrade(id))
+        return;
+    }
+    else
+    {
+      int route = 0;
+      while (route < routeCount_ && strcmp(routes_[route].path, c.path) != 0)
+        route++;
+      if (route < routeCount_)
+        routes_[route].handler();
+      else if (notFound_)
+        notFound_();
+      if (!c.responding)
+        send(404);
+    }
+    c.state = SENDING;
+    c.active = true;
+    current_ = -1;
+  }
+
+  /**
+   * @brief Answer a request on the WebSocket path: switch protocols, or
+   *        refuse with 426 (not an upgrade) or 503 (no client slot left)
+   * @return true if the connection is now a WebSocket
+   */
+  bool upgrade(int id)
+  {
+    Connection &c = connections_[id];
+    if (c.method != GET || !c.upgrade || strcasecmp(c.upgrade, "websocket") != 0 || !c.key)
+    {
+      sendHeader("Upgrade", "websocket");
+      send(426);
+      return false;
+    }
+    if (webSocketClients() >= PortalConfig::WiFi::WS_MAX_CLIENTS)
+    {
+      send(503);
+      return false;
+    }
+    char accept[WebSocket::ACCEPT_LENGTH];
+    static const char SWITCHING[] = "HTTP/1.1 101 Switching Protocols\r\nUpgrade: websocket\r\nConnection: Upgrade\r\n";
+    queue(c, SWITCHING, sizeof(SWITCHING) - 1);
+    queueHeader(c, "Sec-WebSocket-Accept", WebSocket::acceptKey(c.key, accept));
+    queue(c, "\r\n", 2);
+    c.state = WEBSOCKET;
+    c.webSocket = true;
+    c.received = 0;
+    c.active = true;
+    current_ = -1;
+    webSocketHandler_->onOpen(id);
+    return true;
+  }
+
+  /**
+   * @brief Handle the complete frames in a WebSocket's request buffer
+   */
+  void receiveFrames(int id)
+  {
+    Connection &c = connections_[id];
+    uint8_t *data = (uint8_t *)c.request;
+    size_t used = 0;
+    while (c.state == WEBSOCKET)
+    {
+      WebSocket::Frame frame;
+      WebSocket::Parse result = WebSocket::parse(data + used, c.received - used, PortalConfig::WiFi::WS_MESSAGE_MAX, frame);
+      if (result == WebSocket::INCOMPLETE)
+        break;
+      if (result != WebSocket::COMPLETE)
+      {
+        closeWebSocket(c, result == WebSocket::TOO_BIG ? WebSocket::CLOSE_TOO_BIG : WebSocket::CLOSE_PROTOCOL_ERROR);
+        break;
+      }
+      uint8_t *payload = data + used + frame.headerLength;
+      WebSocket::unmask(payload, frame.payloadLength, frame.mask);
+      used += frame.headerLength + frame.payloadLength;
+      switch (frame.opcode)
+      {
+      case WebSocket::TEXT:
+      case WebSocket::BINARY:
+        if (!frame.fin)
+          closeWebSocket(c, WebSocket::CLOSE_UNSUPPORTED); // Fragmented message
+        else
+        {
+          // Terminate in place, keeping the byte that starts the next frame
+          uint8_t next = payload[frame.payloadLength];
+          payload[frame.payloadLength] = 0;
+          webSocketHandler_->onMessage(id, (char *)payload, frame.payloadLength);
+          payload[frame.payloadLength] = next;
+        }
+        break;
+      case WebSocket::PING:
+        sendFrame(c, WebSocket::PONG, (const char *)payload, frame.payloadLength);
+        break;
+      case WebSocket::PONG:
+        break;
+      case WebSocket::CLOSE:
+        // Echo the client's status, then close once it is sent
+        sendFrame(c, WebSocket::CLOSE, (const char *)payload, frame.payloadLength < 2 ? frame.payloadLength : 2);
+        c.state = SENDING;
+        c.active = true; // The send timeout starts now
+        break;
+      default:
+        closeWebSocket(c, WebSocket::CLOSE_UNSUPPORTED); // Continuation without a start
+      }
+    }
+    memmove(data, data + used, c.received - used);
+    c.received -= used;
+    if (c.state == WEBSOCKET && c.overflow)
+      closeWebSocket(c, WebSocket::CLOSE_TOO_BIG); // Sent faster than the loop reads
+  }
+
+  void closeWebSocket(Connection &c, uint16_t status)
+  {
+    char payload[2] = {(char)(status >> 8), (char)status};
+    sendFrame(c, WebSocket::CLOSE, payload, sizeof(payload));
+    c.state = SENDING;
+    c.active = true;
+  }
+
+  void sendFrame(Connection &c, uint8_t opcode, const char *payload, size_t length)
+  {
+    uint8_t header[WebSocket::MAX_HEADER];
+    queue(c, (const char *)header, WebSocket::header(opcode, length, header));
+    if (length)
+      queue(c, payload, length);
+  }
+
+  void queueHeader(Connection &c, const char *name, const char *value)
+  {
+    queue(c, name, strlen(name));
+    queue(c, ": ", 2);
+    queue(c, value, strlen(value));
+    queue(c, "\r\n", 2);
+  }
+
+  /**
+   * @brief Send response bytes, keeping what the window cannot take yet
+   */
+  void queue(Connection &c, const char *data, size_t length)
+  {
+    if (c.failed)
+      return;
+    if (c.txStart == c.txEnd)
+    {
+      size_t n = transport_->write((int)(&c - connections_), data, length);
+      data += n;
+      length -= n;
+      c.txStart = c.txEnd = 0;
+    }
+    if (length && !makeRoom(c, length))
+    {
+      c.failed = true;
+      return;
+    }
+    memcpy(c.tx + c.txEnd, data, length);
+    c.txEnd += length;
+  }
+
+  bool hasRoom(const Connection &c, size_t length) const { return TX_BUFFER - (c.txEnd - c.txStart) >= length; }
+
+  bool makeRoom(Connection &c, size_t length)
+  {
+    if (TX_BUFFER - c.txEnd >= length)
+      return true;
+    memmove(c.tx, c.tx + c.txStart, c.txEnd - c.txStart);
+    c.txEnd -= c.txStart;
+    c.txStart = 0;
+    return TX_BUFFER - c.txEnd >= length;
+  }
+
+  /**
+   * @brief Push buffered bytes to the transport; with @p readSource, refill
+   *        from the body source while the window keeps taking them
+   */
+  void pump(int id, bool readSource)
+  {
+    Connection &c = connections_[id];
+    for (;;)
+    {
+      if (c.txStart != c.txEnd)
+      {
+        size_t n = transport_->write(id, c.tx + c.txStart, c.txEnd - c.txStart);
+        c.txStart += n;
+        if (n && c.state == SENDING)
+          c.active = true;
+        if (c.txStart != c.txEnd)
+          return; // Window full: onWritable() resumes
+        c.txStart = c.txEnd = 0;
+      }
+      if (!readSource || !c.source)
+        return;
+      if (c.sourceLeft == 0)
+      {
+        c.source->close(id);
+        c.source = nullptr;
+        return;
+      }
+      size_t want = c.sourceLeft < TX_BUFFER ? c.sourceLeft : TX_BUFFER;
+      size_t n = c.source->read(id, (uint8_t *)c.tx, want);
+      if (n == 0)
+      {
+        c.failed = true; // Shorter than its Content-Length
+        return;
+      }
+      c.txEnd = n;
+      c.sourceLeft -= n;
+    }
+  }
+
+  void finish(int id)
+  {
+    transport_->close(id);
+    release(id);
+  }
+
+  void drop(int id)
+  {
+    transport_->abort(id);
+    release(id);
+  }
+
+  void release(int id)
+  {
+    Connection &c = connections_[id];
+    if (c.source)
+      c.source->close(id);
+    c.source = nullptr;
+    c.state = FREE;
+    if (c.webSocket)
+    {
+      c.webSocket = false;
+      webSocketHandler_->onClose(id);
+    }
+  }
+};
+
+/**
+ * @brief IResponseSink that sends a ResponseWriter's body as one WebSocket
+ *        text message, to one client or all of them
+ *
+ * The body must fit the writer's buffer; a longer one is not sent and
+ * counts as missed by every recipient. Read missed() once the writer has
+ * ended.
+ *
+ * @example
+ * ```cpp
+ * WebSocketSink sink(server);
+ * ResponseWriter(sink, buffer, sizeof(buffer), 200, "application/json").beginObject().field(F("fps"), 60).endObject();
+ * bool everyoneGotIt = sink.missed() == 0;
+ * ```
+ */
+class WebSocketSink : public IResponseSink
+{
+public:
+  static constexpr int ALL = -1;
+
+  explicit WebSocketSink(AsyncHttpServer &server, int client = ALL)
+      : _server(server), _client(client), _whole(false), _missed(0)
+  {
+  }
+
+  int missed() const { return _missed; }
+
+  void begin(int, const char *, size_t length) override
+  {
+    _whole = length != UNKNOWN_LENGTH;
+    if (!_whole)
+      _missed = _client == ALL ? _server.webSocketClients() : 1;
+  }
+
+  void write(const char *data, size_t length) override
+  {
+    if (_whole)
+      _missed = _client == ALL ? _server.broadcastText(data, length) : !_server.sendText(_client, data, length);
+  }
+
+  void end() override {}
+
+private:
+  AsyncHttpServer &_server;
+  int _client;
+  bool _whole;
+  int _missed;
+};
+
+#ifndef UNIT_TEST
+/**
+ * @brief ITcpTransport on lwIP's raw TCP API
+ *
+ * lwIP calls back from the SDK's event context between passes of loop(), so
+ * the callbacks never run in the middle of a frame or a handler.
+ */
+class LwipTcpTransport : public ITcpTransport
+{
+public:
+  static constexpr int MAX_CONNECTIONS = PortalConfig::WiFi::HTTP_MAX_CONNECTIONS;
+
+  LwipTcpTransport() : handler_(nullptr), listener_(nullptr)
+  {
+    for (int i = 0; i < MAX_CONNECTIONS; i++)
+      slots_[i] = {this, nullptr, i};
+  }
+
+  bool begin(uint16_t port, ITcpHandler *handler) override
+  {
+    handler_ = handler;
+    tcp_pcb *pcb = tcp_new();
+    if (!pcb)
+      return false;
+    if (tcp_bind(pcb, IP_ADDR_ANY, port) != ERR_OK)
+    {
+      tcp_close(pcb);
+      return false;
+    }
+    listener_ = tcp_listen(pcb);
+    if (!listener_)
+    {
+      tcp_close(pcb);
+      return false;
+    }
+    tcp_arg(listener_, this);
+    tcp_accept(listener_, &LwipTcpTransport::accepted);
+    return true;
+  }
+
+  size_t write(int id, const char *data, size_t length) override
+  {
+    tcp_pcb *pcb = slots_[id].pcb;
+    if (!pcb)
+      return 0;
+    size_t n = tcp_sndbuf(pcb);
+    n = length < n ? length : n;
+    if (n == 0 || tcp_write(pcb, data, n, TCP_WRITE_FLAG_COPY) != ERR_OK)
+      return 0;
+    tcp_output(pcb);
+    return n;
+  }
+
+  void close(int id) override
+  {
+    tcp_pcb *pcb = detach(id);
+    if (pcb && tcp_close(pcb) != ERR_OK)
+      tcp_abort(pcb);
+  }
+
+  void abort(int id) override
+  {
+    tcp_pcb *pcb = detach(id);
+    if (pcb)
+      tcp_abort(pcb);
+  }
+
+private:
+  struct Slot
+  {
+    LwipTcpTransport *owner;
+    tcp_pcb *pcb;
+    int id;
+  };
+
+  ITcpHandler *handler_;
+  tcp_pcb *listener_;
+  Slot slots_[MAX_CONNECTIONS];
+
+  tcp_pcb *detach(int id)
+  {
+    tcp_pcb *pcb = slots_[id].pcb;
+    slots_[id].pcb = nullptr;
+    if (pcb)
+    {
+      tcp_arg(pcb, nullptr);
+      tcp_recv(pcb, nullptr);
+      tcp_sent(pcb, nullptr);
+      tcp_err(pcb, nullptr);
+    }
+    return pcb;
+  }
+
+  static err_t accepted(void *arg, tcp_pcb *pcb, err_t err)
+  {
+    LwipTcpTransport *self = static_cast<LwipTcpTransport *>(arg);
+    if (err != ERR_OK || !pcb)
+      return ERR_VAL;
+    Slot *slot = nullptr;
+    for (Slot &s : self->slots_)
+      if (!s.pcb)
+      {
+        slot = &s;
+        break;
+      }
+    if (!slot)
+    {
+      tcp_abort(pcb); // Connection limit
+      return ERR_ABRT;
+    }
+    slot->pcb = pcb;
+    tcp_arg(pcb, slot);
+    tcp_recv(pcb, &LwipTcpTransport::received);
+    tcp_sent(pcb, &LwipTcpTransport::sent);
+    tcp_err(pcb, &LwipTcpTransport::failed);
+    tcp_nagle_disable(pcb);
+    self->handler_->onConnect(slot->id);
+    return ERR_OK;
+  }
+
+  static err_t received(void *arg, tcp_pcb *pcb, pbuf *p, err_t err)
+  {
+    Slot *slot = static_cast<Slot *>(arg);
+    if (!slot)
+    {
+      if (p)
+        pbuf_free(p);
+      return ERR_OK;
+    }
+    if (!p || err != ERR_OK)
+    {
+      // Peer closed
+      if (p)
+        pbuf_free(p);
+      int id = slot->id;
+      LwipTcpTransport *self = slot->owner;
+      self->detach(id);
+      err_t result = ERR_OK;
+      if (tcp_close(pcb) != ERR_OK)
+      {
+        tcp_abort(pcb);
+        result = ERR_ABRT;
+      }
+      self->handler_->onClose(id);
+      return result;
+    }
+    for (pbuf *q = p; q; q = q->next)
+      slot->owner->handler_->onData(slot->id, static_cast<const uint8_t *>(q->payload), q->len);
+    tcp_recved(pcb, p->tot_len);
+    pbuf_free(p);
+    return ERR_OK;
+  }
+
+  static err_t sent(void *arg, tcp_pcb *, u16_t)
+  {
+    Slot *slot = static_cast<Slot *>(arg);
+    if (slot)
+      slot->owner->handler_->onWritable(slot->id);
+    return ERR_OK;
+  }
+
+  static void failed(void *arg, err_t)
+  {
+    // lwIP has already freed the pcb
+    Slot *slot = static_cast<Slot *>(arg);
+    if (!slot)
+      return;
+    slot->pcb = nullptr;
+    slot->owner->handler_->onClose(slot->id);
+  }
+};
+#endif
@@ -0,0 +1,150 @@
+#pragma once
+
+#include <stdint.h>
+#include "effects.h"
+
+/**
+ * @file color_math.h
+ * @brief Fixed-point colour math for the FPU-less ESP8266
+ *
+ * Every float operation on the ESP8266 is software-emulated, so the per-pixel
+ * effect paths use these integer helpers instead. Two formats are used:
+ * - Q16 (uint32_t): unsigned ratio where 0x10000 == 1.0, for interpolation
+ * - Q8.8 (int16_t): signed value where 256 == 1.0, for brightness envelopes
+ *
+ * Results truncate the same way the previous float code did and stay within
+ * 1 LSB of it (see test/native_color_math_test.cpp).
+ */
+namespace ColorMath
+{
+  typedef uint32_t q16_t;  ///< Unsigned Q16 ratio, Q16_ONE == 1.0
+  typedef int16_t q8_8_t;  ///< Signed Q8.8 value, Q8_8_ONE == 1.0
+
+  constexpr q16_t Q16_ONE = 0x10000UL;
+  constexpr q8_8_t Q8_8_ONE = 256;
+
+  /**
+   * @brief Convert a float constant to Q8.8 at compile time
+   */
+  constexpr q8_8_t toQ8_8(float v)
+  {
+    return (q8_8_t)(v * 256.0f + (v < 0.0f ? -0.5f : 0.5f));
+  }
+
+  /**
+   * @brief Convert a float constant in [0, 1] to Q16 at compile time
+   */
+  constexpr q16_t toQ16(float v)
+  {
+    return v <= 0.0f ? 0 : (v >= 1.0f ? Q16_ONE : (q16_t)(v * 65536.0f + 0.5f));
+  }
+
+  /**
+   * @brief Ratio num / den as Q16, clamped to [0, 1]
+   */
+  inline q16_t ratioQ16(uint32_t num, uint32_t den)
+  {
+    if (den == 0 || num >= den)
+      return Q16_ONE;
+    return (q16_t)(((uint64_t)num << 16) / den);
+  }
+
+  /**
+   * @brief Linear interpolation a + (b - a) * t, truncated like the float path
+   * @param t Q16 ratio in [0, Q16_ONE]
+   */
+  inline uint8_t lerp8(uint8_t a, uint8_t b, q16_t t)
+  {
+    int32_t delta = (int32_t)b - (int32_t)a;
+    return (uint8_t)((((int32_t)a << 16) + delta * (int32_t)t) >> 16);
+  }
+
+  /**
+   * @brief Linear interpolation between two colours
+   * @param t Q16 ratio in [0, Q16_ONE]
+   */
+  inline CRGB lerpColor(const CRGB &a, const CRGB &b, q16_t t)
+  {
+    return CRGB(lerp8(a.r, b.r, t), lerp8(a.g, b.g, t), lerp8(a.b, b.b, t));
+  }
+
+  /**
+   * @brief Scale v by scale / 256, with 255 meaning full scale (FastLED scale8)
+   */
+  inline uint8_t scale8(uint8_t v, uint8_t scale)
+  {
+    return (uint8_t)(((uint16_t)v * (1 + (uint16_t)scale)) >> 8);
+  }
+
+  /**
+   * @brief Saturating 8-bit add
+   */
+  inline uint8_t qadd8(uint8_t a, uint8_t b)
+  {
+    uint16_t sum = (uint16_t)a + b;
+    return sum > 255 ? 255 : (uint8_t)sum;
+  }
+
+  /**
+   * @brief Clamp an integer into the 0-255 range
+   */
+  inline uint8_t saturate8(int32_t v)
+  {
+    return v < 0 ? 0 : (v > 255 ? 255 : (uint8_t)v);
+  }
+
+  /**
+   * @brief Fade-in curve: floor(255 * elapsed / duration), clamped to 255
+   */
+  inline uint8_t fadeInScale(unsigned long elapsed, unsigned long duration)
+  {
+    if (elapsed >= duration)
+      return 255;
+    return (uint8_t)((elapsed * 255UL) / duration);
+  }
+
+  /**
+   * @brief Fade-out curve: floor(255 * (1 - elapsed / duration)), 0 once elapsed
+   */
+  inline uint8_t fadeOutScale(unsigned long elapsed, unsigned long duration)
+  {
+    if (elapsed >= duration)
+      return 0;
+    return (uint8_t)(255UL - (elapsed * 255UL + duration - 1) / duration);
+  }
+
+  /**
+   * @brief Fill dst[0..len) with a linear ramp from a (first) to b (last)
+   *
+   * Matches interpolateColor(a, b, i / (len - 1)) for each pixel, but walks the
+   * Q16 ratio with an error accumulator so there is no division per pixel.
+   * Pixel may be any type assignable from CRGB (e.g. a packed format).
+   */
+  template <typename Pixel>
+  inline void fillGradient(Pixel *dst, int len, const CRGB &a, const CRGB &b)
+  {
+    if (len <= 0)
+      return;
+    if (len == 1)
+    {
+      dst[0] = a;
+      return;
+    }
+    const uint32_t den = (uint32_t)(len - 1);
+    const q16_t step = Q16_ONE / den;
+    const uint32_t rem = Q16_ONE % den;
+    q16_t t = 0;
+    uint32_t err = 0;
+    for (int i = 0; i < len; i++)
+    {
+      dst[i] = lerpColor(a, b, t);
+      t += step;
+      err += rem;
+      if (err >= den)
+      {
+        t++;
+        err -= den;
+      }
+    }
+  }
+}
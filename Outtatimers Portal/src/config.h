@@ -3,6 +3,7 @@
 #define COLOR_ORDER GRB
 
 #include <stdint.h>
+#include <stddef.h>
 
 /**
  * @file config.h
@@ -25,10 +26,15 @@ namespace PortalConfig
     constexpr uint8_t DEFAULT_BRIGHTNESS = 255;   // Maximum brightness
     constexpr uint8_t DIAGNOSTIC_BRIGHTNESS = 25; // ~10% for startup diagnostics
 
+    // WS2812B wire timing, used by FramePacer's transmit model
+    constexpr unsigned long WS2812_BIT_NS = 1250;  // 800 kHz data rate
+    constexpr unsigned long WS2812_LATCH_US = 300; // Reset/latch low time (newer WS2812B parts)
+
     // Button pin assignments
     constexpr int BUTTON1_PIN = 14; // GPIO14 (D5) - Portal toggle
     constexpr int BUTTON2_PIN = 12; // GPIO12 (D6) - Malfunction trigger
     constexpr int BUTTON3_PIN = 13; // GPIO13 (D7) - Fade out
+    constexpr int BUTTON4_PIN = 5;  // GPIO5 (D1) - Next preset
 
     // Status LED (on-board LED)
     constexpr int STATUS_LED_PIN = 2;            // GPIO2 (D4) - On-board LED on most ESP8266 boards
@@ -48,7 +54,15 @@ namespace PortalConfig
   // Timing Configuration
   namespace Timing
   {
-    constexpr unsigned long UPDATE_INTERVAL_MS = 10;   // ~100 FPS update rate
+    constexpr unsigned long UPDATE_INTERVAL_MS = 10;   // Minimum frame interval (~100 FPS cap)
+    constexpr unsigned long FRAME_INPUT_SLICE_MS = 5;    // Loop time reserved per frame for input and HTTP
+    constexpr unsigned long FRAME_MAX_INTERVAL_MS = 100; // Slowest frame interval the pacer will choose
+
+    // Motion timing: speed settings are positions per MOTION_TICK_MS of real
+    // time. 25 ms is the rate a 756-LED strip actually ran at with per-frame
+    // motion, so existing speed settings keep their on-set look.
+    constexpr unsigned long MOTION_TICK_MS = 25;
+    constexpr unsigned long MOTION_MAX_STEP_MS = 100; // Longest gap a single frame may catch up
     constexpr unsigned long DEBOUNCE_INTERVAL_MS = 50; // Button debounce time
 
     // Startup sequence timing
@@ -58,6 +72,10 @@ namespace PortalConfig
     // Effect timing
     constexpr unsigned long FADE_IN_DURATION_MS = 3000; // 3 second fade in
     constexpr unsigned long FADE_OUT_DURATION_MS = 200; // 200ms fade out
+    constexpr unsigned long RECOLOR_FADE_MS = 1000;     // Driver colour crossfade after a hue/saturation change
+
+    // Settings are saved to flash once they have been left alone this long
+    constexpr unsigned long CONFIG_SAVE_DELAY_MS = 5000;
 
     // Malfunction effect timing
     constexpr unsigned long MALFUNCTION_MIN_JUMP_MS = 40;
@@ -82,6 +100,20 @@ namespace PortalConfig
     // Portal effect parameters
     constexpr int MIN_DRIVER_DISTANCE = 5;  // Minimum distance between color drivers
     constexpr int MAX_DRIVER_DISTANCE = 15; // Maximum distance between color drivers
+    constexpr int MAX_DRIVER_POINTS = Hardware::NUM_LEDS / MIN_DRIVER_DISTANCE + 2; // Upper bound per pattern
+
+    // Storage for the rotating gradient patterns (see ring_buffer.h). Sizes are
+    // per pattern at 756 LEDs, front and back ring together (DoubleRing); there
+    // are three patterns. A plain CRGB[756] is 2268 bytes.
+    enum class RingLayout : uint8_t
+    {
+      PROCEDURAL, // Driver points only, evaluated during the blit (2 x 768 B)
+      MIRRORED,   // RGB array stored twice, every rotation a linear read (2 x 4680 B)
+      WRAPPED,    // RGB array stored once, one wrap branch per pixel (2 x 2416 B)
+      RGB565      // 16-bit array, expanded to RGB in the blit (2 x 1656 B)
+    };
+    constexpr RingLayout RING_LAYOUT = RingLayout::PROCEDURAL;
+    constexpr int GENERATION_POINTS_PER_STEP = 16; // Driver points per background generation step
 
     // Color generation parameters
     constexpr uint8_t PORTAL_HUE_BASE = 160;       // Base hue for portal colors (blue-purple range)
@@ -107,6 +139,52 @@ namespace PortalConfig
     constexpr uint8_t MALFUNCTION_BRIGHTNESS_OFFSET = 85;
   }
 
+  // Scene presets (see preset_store.h)
+  namespace Presets
+  {
+    constexpr int SLOTS = 8;         // Presets kept in flash, /preset0.bin to /preset7.bin
+    constexpr int NAME_LENGTH = 15;  // Longest preset name
+    constexpr int STREAM_CHUNK = 64; // Bytes moved to or from flash at a time
+  }
+
+  // Realtime frame input over UDP (see realtime_input.h)
+  namespace Realtime
+  {
+    constexpr int PORTAL_MODE = 2;                  // Portal mode showing these frames, after classic and virtual gradients
+    constexpr uint16_t E131_PORT = 5568;            // sACN (E1.31)
+    constexpr uint16_t ARTNET_PORT = 6454;          // Art-Net
+    constexpr uint16_t E131_FIRST_UNIVERSE = 1;     // Universe holding pixel 0; sACN numbers from 1
+    constexpr uint16_t ARTNET_FIRST_UNIVERSE = 0;   // Port-Address holding pixel 0
+    constexpr int PIXELS_PER_UNIVERSE = 170;        // 510 of the 512 channels, RGB
+    constexpr int MAX_PACKETS_PER_UPDATE = 16;      // Datagrams read per loop pass, so a flood cannot stall frames
+    constexpr unsigned long FRAME_HOLD_MS = 100;    // Longest a frame waits for missing universes, then to be shown
+  }
+
+  // Show time shared between units over UDP multicast (see show_clock.h)
+  namespace Sync
+  {
+    constexpr bool LEADER = false;                  // Build exactly one unit of a set with true; the rest follow it
+    constexpr uint16_t PORT = 5571;                 // Beacon port
+    constexpr uint8_t GROUP[4] = {239, 255, 83, 89}; // Beacon multicast group
+    constexpr unsigned long BEACON_INTERVAL_MS = 250; // Leader's beacon period
+    constexpr unsigned long TIMEOUT_MS = 3000;      // Followers free-run after this long without a beacon
+    constexpr int WINDOW = 8;                       // Beacons whose least-delayed one sets the offset
+    constexpr unsigned long STEP_MS = 100;          // Larger errors are stepped; smaller ones slewed out
+    constexpr unsigned long SLEW_TIME_MS = 1000;    // Time constant of the slew
+    constexpr int MAX_SLEW_PPM = 20000;             // Fastest slew: show time runs at most 2% fast or slow
+    constexpr int MAX_DRIFT_PPM = 1000;             // Largest believable crystal drift between units
+  }
+
+  // Cue triggers over UDP (see cue_input.h)
+  namespace Cues
+  {
+    constexpr uint16_t PORT = 5572;                 // Cue port
+    constexpr int QUEUE = 8;                        // Cues waiting for the input manager
+    constexpr int MAX_PACKETS_PER_UPDATE = 4;       // Datagrams read per loop pass
+    constexpr int DUPLICATE_WINDOW = 32;            // Sequence numbers this far behind the last are repeats
+    constexpr unsigned long SHOW_TIMEOUT_MS = 1000; // A cue not shown by then is counted unshown
+  }
+
   // Mathematical Constants
   namespace Math
   {
@@ -125,6 +203,19 @@ namespace PortalConfig
   {
     constexpr int HTTP_PORT = 80;                    // Web server port
     constexpr unsigned long WIFI_TIMEOUT_MS = 10000; // WiFi connection timeout
+    constexpr unsigned long CONFIG_APPLY_INTERVAL_MS = 100; // Shortest gap between applied /set batches
+    constexpr int MAX_ASSETS = 8;                    // Web assets served from LittleFS
+    constexpr size_t ASSET_CHUNK = 512;              // Bytes per write when streaming an asset
+    constexpr size_t RESPONSE_BUFFER = 512;          // Response body buffer; longer bodies are sent in pieces
+    constexpr int HTTP_MAX_CONNECTIONS = 5;          // Clients served at once, WebSockets included; more are refused (lwIP has 5 TCP PCBs)
+    constexpr size_t HTTP_REQUEST_BUFFER = 1024;     // Largest request: line, headers and form body
+    constexpr size_t HTTP_TX_BUFFER = 1024;          // Response bytes held per connection while the TCP window is full
+    constexpr unsigned long HTTP_REQUEST_TIMEOUT_MS = 3000; // Time a client has to send its whole request
+    constexpr unsigned long HTTP_SEND_TIMEOUT_MS = 5000;    // Time a client may go without taking response data
+    constexpr int WS_MAX_CLIENTS = 2;                // WebSocket clients at once, leaving the other connections to HTTP
+    constexpr size_t WS_MESSAGE_MAX = 128;           // Longest message a client may send
+    constexpr unsigned long WS_PING_INTERVAL_MS = 15000; // Silence before a ping; a client silent for two is dropped
+    constexpr unsigned long WS_STATE_INTERVAL_MS = 1000; // Shortest gap between state pushes
 
     // WiFi credentials are loaded from wifi_credentials.h (git-ignored)
     // Copy wifi_credentials.h.template to wifi_credentials.h and configure
@@ -0,0 +1,163 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "config.h"
+#include "config_manager.h"
+
+/**
+ * @brief Several runtime parameters changed together
+ *
+ * Filled from request arguments named as in the /config JSON and applied in
+ * one step between frames, so the next frame's ConfigSnapshot holds all of
+ * them: changing the hue and saturation ranges together recolours the
+ * patterns once, not once per parameter. A batch with any bad argument is
+ * rejected whole.
+ *
+ * @example
+ * ```cpp
+ * ConfigBatch batch;
+ * if (batch.set("hueMin", "20") && batch.set("hueMax", "90"))
+ *     batch.apply();
+ * ```
+ */
+class ConfigBatch
+{
+public:
+  enum Field : uint8_t
+  {
+    SPEED,
+    BRIGHTNESS,
+    HUE_MIN,
+    HUE_MAX,
+    SAT_MIN,
+    SAT_MAX,
+    MODE,
+    FIELD_COUNT
+  };
+
+  ConfigBatch() : _fields(0) {}
+
+  /**
+   * @brief Add one parameter from its argument name and text
+   * @return false if the name is unknown or the value is not an integer 0-255
+   */
+  bool set(const char *name, const char *text)
+  {
+    char *end;
+    long value = strtol(text, &end, 10);
+    if (*text == '\0' || *end != '\0' || value < 0 || value > 255)
+      return false;
+    for (int i = 0; i < FIELD_COUNT; ++i)
+    {
+      if (strcmp(name, fieldName((Field)i)) == 0)
+      {
+        set((Field)i, (uint8_t)value);
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void set(Field field, uint8_t value)
+  {
+    _values[field] = value;
+    _fields |= 1u << field;
+  }
+
+  bool has(Field field) const { return _fields & (1u << field); }
+  uint8_t get(Field field) const { return _values[field]; }
+  bool empty() const { return _fields == 0; }
+  void clear() { _fields = 0; }
+
+  /**
+   * @brief Take every parameter in @p newer, replacing values already held
+   */
+  void merge(const ConfigBatch &newer)
+  {
+    for (int i = 0; i < FIELD_COUNT; ++i)
+      if (newer.has((Field)i))
+        set((Field)i, newer.get((Field)i));
+  }
+
+  /**
+   * @brief Hand the parameters to ConfigManager (setters clamp further)
+   */
+  void apply() const
+  {
+    if (has(SPEED))
+      ConfigManager::setRotationSpeed(get(SPEED));
+    if (has(BRIGHTNESS))
+      ConfigManager::setMaxBrightness(get(BRIGHTNESS));
+    if (has(HUE_MIN))
+      ConfigManager::setHueMin(get(HUE_MIN));
+    if (has(HUE_MAX))
+      ConfigManager::setHueMax(get(HUE_MAX));
+    if (has(SAT_MIN))
+      ConfigManager::setSatMin(get(SAT_MIN));
+    if (has(SAT_MAX))
+      ConfigManager::setSatMax(get(SAT_MAX));
+    if (has(MODE))
+      ConfigManager::setPortalMode(get(MODE));
+  }
+
+  static const char *fieldName(Field field)
+  {
+    static const char *const names[FIELD_COUNT] = {"speed", "brightness", "hueMin", "hueMax", "satMin", "satMax", "mode"};
+    return names[field];
+  }
+
+private:
+  uint8_t _values[FIELD_COUNT];
+  uint8_t _fields; // Bit per Field present
+};
+
+/**
+ * @brief Applies staged ConfigBatch changes at most once per interval
+ *
+ * A dragged slider sends a request per step. Staged batches merge, later
+ * values winning, and are applied on the first service() call at least
+ * intervalMs after the previous apply, so a burst of requests costs one
+ * recolour per interval. A change after a quiet period applies at once.
+ */
+class ConfigCoalescer
+{
+public:
+  explicit ConfigCoalescer(unsigned long intervalMs = PortalConfig::WiFi::CONFIG_APPLY_INTERVAL_MS)
+      : _intervalMs(intervalMs), _lastApply(0), _applied(false) {}
+
+  void stage(const ConfigBatch &batch) { _pending.merge(batch); }
+  bool pending() const { return !_pending.empty(); }
+
+  /**
+   * @brief Apply the staged changes if the interval has passed
+   * @param now Current millis()
+   * @return true if a batch was applied
+   */
+  bool service(unsigned long now)
+  {
+    if (_pending.empty() || (_applied && now - _lastApply < _intervalMs))
+      return false;
+    _pending.apply();
+    _pending.clear();
+    _lastApply = now;
+    _applied = true;
+    return true;
+  }
+
+  /**
+   * @brief Apply the staged changes now, whatever the interval
+   */
+  void flush()
+  {
+    _pending.apply();
+    _pending.clear();
+  }
+
+private:
+  ConfigBatch _pending;
+  unsigned long _intervalMs;
+  unsigned long _lastApply;
+  bool _applied; // Nothing applied yet: the first batch goes straight through
+};
@@ -3,6 +3,42 @@
 #include <stdint.h>
 #include <Arduino.h>
 
+/**
+ * @brief Immutable copy of every runtime parameter
+ *
+ * Taken once per frame (see FrameContext) so an effect reads consistent
+ * values however often it consults them. Each parameter group carries the
+ * value of the global version counter at its last change: comparing a
+ * group version with the one a piece of work was built from tells whether
+ * that work is stale, without a shared flag that one consumer could clear
+ * before another saw it.
+ */
+struct ConfigSnapshot
+{
+  uint32_t version;           // Bumped by every change; never decreases
+  uint32_t colorVersion;      // hueMin, hueMax, satMin, satMax
+  uint32_t motionVersion;     // rotationSpeed
+  uint32_t brightnessVersion; // maxBrightness
+  uint32_t modeVersion;       // portalMode
+
+  int rotationSpeed;
+  uint8_t maxBrightness;
+  uint8_t hueMin;
+  uint8_t hueMax;
+  uint8_t satMin;
+  uint8_t satMax;
+  int portalMode;
+};
+
+/**
+ * @brief Per-frame inputs: the frame time and the configuration it renders
+ */
+struct FrameContext
+{
+  unsigned long now;
+  ConfigSnapshot config;
+};
+
 /**
  * @brief Configuration manager for runtime parameters
  *
@@ -25,7 +61,19 @@ public:
     satMin = 128;        // Default minimum saturation
     satMax = 255;        // Default maximum saturation
     portalMode = 0;      // Default to classic mode
-    effectNeedsRegeneration = false;
+
+    // Everything may have changed: patterns built before begin() are stale
+    version++;
+    colorVersion = motionVersion = brightnessVersion = modeVersion = version;
+  }
+
+  /**
+   * @brief Copy the current configuration, with its versions
+   */
+  static ConfigSnapshot snapshot()
+  {
+    return {version, colorVersion, motionVersion, brightnessVersion, modeVersion,
+            rotationSpeed, maxBrightness, hueMin, hueMax, satMin, satMax, portalMode};
   }
 
   /**
@@ -43,7 +91,7 @@ public:
    */
   static void setRotationSpeed(int speed)
   {
-    rotationSpeed = constrain(speed, 0, 10);
+    assign(rotationSpeed, constrain(speed, 0, 10), motionVersion);
   }
 
   /**
@@ -61,7 +109,7 @@ public:
    */
   static void setMaxBrightness(uint8_t brightness)
   {
-    maxBrightness = constrain(brightness, 0, 255);
+    assign(maxBrightness, brightness, brightnessVersion);
   }
 
   /**
@@ -79,8 +127,7 @@ public:
    */
   static void setHueMin(uint8_t minHue)
   {
-    hueMin = constrain(minHue, 0, 255);
-    effectNeedsRegeneration = true;
+    assign(hueMin, minHue, colorVersion);
   }
 
   /**
@@ -98,8 +145,7 @@ public:
    */
   static void setHueMax(uint8_t maxHue)
   {
-    hueMax = constrain(maxHue, 0, 255);
-    effectNeedsRegeneration = true;
+    assign(hueMax, maxHue, colorVersion);
   }
 
   /**
@@ -117,8 +163,7 @@ public:
    */
   static void setSatMin(uint8_t minSat)
   {
-    satMin = constrain(minSat, 0, 255);
-    effectNeedsRegeneration = true;
+    assign(satMin, minSat, colorVersion);
   }
 
   /**
@@ -136,30 +181,12 @@ public:
    */
   static void setSatMax(uint8_t maxSat)
   {
-    satMax = constrain(maxSat, 0, 255);
-    effectNeedsRegeneration = true;
-  }
-
-  /**
-   * @brief Check if effect regeneration is needed
-   * @return true if regeneration is required
-   */
-  static bool needsEffectRegeneration()
-  {
-    return effectNeedsRegeneration;
-  }
-
-  /**
-   * @brief Clear the effect regeneration flag
-   */
-  static void clearEffectRegenerationFlag()
-  {
-    effectNeedsRegeneration = false;
+    assign(satMax, maxSat, colorVersion);
   }
 
   /**
    * @brief Get the current portal mode
-   * @return Portal mode (0: classic, 1: virtual gradients)
+   * @return Portal mode (0: classic, 1: virtual gradients, 2: realtime)
    */
   static int getPortalMode()
   {
@@ -168,21 +195,36 @@ public:
 
   /**
    * @brief Set the portal mode
-   * @param mode Portal mode (0: classic, 1: virtual gradients)
+   * @param mode Portal mode (0: classic, 1: virtual gradients, 2: realtime)
    */
   static void setPortalMode(int mode)
   {
-    portalMode = constrain(mode, 0, 1);
-    effectNeedsRegeneration = true;
+    assign(portalMode, constrain(mode, 0, 2), modeVersion);
   }
 
 private:
+  // Store a setting, bumping its group's version only when the value changes
+  template <typename T, typename V>
+  static void assign(T &field, V value, uint32_t &groupVersion)
+  {
+    if (field == (T)value)
+      return;
+    field = (T)value;
+    groupVersion = ++version;
+  }
+
+  // Change versions (see ConfigSnapshot)
+  static uint32_t version;
+  static uint32_t colorVersion;
+  static uint32_t motionVersion;
+  static uint32_t brightnessVersion;
+  static uint32_t modeVersion;
+
   static int rotationSpeed;
   static uint8_t maxBrightness;
   static uint8_t hueMin;
   static uint8_t hueMax;
   static uint8_t satMin;
   static uint8_t satMax;
-  static bool effectNeedsRegeneration;
   static int portalMode;
 };
\ No newline at end of file
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <stdint.h>
+#include "effects.h"
+
+/**
+ * @brief Fixed-capacity list of gradient driver points
+ *
+ * A gradient pattern is defined by its driver points: a position on the
+ * strip and the colour at that position. With drivers at least
+ * MIN_DRIVER_DISTANCE apart, a strip holds at most
+ * NUM_LEDS / MIN_DRIVER_DISTANCE of them plus the closing point, so the
+ * list is sized from that bound (Effects::MAX_DRIVER_POINTS) rather than
+ * from the strip length. Positions are uint16_t: 5 bytes per point.
+ *
+ * @example
+ * ```cpp
+ * DriverPoints<PortalConfig::Effects::MAX_DRIVER_POINTS> points;
+ * points.push(0, CRGB::Red);
+ * points.push(12, CRGB::Blue);
+ * ```
+ */
+template <int Capacity>
+class DriverPoints
+{
+public:
+  static constexpr int capacity = Capacity;
+
+  DriverPoints() : _count(0) {}
+
+  void clear() { _count = 0; }
+
+  /**
+   * @brief Append a point
+   * @return false (and nothing stored) when the list is full
+   */
+  bool push(uint16_t pos, const CRGB &color)
+  {
+    if (_count >= Capacity)
+      return false;
+    _pos[_count] = pos;
+    _color[_count] = color;
+    _count++;
+    return true;
+  }
+
+  int size() const { return _count; }
+  bool empty() const { return _count == 0; }
+  bool full() const { return _count >= Capacity; }
+
+  uint16_t position(int i) const { return _pos[i]; }
+  const CRGB &color(int i) const { return _color[i]; }
+  CRGB &color(int i) { return _color[i]; }
+
+private:
+  uint16_t _pos[Capacity];
+  CRGB _color[Capacity];
+  uint16_t _count;
+};
@@ -0,0 +1,187 @@
+#pragma once
+
+#include "config.h"
+#include "debounce.h"
+#include "edge_ring.h"
+#include "input_manager.h"
+
+#ifdef UNIT_TEST
+extern "C" unsigned long micros();
+#endif
+
+/**
+ * @brief Buttons read by pin-change interrupts instead of polling
+ *
+ * ButtonInputSource reads every pin once per loop pass, so its debounce
+ * runs on loop time: a pass held up by a 23 ms show() delays presses and
+ * stretches the interval, and a bounce between two reads is never seen.
+ * Here each button's interrupt pushes (pin, level, micros()) into an
+ * EdgeRing; update() drains it into an EdgeDebounce per button, so a press
+ * is judged, and timestamped, by when its edges happened. Nothing is read
+ * while the buttons are still: update() returns at once when the ring is
+ * empty and no button is settling.
+ *
+ * If the ring overflows (a very noisy line while the loop is stuck), every
+ * pin is read again and taken as an edge at that moment.
+ *
+ * Events carry the time of the press (on the clock passed to update()),
+ * not the time update() found it.
+ *
+ * @example
+ * ```cpp
+ * InterruptButtonInputSource buttons(buttonConfigs, 4);
+ * buttons.begin();
+ * inputManager.addInputSource(&buttons);
+ * ```
+ */
+class InterruptButtonInputSource : public IInputSource
+{
+public:
+  using ButtonConfig = ButtonInputSource::ButtonConfig;
+  static constexpr int MAX_BUTTONS = 8;
+  static constexpr int RING_SIZE = 64; // Edges held for the loop: a few bouncy presses
+
+  InterruptButtonInputSource(const ButtonConfig *buttons, int buttonCount)
+      : buttons_(buttons), buttonCount_(buttonCount < MAX_BUTTONS ? buttonCount : MAX_BUTTONS), eventQueueHead_(0),
+        eventQueueTail_(0), seenDropped_(0) {}
+
+  /**
+   * @brief Configure the pins, take their levels as stable and attach the interrupts
+   */
+  void begin()
+  {
+    for (int i = 0; i < buttonCount_; i++)
+    {
+      pinMode(buttons_[i].pin, INPUT_PULLUP);
+      debouncers_[i] = EdgeDebounce(buttons_[i].debounceMs * 1000UL, digitalRead(buttons_[i].pin));
+      lines_[i] = {this, (uint8_t)buttons_[i].pin};
+#ifndef UNIT_TEST
+      attachInterruptArg(digitalPinToInterrupt(buttons_[i].pin), onEdge, &lines_[i], CHANGE);
+#endif
+    }
+    seenDropped_ = edges_.dropped();
+  }
+
+  /**
+   * @brief The interrupt's work: queue an edge (public so tests can play interrupt)
+   */
+  IRAM_ATTR void recordEdge(uint8_t pin, int level, uint32_t atUs) { edges_.push({pin, (uint8_t)level, atUs}); }
+
+  /**
+   * @brief Edges dropped on a full ring so far
+   */
+  uint32_t droppedEdges() const { return edges_.dropped(); }
+
+  /**
+   * @brief true while edges are queued or a button is settling
+   */
+  bool busy() const
+  {
+    if (!edges_.empty())
+      return true;
+    for (int i = 0; i < buttonCount_; i++)
+      if (debouncers_[i].settling())
+        return true;
+    return false;
+  }
+
+  // ---- IInputSource ----
+
+  bool update(unsigned long currentTime) override
+  {
+    if (!busy() && edges_.dropped() == seenDropped_)
+      return false;
+
+    PinEdge edge;
+    while (edges_.pop(edge))
+    {
+      int i = indexOf(edge.pin);
+      if (i >= 0)
+        debouncers_[i].edge(edge.level, edge.atUs);
+    }
+
+    uint32_t nowUs = (uint32_t)micros();
+    uint32_t dropped = edges_.dropped();
+    if (dropped != seenDropped_)
+    {
+      // Edges were lost: the queue no longer tells the pin levels
+      seenDropped_ = dropped;
+      for (int i = 0; i < buttonCount_; i++)
+        debouncers_[i].edge(digitalRead(buttons_[i].pin), nowUs);
+    }
+
+    bool queued = false;
+    for (int i = 0; i < buttonCount_; i++)
+    {
+      if (!debouncers_[i].settle(nowUs))
+        continue;
+      const ButtonConfig &config = buttons_[i];
+      bool low = debouncers_[i].getState() == static_cast<int>(PortalConfig::PinState::Low);
+      bool pressed = low == config.activeLow;
+      unsigned long ageMs = (nowUs - debouncers_[i].changedAtUs()) / 1000UL;
+      queueEvent({config.inputId, pressed ? EventType::Pressed : EventType::Released, currentTime - ageMs,
+                  config.name});
+      queued = true;
+    }
+    return queued;
+  }
+
+  bool hasEvents() const override { return eventQueueHead_ != eventQueueTail_; }
+
+  InputEvent getNextEvent() override
+  {
+    if (!hasEvents())
+      return {0, EventType::Released, 0, "none"};
+    InputEvent event = eventQueue_[eventQueueHead_];
+    eventQueueHead_ = (eventQueueHead_ + 1) % MAX_EVENTS;
+    return event;
+  }
+
+  const char *getSourceName() const override { return "ButtonInterrupts"; }
+
+private:
+  static constexpr int MAX_EVENTS = 16;
+
+  // What an interrupt needs to know: whose ring, which pin
+  struct Line
+  {
+    InterruptButtonInputSource *owner;
+    uint8_t pin;
+  };
+
+  const ButtonConfig *buttons_;
+  int buttonCount_;
+  EdgeDebounce debouncers_[MAX_BUTTONS];
+  Line lines_[MAX_BUTTONS];
+  EdgeRing<RING_SIZE> edges_;
+  InputEvent eventQueue_[MAX_EVENTS];
+  int eventQueueHead_;
+  int eventQueueTail_;
+  uint32_t seenDropped_;
+
+#ifndef UNIT_TEST
+  static IRAM_ATTR void onEdge(void *arg)
+  {
+    Line *line = static_cast<Line *>(arg);
+    line->owner->recordEdge(line->pin, digitalRead(line->pin), (uint32_t)micros());
+  }
+#endif
+
+  int indexOf(uint8_t pin) const
+  {
+    for (int i = 0; i < buttonCount_; i++)
+      if (buttons_[i].pin == pin)
+        return i;
+    return -1;
+  }
+
+  void queueEvent(const InputEvent &event)
+  {
+    int nextTail = (eventQueueTail_ + 1) % MAX_EVENTS;
+    if (nextTail != eventQueueHead_)
+    {
+      eventQueue_[eventQueueTail_] = event;
+      eventQueueTail_ = nextTail;
+    }
+  }
+};
@@ -6,10 +6,17 @@
 #include "config.h"
 #include "startup_sequence.h"
 #include "input_manager.h"
+#include "interrupt_buttons.h"
 #include "status_led.h"
 #include "config_manager.h"
+#include "config_store.h"
+#include "preset_store.h"
+#include "frame_pacer.h"
 #if ENABLE_WIFI_CONTROL
 #include "wifi_input_source.h"
+#include "realtime_input.h"
+#include "show_sync.h"
+#include "cue_input.h"
 #endif
 
 // LED Strip Configuration - using config constants
@@ -18,16 +25,34 @@
 // Static driver and portal effect using template-based class
 static FastLEDDriver<PortalConfig::Hardware::NUM_LEDS> fastDriver(PortalConfig::Hardware::LED_PIN);
 static PortalEffectTemplate<PortalConfig::Hardware::NUM_LEDS, PortalConfig::Effects::GRADIENT_STEP_DEFAULT, PortalConfig::Effects::GRADIENT_MOVE_DEFAULT> portal(&fastDriver);
+// Frame pacing, seeded with the modelled transmit time until frames are measured
+static FramePacer framePacer(FramePacer::wireTimeUs(PortalConfig::Hardware::NUM_LEDS));
+// Settings saved in flash, restored at boot
+static LittleFSConfigStorage configStorage("/config.bin", "/config.tmp");
+static ConfigStore configStore(&configStorage);
+// Scene presets: settings plus the patterns on show
+static LittleFSPresetStorage presetStorage;
+static PresetStore presets(&presetStorage, &portal);
 // Application state
 bool portalRunning = false;
 
 // System components
 StartupSequence startupSequence;
 InputManager inputManager;
-ButtonInputSource buttonInput(nullptr, 0); // Will be initialized in setup()
 
 #if ENABLE_WIFI_CONTROL
 WiFiInputSource wifiInput(PortalConfig::WiFi::HTTP_PORT);
+// E1.31 / Art-Net frames for the realtime portal mode, received straight into the LED buffer
+static WiFiUdpReceiver sacnReceiver((PortalConfig::Hardware::NUM_LEDS + PortalConfig::Realtime::PIXELS_PER_UNIVERSE - 1) / PortalConfig::Realtime::PIXELS_PER_UNIVERSE);
+static WiFiUdpReceiver artnetReceiver;
+static RealtimeInputSource realtimeInput(&fastDriver, PortalConfig::Hardware::NUM_LEDS, &sacnReceiver, &artnetReceiver);
+// Show time shared with the other units of a set, so their rotation and patterns match
+static ShowClock showClock;
+static WiFiSyncLink syncLink;
+static ShowSync showSync(&syncLink, &showClock, (uint16_t)ESP.getChipId());
+// Show commands over UDP, timed from receipt to the first frame that shows them
+static WiFiCueLink cueLink;
+static CueInputSource cueInput(&cueLink);
 #endif
 
 // Button configuration
@@ -46,7 +71,14 @@ const ButtonInputSource::ButtonConfig buttonConfigs[] = {
      .inputId = static_cast<int>(InputManager::Command::FadeOut),
      .activeLow = true,
      .debounceMs = PortalConfig::Timing::DEBOUNCE_INTERVAL_MS,
-     .name = "Button3_FadeOut"}};
+     .name = "Button3_FadeOut"},
+    {.pin = PortalConfig::Hardware::BUTTON4_PIN,
+     .inputId = static_cast<int>(InputManager::Command::NextPreset),
+     .activeLow = true,
+     .debounceMs = PortalConfig::Timing::DEBOUNCE_INTERVAL_MS,
+     .name = "Button4_NextPreset"}};
+// Buttons are read by pin-change interrupts, debounced on the edges' own times
+InterruptButtonInputSource buttonInput(buttonConfigs, 4);
 
 // PortalEffect encapsulates malfunction and gradient logic now.
 
@@ -88,6 +120,19 @@ void handleInputCommand(InputManager::Command command, const char *source)
     portal.triggerFadeOut();
     break;
 
+  case InputManager::Command::NextPreset:
+  {
+    int slot = presets.recallNext();
+    if (slot < 0)
+      Serial.println("No presets stored");
+    else
+    {
+      Serial.print("Preset recalled: slot ");
+      Serial.println(slot);
+    }
+    break;
+  }
+
   default:
     Serial.print("Unknown command: ");
     Serial.println(static_cast<int>(command));
@@ -104,23 +149,39 @@ void setup()
   // Initialize status LED
   StatusLED::begin();
 
+  // Initialize configuration manager, then restore the saved settings so
+  // the patterns generated below already use them
+  ConfigManager::begin();
+  if (configStore.load())
+    Serial.println("Saved settings restored");
+
   // Initialize portal effect (which initializes LEDs)
   portal.begin();
 
   // Initialize startup sequence
   startupSequence.begin(&fastDriver);
 
-  // Initialize configuration manager
-  ConfigManager::begin();
-
   // Initialize input system
-  buttonInput = ButtonInputSource(buttonConfigs, 3);
+  buttonInput.begin();
   inputManager.addInputSource(&buttonInput);
 
 #if ENABLE_WIFI_CONTROL
   // Initialize WiFi input source (non-blocking)
   wifiInput.begin(PortalConfig::WiFi::DEFAULT_SSID, PortalConfig::WiFi::DEFAULT_PASSWORD);
   inputManager.addInputSource(&wifiInput);
+  wifiInput.setFramePacer(&framePacer);
+  wifiInput.setPresetStore(&presets);
+  realtimeInput.begin();
+  inputManager.addInputSource(&realtimeInput);
+  portal.setRealtimeFrames(&realtimeInput);
+  showClock.setLeader(PortalConfig::Sync::LEADER);
+  showSync.begin(ESP.random());
+  inputManager.addInputSource(&showSync);
+  portal.setShowClock(&showClock);
+  wifiInput.setShowClock(&showClock);
+  cueInput.begin();
+  inputManager.addInputSource(&cueInput);
+  wifiInput.setCueInput(&cueInput);
   Serial.println("WiFi input source initialized - attempting connection in background");
   Serial.println("WiFi commands available:");
   Serial.println("  http://[ip]/toggle - Toggle portal effect");
@@ -128,6 +189,9 @@ void setup()
   Serial.println("  http://[ip]/fadeout - Fade out effect");
   Serial.println("  http://[ip]/status - View status");
   Serial.println("  http://[ip]/config - View configuration");
+  Serial.println("  http://[ip]/presets - List presets");
+  Serial.println("  http://[ip]/cues - Cue latency (cues on UDP port 5572)");
+  Serial.println("  http://[ip]/set?mode=2 - Show E1.31 (port 5568) / Art-Net (port 6454) frames");
 #endif
 
   inputManager.setInputCallback(handleInputCommand);
@@ -137,6 +201,7 @@ void setup()
   Serial.println("  Button 1: Toggle portal effect");
   Serial.println("  Button 2: Trigger malfunction");
   Serial.println("  Button 3: Fade out");
+  Serial.println("  Button 4: Next preset");
   Serial.print("Total LEDs: ");
   Serial.println(PortalConfig::Hardware::NUM_LEDS);
   Serial.print("Circle radius: ");
@@ -166,8 +231,32 @@ void loop()
   }
 
   // Process all input sources (buttons, WiFi, etc.)
+  uint32_t transmits = fastDriver.transmits();
   inputManager.update(now);
+#if ENABLE_WIFI_CONTROL
+  // A cue is rendered at once rather than when the next frame falls due
+  bool cued = cueInput.takeFrameRequest();
+#else
+  bool cued = false;
+#endif
 
-  // Run effects
-  portal.update(now);
+  // Run effects when the pacer says a frame fits; the rest of the interval
+  // is left for input and HTTP handling
+  if (cued || framePacer.frameDue(micros()))
+  {
+    framePacer.beginFrame(micros());
+    portal.renderFrame(millis());
+    framePacer.endFrame(micros());
+  }
+  else
+  {
+    // Idle until the next frame: build pending patterns in the background
+    // and save settings that have settled
+    portal.serviceGeneration();
+    configStore.service(now);
+  }
+#if ENABLE_WIFI_CONTROL
+  if (fastDriver.transmits() != transmits)
+    cueInput.shown(micros());
+#endif
 }
@@ -1,9 +1,16 @@
 #pragma once
 
 #include "effects.h"
+#include "color_math.h"
+#include "motion.h"
+#include "driver_points.h"
+#include "ring_buffer.h"
 #include "led_driver.h"
 #include "config.h"
 #include "config_manager.h"
+#include "preset_store.h"
+#include "realtime_input.h"
+#include "show_clock.h"
 #ifndef UNIT_TEST
 #include <Arduino.h>
 #include <math.h>
@@ -54,15 +61,14 @@ static inline long arduino_random(long min, long max)
 
 // Template PortalEffect uses a driver and static buffers sized at compile time
 template <int N, int GRADIENT_STEP, int GRADIENT_MOVE>
-class PortalEffectTemplate
+class PortalEffectTemplate : public IPresetPatterns
 {
 public:
-  PortalEffectTemplate(ILEDDriver *driver) : _driver(driver)
+  PortalEffectTemplate(ILEDDriver *driver)
+      : _driver(driver), gradientMotion(N), gradientMotion1(N), gradientMotion2(N)
   {
     NUM_LEDS = N;
-    gradientPosition = 0;
-    gradientPos1 = 0;
-    gradientPos2 = 0;
+    lastMotion = 0;
     animationActive = false;
     fadeInActive = false;
     fadeInStart = 0;
@@ -72,27 +78,62 @@ public:
     lastUpdate = 0;
     numGradientPoints = 0;
     sequenceInitialized = false;
+    lastFrameValid = false;
+    job = GenerationJob::NONE;
+    recolorStart = 0;
+    classicFading = false;
+    virtualFading = false;
+    classicBackReady = false;
+    classicGenerated = false;
+    classicHeld = false;
+    classicFrontVersion = 0;
+    classicBackVersion = 0;
+    appliedColorVersion = 0;
+    sequenceColorVersion = 0;
+    _realtime = nullptr;
+    _showClock = nullptr;
+    showSeed = 0;
+    showSeedCount = 0;
   }
 
   void begin()
   {
     _driver->begin();
     _leds = _driver->getBuffer();
-    // effectLeds are static arrays
+    // Pre-generate both patterns so the first start() lights at once; the
+    // next classic pattern is then built in the background
+    const ConfigSnapshot config = ConfigManager::snapshot();
+    generatePortalEffect(effectLeds.front(), config);
+    classicGenerated = true;
+    classicFrontVersion = appliedColorVersion = config.colorVersion;
+    generateVirtualGradients(config);
   }
 
-  void setBrightness(uint8_t b) { _driver->setBrightness(b); }
+  void setBrightness(uint8_t b)
+  {
+    _driver->setBrightness(b);
+    invalidateFrame();
+  }
   void fillSolid(const CRGB &c)
   {
     _driver->fillSolid(c);
     _driver->show();
+    invalidateFrame();
   }
   void clear()
   {
     _driver->clear();
     _driver->show();
+    invalidateFrame();
   }
 
+  // Source of Realtime::PORTAL_MODE frames (see RealtimeInputSource)
+  void setRealtimeFrames(IRealtimeFrames *frames) { _realtime = frames; }
+
+  // Show time shared with other units (see ShowClock); while it is in sync,
+  // gradient rotation and pattern seeds follow it
+  void setShowClock(const ShowClock *clock) { _showClock = clock; }
+
   void start()
   {
     if (!animationActive)
@@ -100,8 +141,27 @@ public:
       animationActive = true;
       fadeInActive = true;
       fadeInStart = millis();
-      gradientPosition = 0;
-      generatePortalEffect(effectLeds);
+      gradientMotion.reset();
+      lastMotion = millis();
+      // Show the pattern prepared in the background (see serviceGeneration),
+      // else the current one; generate inline only if there is none yet.
+      // A pattern recalled from a preset is kept for the next start()
+      if (classicBackReady && !classicHeld)
+      {
+        effectLeds.swap();
+        classicFrontVersion = classicBackVersion;
+        classicBackReady = false;
+        classicFading = false; // The fade belonged to the pattern swapped out
+      }
+      else if (!classicGenerated)
+      {
+        const ConfigSnapshot config = ConfigManager::snapshot();
+        generatePortalEffect(effectLeds.front(), config);
+        classicFrontVersion = config.colorVersion;
+      }
+      classicGenerated = true;
+      classicHeld = false;
+      invalidateFrame();
     }
   }
 
@@ -110,6 +170,7 @@ public:
     animationActive = false;
     _driver->clear();
     _driver->show();
+    invalidateFrame();
   }
 
   void triggerFadeOut()
@@ -134,66 +195,205 @@ public:
   }
 
   void update(unsigned long now)
+  {
+    if (now - lastUpdate >= PortalConfig::Timing::UPDATE_INTERVAL_MS)
+      renderFrame(now);
+  }
+
+  // Render one frame without update()'s minimum-interval check, for callers
+  // that pace frames themselves (see FramePacer)
+  void renderFrame(unsigned long now)
   {
     if (fadeOutActive || malfunctionActive || animationActive)
     {
-      if (now - lastUpdate >= 10)
+      // Settings are read once per frame; everything below renders this copy
+      const FrameContext frame{now, ConfigManager::snapshot()};
+
+      // Colour changes fade in and new patterns are built in the background
+      serviceGeneration(frame.config);
+      advanceRecolor(now);
+
+      // Motion follows elapsed time, so dropped frames do not slow it down
+      unsigned long elapsed = motionStep(now);
+      int speed = frame.config.rotationSpeed;
+      if (frame.config.portalMode == 0)
       {
-        if (animationActive && ConfigManager::needsEffectRegeneration())
-        {
-          if (ConfigManager::getPortalMode() == 0)
-          {
-            generatePortalEffect(effectLeds);
-          }
-          else
-            generateVirtualGradients();
-          ConfigManager::clearEffectRegenerationFlag();
-        }
+        gradientMotion.advance(speed, elapsed, PortalConfig::Timing::MOTION_TICK_MS);
+        lockToShow(gradientMotion, speed, now);
+      }
+      else if (frame.config.portalMode == 1)
+      {
+        // Ensure balanced speeds for wave effect
+        gradientMotion1.advance(speed, elapsed, PortalConfig::Timing::MOTION_TICK_MS);
+        gradientMotion2.advance(-speed, elapsed, PortalConfig::Timing::MOTION_TICK_MS);
+        lockToShow(gradientMotion1, speed, now);
+        lockToShow(gradientMotion2, -speed, now);
+      }
 
-        int speed = ConfigManager::getRotationSpeed();
-        if (ConfigManager::getPortalMode() == 0)
-          gradientPosition = (gradientPosition + speed) % NUM_LEDS;
+      if (fadeOutActive || animationActive)
+      {
+        if (frame.config.portalMode == 0)
+          portalEffect(frame);
+        else if (frame.config.portalMode == PortalConfig::Realtime::PORTAL_MODE)
+          realtimeEffect(frame);
         else
-        {
-          // Move at half speed for virtual gradient effect
-          // Ensure balanced speeds for wave effect
-          gradientPos1 = (gradientPos1 + speed) % NUM_LEDS;
-          gradientPos2 = (gradientPos2 - speed + NUM_LEDS) % NUM_LEDS;
-        }
-
-        if (fadeOutActive || animationActive)
-        {
-          if (ConfigManager::getPortalMode() == 0)
-            portalEffect();
-          else
-            virtualGradientEffect();
-        }
-        else if (malfunctionActive)
-          portalMalfunctionEffect();
-        lastUpdate = now;
+          virtualGradientEffect(frame);
       }
+      else if (malfunctionActive)
+        portalMalfunctionEffect(frame, elapsed);
+      lastUpdate = now;
     }
   }
 
+  /**
+   * @brief Advance background pattern work by one step
+   *
+   * A hue or saturation change recolours the existing patterns, keeping
+   * their driver positions (see recolorPatterns). The next classic pattern
+   * for start() is built into a back ring GENERATION_POINTS_PER_STEP driver
+   * points at a time, so it is ready without stalling a frame.
+   * renderFrame() runs one step per frame; call this from idle time as well
+   * to finish sooner.
+   *
+   * @return true while work remains
+   */
+  bool serviceGeneration(int maxPoints = PortalConfig::Effects::GENERATION_POINTS_PER_STEP)
+  {
+    return serviceGeneration(ConfigManager::snapshot(), maxPoints);
+  }
+
+  // As above, against a snapshot the caller already holds
+  bool serviceGeneration(const ConfigSnapshot &config, int maxPoints = PortalConfig::Effects::GENERATION_POINTS_PER_STEP)
+  {
+    if (config.colorVersion != appliedColorVersion)
+    {
+      appliedColorVersion = config.colorVersion;
+      recolorPatterns(config);
+    }
+    if (job == GenerationJob::CLASSIC ? classicBackVersion != config.colorVersion : job == GenerationJob::NONE && !classicBackReady)
+      beginClassicJob(config);
+    return advanceJob(config, maxPoints);
+  }
+
+  // Presets (see preset_store.h): the classic pattern, then virtual
+  // sequences 1 and 2
+  int patternCount() const override { return 3; }
+
+  bool writePatterns(PresetWriter &writer) override
+  {
+    return writePattern(writer, classicGenerated, effectLeds.front()) &&
+           writePattern(writer, sequenceInitialized, sequence1.front()) &&
+           writePattern(writer, sequenceInitialized, sequence2.front());
+  }
+
+  /**
+   * @brief Show patterns read from a preset, in place of the current ones
+   *
+   * Each is read into its back ring and swapped in whole. They are marked
+   * as built for @p config, the settings recalled with them, so the
+   * recall neither recolours nor regenerates them.
+   */
+  bool recallPatterns(PresetReader &reader, const ConfigSnapshot &config) override
+  {
+    abandonJob();
+    classicBackReady = false; // The back ring is overwritten
+    int classic, virtual1, virtual2;
+    if (!readPattern(reader, effectLeds.back(), classic))
+      return false;
+    if (classic > 0)
+    {
+      effectLeds.swap();
+      classicGenerated = true;
+      classicHeld = true;
+      classicFrontVersion = config.colorVersion;
+      classicFading = false;
+    }
+    if (!readPattern(reader, sequence1.back(), virtual1) || !readPattern(reader, sequence2.back(), virtual2))
+      return false;
+    if (virtual1 > 0 && virtual2 > 0)
+    {
+      sequence1.swap();
+      sequence2.swap();
+      sequenceInitialized = true;
+      sequenceColorVersion = config.colorVersion;
+      virtualFading = false;
+    }
+    invalidateFrame();
+    return true;
+  }
+
 private:
   ILEDDriver *_driver;
   CRGB *_leds;
+  IRealtimeFrames *_realtime; // Frames for Realtime::PORTAL_MODE, written into the driver buffer
+  const ShowClock *_showClock;
+  uint32_t showSeed;      // Set's seed the current pattern seeds count up from
+  uint32_t showSeedCount; // Patterns seeded from it so far
+
+  // In sync, rotation follows show time so units side by side match
+  void lockToShow(RingMotion &motion, int speed, unsigned long now)
+  {
+    if (_showClock && _showClock->synced())
+      motion.lock(speed, _showClock->now(now), PortalConfig::Timing::MOTION_TICK_MS);
+  }
+
+  // In sync, patterns are seeded from the set's seed, counting up, so units
+  // with the same settings build the same patterns in turn. False if not
+  bool seedFromShow()
+  {
+    if (!_showClock || !_showClock->synced())
+      return false;
+    if (_showClock->seed() != showSeed)
+    {
+      showSeed = _showClock->seed();
+      showSeedCount = 0;
+    }
+    randomSeed(showSeed + showSeedCount++);
+    return true;
+  }
 #ifdef UNIT_TEST
 public:
-  CRGB *testGeneratePortalEffect(CRGB *effectLeds) { return generatePortalEffect(effectLeds); }
-  int testGetDriverIndex(int i) { return driverIndices[i]; }
-  void testGenerateVirtualGradients() { generateVirtualGradients(); }
-  CRGB *testGetSequence1() { return sequence1; }
-  CRGB *testGetSequence2() { return sequence2; }
+  CRGB *testGeneratePortalEffect(CRGB *effectLeds)
+  {
+    GradientRasterizer raster(effectLeds, N);
+    generatePortalEffect(raster, ConfigManager::snapshot());
+    return effectLeds;
+  }
+  void testGenerateVirtualGradients() { generateVirtualGradients(ConfigManager::snapshot()); }
+  CRGB *testGetSequence1()
+  {
+    static CRGB pixels[PortalConfig::Hardware::NUM_LEDS];
+    sequence1.front().render(pixels, PortalConfig::Hardware::NUM_LEDS, 0);
+    return pixels;
+  }
+  CRGB *testGetSequence2()
+  {
+    static CRGB pixels[PortalConfig::Hardware::NUM_LEDS];
+    sequence2.front().render(pixels, PortalConfig::Hardware::NUM_LEDS, 0);
+    return pixels;
+  }
   bool testIsSequenceInitialized() { return sequenceInitialized; }
+  CRGB *testGetEffectLeds(bool back = false)
+  {
+    static CRGB pixels[N];
+    (back ? effectLeds.back() : effectLeds.front()).render(pixels, N, 0);
+    return pixels;
+  }
+  bool testClassicBackReady() { return classicBackReady; }
+  const auto &testClassicPattern() { return effectLeds.front(); }
+  const auto &testSequencePattern(int which) { return which == 1 ? sequence1.front() : sequence2.front(); }
 #endif
-  CRGB effectLeds[N]; // Changed from static to instance storage
+  // Rotating patterns, stored per PortalConfig::Effects::RING_LAYOUT
+  template <int L>
+  using Ring = typename EffectRing<L, PortalConfig::Effects::RING_LAYOUT, PortalConfig::Effects::MAX_DRIVER_POINTS>::type;
+  DoubleRing<Ring<N>> effectLeds; // Front is drawn, back is built by serviceGeneration()
   int numGradientPoints;
 
   int NUM_LEDS;
-  int gradientPosition;
-  int gradientPos1;
-  int gradientPos2;
+  RingMotion gradientMotion;  // Classic gradient rotation
+  RingMotion gradientMotion1; // Virtual gradient sequence 1 (forward)
+  RingMotion gradientMotion2; // Virtual gradient sequence 2 (backward)
+  unsigned long lastMotion;   // Time of the previous motion step
   bool animationActive;
   bool fadeInActive;
   unsigned long fadeInStart;
@@ -202,146 +402,370 @@ public:
   bool malfunctionActive;
   unsigned long lastUpdate;
   // Virtual gradient sequences (instance storage)
-  CRGB sequence1[PortalConfig::Hardware::NUM_LEDS];
-  CRGB sequence2[PortalConfig::Hardware::NUM_LEDS];
+  DoubleRing<Ring<PortalConfig::Hardware::NUM_LEDS>> sequence1;
+  DoubleRing<Ring<PortalConfig::Hardware::NUM_LEDS>> sequence2;
   bool sequenceInitialized;
-  uint8_t lastHueMin; // Track hue values to detect changes
-  uint8_t lastHueMax;
-  uint8_t lastSatMin; // Track saturation values to detect changes
-  uint8_t lastSatMax;
+  uint32_t sequenceColorVersion; // ConfigSnapshot::colorVersion the sequences were built with
 
-  void generateVirtualGradients()
+  // Everything a frame's pixels depend on. When the key matches the frame
+  // already in the buffer, rendering is skipped; brightness lives in the
+  // output stage, so fades and flicker never re-render.
+  struct FrameKey
   {
-    // Generate and seed virtual gradient sequences used by virtualGradientEffect
-    uint8_t currentHueMin = ConfigManager::getHueMin();
-    uint8_t currentHueMax = ConfigManager::getHueMax();
-    uint8_t currentSatMin = ConfigManager::getSatMin();
-    uint8_t currentSatMax = ConfigManager::getSatMax();
+    uint8_t mode;
+    uint32_t posA;   // Q8 gradient offset
+    uint32_t posB;   // Second Q8 gradient offset
+    uint32_t params; // Packed mode-specific settings
 
-    // Check if hue or saturation values have changed since last generation
-    if (sequenceInitialized && currentHueMin == lastHueMin && currentHueMax == lastHueMax &&
-        currentSatMin == lastSatMin && currentSatMax == lastSatMax)
+    bool operator==(const FrameKey &o) const
     {
-      Serial.println("Virtual gradient: No changes detected, skipping regeneration");
-      return;
+      return mode == o.mode && posA == o.posA && posB == o.posB && params == o.params;
     }
+  };
+  FrameKey lastFrame;
+  bool lastFrameValid;
+
+  // True if @p key is already on the strip; otherwise records it as the new frame
+  bool frameUnchanged(const FrameKey &key)
+  {
+    if (lastFrameValid && key == lastFrame)
+      return true;
+    lastFrame = key;
+    lastFrameValid = true;
+    return false;
+  }
 
-    Serial.print("Virtual gradient: Regenerating sequences - ");
-    if (currentHueMin != lastHueMin || currentHueMax != lastHueMax)
-      Serial.print("hue changed ");
-    if (currentSatMin != lastSatMin || currentSatMax != lastSatMax)
-      Serial.print("saturation changed ");
-    Serial.println();
+  // Force the next frame to render, e.g. after the buffer was overwritten
+  void invalidateFrame() { lastFrameValid = false; }
 
-    // Update tracked values
-    lastHueMin = currentHueMin;
-    lastHueMax = currentHueMax;
-    lastSatMin = currentSatMin;
-    lastSatMax = currentSatMax;
+  // Background generation (see serviceGeneration): one pattern at a time is
+  // built into back rings, virtual sequence 1 then 2
+  enum class GenerationJob : uint8_t
+  {
+    NONE,
+    CLASSIC,
+    VIRTUAL_1,
+    VIRTUAL_2
+  };
+
+  // Driver positions at random spacing from 0 up to length - MIN_DRIVER_DISTANCE,
+  // resumable so a pattern can be built a few points at a time
+  struct DriverWalk
+  {
+    int idx;
+    int count;
+    int length;
+    int maxCount;
+    bool done;
+  };
+
+  GenerationJob job;
+  DriverWalk jobWalk;
+  bool classicBackReady; // effectLeds.back() holds a finished pattern
+  bool classicGenerated; // effectLeds.front() holds a pattern
+  bool classicHeld;      // effectLeds.front() was recalled from a preset
+  uint32_t classicFrontVersion; // ConfigSnapshot::colorVersion each classic pattern was built with
+  uint32_t classicBackVersion;
+  uint32_t appliedColorVersion; // Last colorVersion handed to recolorPatterns()
+
+  // Driver colour crossfades after a hue/saturation change (see recolorPatterns)
+  DriverCrossfade<PortalConfig::Effects::MAX_DRIVER_POINTS> classicFade;
+  DriverCrossfade<PortalConfig::Effects::MAX_DRIVER_POINTS> sequence1Fade;
+  DriverCrossfade<PortalConfig::Effects::MAX_DRIVER_POINTS> sequence2Fade;
+  unsigned long recolorStart;
+  bool classicFading;
+  bool virtualFading;
+
+  // Max brightness, fade and flicker combined into the single scale FastLED
+  // applies as pixels are clocked out, instead of a scaling pass per frame.
+  // show() still transmits when only this value changed.
+  void setOutputScale(uint8_t brightness, uint8_t scale)
+  {
+    _driver->setBrightness(ColorMath::scale8(brightness, scale));
+  }
+
+  // Real time since the previous frame, capped so a stall cannot make motion jump
+  unsigned long motionStep(unsigned long now)
+  {
+    unsigned long elapsed = now - lastMotion;
+    lastMotion = now;
+    return elapsed > PortalConfig::Timing::MOTION_MAX_STEP_MS ? PortalConfig::Timing::MOTION_MAX_STEP_MS : elapsed;
+  }
+
+  // Generate the virtual gradient sequences now rather than in the background
+  void generateVirtualGradients(const ConfigSnapshot &config)
+  {
+    if (beginVirtualJob(config))
+      while (advanceJob(config, PortalConfig::Hardware::NUM_LEDS))
+        ;
+  }
+
+  // Start building new virtual gradient sequences, unless hue and saturation
+  // are unchanged since the last ones
+  bool beginVirtualJob(const ConfigSnapshot &config)
+  {
+    if (sequenceInitialized && sequenceColorVersion == config.colorVersion)
+    {
+      Serial.println("Virtual gradient: No changes detected, skipping regeneration");
+      return false;
+    }
+
+    Serial.println("Virtual gradient: Regenerating sequences");
+    sequenceColorVersion = config.colorVersion;
 
     // Seed random once per regeneration cycle
-    randomSeed(millis());
+    if (!seedFromShow())
+      randomSeed(millis());
+
+    abandonJob();
+    job = GenerationJob::VIRTUAL_1;
+    beginVirtualSequence(sequence1.back());
+    return true;
+  }
+
+  // Build the next classic pattern into effectLeds.back()
+  void beginClassicJob(const ConfigSnapshot &config)
+  {
+    abandonJob();
+    job = GenerationJob::CLASSIC;
+    classicBackReady = false;
+    classicBackVersion = config.colorVersion;
+    seedFromShow();
+    beginWalk(jobWalk, NUM_LEDS, N - 1);
+    effectLeds.back().beginPoints();
+  }
+
+  // A virtual job cut short leaves its sequences to be generated on demand
+  void abandonJob()
+  {
+    if (job == GenerationJob::VIRTUAL_1 || job == GenerationJob::VIRTUAL_2)
+      sequenceInitialized = false;
+    job = GenerationJob::NONE;
+  }
+
+  // Add up to maxPoints driver points to the job's pattern; finished virtual
+  // sequences are swapped in. True while the job is unfinished
+  bool advanceJob(const ConfigSnapshot &config, int maxPoints)
+  {
+    switch (job)
+    {
+    case GenerationJob::CLASSIC:
+      if (!addPortalPoints(effectLeds.back(), jobWalk, maxPoints, config))
+        return true;
+      job = GenerationJob::NONE;
+      classicBackReady = true;
+      return false;
+    case GenerationJob::VIRTUAL_1:
+      if (!addVirtualPoints(sequence1.back(), jobWalk, maxPoints, config))
+        return true;
+      job = GenerationJob::VIRTUAL_2;
+      beginVirtualSequence(sequence2.back());
+      return true;
+    case GenerationJob::VIRTUAL_2:
+      if (!addVirtualPoints(sequence2.back(), jobWalk, maxPoints, config))
+        return true;
+      job = GenerationJob::NONE;
+      sequence1.swap();
+      sequence2.swap();
+      sequenceInitialized = true;
+      invalidateFrame();
+      return false;
+    default:
+      return false;
+    }
+  }
+
+  // New hue/saturation: patterns keep their driver positions, and the shown
+  // ones fade their driver colours to new ones over RECOLOR_FADE_MS
+  void recolorPatterns(const ConfigSnapshot &config)
+  {
+    recolorStart = millis();
+    if (classicGenerated && classicFrontVersion != config.colorVersion)
+    {
+      classicFade.begin(effectLeds.front(), [this, &config](int)
+                        { return getRandomDriverColorInternal(config); });
+      classicFrontVersion = config.colorVersion;
+      classicFading = true;
+    }
+    if (classicBackReady && classicBackVersion != config.colorVersion)
+    {
+      // Not shown yet, so recoloured at once
+      Ring<N> &back = effectLeds.back();
+      for (int i = 0; i < back.pointCount(); i++)
+        back.setPointColor(i, getRandomDriverColorInternal(config));
+      back.commitColors();
+      classicBackVersion = config.colorVersion;
+    }
+    if (sequenceInitialized && sequenceColorVersion != config.colorVersion)
+    {
+      sequence1Fade.begin(sequence1.front(), [this, &config](int driverIndex)
+                          { return virtualDriverColor(config, driverIndex); });
+      sequence2Fade.begin(sequence2.front(), [this, &config](int driverIndex)
+                          { return virtualDriverColor(config, driverIndex); });
+      sequenceColorVersion = config.colorVersion;
+      virtualFading = true;
+    }
+  }
+
+  // Step the crossfades started by recolorPatterns()
+  void advanceRecolor(unsigned long now)
+  {
+    if (!classicFading && !virtualFading)
+      return;
+    uint8_t progress = ColorMath::fadeInScale(now - recolorStart, PortalConfig::Timing::RECOLOR_FADE_MS);
+    if (classicFading)
+      classicFade.apply(effectLeds.front(), progress);
+    if (virtualFading)
+    {
+      sequence1Fade.apply(sequence1.front(), progress);
+      sequence2Fade.apply(sequence2.front(), progress);
+    }
+    if (progress == 255)
+      classicFading = virtualFading = false;
+    invalidateFrame();
+  }
+
+  template <typename Ring>
+  static bool writePattern(PresetWriter &writer, bool generated, const Ring &ring)
+  {
+    int count = generated ? ring.pointCount() : 0;
+    if (!writer.beginPattern(count))
+      return false;
+    for (int i = 0; i < count; i++)
+      if (!writer.point(ring.pointPosition(i), ring.pointColor(i)))
+        return false;
+    return true;
+  }
 
-    // Generate sequence 1 using driver-based approach
-    generateVirtualSequence(sequence1, currentHueMin);
+  // Read one preset pattern into @p ring; count is 0 if the preset has none.
+  // False if the points do not start at 0 or the ring refuses one
+  template <typename Ring>
+  static bool readPattern(PresetReader &reader, Ring &ring, int &count)
+  {
+    count = reader.beginPattern();
+    if (count <= 0)
+      return count == 0;
+    ring.beginPoints();
+    for (int i = 0; i < count; i++)
+    {
+      uint16_t pos;
+      CRGB color;
+      if (!reader.point(pos, color) || (i == 0 && pos != 0) || !ring.addPoint(pos, color))
+        return false;
+    }
+    ring.closePoints();
+    return true;
+  }
 
-    // Generate sequence 2 using driver-based approach with different hue
-    generateVirtualSequence(sequence2, currentHueMax);
+  static void beginWalk(DriverWalk &walk, int length, int maxCount)
+  {
+    walk = {0, 0, length, maxCount, false};
+  }
 
-    sequenceInitialized = true;
+  // Position for the next driver, or -1 once the walk has ended
+  static int walkPosition(const DriverWalk &walk)
+  {
+    if (walk.done || walk.idx >= walk.length - PortalConfig::Effects::MIN_DRIVER_DISTANCE || walk.count >= walk.maxCount)
+      return -1;
+    return walk.idx;
   }
 
-  void generateVirtualSequence(CRGB *sequence, uint8_t hue)
+  // Step past the driver just placed
+  static void walkAdvance(DriverWalk &walk)
   {
     const int minDist = PortalConfig::Effects::MIN_DRIVER_DISTANCE;
     const int maxDist = PortalConfig::Effects::MAX_DRIVER_DISTANCE;
+    walk.count++;
+    int step = minDist + random(maxDist - minDist + 1);
+    if (walk.idx + step > walk.length - minDist)
+      walk.done = true;
+    else
+      walk.idx += step;
+  }
 
-    // Create driver positions at random distances
-    int driverIndices[PortalConfig::Hardware::NUM_LEDS / minDist + 2]; // Conservative size
-    CRGB driverColors[PortalConfig::Hardware::NUM_LEDS / minDist + 2];
-    int numDrivers = 0;
-    int idx = 0;
+  // Add up to maxPoints drivers from walk, coloured by color(driverIndex),
+  // and close the ring when the walk ends; true once closed
+  template <typename Sink, typename ColorFn>
+  static bool addWalkPoints(Sink &sink, DriverWalk &walk, int maxPoints, ColorFn color)
+  {
+    for (int i = 0; i < maxPoints; i++)
+    {
+      int pos = walkPosition(walk);
+      if (pos < 0)
+      {
+        sink.closePoints();
+        return true;
+      }
+      sink.addPoint(pos, color(walk.count));
+      walkAdvance(walk);
+    }
+    return false;
+  }
+
+  template <typename Sink>
+  void beginVirtualSequence(Sink &sequence)
+  {
+    beginWalk(jobWalk, PortalConfig::Hardware::NUM_LEDS, PortalConfig::Hardware::NUM_LEDS / PortalConfig::Effects::MIN_DRIVER_DISTANCE);
+    sequence.beginPoints();
+  }
 
-    while (idx < PortalConfig::Hardware::NUM_LEDS - minDist && numDrivers < PortalConfig::Hardware::NUM_LEDS / minDist)
+  // Virtual sequence drivers: every 3rd one coloured, the rest black
+  template <typename Sink>
+  bool addVirtualPoints(Sink &sequence, DriverWalk &walk, int maxPoints, const ConfigSnapshot &config)
+  {
+    return addWalkPoints(sequence, walk, maxPoints, [this, &config](int driverIndex)
+                         { return virtualDriverColor(config, driverIndex); });
+  }
+
+  CRGB virtualDriverColor(const ConfigSnapshot &config, int driverIndex)
+  {
+    CRGB driverColor;
+    // Only every 3rd driver gets color, others are black
+    if (driverIndex % 3 == 0)
     {
-      driverIndices[numDrivers] = idx;
+      // Randomly select hue from min to max range for more dynamic effect
+      uint8_t hueMin = config.hueMin;
+      uint8_t hueMax = config.hueMax;
+      uint8_t randomHue;
 
-      // Only every 3rd driver gets color, others are black
-      if (numDrivers % 3 == 0)
+      if (hueMin <= hueMax)
       {
-        // Randomly select hue from min to max range for more dynamic effect
-        uint8_t hueMin = ConfigManager::getHueMin();
-        uint8_t hueMax = ConfigManager::getHueMax();
-        uint8_t randomHue;
-
-        if (hueMin <= hueMax)
+        randomHue = hueMin + random(hueMax - hueMin + 1);
+      }
+      else
+      {
+        // Handle wrap-around (e.g., min=250, max=10)
+        uint8_t range1 = 256 - hueMin;
+        uint8_t range2 = hueMax + 1;
+        if (random(range1 + range2) < range1)
         {
-          randomHue = hueMin + random(hueMax - hueMin + 1);
+          randomHue = hueMin + random(range1);
         }
         else
         {
-          // Handle wrap-around (e.g., min=250, max=10)
-          uint8_t range1 = 256 - hueMin;
-          uint8_t range2 = hueMax + 1;
-          if (random(range1 + range2) < range1)
-          {
-            randomHue = hueMin + random(range1);
-          }
-          else
-          {
-            randomHue = random(range2);
-          }
+          randomHue = random(range2);
         }
-
-        uint8_t satMin = ConfigManager::getSatMin();
-        uint8_t satMax = ConfigManager::getSatMax();
-        uint8_t satRange = satMax - satMin;
-        uint8_t sat = satMin + random(satRange + 1);
-        uint8_t val = PortalConfig::Effects::PORTAL_VAL_BASE + random(PortalConfig::Effects::PORTAL_VAL_RANGE);
-        driverColors[numDrivers] = CHSV(randomHue, sat, val);
-      }
-      else
-      {
-        driverColors[numDrivers] = CRGB(0, 0, 0); // Black for breaks
       }
 
-      numDrivers++;
-      int step = minDist + random(maxDist - minDist + 1);
-      if (idx + step > PortalConfig::Hardware::NUM_LEDS - minDist)
-        break;
-      idx += step;
+      uint8_t satMin = config.satMin;
+      uint8_t satMax = config.satMax;
+      uint8_t satRange = satMax - satMin;
+      uint8_t sat = satMin + random(satRange + 1);
+      uint8_t val = PortalConfig::Effects::PORTAL_VAL_BASE + random(PortalConfig::Effects::PORTAL_VAL_RANGE);
+      driverColor = CHSV(randomHue, sat, val);
     }
-
-    // Close the loop
-    driverIndices[numDrivers] = PortalConfig::Hardware::NUM_LEDS;
-    driverColors[numDrivers] = driverColors[0];
-    numDrivers++;
-
-    // Calculate gradients between drivers
-    for (int d = 0; d < numDrivers - 1; d++)
+    else
     {
-      int start = driverIndices[d];
-      int end = driverIndices[d + 1];
-      CRGB c1 = driverColors[d];
-      CRGB c2 = driverColors[d + 1];
-      int segLen = end - start;
-
-      for (int i = 0; i < segLen; i++)
-      {
-        float ratio = (segLen == 1) ? 0.0f : (float)i / (segLen - 1);
-        CRGB col = interpolateColor(c1, c2, ratio);
-        int pos = start + i;
-        if (pos >= 0 && pos < PortalConfig::Hardware::NUM_LEDS)
-          sequence[pos] = col;
-      }
+      driverColor = CRGB(0, 0, 0); // Black for breaks
     }
+    return driverColor;
   }
 
-  CRGB getRandomDriverColorInternal()
+  CRGB getRandomDriverColorInternal(const ConfigSnapshot &config)
   {
     // Handle hue range with wrap-around (e.g., min=250, max=10 for crossing 0/255)
-    uint8_t hueMin = ConfigManager::getHueMin();
-    uint8_t hueMax = ConfigManager::getHueMax();
+    uint8_t hueMin = config.hueMin;
+    uint8_t hueMax = config.hueMax;
     uint8_t length;
     if (hueMin <= hueMax)
     {
@@ -354,8 +778,8 @@ public:
     uint8_t offset = random(length);
     uint8_t hue = (hueMin + offset) % 256;
 
-    uint8_t satMin = ConfigManager::getSatMin();
-    uint8_t satMax = ConfigManager::getSatMax();
+    uint8_t satMin = config.satMin;
+    uint8_t satMax = config.satMax;
     uint8_t satRange = satMax - satMin;
     uint8_t sat = satMin + random(satRange + 1);
     if (random(10) == 0)    // 1 in 10 chance for low saturation
@@ -364,25 +788,30 @@ public:
     return CHSV(hue, sat, val);
   }
 
-  CRGB *generateDriverColors(CRGB *driverColors, int &numDrivers, bool useBlackDrivers = false, uint8_t hue = 0)
+  // Random driver colours at random distances; @p points receives their
+  // positions, ending with a closing point at NUM_LEDS
+  CRGB *generateDriverColors(CRGB *driverColors, DriverPoints<PortalConfig::Effects::MAX_DRIVER_POINTS> &points, int &numDrivers,
+                             bool useBlackDrivers = false, uint8_t hue = 0)
   {
     const int minDist = PortalConfig::Effects::MIN_DRIVER_DISTANCE;
     const int maxDist = PortalConfig::Effects::MAX_DRIVER_DISTANCE;
-    static int driverIndices[N];
+    const ConfigSnapshot config = ConfigManager::snapshot();
     numDrivers = 0;
     int idx = 0;
-    while (idx < NUM_LEDS - minDist && numDrivers < N - 1)
+    points.clear();
+    // Last slot is kept for the closing point
+    while (idx < NUM_LEDS - minDist && numDrivers < points.capacity - 1)
     {
-      driverIndices[numDrivers] = idx;
-      driverColors[numDrivers] = getRandomDriverColorInternal();
+      driverColors[numDrivers] = getRandomDriverColorInternal(config);
+      points.push((uint16_t)idx, driverColors[numDrivers]);
       numDrivers++;
       int step = minDist + random(maxDist - minDist + 1);
       if (idx + step > NUM_LEDS - minDist)
         break;
       idx += step;
     }
-    driverIndices[numDrivers] = NUM_LEDS;
     driverColors[numDrivers] = driverColors[0];
+    points.push((uint16_t)NUM_LEDS, driverColors[numDrivers]);
     numDrivers++;
 
     if (useBlackDrivers)
@@ -396,9 +825,10 @@ public:
         else
         {
           driverColors[i] = CHSV(hue,
-                                 ConfigManager::getSatMin() + random(ConfigManager::getSatMax() - ConfigManager::getSatMin() + 1),
+                                 config.satMin + random(config.satMax - config.satMin + 1),
                                  PortalConfig::Effects::PORTAL_VAL_BASE + random(PortalConfig::Effects::PORTAL_VAL_RANGE));
         }
+        points.color(i) = driverColors[i];
       }
     }
 
@@ -407,57 +837,32 @@ public:
 
   typedef CRGB (*DriverColorGenerator)(int driverIndex);
 
-  void generatePortalEffect(CRGB *effectLeds, DriverColorGenerator colorGen = nullptr)
+  // Stream driver points at random distances into a ring (see ring_buffer.h)
+  template <typename Sink>
+  void generatePortalEffect(Sink &effectLeds, const ConfigSnapshot &config, DriverColorGenerator colorGen = nullptr)
   {
-    const int minDist = PortalConfig::Effects::MIN_DRIVER_DISTANCE;
-    const int maxDist = PortalConfig::Effects::MAX_DRIVER_DISTANCE;
-    int driverIndices[N];
-    CRGB driverColors[N];
-    int numDrivers = 0;
-    int idx = 0;
-
-    while (idx < NUM_LEDS - minDist && numDrivers < N - 1)
-    {
-      driverIndices[numDrivers] = idx;
-      if (colorGen)
-        driverColors[numDrivers] = colorGen(numDrivers);
-      else
-        driverColors[numDrivers] = getRandomDriverColorInternal();
-      numDrivers++;
-      int step = minDist + random(maxDist - minDist + 1);
-      if (idx + step > NUM_LEDS - minDist)
-        break;
-      idx += step;
-    }
-    driverIndices[numDrivers] = NUM_LEDS;
-    driverColors[numDrivers] = driverColors[0];
-    numDrivers++;
+    DriverWalk walk;
+    beginWalk(walk, NUM_LEDS, N - 1);
+    effectLeds.beginPoints();
+    while (!addPortalPoints(effectLeds, walk, NUM_LEDS, config, colorGen))
+      ;
+    invalidateFrame();
+  }
 
-    for (int d = 0; d < numDrivers - 1; d++)
-    {
-      int start = driverIndices[d];
-      int end = driverIndices[d + 1];
-      CRGB c1 = driverColors[d];
-      CRGB c2 = driverColors[d + 1];
-      int segLen = end - start;
-      for (int i = 0; i < segLen; i++)
-      {
-        float ratio = (segLen == 1) ? 0.0f : (float)i / (segLen - 1);
-        CRGB col = interpolateColor(c1, c2, ratio);
-        int pos = start + i;
-        if (pos >= 0 && pos < NUM_LEDS)
-          effectLeds[pos] = col;
-      }
-    }
+  template <typename Sink>
+  bool addPortalPoints(Sink &effectLeds, DriverWalk &walk, int maxPoints, const ConfigSnapshot &config, DriverColorGenerator colorGen = nullptr)
+  {
+    return addWalkPoints(effectLeds, walk, maxPoints, [this, &config, colorGen](int driverIndex)
+                         { return colorGen ? colorGen(driverIndex) : getRandomDriverColorInternal(config); });
   }
 
   // Helper function for virtual gradient sequences with black drivers
-  CRGB virtualGradientColorGen(int driverIndex, uint8_t hue)
+  CRGB virtualGradientColorGen(const ConfigSnapshot &config, int driverIndex, uint8_t hue)
   {
     if (driverIndex % 3 == 0) // 1 color, 2 black pattern
     {
-      uint8_t satMin = ConfigManager::getSatMin();
-      uint8_t satMax = ConfigManager::getSatMax();
+      uint8_t satMin = config.satMin;
+      uint8_t satMax = config.satMax;
       uint8_t sat = satMin + random(satMax - satMin + 1);
       uint8_t val = PortalConfig::Effects::PORTAL_VAL_BASE + random(PortalConfig::Effects::PORTAL_VAL_RANGE);
       return CHSV(hue, sat, val);
@@ -468,75 +873,92 @@ public:
     }
   }
 
-  void portalEffect()
+  void portalEffect(const FrameContext &frame)
   {
-    float fadeScale = 1.0f;
+    uint8_t fadeScale = 255;
     if (fadeInActive)
     {
-      unsigned long now = millis();
-      float t = (now - fadeInStart) / (float)PortalConfig::Timing::FADE_IN_DURATION_MS;
-      fadeScale = constrain(t, 0.0f, 1.0f);
-      if (fadeScale >= 1.0f)
-      {
-        fadeInActive = false;
-        fadeScale = 1.0f;
-      }
+      fadeScale = calculateFade(true, fadeInStart, PortalConfig::Timing::FADE_IN_DURATION_MS);
     }
     else if (fadeOutActive)
     {
-      unsigned long now = millis();
-      float t = (now - fadeOutStart) / (float)PortalConfig::Timing::FADE_OUT_DURATION_MS;
-      fadeScale = 1.0f - constrain(t, 0.0f, 1.0f);
-      if (fadeScale <= 0.0f)
-      {
-        fadeOutActive = false;
-        fadeScale = 0.0f;
-        animationActive = false;
-        _driver->clear();
-        _driver->show();
-        return;
-      }
+      fadeScale = calculateFade(false, fadeOutStart, PortalConfig::Timing::FADE_OUT_DURATION_MS);
+      if (fadeScale == 0)
+        return; // Early exit on fade out completion
+    }
+    if (!frameUnchanged({0, gradientMotion.positionQ8(), 0, 0}))
+      effectLeds.front().blit(*_driver, gradientMotion.positionQ8());
+    setOutputScale(frame.config.maxBrightness, fadeScale);
+    _driver->show(); // No-op for a static scene at constant brightness
+  }
+
+  // Latest frame received over E1.31 / Art-Net
+  void realtimeEffect(const FrameContext &frame)
+  {
+    uint8_t fadeScale = 255;
+    if (fadeInActive)
+    {
+      fadeScale = calculateFade(true, fadeInStart, PortalConfig::Timing::FADE_IN_DURATION_MS);
     }
-    for (int i = 0; i < NUM_LEDS; i++)
+    else if (fadeOutActive)
     {
-      _driver->setPixel(i, effectLeds[(i + gradientPosition) % NUM_LEDS]);
-      if (fadeScale < 1.0f)
-        _driver->getBuffer()[i].nscale8((uint8_t)(fadeScale * 255));
+      fadeScale = calculateFade(false, fadeOutStart, PortalConfig::Timing::FADE_OUT_DURATION_MS);
+      if (fadeScale == 0)
+        return;
     }
-    _driver->setBrightness(ConfigManager::getMaxBrightness());
-    _driver->show();
+
+    // The pixels are already in the buffer; they are transmitted once a
+    // frame is whole, and the last frame holds while none is arriving
+    bool newFrame = _realtime && _realtime->takeFrame();
+    invalidateFrame(); // The buffer is not ours: other modes must redraw
+    setOutputScale(frame.config.maxBrightness, fadeScale);
+    if (newFrame || !(_realtime && _realtime->midFrame()))
+      _driver->show();
   }
 
-  void portalMalfunctionEffect()
+  void portalMalfunctionEffect(const FrameContext &frame, unsigned long elapsed)
   {
-    unsigned long now = millis();
+    using ColorMath::toQ8_8;
+    // Brightness envelope in Q8.8 (256 == nominal brightness)
+    constexpr int32_t targetMin = toQ8_8(PortalConfig::Effects::MALFUNCTION_BRIGHTNESS_MIN);
+    constexpr int32_t targetRange = toQ8_8(PortalConfig::Effects::MALFUNCTION_BRIGHTNESS_RANGE);
+    constexpr int32_t smoothingMin = toQ8_8(PortalConfig::Effects::MALFUNCTION_BRIGHTNESS_SMOOTHING_MIN);
+    constexpr int32_t smoothingRange = toQ8_8(PortalConfig::Effects::MALFUNCTION_BRIGHTNESS_SMOOTHING_RANGE);
+    constexpr int32_t clampMin = toQ8_8(PortalConfig::Effects::MALFUNCTION_BRIGHTNESS_CLAMP_MIN);
+    constexpr int32_t clampMax = toQ8_8(PortalConfig::Effects::MALFUNCTION_BRIGHTNESS_CLAMP_MAX);
+
+    unsigned long now = frame.now;
     static unsigned long lastJump = 0;
-    static float targetBrightness = 1.0f;
-    static float currentBrightness = 1.0f;
+    static int32_t targetBrightness = ColorMath::Q8_8_ONE;
+    static int32_t currentBrightness = ColorMath::Q8_8_ONE;
     static int jumpInterval = 100;
-    gradientPosition = (gradientPosition + GRADIENT_MOVE) % NUM_LEDS;
+    gradientMotion.advance(GRADIENT_MOVE, elapsed, PortalConfig::Timing::MOTION_TICK_MS);
 
     if (now - lastJump > (unsigned long)jumpInterval)
     {
-      targetBrightness = PortalConfig::Effects::MALFUNCTION_BRIGHTNESS_MIN +
-                         PortalConfig::Effects::MALFUNCTION_BRIGHTNESS_RANGE * (random(1000) / 1000.0f);
+      targetBrightness = targetMin + targetRange * random(1000) / 1000;
       jumpInterval = PortalConfig::Timing::MALFUNCTION_MIN_JUMP_MS +
                      random(PortalConfig::Timing::MALFUNCTION_MAX_JUMP_MS - PortalConfig::Timing::MALFUNCTION_MIN_JUMP_MS);
       lastJump = now;
     }
-    float delta = targetBrightness - currentBrightness;
-    currentBrightness += delta * (PortalConfig::Effects::MALFUNCTION_BRIGHTNESS_SMOOTHING_MIN +
-                                  PortalConfig::Effects::MALFUNCTION_BRIGHTNESS_SMOOTHING_RANGE * (random(1000) / 1000.0f));
-    currentBrightness += (random(-PortalConfig::Effects::MALFUNCTION_NOISE_OFFSET, PortalConfig::Effects::MALFUNCTION_NOISE_OFFSET + 1)) / 255.0f;
-    currentBrightness = constrain(currentBrightness,
-                                  PortalConfig::Effects::MALFUNCTION_BRIGHTNESS_CLAMP_MIN,
-                                  PortalConfig::Effects::MALFUNCTION_BRIGHTNESS_CLAMP_MAX);
-
-    for (int i = 0; i < NUM_LEDS; i++)
-    {
-      _driver->setPixel(i, effectLeds[(i + gradientPosition) % NUM_LEDS]);
-      _driver->getBuffer()[i].nscale8((uint8_t)(currentBrightness * PortalConfig::Effects::MALFUNCTION_BASE_BRIGHTNESS + PortalConfig::Effects::MALFUNCTION_BRIGHTNESS_OFFSET));
-    }
+    // Smoothing and noise are per motion tick, scaled by the time this frame covers
+    const int32_t tickMs = (int32_t)PortalConfig::Timing::MOTION_TICK_MS;
+    int32_t delta = targetBrightness - currentBrightness;
+    int32_t smoothing = (smoothingMin + smoothingRange * random(1000) / 1000) * (int32_t)elapsed / tickMs;
+    if (smoothing > ColorMath::Q8_8_ONE)
+      smoothing = ColorMath::Q8_8_ONE; // Never past the target
+    currentBrightness += delta * smoothing / ColorMath::Q8_8_ONE;
+    int32_t noise = random(-PortalConfig::Effects::MALFUNCTION_NOISE_OFFSET, PortalConfig::Effects::MALFUNCTION_NOISE_OFFSET + 1) * ColorMath::Q8_8_ONE / 255;
+    currentBrightness += noise * (int32_t)elapsed / tickMs;
+    currentBrightness = currentBrightness < clampMin ? clampMin : (currentBrightness > clampMax ? clampMax : currentBrightness);
+
+    // Map the envelope onto an 8-bit scale; overshoot above nominal saturates
+    uint8_t scale = ColorMath::saturate8(currentBrightness * PortalConfig::Effects::MALFUNCTION_BASE_BRIGHTNESS / ColorMath::Q8_8_ONE +
+                                         PortalConfig::Effects::MALFUNCTION_BRIGHTNESS_OFFSET);
+
+    if (!frameUnchanged({0, gradientMotion.positionQ8(), 0, 0}))
+      effectLeds.front().blit(*_driver, gradientMotion.positionQ8());
+    setOutputScale(frame.config.maxBrightness, scale);
     _driver->show();
   }
 
@@ -564,67 +986,44 @@ public:
         dist = PortalConfig::Hardware::NUM_LEDS - dist;
       }
 
-      float ratio = (float)((ledIndex - pos + PortalConfig::Hardware::NUM_LEDS) % PortalConfig::Hardware::NUM_LEDS) / dist;
-      bright = (uint8_t)(sequence[pos].b * (1.0f - ratio) + sequence[nextDriver].b * ratio);
+      int offset = (ledIndex - pos + PortalConfig::Hardware::NUM_LEDS) % PortalConfig::Hardware::NUM_LEDS;
+      bright = (uint8_t)((sequence[pos].b * (dist - offset) + sequence[nextDriver].b * offset) / dist);
     }
 
     return bright;
   }
 
-  // Blend two colors additively, combining both sequences for brighter, more vibrant effect
-  CRGB blendByBrightness(CRGB color1, CRGB color2, uint8_t bright1, uint8_t bright2)
+  // Unified fade calculation for both fade in and fade out, as a 0-255 scale
+  uint8_t calculateFade(bool isFadeIn, unsigned long startTime, unsigned long duration)
   {
-    // Additive blending: add RGB components together with clamping
-    uint8_t r = min(255, (uint16_t)color1.r + (uint16_t)color2.r);
-    uint8_t g = min(255, (uint16_t)color1.g + (uint16_t)color2.g);
-    uint8_t b = min(255, (uint16_t)color1.b + (uint16_t)color2.b);
-    return CRGB(r, g, b);
-  }
-
-  // Unified fade calculation for both fade in and fade out
-  float calculateFade(bool isFadeIn, unsigned long startTime, float duration)
-  {
-    unsigned long now = millis();
-    float t = (now - startTime) / duration;
-    float fadeScale = constrain(t, 0.0f, 1.0f);
+    unsigned long elapsed = millis() - startTime;
 
     if (isFadeIn)
     {
-      if (fadeScale >= 1.0f)
-      {
+      uint8_t fadeScale = ColorMath::fadeInScale(elapsed, duration);
+      if (fadeScale == 255)
         fadeInActive = false;
-        return 1.0f;
-      }
       return fadeScale;
     }
     else // fade out
     {
-      fadeScale = 1.0f - fadeScale;
-      if (fadeScale <= 0.0f)
+      uint8_t fadeScale = ColorMath::fadeOutScale(elapsed, duration);
+      if (fadeScale == 0)
       {
         fadeOutActive = false;
         animationActive = false;
         _driver->clear();
         _driver->show();
-        return 0.0f;
+        invalidateFrame();
       }
       return fadeScale;
     }
   }
 
-  // Apply fade scaling to a color
-  void applyFade(CRGB &color, float fadeScale)
-  {
-    if (fadeScale < 1.0f)
-    {
-      color.nscale8((uint8_t)(fadeScale * 255));
-    }
-  }
-
-  void virtualGradientEffect()
+  void virtualGradientEffect(const FrameContext &frame)
   {
     // Handle fade transitions with unified function
-    float fadeScale = 1.0f;
+    uint8_t fadeScale = 255;
     if (fadeInActive)
     {
       fadeScale = calculateFade(true, fadeInStart, PortalConfig::Timing::FADE_IN_DURATION_MS);
@@ -632,37 +1031,26 @@ public:
     else if (fadeOutActive)
     {
       fadeScale = calculateFade(false, fadeOutStart, PortalConfig::Timing::FADE_OUT_DURATION_MS);
-      if (fadeScale == 0.0f)
+      if (fadeScale == 0)
         return; // Early exit on fade out completion
     }
 
     // Ensure virtual sequences are generated
     if (!sequenceInitialized)
-      generateVirtualGradients();
+      generateVirtualGradients(frame.config);
 
-    // Process each LED using functional composition
-    for (int i = 0; i < PortalConfig::Hardware::NUM_LEDS; i++)
+    if (!frameUnchanged({1, gradientMotion1.positionQ8(), gradientMotion2.positionQ8(), 0}))
     {
-      // Get the actual LED values from both sequences
-      int pos1 = (i + gradientPos1) % PortalConfig::Hardware::NUM_LEDS;
-      int pos2 = (i + gradientPos2 + PortalConfig::Hardware::NUM_LEDS) % PortalConfig::Hardware::NUM_LEDS;
-
-      CRGB led1 = sequence1[pos1];
-      CRGB led2 = sequence2[pos2];
-
-      // Blend the actual LED values additively
-      CRGB blended = blendByBrightness(led1, led2, 0, 0); // brightness params not needed for additive blending
-
-      // Apply fade scaling
-      applyFade(blended, fadeScale);
-
-      _driver->setPixel(i, blended);
+      // Blend both rotated sequences additively straight into the driver buffer
+      sequence1.front().blit(*_driver, gradientMotion1.positionQ8());
+      sequence2.front().add(*_driver, gradientMotion2.positionQ8());
     }
 
-    _driver->setBrightness(ConfigManager::getMaxBrightness());
+    setOutputScale(frame.config.maxBrightness, fadeScale);
     _driver->show();
   }
 };
 
 // Static storage definitions removed - now using instance storage
 // This eliminates the critical bug where multiple instances would share the same buffers
+
@@ -0,0 +1,257 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include "config.h"
+#include "input_manager.h"
+#include "show_clock.h"
+#ifndef UNIT_TEST
+#include <ESP8266WiFi.h>
+#include <WiFiUdp.h>
+#endif
+
+/**
+ * @brief Datagrams to and from the other units of a set
+ */
+class ISyncLink
+{
+public:
+  virtual ~ISyncLink() = default;
+  virtual bool begin() = 0;
+  virtual bool send(const uint8_t *data, size_t length) = 0;
+
+  /**
+   * @brief Copy the next datagram into @p data
+   * @return Its length (at most @p length), 0 if nothing is waiting
+   */
+  virtual size_t receive(uint8_t *data, size_t length) = 0;
+};
+
+/**
+ * @brief Show time beacons between units: the leader sends, followers lock
+ *
+ * The leader beacons its show time and pattern seed every
+ * Sync::BEACON_INTERVAL_MS; followers feed them to their ShowClock. A
+ * follower keeps to the first leader it hears until that one has been
+ * silent for Sync::TIMEOUT_MS, and drops beacons whose sequence number is
+ * not newer than the last. Its own beacons, looped back by multicast, are
+ * ignored.
+ *
+ * Beacon, 18 bytes, big-endian:
+ *   0  "SHOW"
+ *   4  version (1)
+ *   5  type (1: beacon)
+ *   6  unit ID of the leader
+ *   8  sequence number
+ *   10 show time, ms
+ *   14 pattern seed
+ *
+ * An IInputSource so InputManager polls it every loop; it raises no events.
+ *
+ * @example
+ * ```cpp
+ * ShowSync sync(&link, &clock, ESP.getChipId());
+ * clock.setLeader(PortalConfig::Sync::LEADER);
+ * sync.begin(ESP.random());
+ * inputManager.addInputSource(&sync);
+ * ```
+ */
+class ShowSync : public IInputSource
+{
+public:
+  static constexpr size_t BEACON_SIZE = 18;
+  static constexpr uint8_t VERSION = 1;
+  static constexpr uint8_t BEACON = 1;
+  static constexpr int MAX_PACKETS_PER_UPDATE = 4;
+
+  struct Beacon
+  {
+    uint16_t unit;
+    uint16_t sequence;
+    uint32_t showMs;
+    uint32_t seed;
+  };
+
+  struct Stats
+  {
+    uint32_t sent;
+    uint32_t received; // Fed to the clock
+    uint32_t late;     // Repeated or older sequence numbers
+    uint32_t foreign;  // From a leader other than the one followed, or heard by a leader
+    uint32_t invalid;  // Not a beacon
+  };
+
+  ShowSync(ISyncLink *link, ShowClock *clock, uint16_t unit)
+      : _link(link), _clock(clock), _unit(unit), _sequence(0), _sentAt(0), _sentAny(false), _following(0),
+        _lastSequence(0), _stats() {}
+
+  /**
+   * @brief Start the link; @p seed becomes the set's pattern seed if leading
+   */
+  bool begin(uint32_t seed)
+  {
+    if (_clock->leader())
+      _clock->setSeed(seed);
+    return _link->begin();
+  }
+
+  const Stats &stats() const { return _stats; }
+
+  /**
+   * @brief Unit ID of the leader being followed, if locked()
+   */
+  uint16_t following() const { return _following; }
+
+  static size_t encode(const Beacon &beacon, uint8_t *out)
+  {
+    memcpy(out, "SHOW", 4);
+    out[4] = VERSION;
+    out[5] = BEACON;
+    write16(out + 6, beacon.unit);
+    write16(out + 8, beacon.sequence);
+    write32(out + 10, beacon.showMs);
+    write32(out + 14, beacon.seed);
+    return BEACON_SIZE;
+  }
+
+  static bool decode(const uint8_t *data, size_t length, Beacon &beacon)
+  {
+    if (length != BEACON_SIZE || memcmp(data, "SHOW", 4) != 0 || data[4] != VERSION || data[5] != BEACON)
+      return false;
+    beacon.unit = read16(data + 6);
+    beacon.sequence = read16(data + 8);
+    beacon.showMs = read32(data + 10);
+    beacon.seed = read32(data + 14);
+    return true;
+  }
+
+  // ---- IInputSource ----
+
+  bool update(unsigned long now) override
+  {
+    uint8_t packet[BEACON_SIZE + 1]; // One over, so longer datagrams fail to decode
+    for (int budget = MAX_PACKETS_PER_UPDATE; budget > 0; budget--)
+    {
+      size_t length = _link->receive(packet, sizeof(packet));
+      if (length == 0)
+        break;
+      handle(packet, length, (uint32_t)now);
+    }
+    _clock->update((uint32_t)now);
+    if (_clock->leader() && (!_sentAny || now - _sentAt >= PortalConfig::Sync::BEACON_INTERVAL_MS))
+    {
+      Beacon beacon = {_unit, ++_sequence, _clock->now((uint32_t)now), _clock->seed()};
+      encode(beacon, packet);
+      if (_link->send(packet, BEACON_SIZE))
+        _stats.sent++;
+      _sentAt = now;
+      _sentAny = true;
+    }
+    return false;
+  }
+
+  bool hasEvents() const override { return false; }
+  InputEvent getNextEvent() override { return {0, EventType::Released, 0, "none"}; }
+  const char *getSourceName() const override { return "ShowSync"; }
+
+private:
+  ISyncLink *_link;
+  ShowClock *_clock;
+  uint16_t _unit;
+  uint16_t _sequence;
+  unsigned long _sentAt;
+  bool _sentAny;
+  uint16_t _following;
+  uint16_t _lastSequence;
+  Stats _stats;
+
+  static void write16(uint8_t *p, uint16_t v)
+  {
+    p[0] = (uint8_t)(v >> 8);
+    p[1] = (uint8_t)v;
+  }
+  static void write32(uint8_t *p, uint32_t v)
+  {
+    write16(p, (uint16_t)(v >> 16));
+    write16(p + 2, (uint16_t)v);
+  }
+  static uint16_t read16(const uint8_t *p) { return (uint16_t)(p[0] << 8 | p[1]); }
+  static uint32_t read32(const uint8_t *p) { return (uint32_t)read16(p) << 16 | read16(p + 2); }
+
+  void handle(const uint8_t *packet, size_t length, uint32_t now)
+  {
+    Beacon beacon;
+    if (!decode(packet, length, beacon))
+    {
+      _stats.invalid++;
+      return;
+    }
+    if (beacon.unit == _unit)
+      return; // Our own, looped back
+    if (_clock->leader() || (_clock->locked() && beacon.unit != _following))
+    {
+      _stats.foreign++;
+      return;
+    }
+    if (_clock->locked() && (int16_t)(beacon.sequence - _lastSequence) <= 0)
+    {
+      _stats.late++;
+      return;
+    }
+    _following = beacon.unit;
+    _lastSequence = beacon.sequence;
+    _clock->onBeacon(beacon.showMs, now, beacon.seed);
+    _stats.received++;
+  }
+};
+
+#ifndef UNIT_TEST
+/**
+ * @brief ISyncLink on WiFiUDP, multicast to Sync::GROUP
+ *
+ * The group is joined once the station is connected; until then nothing is
+ * sent or received.
+ */
+class WiFiSyncLink : public ISyncLink
+{
+public:
+  WiFiSyncLink() : _started(false) {}
+
+  bool begin() override { return true; }
+
+  bool send(const uint8_t *data, size_t length) override
+  {
+    if (!start())
+      return false;
+    _udp.beginPacketMulticast(group(), PortalConfig::Sync::PORT, WiFi.localIP());
+    _udp.write(data, length);
+    return _udp.endPacket() == 1;
+  }
+
+  size_t receive(uint8_t *data, size_t length) override
+  {
+    if (!start() || _udp.parsePacket() <= 0)
+      return 0;
+    int n = _udp.read(data, length);
+    return n > 0 ? (size_t)n : 0;
+  }
+
+private:
+  WiFiUDP _udp;
+  bool _started;
+
+  static IPAddress group()
+  {
+    const uint8_t *g = PortalConfig::Sync::GROUP;
+    return IPAddress(g[0], g[1], g[2], g[3]);
+  }
+
+  bool start()
+  {
+    if (!_started && WiFi.status() == WL_CONNECTED)
+      _started = _udp.beginMulticast(WiFi.localIP(), group(), PortalConfig::Sync::PORT) == 1;
+    return _started;
+  }
+};
+#endif
@@ -0,0 +1,212 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include "config.h"
+#include "config_store.h"
+#include "async_http_server.h"
+#ifndef UNIT_TEST
+#include <LittleFS.h>
+#endif
+
+/**
+ * @brief Table of the gzipped web assets in LittleFS, with their ETags
+ *
+ * gzip_assets.py compresses data/ at build time, so the filesystem holds
+ * index.html.gz rather than index.html. The table is filled once at boot
+ * with each asset's size and a CRC-32 of its content, used as the ETag:
+ * answering a revalidation with 304 then needs no file access at all.
+ *
+ * @example
+ * ```cpp
+ * StaticAssets assets;
+ * assets.loadFromLittleFS(); // After LittleFS.begin()
+ * const StaticAssets::Asset *asset = assets.find("/");
+ * if (asset && StaticAssets::etagMatches(ifNoneMatch, asset->etag))
+ *     server.send(304);
+ * ```
+ */
+class StaticAssets
+{
+public:
+  static constexpr int MAX_ASSETS = PortalConfig::WiFi::MAX_ASSETS;
+  static constexpr size_t PATH_LENGTH = 32;   // Including the terminator
+  static constexpr size_t ETAG_LENGTH = 11;   // "xxxxxxxx" plus the terminator
+
+  struct Asset
+  {
+    char path[PATH_LENGTH]; // Request path, e.g. /index.html
+    uint32_t size;          // Bytes of gzip data
+    uint32_t etag;          // CRC-32 of the gzip data
+  };
+
+  StaticAssets() : _count(0) {}
+
+  /**
+   * @brief Record an asset
+   * @param file Its file name in LittleFS, ending in .gz
+   * @return false if the table is full, or the name is too long or not .gz
+   */
+  bool add(const char *file, uint32_t size, uint32_t etag)
+  {
+    size_t length = strlen(file);
+    if (_count >= MAX_ASSETS || length < 4 || length - 3 >= PATH_LENGTH || strcmp(file + length - 3, ".gz") != 0)
+      return false;
+    Asset &asset = _assets[_count++];
+    memcpy(asset.path, file, length - 3);
+    asset.path[length - 3] = '\0';
+    asset.size = size;
+    asset.etag = etag;
+    return true;
+  }
+
+  /**
+   * @brief Look up a request path; "/" is /index.html
+   * @return nullptr if there is no such asset
+   */
+  const Asset *find(const char *uri) const
+  {
+    if (strcmp(uri, "/") == 0)
+      uri = "/index.html";
+    for (int i = 0; i < _count; i++)
+      if (strcmp(_assets[i].path, uri) == 0)
+        return &_assets[i];
+    return nullptr;
+  }
+
+  int count() const { return _count; }
+
+  /**
+   * @brief LittleFS file holding an asset: its path plus .gz
+   * @param file At least PATH_LENGTH + 3 bytes
+   */
+  static const char *fileName(const Asset &asset, char *file)
+  {
+    snprintf(file, PATH_LENGTH + 3, "%s.gz", asset.path);
+    return file;
+  }
+
+  /**
+   * @brief ETag header value, quoted
+   * @param out At least ETAG_LENGTH bytes
+   */
+  static const char *formatEtag(uint32_t etag, char *out)
+  {
+    snprintf(out, ETAG_LENGTH, "\"%08lx\"", (unsigned long)etag);
+    return out;
+  }
+
+  /**
+   * @brief True if an If-None-Match header names @p etag
+   *
+   * Accepts a comma-separated list, weak validators (W/"...") and "*".
+   */
+  static bool etagMatches(const char *ifNoneMatch, uint32_t etag)
+  {
+    char quoted[ETAG_LENGTH];
+    formatEtag(etag, quoted);
+    const char *p = ifNoneMatch;
+    while (*p)
+    {
+      while (*p == ' ' || *p == ',')
+        p++;
+      if (*p == '*')
+        return true;
+      if (p[0] == 'W' && p[1] == '/')
+        p += 2;
+      if (strncmp(p, quoted, ETAG_LENGTH - 1) == 0 && (p[ETAG_LENGTH - 1] == '\0' || p[ETAG_LENGTH - 1] == ',' || p[ETAG_LENGTH - 1] == ' '))
+        return true;
+      while (*p && *p != ',')
+        p++;
+    }
+    return false;
+  }
+
+  /**
+   * @brief Content-Type for a request path, from its extension
+   */
+  static const char *contentType(const char *path)
+  {
+    static const char *const types[][2] = {
+        {".html", "text/html"},
+        {".css", "text/css"},
+        {".js", "application/javascript"},
+        {".json", "application/json"},
+        {".svg", "image/svg+xml"},
+        {".png", "image/png"},
+        {".ico", "image/x-icon"}};
+    size_t length = strlen(path);
+    for (const auto &type : types)
+    {
+      size_t ext = strlen(type[0]);
+      if (length >= ext && strcmp(path + length - ext, type[0]) == 0)
+        return type[1];
+    }
+    return "application/octet-stream";
+  }
+
+#ifndef UNIT_TEST
+  /**
+   * @brief Fill the table from the .gz files in the LittleFS root
+   *
+   * Reads each asset once to compute its ETag. LittleFS must be mounted.
+   * @return Number of assets found
+   */
+  int loadFromLittleFS()
+  {
+    _count = 0;
+    Dir dir = LittleFS.openDir("/");
+    while (dir.next())
+    {
+      String name = "/" + dir.fileName();
+      if (!name.endsWith(".gz"))
+        continue;
+      File file = dir.openFile("r");
+      if (!file)
+        continue;
+      uint8_t buffer[PortalConfig::WiFi::ASSET_CHUNK];
+      uint32_t crc = 0;
+      size_t n;
+      while ((n = file.read(buffer, sizeof(buffer))) > 0)
+        crc = ConfigStore::crc32(buffer, n, crc);
+      add(name.c_str(), file.size(), crc);
+      file.close();
+    }
+    return _count;
+  }
+#endif
+
+private:
+  Asset _assets[MAX_ASSETS];
+  int _count;
+};
+
+#ifndef UNIT_TEST
+/**
+ * @brief Asset files being sent, one per HTTP connection
+ */
+class LittleFSAssetSource : public IBodySource
+{
+public:
+  bool open(int connection, const char *file)
+  {
+    _files[connection] = LittleFS.open(file, "r");
+    return (bool)_files[connection];
+  }
+
+  size_t read(int connection, uint8_t *data, size_t length) override
+  {
+    return _files[connection].read(data, length);
+  }
+
+  void close(int connection) override
+  {
+    _files[connection].close();
+  }
+
+private:
+  File _files[PortalConfig::WiFi::HTTP_MAX_CONNECTIONS];
+};
+#endif
@@ -0,0 +1,257 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+/**
+ * @brief WebSocket (RFC 6455) handshake and framing, for AsyncHttpServer
+ *
+ * Only what a server needs: the Sec-WebSocket-Accept value, parsing of the
+ * masked frames clients send, and headers for the unmasked frames it sends.
+ * Messages are single frames of at most 65535 bytes; fragmented messages
+ * are not supported.
+ *
+ * @example
+ * ```cpp
+ * char accept[WebSocket::ACCEPT_LENGTH];
+ * WebSocket::acceptKey("dGhlIHNhbXBsZSBub25jZQ==", accept); // s3pPLMBiTxaQ9kYGzzhZRbK+xOo=
+ * ```
+ */
+class WebSocket
+{
+public:
+  static constexpr size_t ACCEPT_LENGTH = 29; // 28 base64 characters plus the terminator
+  static constexpr size_t MAX_HEADER = 4;     // Server frame header, payloads up to 65535 bytes
+
+  enum Opcode : uint8_t
+  {
+    CONTINUATION = 0x0,
+    TEXT = 0x1,
+    BINARY = 0x2,
+    CLOSE = 0x8,
+    PING = 0x9,
+    PONG = 0xA
+  };
+
+  // Close status codes
+  static constexpr uint16_t CLOSE_NORMAL = 1000;
+  static constexpr uint16_t CLOSE_PROTOCOL_ERROR = 1002;
+  static constexpr uint16_t CLOSE_UNSUPPORTED = 1003;
+  static constexpr uint16_t CLOSE_TOO_BIG = 1009;
+
+  struct Frame
+  {
+    bool fin;
+    uint8_t opcode;
+    size_t headerLength;  // Bytes before the payload, mask included
+    size_t payloadLength;
+    uint8_t mask[4];
+  };
+
+  /**
+   * @brief Sec-WebSocket-Accept for a client's Sec-WebSocket-Key
+   * @param out At least ACCEPT_LENGTH bytes
+   */
+  static const char *acceptKey(const char *key, char *out)
+  {
+    static const char GUID[] = "258EAFA5-E914-47DA-95CA-C5AB0DC85B11";
+    Sha1 sha;
+    sha.update((const uint8_t *)key, strlen(key));
+    sha.update((const uint8_t *)GUID, sizeof(GUID) - 1);
+    uint8_t digest[20];
+    sha.finish(digest);
+    base64(digest, sizeof(digest), out);
+    return out;
+  }
+
+  enum Parse : uint8_t
+  {
+    INCOMPLETE, // More bytes needed
+    COMPLETE,   // Header and payload have all arrived
+    INVALID,    // Not masked, as client frames must be
+    TOO_BIG     // Payload longer than allowed
+  };
+
+  /**
+   * @brief Read a client frame's header, filling in @p frame once COMPLETE
+   */
+  static Parse parse(const uint8_t *data, size_t length, size_t maxPayload, Frame &frame)
+  {
+    if (length < 2)
+      return INCOMPLETE;
+    frame.fin = data[0] & 0x80;
+    frame.opcode = data[0] & 0x0F;
+    if (!(data[1] & 0x80))
+      return INVALID;
+    size_t payload = data[1] & 0x7F;
+    size_t at = 2;
+    if (payload == 127)
+      return TOO_BIG; // 64-bit length, far beyond any buffer here
+    if (payload == 126)
+    {
+      if (length < 4)
+        return INCOMPLETE;
+      payload = (size_t)data[2] << 8 | data[3];
+      at = 4;
+    }
+    if (payload > maxPayload)
+      return TOO_BIG;
+    if (length < at + 4)
+      return INCOMPLETE;
+    memcpy(frame.mask, data + at, 4);
+    frame.headerLength = at + 4;
+    frame.payloadLength = payload;
+    return length >= frame.headerLength + payload ? COMPLETE : INCOMPLETE;
+  }
+
+  /**
+   * @brief Remove a frame's mask from its payload, in place
+   */
+  static void unmask(uint8_t *payload, size_t length, const uint8_t mask[4])
+  {
+    for (size_t i = 0; i < length; i++)
+      payload[i] ^= mask[i & 3];
+  }
+
+  /**
+   * @brief Header of an unmasked, final server frame
+   * @param out At least MAX_HEADER bytes
+   * @return Header length
+   */
+  static size_t header(uint8_t opcode, size_t length, uint8_t *out)
+  {
+    out[0] = 0x80 | opcode;
+    if (length < 126)
+    {
+      out[1] = (uint8_t)length;
+      return 2;
+    }
+    out[1] = 126;
+    out[2] = (uint8_t)(length >> 8);
+    out[3] = (uint8_t)length;
+    return 4;
+  }
+
+private:
+  /**
+   * @brief Just enough SHA-1 for the handshake
+   */
+  class Sha1
+  {
+  public:
+    Sha1() : _length(0), _used(0)
+    {
+      _h[0] = 0x67452301;
+      _h[1] = 0xEFCDAB89;
+      _h[2] = 0x98BADCFE;
+      _h[3] = 0x10325476;
+      _h[4] = 0xC3D2E1F0;
+    }
+
+    void update(const uint8_t *data, size_t length)
+    {
+      _length += length;
+      while (length--)
+      {
+        _block[_used++] = *data++;
+        if (_used == 64)
+          compress();
+      }
+    }
+
+    void finish(uint8_t digest[20])
+    {
+      uint64_t bits = _length * 8;
+      uint8_t pad = 0x80;
+      update(&pad, 1);
+      pad = 0;
+      while (_used != 56)
+        update(&pad, 1);
+      for (int i = 7; i >= 0; i--)
+      {
+        uint8_t b = (uint8_t)(bits >> (i * 8));
+        update(&b, 1);
+      }
+      for (int i = 0; i < 20; i++)
+        digest[i] = (uint8_t)(_h[i / 4] >> (24 - (i % 4) * 8));
+    }
+
+  private:
+    uint32_t _h[5];
+    uint8_t _block[64];
+    uint64_t _length;
+    size_t _used;
+
+    static uint32_t rotl(uint32_t x, int n) { return x << n | x >> (32 - n); }
+
+    void compress()
+    {
+      uint32_t w[80];
+      for (int i = 0; i < 16; i++)
+        w[i] = (uint32_t)_block[i * 4] << 24 | (uint32_t)_block[i * 4 + 1] << 16 | (uint32_t)_block[i * 4 + 2] << 8 | _block[i * 4 + 3];
+      for (int i = 16; i < 80; i++)
+        w[i] = rotl(w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16], 1);
+      uint32_t a = _h[0], b = _h[1], c = _h[2], d = _h[3], e = _h[4];
+      for (int i = 0; i < 80; i++)
+      {
+        uint32_t f, k;
+        if (i < 20)
+        {
+          f = (b & c) | (~b & d);
+          k = 0x5A827999;
+        }
+        else if (i < 40)
+        {
+          f = b ^ c ^ d;
+          k = 0x6ED9EBA1;
+        }
+        else if (i < 60)
+        {
+          f = (b & c) | (b & d) | (c & d);
+          k = 0x8F1BBCDC;
+        }
+        else
+        {
+          f = b ^ c ^ d;
+          k = 0xCA62C1D6;
+        }
+        uint32_t t = rotl(a, 5) + f + e + k + w[i];
+        e = d;
+        d = c;
+        c = rotl(b, 30);
+        b = a;
+        a = t;
+      }
+      _h[0] += a;
+      _h[1] += b;
+      _h[2] += c;
+      _h[3] += d;
+      _h[4] += e;
+      _used = 0;
+    }
+  };
+
+  static void base64(const uint8_t *data, size_t length, char *out)
+  {
+    static const char ALPHABET[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    size_t i = 0;
+    for (; i + 2 < length; i += 3)
+    {
+      uint32_t v = (uint32_t)data[i] << 16 | (uint32_t)data[i + 1] << 8 | data[i + 2];
+      *out++ = ALPHABET[v >> 18];
+      *out++ = ALPHABET[(v >> 12) & 63];
+      *out++ = ALPHABET[(v >> 6) & 63];
+      *out++ = ALPHABET[v & 63];
+    }
+    if (i < length)
+    {
+      uint32_t v = (uint32_t)data[i] << 16 | (i + 1 < length ? (uint32_t)data[i + 1] << 8 : 0);
+      *out++ = ALPHABET[v >> 18];
+      *out++ = ALPHABET[(v >> 12) & 63];
+      *out++ = i + 1 < length ? ALPHABET[(v >> 6) & 63] : '=';
+      *out++ = '=';
+    }
+    *out = '\0';
+  }
+};
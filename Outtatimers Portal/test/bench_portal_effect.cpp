@@ -0,0 +1,129 @@
+// Host-side frame benchmark for PortalEffectTemplate on a full-size strip.
+// Build and run with ./run_benchmarks.sh
+#include "bench_harness.h"
+#include "mock_led_driver.h"
+#include "../src/frame_pacer.h"
+#include "../src/portal_effect.h"
+
+static unsigned long simulated_time = 0;
+extern "C" unsigned long millis() { return simulated_time; }
+
+constexpr int N = PortalConfig::Hardware::NUM_LEDS;
+constexpr int FRAMES = 2000;
+constexpr int GENERATIONS = 200;
+
+using Portal = PortalEffectTemplate<N, PortalConfig::Effects::GRADIENT_STEP_DEFAULT, PortalConfig::Effects::GRADIENT_MOVE_DEFAULT>;
+
+static MockLEDDriver<N> mock;
+static Portal *portal = nullptr;
+
+// Fresh effect instance, started and advanced past the fade-in
+static void startPortal(int portalMode)
+{
+  delete portal;
+  portal = new Portal(&mock);
+  simulated_time = 1;
+  ConfigManager::begin();
+  ConfigManager::setPortalMode(portalMode);
+  portal->begin();
+  portal->start();
+  while (simulated_time < PortalConfig::Timing::FADE_IN_DURATION_MS + 100)
+  {
+    simulated_time += PortalConfig::Timing::UPDATE_INTERVAL_MS;
+    portal->update(simulated_time);
+  }
+}
+
+static void renderFrame()
+{
+  simulated_time += PortalConfig::Timing::UPDATE_INTERVAL_MS;
+  portal->update(simulated_time);
+}
+
+int main()
+{
+  Bench::printHeader("PortalEffectTemplate<756> frame cost (host build)");
+
+  startPortal(0);
+  Bench::printResult("CLASSIC frame", Bench::run(renderFrame, FRAMES));
+
+  startPortal(1);
+  Bench::printResult("VIRTUAL_GRADIENT frame", Bench::run(renderFrame, FRAMES));
+
+  startPortal(0);
+  portal->triggerMalfunction();
+  Bench::printResult("malfunction frame", Bench::run(renderFrame, FRAMES));
+
+  // Frames during a colour crossfade, restarted by a hue change every frame
+  startPortal(1);
+  Bench::printResult("VIRTUAL recolour frame", Bench::run([]
+                                                          {
+    ConfigManager::setHueMin(ConfigManager::getHueMin() ^ 1);
+    renderFrame(); },
+                                                          FRAMES));
+
+  // Rotation alone, at fractional offsets so every pixel is blended
+  static MirroredRing<N> mirrored;
+  static WrappedRing<N> wrapped;
+  static GradientRing<N, PortalConfig::Effects::MAX_DRIVER_POINTS> procedural;
+  static Rgb565Ring<N> compact;
+  srand(1);
+  mirrored.beginPoints();
+  wrapped.beginPoints();
+  procedural.beginPoints();
+  compact.beginPoints();
+  for (int pos = 0; pos < N - PortalConfig::Effects::MAX_DRIVER_DISTANCE; pos += 10)
+  {
+    CRGB color(rand() % 256, rand() % 256, rand() % 256);
+    mirrored.addPoint(pos, color);
+    wrapped.addPoint(pos, color);
+    procedural.addPoint(pos, color);
+    compact.addPoint(pos, color);
+  }
+  mirrored.closePoints();
+  wrapped.closePoints();
+  procedural.closePoints();
+  compact.closePoints();
+  static uint32_t offsetQ8 = 0;
+  Bench::printResult("MirroredRing blit", Bench::run([]
+                                                     { mirrored.blit(mock, offsetQ8 += 389); },
+                                                     FRAMES));
+  Bench::printResult("WrappedRing blit", Bench::run([]
+                                                    { wrapped.blit(mock, offsetQ8 += 389); },
+                                                    FRAMES));
+  Bench::printResult("GradientRing blit", Bench::run([]
+                                                     { procedural.blit(mock, offsetQ8 += 389); },
+                                                     FRAMES));
+  Bench::printResult("Rgb565Ring blit", Bench::run([]
+                                                   { compact.blit(mock, offsetQ8 += 389); },
+                                                   FRAMES));
+
+  static CRGB effectLeds[N];
+  Bench::printResult("generatePortalEffect", Bench::run([]
+                                                        { portal->testGeneratePortalEffect(effectLeds); },
+                                                        GENERATIONS));
+
+  // Alternate the hue so every call performs a full regeneration
+  Bench::printResult("generateVirtualGradients", Bench::run([]
+                                                            {
+    ConfigManager::setHueMin(ConfigManager::getHueMin() ^ 1);
+    portal->testGenerateVirtualGradients(); },
+                                                            GENERATIONS));
+
+  // Hue change handling: recolour starts plus one step of the next pattern
+  startPortal(0);
+  Bench::printResult("hue change", Bench::run([]
+                                              {
+    ConfigManager::setHueMin(ConfigManager::getHueMin() ^ 1);
+    portal->serviceGeneration(); },
+                                              GENERATIONS));
+
+  // Modelled WS2812B transmit time: the floor under every frame that is sent
+  printf("\nWS2812B wire time (model)\n");
+  printf("%-28s %14s %14s\n", "strip length", "us/frame", "max fps");
+  for (int leds : {100, 300, 600, N, 1000, 1500})
+    printf("%-28d %14lu %14lu\n", leds, FramePacer::wireTimeUs(leds), 1000000UL / FramePacer::wireTimeUs(leds));
+
+  delete portal;
+  return 0;
+}
@@ -0,0 +1,157 @@
+// Host throughput test for RealtimeInputSource over a real UDP socket
+// (127.0.0.1). Build and run with ./run_benchmarks.sh
+//
+// A sender thread streams E1.31 frames for the full strip (five universes)
+// while the main thread runs update() and takes frames as the frame loop
+// would: first paced at 44 fps, then with every datagram followed by a
+// stale duplicate, then as fast as the sender can go. Reports frames shown
+// per second, partial frames, late and lost datagrams, time spent in
+// update() calls that read datagrams per frame shown, and heap allocations
+// per frame. Fails if the paced stream is not shown at 40 fps or more.
+#include "bench_harness.h"
+#include "mock_led_driver.h"
+#include "posix_udp_receiver.h"
+#include <arpa/inet.h>
+#include <atomic>
+#include <thread>
+
+extern "C" unsigned long millis()
+{
+  using namespace std::chrono;
+  return (unsigned long)duration_cast<milliseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+constexpr int N = PortalConfig::Hardware::NUM_LEDS;
+constexpr int UNIVERSES = (N + PortalConfig::Realtime::PIXELS_PER_UNIVERSE - 1) / PortalConfig::Realtime::PIXELS_PER_UNIVERSE;
+constexpr double MIN_FPS = 40;
+
+static uint16_t port;
+static std::atomic<bool> senderDone(false);
+
+// An E1.31 data packet carrying 170 pixels
+static size_t buildPacket(uint8_t *p, uint16_t universe, uint8_t sequence, uint8_t level)
+{
+  static const uint8_t ACN_ID[12] = {'A', 'S', 'C', '-', 'E', '1', '.', '1', '7', 0, 0, 0};
+  const size_t channels = RealtimeInputSource::UNIVERSE_CHANNELS;
+  memset(p, 0, RealtimeInputSource::E131_HEADER);
+  p[1] = 0x10;
+  memcpy(p + 4, ACN_ID, sizeof(ACN_ID));
+  p[21] = 0x04;
+  p[43] = 0x02;
+  p[108] = 100;
+  p[111] = sequence;
+  p[113] = (uint8_t)(universe >> 8);
+  p[114] = (uint8_t)universe;
+  p[117] = 0x02;
+  p[118] = 0xa1;
+  p[122] = 1;
+  p[123] = (uint8_t)((channels + 1) >> 8);
+  p[124] = (uint8_t)(channels + 1);
+  memset(p + RealtimeInputSource::E131_HEADER, level, channels);
+  return RealtimeInputSource::E131_HEADER + channels;
+}
+
+// Send @p frames frames, one every @p intervalUs (0: unpaced); with
+// @p duplicates each datagram is followed by a copy of the previous one
+static void sender(int frames, long intervalUs, bool duplicates)
+{
+  int fd = socket(AF_INET, SOCK_DGRAM, 0);
+  sockaddr_in address = {};
+  address.sin_family = AF_INET;
+  address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  address.sin_port = htons(port);
+  static uint8_t packet[RealtimeInputSource::E131_HEADER + RealtimeInputSource::UNIVERSE_CHANNELS];
+  static uint8_t sequence[UNIVERSES];
+  auto next = std::chrono::steady_clock::now();
+  for (int f = 0; f < frames; f++)
+  {
+    for (int u = 0; u < UNIVERSES; u++)
+    {
+      uint16_t universe = PortalConfig::Realtime::E131_FIRST_UNIVERSE + u;
+      size_t length = buildPacket(packet, universe, ++sequence[u], (uint8_t)f);
+      sendto(fd, packet, length, 0, (sockaddr *)&address, sizeof(address));
+      if (duplicates)
+      {
+        buildPacket(packet, universe, (uint8_t)(sequence[u] - 1), (uint8_t)(f - 1));
+        sendto(fd, packet, length, 0, (sockaddr *)&address, sizeof(address));
+      }
+    }
+    if (intervalUs)
+    {
+      next += std::chrono::microseconds(intervalUs);
+      std::this_thread::sleep_until(next);
+    }
+    else if (f % 8 == 7)
+      std::this_thread::yield(); // Let the receiver run on a single core
+  }
+  close(fd);
+  senderDone = true;
+}
+
+static bool runCase(RealtimeInputSource &realtime, const char *name, int frames, long intervalUs, bool duplicates)
+{
+  RealtimeInputSource::Stats before = realtime.stats();
+  senderDone = false;
+  double updateUs = 0;
+  unsigned long allocations = 0;
+  auto start = std::chrono::steady_clock::now();
+  auto lastFrame = start;
+  std::thread thread(sender, frames, intervalUs, duplicates);
+  unsigned long idleSince = millis();
+  while (!senderDone || millis() - idleSince < 50)
+  {
+    unsigned long allocsBefore = Bench::allocationCount;
+    uint32_t read = realtime.stats().packets + realtime.stats().late;
+    auto t0 = std::chrono::steady_clock::now();
+    realtime.update(millis());
+    double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count();
+    if (realtime.stats().packets + realtime.stats().late != read)
+      updateUs += us; // Calls that found nothing waiting are the idle loop, not receive cost
+    allocations += Bench::allocationCount - allocsBefore;
+    if (realtime.takeFrame())
+    {
+      lastFrame = std::chrono::steady_clock::now();
+      idleSince = millis();
+    }
+    else if (!senderDone)
+      idleSince = millis();
+  }
+  thread.join();
+
+  const RealtimeInputSource::Stats &after = realtime.stats();
+  unsigned long shown = after.frames - before.frames;
+  unsigned long late = after.late - before.late;
+  unsigned long packets = after.packets - before.packets;
+  unsigned long lost = (unsigned long)frames * UNIVERSES - packets - (duplicates ? 0 : late);
+  double seconds = std::chrono::duration<double>(lastFrame - start).count();
+  double fps = shown / seconds;
+  printf("%-24s %6d %6lu %8.1f %7u %6lu %6lu %9.1f %10.2f\n", name, frames, shown, fps, after.partial - before.partial,
+         late, lost, shown ? updateUs / shown : 0.0, shown ? (double)allocations / shown : 0.0);
+  return fps >= MIN_FPS;
+}
+
+int main()
+{
+  ConfigManager::begin();
+  ConfigManager::setPortalMode(PortalConfig::Realtime::PORTAL_MODE);
+  static MockLEDDriver<N> driver;
+  PosixUdpReceiver rx;
+  RealtimeInputSource realtime(&driver, N, &rx, nullptr);
+  if (!rx.begin(0))
+  {
+    printf("Cannot bind 127.0.0.1\n");
+    return 1;
+  }
+  port = rx.port();
+
+  printf("\nRealtimeInputSource on a POSIX UDP socket, %d LEDs in %d E1.31 universes (host build)\n", N, UNIVERSES);
+  printf("%-24s %6s %6s %8s %7s %6s %6s %9s %10s\n", "case", "sent", "shown", "fps", "partial", "late", "lost",
+         "us/frame", "allocs/fr");
+
+  bool ok = runCase(realtime, "44 fps", 88, 1000000 / 44, false);
+  ok &= runCase(realtime, "44 fps, stale copies", 88, 1000000 / 44, true);
+  runCase(realtime, "unpaced", 2000, 0, false);
+  if (!ok)
+    printf("Paced stream shown below %.0f fps\n", MIN_FPS);
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,71 @@
+#pragma once
+// IUdpReceiver on a non-blocking POSIX UDP socket, for running
+// RealtimeInputSource on the host against a local E1.31 / Art-Net sender
+//
+// peek() is recv(MSG_PEEK); take() reads the datagram with recvmsg() into
+// a scratch buffer for the skipped header and the caller's buffer for the
+// rest, so the data is copied once, into its destination, as on the device.
+
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include "realtime_input.h"
+
+class PosixUdpReceiver : public IUdpReceiver
+{
+public:
+  PosixUdpReceiver() : fd_(-1), port_(0) {}
+
+  ~PosixUdpReceiver() override
+  {
+    if (fd_ >= 0)
+      ::close(fd_);
+  }
+
+  /**
+   * @brief Bind 127.0.0.1; port 0 picks a free one (see port())
+   */
+  bool begin(uint16_t port) override
+  {
+    fd_ = socket(AF_INET, SOCK_DGRAM, 0);
+    if (fd_ < 0)
+      return false;
+    int buffer = 1 << 20; // Room for a burst of frames while a test looks away
+    setsockopt(fd_, SOL_SOCKET, SO_RCVBUF, &buffer, sizeof(buffer));
+    sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = htons(port);
+    socklen_t length = sizeof(address);
+    if (bind(fd_, (sockaddr *)&address, sizeof(address)) < 0 || getsockname(fd_, (sockaddr *)&address, &length) < 0)
+      return false;
+    port_ = ntohs(address.sin_port);
+    fcntl(fd_, F_SETFL, fcntl(fd_, F_GETFL) | O_NONBLOCK);
+    return true;
+  }
+
+  uint16_t port() const { return port_; }
+
+  size_t peek(uint8_t *header, size_t length) override
+  {
+    ssize_t n = recv(fd_, header, length, MSG_PEEK);
+    return n > 0 ? (size_t)n : 0;
+  }
+
+  size_t take(size_t skip, uint8_t *data, size_t length) override
+  {
+    uint8_t scratch[RealtimeInputSource::E131_HEADER];
+    iovec parts[2] = {{scratch, skip < sizeof(scratch) ? skip : sizeof(scratch)}, {data, data ? length : 0}};
+    msghdr message = {};
+    message.msg_iov = parts;
+    message.msg_iovlen = 2;
+    ssize_t n = recvmsg(fd_, &message, 0);
+    return n > (ssize_t)parts[0].iov_len ? (size_t)n - parts[0].iov_len : 0;
+  }
+
+private:
+  int fd_;
+  uint16_t port_;
+};
@@ -0,0 +1,79 @@
+#include <cassert>
+#include <iostream>
+#include "frame_pacer.h"
+
+// Drive the pacer with a simulated clock where every frame costs costUs.
+// Returns the number of frames rendered in durationUs.
+static int simulate(FramePacer &pacer, unsigned long &nowUs, unsigned long costUs, unsigned long durationUs)
+{
+  int frames = 0;
+  unsigned long end = nowUs + durationUs;
+  while (nowUs < end)
+  {
+    if (pacer.frameDue(nowUs))
+    {
+      pacer.beginFrame(nowUs);
+      nowUs += costUs;
+      pacer.endFrame(nowUs);
+      frames++;
+    }
+    else
+    {
+      nowUs += 100; // Input/HTTP work between frames
+    }
+  }
+  return frames;
+}
+
+int main()
+{
+  using namespace PortalConfig;
+
+  // WS2812B wire model: 30 us per pixel plus the latch gap
+  static_assert(FramePacer::wireTimeUs(0) == Hardware::WS2812_LATCH_US, "empty strip is just the latch");
+  static_assert(FramePacer::wireTimeUs(756) == 756 * 30 + Hardware::WS2812_LATCH_US, "30 us per pixel");
+  assert(FramePacer::wireTimeUs(Hardware::NUM_LEDS) > Timing::UPDATE_INTERVAL_MS * 1000UL);
+
+  // Before any measurement the interval covers the modelled transmit plus the input slice
+  const unsigned long wire = FramePacer::wireTimeUs(Hardware::NUM_LEDS);
+  FramePacer pacer(wire);
+  assert(pacer.frameIntervalUs() == wire + Timing::FRAME_INPUT_SLICE_MS * 1000UL);
+
+  // Full-cost frames: every interval keeps the input slice free
+  unsigned long now = 0;
+  int frames = simulate(pacer, now, wire, 3000000UL);
+  unsigned long expectedFps = 1000000UL / (wire + Timing::FRAME_INPUT_SLICE_MS * 1000UL);
+  assert(frames >= (int)(3 * expectedFps) - 3 && frames <= (int)(3 * expectedFps) + 3);
+  assert(pacer.achievedFps() >= expectedFps - 1 && pacer.achievedFps() <= expectedFps + 1);
+
+  // Cheap (skipped) frames decay toward the minimum interval
+  simulate(pacer, now, 200, 2000000UL);
+  assert(pacer.frameIntervalUs() == Timing::UPDATE_INTERVAL_MS * 1000UL);
+  simulate(pacer, now, 200, 1100000UL);
+  assert(pacer.achievedFps() >= 95 && pacer.achievedFps() <= 100);
+
+  // A single expensive frame widens the interval immediately
+  pacer.beginFrame(now);
+  now += 40000;
+  pacer.endFrame(now);
+  assert(pacer.frameCostUs() == 40000);
+  assert(pacer.frameIntervalUs() == 40000 + Timing::FRAME_INPUT_SLICE_MS * 1000UL);
+  assert(!pacer.frameDue(now));
+
+  // Pathological frame cost is clamped to the maximum interval
+  pacer.beginFrame(now);
+  now += 500000;
+  pacer.endFrame(now);
+  assert(pacer.frameIntervalUs() == Timing::FRAME_MAX_INTERVAL_MS * 1000UL);
+
+  // Clock wrap-around is handled by unsigned arithmetic
+  FramePacer wrapped(wire);
+  unsigned long nearWrap = ~0UL - 5000UL;
+  wrapped.beginFrame(nearWrap);
+  wrapped.endFrame(nearWrap + 1000UL);
+  assert(!wrapped.frameDue(nearWrap + 2000UL));
+  assert(wrapped.frameDue(nearWrap + wire + Timing::FRAME_INPUT_SLICE_MS * 1000UL));
+
+  std::cout << "Frame pacer tests passed" << std::endl;
+  return 0;
+}
@@ -0,0 +1,77 @@
+// Unchanged frames must not be retransmitted: static scenes skip show()
+#include <cassert>
+#include <iostream>
+#include "mock_led_driver.h"
+#include "../src/portal_effect.h"
+
+static unsigned long simulated_time = 0;
+extern "C" unsigned long millis() { return simulated_time; }
+
+constexpr int N = PortalConfig::Hardware::NUM_LEDS;
+using Portal = PortalEffectTemplate<N, PortalConfig::Effects::GRADIENT_STEP_DEFAULT, PortalConfig::Effects::GRADIENT_MOVE_DEFAULT>;
+
+static MockLEDDriver<N> mock;
+
+// Advance by @p ticks update intervals; returns the number of frames transmitted
+static int runTicks(Portal &portal, int ticks)
+{
+  int before = mock.transmitCount;
+  for (int i = 0; i < ticks; ++i)
+  {
+    simulated_time += PortalConfig::Timing::UPDATE_INTERVAL_MS;
+    portal.update(simulated_time);
+  }
+  return mock.transmitCount - before;
+}
+
+int main()
+{
+  const int fadeTicks = PortalConfig::Timing::FADE_IN_DURATION_MS / PortalConfig::Timing::UPDATE_INTERVAL_MS;
+  ConfigManager::begin();
+
+  for (int mode = 0; mode <= 1; ++mode)
+  {
+    Portal portal(&mock);
+    ConfigManager::setPortalMode(mode);
+    ConfigManager::setRotationSpeed(0);
+    simulated_time = 1;
+    portal.begin();
+    portal.start();
+
+    // The fade-in ramp changes the frame on most ticks
+    int sent = runTicks(portal, 1);
+    static CRGB firstFrame[N];
+    for (int i = 0; i < N; ++i)
+      firstFrame[i] = mock.buffer[i];
+    assert(mock.brightness < ConfigManager::getMaxBrightness());
+    sent += runTicks(portal, fadeTicks + 9);
+    assert(sent > fadeTicks / 2 && sent <= fadeTicks + 10);
+
+    // ...but only through the output brightness: the pixels were rendered once
+    assert(mock.brightness == ConfigManager::getMaxBrightness());
+    for (int i = 0; i < N; ++i)
+      assert(mock.buffer[i] == firstFrame[i]);
+
+    // A static scene transmits nothing
+    assert(runTicks(portal, 200) == 0);
+
+    // A brightness change sends exactly one frame
+    ConfigManager::setMaxBrightness(ConfigManager::getMaxBrightness() - 1);
+    assert(runTicks(portal, 50) == 1);
+
+    // A moving gradient transmits every tick
+    ConfigManager::setRotationSpeed(2);
+    assert(runTicks(portal, 50) == 50);
+
+    // Stopping clears the strip once, then nothing further is sent
+    ConfigManager::setRotationSpeed(0);
+    runTicks(portal, 1);
+    int beforeStop = mock.transmitCount;
+    portal.stop();
+    assert(mock.transmitCount == beforeStop + 1);
+    assert(runTicks(portal, 20) == 0);
+  }
+
+  std::cout << "Frame skip tests passed" << std::endl;
+  return 0;
+}
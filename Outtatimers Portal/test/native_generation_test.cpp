@@ -0,0 +1,131 @@
+// Pattern generation runs in the background: the next start() pattern is
+// built a few driver points per step and swapped in whole, and colour
+// changes crossfade the existing drivers instead of regenerating them
+#include <cassert>
+#include <cstring>
+#include <iostream>
+#include "mock_led_driver.h"
+#include "../src/portal_effect.h"
+
+static unsigned long simulated_time = 0;
+extern "C" unsigned long millis() { return simulated_time; }
+
+constexpr int N = PortalConfig::Hardware::NUM_LEDS;
+using Portal = PortalEffectTemplate<N, PortalConfig::Effects::GRADIENT_STEP_DEFAULT, PortalConfig::Effects::GRADIENT_MOVE_DEFAULT>;
+
+static MockLEDDriver<N> mock;
+
+static bool samePattern(const CRGB *a, const CRGB *b)
+{
+  for (int i = 0; i < N; ++i)
+    if (!(a[i] == b[i]))
+      return false;
+  return true;
+}
+
+static void renderTick(Portal &portal)
+{
+  simulated_time += PortalConfig::Timing::UPDATE_INTERVAL_MS;
+  portal.renderFrame(simulated_time);
+}
+
+int main()
+{
+  ConfigManager::begin();
+  ConfigManager::setRotationSpeed(0); // Offset 0: the strip shows the front pattern as is
+  ConfigManager::setPortalMode(0);
+  simulated_time = 1;
+  static Portal portal(&mock);
+  static CRGB shown[N], prepared[N];
+
+  // begin() pre-generates both patterns
+  portal.begin();
+  assert(portal.testIsSequenceInitialized());
+  memcpy(shown, portal.testGetEffectLeds(), sizeof(shown));
+
+  // The next classic pattern is built over several steps
+  int steps = 1;
+  while (portal.serviceGeneration())
+    steps++;
+  assert(steps > 2 && portal.testClassicBackReady());
+  memcpy(prepared, portal.testGetEffectLeds(true), sizeof(prepared));
+  assert(!samePattern(shown, prepared));
+
+  // start() shows the prepared pattern straight away
+  portal.start();
+  assert(samePattern(portal.testGetEffectLeds(), prepared) && !portal.testClassicBackReady());
+  renderTick(portal);
+  assert(samePattern(mock.buffer, prepared));
+  while (portal.serviceGeneration())
+    ;
+
+  // A mode change keeps the pattern and leaves nothing to build
+  ConfigManager::setPortalMode(1);
+  ConfigManager::setPortalMode(0);
+  assert(!portal.serviceGeneration());
+  assert(samePattern(portal.testGetEffectLeds(), prepared));
+
+  // A hue change keeps every driver and crossfades its colour to a new one
+  const int fadeTicks = PortalConfig::Timing::RECOLOR_FADE_MS / PortalConfig::Timing::UPDATE_INTERVAL_MS;
+  constexpr int MAX_POINTS = PortalConfig::Effects::MAX_DRIVER_POINTS;
+  static uint16_t positions[MAX_POINTS];
+  static CRGB before[MAX_POINTS], midway[MAX_POINTS];
+  const auto &classic = portal.testClassicPattern();
+  int count = classic.pointCount();
+  for (int i = 0; i < count; ++i)
+  {
+    positions[i] = classic.pointPosition(i);
+    before[i] = classic.pointColor(i);
+  }
+  ConfigManager::setHueMin(ConfigManager::getHueMin() + 40);
+  for (int i = 0; i < fadeTicks / 2; ++i)
+    renderTick(portal);
+  for (int i = 0; i < count; ++i)
+    midway[i] = classic.pointColor(i);
+  for (int i = 0; i <= fadeTicks / 2 + 1; ++i)
+    renderTick(portal);
+  assert(classic.pointCount() == count);
+  int blended = 0;
+  for (int i = 0; i < count; ++i)
+  {
+    assert(classic.pointPosition(i) == positions[i]);
+    if (!(midway[i] == before[i]) && !(midway[i] == classic.pointColor(i)))
+      blended++;
+  }
+  assert(blended > count / 2);
+  assert(samePattern(mock.buffer, portal.testGetEffectLeds()));
+
+  // Once faded, the colours hold still
+  memcpy(shown, mock.buffer, sizeof(shown));
+  for (int i = 0; i < 10; ++i)
+    renderTick(portal);
+  assert(samePattern(mock.buffer, shown));
+
+  // Virtual sequences keep their positions and black breaks too
+  ConfigManager::setPortalMode(1);
+  while (portal.serviceGeneration())
+    ;
+  const auto &sequence = portal.testSequencePattern(1);
+  count = sequence.pointCount();
+  for (int i = 0; i < count; ++i)
+  {
+    positions[i] = sequence.pointPosition(i);
+    before[i] = sequence.pointColor(i);
+  }
+  ConfigManager::setHueMin(ConfigManager::getHueMin() + 40);
+  for (int i = 0; i <= fadeTicks + 1; ++i)
+    renderTick(portal);
+  int recoloured = 0;
+  for (int i = 0; i < count; ++i)
+  {
+    assert(sequence.pointPosition(i) == positions[i]);
+    if (i % 3 != 0)
+      assert(sequence.pointColor(i) == CRGB(0, 0, 0));
+    else if (!(sequence.pointColor(i) == before[i]))
+      recoloured++;
+  }
+  assert(recoloured > count / 6);
+
+  std::cout << "Generation tests passed" << std::endl;
+  return 0;
+}
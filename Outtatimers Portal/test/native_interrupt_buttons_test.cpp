@@ -0,0 +1,149 @@
+// Interrupt-driven buttons: the edge ring (including a producer thread
+// racing the consumer), debouncing on edge times, and presses judged and
+// timestamped the same however late the loop gets to them
+#include <cassert>
+#include <iostream>
+#include <thread>
+#include <vector>
+#include "interrupt_buttons.h"
+
+static unsigned long simulated_us = 1000000;
+static int pinLevels[32];
+extern "C" unsigned long millis() { return simulated_us / 1000; }
+extern "C" unsigned long micros() { return simulated_us; }
+extern "C" int digitalRead(int pin) { return pinLevels[pin]; }
+extern "C" void pinMode(int, int) {}
+
+using EventType = IInputSource::EventType;
+
+// Edges of a press: a few bounces over 3 ms from @p atUs, settling at @p level
+static void bounce(InterruptButtonInputSource &buttons, uint8_t pin, int level, uint32_t atUs)
+{
+  for (int i = 0; i < 5; i++)
+    buttons.recordEdge(pin, i % 2 ? !level : level, atUs + i * 600);
+  pinLevels[pin] = level;
+}
+
+int main()
+{
+  // The ring: order, capacity, drops
+  {
+    EdgeRing<4> ring;
+    PinEdge edge;
+    assert(ring.empty() && !ring.pop(edge));
+    for (uint32_t i = 0; i < 6; i++)
+      ring.push({1, 0, i});
+    assert(ring.dropped() == 2);
+    for (uint32_t i = 0; i < 4; i++)
+      assert(ring.pop(edge) && edge.atUs == i);
+    assert(!ring.pop(edge) && ring.empty());
+    for (uint32_t i = 0; i < 70000; i++) // Indices wrap
+    {
+      assert(ring.push({2, 1, i}));
+      assert(ring.pop(edge) && edge.atUs == i);
+    }
+  }
+
+  // One thread pushing as an interrupt would, the other popping: edges come
+  // out in order, and every one is either popped or counted dropped
+  {
+    static EdgeRing<64> ring;
+    const uint32_t total = 2000000;
+    std::thread producer([&]
+                         {
+                           for (uint32_t i = 0; i < total; i++)
+                             ring.push({(uint8_t)i, (uint8_t)(i >> 8), i}); });
+    uint32_t popped = 0, last = 0;
+    PinEdge edge;
+    while (popped + ring.dropped() < total)
+    {
+      if (!ring.pop(edge))
+        continue;
+      assert(popped == 0 || edge.atUs > last);
+      assert(edge.pin == (uint8_t)edge.atUs && edge.level == (uint8_t)(edge.atUs >> 8));
+      last = edge.atUs;
+      popped++;
+    }
+    producer.join();
+    while (ring.pop(edge))
+      popped++;
+    assert(popped + ring.dropped() == total);
+  }
+
+  // Debouncing on edge times
+  {
+    EdgeDebounce db(50000, HIGH);
+    assert(!db.settle(0) && !db.settling());
+    db.edge(LOW, 1000);
+    db.edge(HIGH, 1400);
+    db.edge(LOW, 2000);
+    assert(db.settling() && !db.settle(51999));
+    assert(db.settle(52000) && db.getState() == LOW && db.changedAtUs() == 1000);
+    db.edge(HIGH, 100000); // A glitch: back within the interval
+    db.edge(LOW, 110000);
+    assert(!db.settle(500000) && db.getState() == LOW && !db.settling());
+    db.edge(HIGH, 0xFFFFFF00u); // Across the micros() wrap
+    assert(!db.settle(0xFFFFFF00u + 49999) && db.settle(0xFFFFFF00u + 50000) && db.getState() == HIGH);
+  }
+
+  const ButtonInputSource::ButtonConfig configs[] = {
+      {.pin = 14, .inputId = 1, .activeLow = true, .debounceMs = 50, .name = "Button1"},
+      {.pin = 12, .inputId = 2, .activeLow = true, .debounceMs = 50, .name = "Button2"},
+  };
+  pinLevels[14] = pinLevels[12] = HIGH;
+  InterruptButtonInputSource buttons(configs, 2);
+  buttons.begin();
+  assert(!buttons.busy() && !buttons.update(millis()));
+
+  // A press found by a loop pass 200 ms late is timed from its first edge
+  uint32_t pressedAt = (uint32_t)simulated_us + 5000;
+  bounce(buttons, 14, LOW, pressedAt);
+  simulated_us += 200000;
+  assert(buttons.busy() && buttons.update(millis()));
+  IInputSource::InputEvent event = buttons.getNextEvent();
+  assert(event.inputId == 1 && event.type == EventType::Pressed && event.timestamp == pressedAt / 1000);
+  assert(!buttons.hasEvents() && !buttons.busy());
+
+  // Not before the line has been quiet for the interval, however often polled
+  uint32_t releasedAt = (uint32_t)simulated_us;
+  bounce(buttons, 14, HIGH, releasedAt);
+  simulated_us = releasedAt + 2400 + 49000;
+  assert(!buttons.update(millis()) && buttons.busy());
+  simulated_us += 1000;
+  assert(buttons.update(millis()) && buttons.getNextEvent().type == EventType::Released);
+
+  // A glitch shorter than the interval is not a press; pins not configured are ignored
+  buttons.recordEdge(12, LOW, (uint32_t)simulated_us);
+  buttons.recordEdge(12, HIGH, (uint32_t)simulated_us + 8000);
+  buttons.recordEdge(5, LOW, (uint32_t)simulated_us);
+  simulated_us += 100000;
+  assert(!buttons.update(millis()) && !buttons.hasEvents() && !buttons.busy());
+
+  // A flood overflows the ring: the pins are read again
+  for (int i = 0; i < InterruptButtonInputSource::RING_SIZE + 10; i++)
+    buttons.recordEdge(12, i % 2 ? HIGH : LOW, (uint32_t)simulated_us + i * 10);
+  pinLevels[12] = LOW;
+  assert(buttons.droppedEdges() == 10);
+  simulated_us += 1000;
+  assert(!buttons.update(millis()));
+  simulated_us += 50000;
+  assert(buttons.update(millis()));
+  event = buttons.getNextEvent();
+  assert(event.inputId == 2 && event.type == EventType::Pressed);
+
+  // Through the input manager
+  {
+    InputManager manager;
+    manager.addInputSource(&buttons);
+    std::vector<InputManager::Command> run;
+    manager.setInputCallback([&](InputManager::Command command, const char *)
+                             { run.push_back(command); });
+    bounce(buttons, 14, LOW, (uint32_t)simulated_us);
+    simulated_us += 60000;
+    manager.update(millis());
+    assert(run.size() == 1 && run[0] == InputManager::Command::TogglePortal);
+  }
+
+  std::cout << "Interrupt button tests passed" << std::endl;
+  return 0;
+}
@@ -0,0 +1,83 @@
+#include <cassert>
+#include <iostream>
+#include "mock_led_driver.h"
+#include "motion.h"
+#include "../src/portal_effect.h"
+
+static unsigned long simulated_time = 0;
+extern "C" unsigned long millis() { return simulated_time; }
+
+constexpr int N = PortalConfig::Hardware::NUM_LEDS;
+using Portal = PortalEffectTemplate<N, PortalConfig::Effects::GRADIENT_STEP_DEFAULT, PortalConfig::Effects::GRADIENT_MOVE_DEFAULT>;
+
+// Render mode for durationMs at a fixed frame interval, leaving the last frame in driver
+static void renderAt(MockLEDDriver<N> &driver, int mode, unsigned long frameMs, unsigned long durationMs)
+{
+  srand(1);
+  Portal portal(&driver);
+  ConfigManager::setPortalMode(mode);
+  simulated_time = 1;
+  portal.begin();
+  portal.start();
+  // First frame at a common time: gradient generation seeds from millis()
+  portal.renderFrame(simulated_time);
+  unsigned long end = simulated_time + durationMs;
+  while (simulated_time < end)
+  {
+    simulated_time += frameMs;
+    portal.renderFrame(simulated_time);
+  }
+}
+
+int main()
+{
+  const unsigned long tick = PortalConfig::Timing::MOTION_TICK_MS;
+
+  // One position per tick is exactly 256 Q8 units per tick
+  RingMotion ring(100);
+  ring.advance(1, tick, tick);
+  assert(ring.positionQ8() == 256 && ring.whole() == 1 && ring.fraction() == 0);
+
+  // Distance is independent of how time is split into frames, including odd periods
+  RingMotion coarse(N), fine(N);
+  for (int i = 0; i < 30; ++i)
+    coarse.advance(3, 70, tick);
+  for (int i = 0; i < 2100; ++i)
+    fine.advance(3, 1, tick);
+  assert(coarse.positionQ8() == fine.positionQ8());
+  assert(coarse.positionQ8() == (3UL * 2100UL * 256UL / tick) % ((uint32_t)N << 8));
+
+  // Fractional steps accumulate between pixels instead of rounding away
+  RingMotion slow(N);
+  slow.advance(1, 5, tick);
+  assert(slow.whole() == 0 && slow.fraction() == 256 * 5 / tick);
+
+  // Backwards motion wraps below zero, and a full lap returns to the start
+  RingMotion back(10);
+  back.advance(-1, tick, tick);
+  assert(back.whole() == 9 && back.fraction() == 0);
+  back.advance(-10, tick, tick);
+  assert(back.whole() == 9);
+
+  // Speed 0 never moves
+  RingMotion still(N);
+  still.advance(0, 1000, tick);
+  assert(still.positionQ8() == 0);
+
+  // Whole effects: the frame at a given time does not depend on the frame rate
+  ConfigManager::begin();
+  ConfigManager::setRotationSpeed(3);
+  const unsigned long duration = PortalConfig::Timing::FADE_IN_DURATION_MS + 1000;
+  for (int mode = 0; mode <= 1; ++mode)
+  {
+    static MockLEDDriver<N> fast, slowDriver;
+    renderAt(fast, mode, 10, duration);
+    renderAt(slowDriver, mode, 40, duration);
+    for (int i = 0; i < N; ++i)
+      assert(fast.buffer[i] == slowDriver.buffer[i]);
+    assert(fast.brightness == slowDriver.brightness);
+  }
+
+  std::cout << "Motion tests passed" << std::endl;
+  return 0;
+}
@@ -0,0 +1,121 @@
+// Response writer: bodies are built in the caller's buffer without any
+// allocation, sent whole with their length if they fit and in pieces if not
+#include <cassert>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <new>
+#include "response_writer.h"
+
+static int allocations = 0;
+void *operator new(size_t size)
+{
+  allocations++;
+  void *p = malloc(size);
+  if (!p)
+    throw std::bad_alloc();
+  return p;
+}
+void operator delete(void *p) noexcept { free(p); }
+void operator delete(void *p, size_t) noexcept { free(p); }
+
+// Records the response in fixed storage, so the sink allocates nothing either
+class MockSink : public IResponseSink
+{
+public:
+  int code = 0;
+  const char *contentType = nullptr;
+  size_t length = 0;
+  int begins = 0, writes = 0, ends = 0;
+  size_t largestWrite = 0;
+  char body[1024];
+  size_t bodyLength = 0;
+
+  void begin(int c, const char *type, size_t n) override
+  {
+    assert(begins == 0 && writes == 0);
+    code = c;
+    contentType = type;
+    length = n;
+    begins++;
+  }
+  void write(const char *data, size_t n) override
+  {
+    assert(begins == 1 && ends == 0 && bodyLength + n < sizeof(body));
+    memcpy(body + bodyLength, data, n);
+    bodyLength += n;
+    body[bodyLength] = '\0';
+    largestWrite = n > largestWrite ? n : largestWrite;
+    writes++;
+  }
+  void end() override
+  {
+    assert(begins == 1);
+    ends++;
+  }
+};
+
+int main()
+{
+  char buffer[64];
+
+  // Text, flash text and numbers; sent once, with its length, at end()
+  {
+    MockSink sink;
+    ResponseWriter out(sink, buffer, sizeof(buffer), 404, "text/plain");
+    out.print(F("Speed ")).print(-42).print(' ').print(0).print(' ').print(4294967295UL).print(" of ").print(10U);
+    assert(sink.begins == 0);
+    out.end();
+    out.end();
+    assert(sink.code == 404 && strcmp(sink.contentType, "text/plain") == 0);
+    assert(strcmp(sink.body, "Speed -42 0 4294967295 of 10") == 0);
+    assert(sink.length == sink.bodyLength && sink.writes == 1 && sink.ends == 1);
+  }
+
+  // JSON: commas placed, strings escaped; the destructor ends the response
+  {
+    MockSink sink;
+    {
+      ResponseWriter out(sink, buffer, sizeof(buffer), 200, "application/json");
+      out.beginObject().field(F("current"), -1).key(F("presets")).beginArray();
+      out.beginObject().field(F("slot"), 2).field(F("name"), "Say \"hi\"\\\n").endObject();
+      out.beginObject().field(F("slot"), 5).endObject();
+      out.endArray().key(F("empty")).beginArray().endArray().endObject();
+    }
+    assert(sink.ends == 1);
+    assert(strcmp(sink.body, "{\"current\":-1,\"presets\":[{\"slot\":2,\"name\":\"Say \\\"hi\\\"\\\\\\u000a\"},"
+                             "{\"slot\":5}],\"empty\":[]}") == 0);
+    assert(sink.length == IResponseSink::UNKNOWN_LENGTH); // Longer than the buffer
+  }
+
+  // A body exactly the buffer's size still goes out whole
+  {
+    MockSink sink;
+    char exact[sizeof(buffer) + 1];
+    memset(exact, 'x', sizeof(buffer));
+    exact[sizeof(buffer)] = '\0';
+    ResponseWriter(sink, buffer, sizeof(buffer), 200, "text/plain").print(exact);
+    assert(sink.length == sizeof(buffer) && sink.writes == 1 && strcmp(sink.body, exact) == 0);
+  }
+
+  // A long body streams in buffer-sized pieces, with nothing allocated
+  {
+    MockSink sink;
+    int before = allocations;
+    {
+      ResponseWriter out(sink, buffer, sizeof(buffer), 200, "text/plain");
+      for (int i = 0; i < 100; i++)
+        out.print(F("line ")).print(i).print('\n');
+      assert(sink.begins == 1 && sink.writes > 0 && sink.ends == 0);
+    }
+    assert(allocations == before);
+    assert(sink.length == IResponseSink::UNKNOWN_LENGTH && sink.largestWrite <= sizeof(buffer) && sink.ends == 1);
+    assert(strncmp(sink.body, "line 0\nline 1\n", 14) == 0);
+    assert(strcmp(sink.body + sink.bodyLength - 8, "line 99\n") == 0);
+    size_t expected = 10 * 7 + 90 * 8;
+    assert(sink.bodyLength == expected);
+  }
+
+  std::cout << "Response writer tests passed" << std::endl;
+  return 0;
+}
@@ -0,0 +1,196 @@
+#include <cassert>
+#include <cstdlib>
+#include <iostream>
+#include "mock_led_driver.h"
+#include "../src/ring_buffer.h"
+
+constexpr int N = 97;          // Odd length so wrap points never line up with the buffer
+constexpr int MAX_POINTS = 40; // Room for the densest pattern below
+
+static CRGB reference[N]; // The pattern rasterised with plain fillGradient
+
+// Same driver points for every layout: random spacing, including 1-pixel segments
+template <typename Sink>
+static void feedPoints(Sink &sink, unsigned seed)
+{
+  srand(seed);
+  sink.beginPoints();
+  for (int pos = 0; pos < N; pos += 1 + rand() % 6)
+    sink.addPoint(pos, CRGB(rand() % 256, rand() % 256, rand() % 256));
+  sink.closePoints();
+}
+
+// Reference rotation: the per-pixel modulo the ring layouts replace
+static CRGB expected(int i, uint32_t offsetQ8)
+{
+  int j = (i + (int)(offsetQ8 >> 8)) % N;
+  return lerpPixel(reference[j], reference[(j + 1) % N], (uint8_t)(offsetQ8 & 0xFF));
+}
+
+// Compact layouts are checked against the reference as their pixels store it
+template <typename Ring>
+static void checkRing(Ring &ring, unsigned seed, bool rgb565 = false)
+{
+  GradientRasterizer raster(reference, N);
+  feedPoints(raster, seed);
+  if (rgb565)
+    for (int i = 0; i < N; ++i)
+      reference[i] = Rgb565(reference[i]).toCRGB();
+  feedPoints(ring, seed);
+
+  static MockLEDDriver<N> mock;
+  static CRGB rendered[N];
+  for (uint32_t offsetQ8 : {0u, 1u, 128u, 256u, 255u, (uint32_t)(N - 1) << 8, ((uint32_t)(N - 1) << 8) + 200, (uint32_t)N << 8, 5000u})
+  {
+    ring.blit(mock, offsetQ8);
+    ring.render(rendered, N, offsetQ8);
+    for (int i = 0; i < N; ++i)
+    {
+      assert(mock.buffer[i] == expected(i, offsetQ8));
+      assert(rendered[i] == mock.buffer[i]);
+    }
+
+    // Adding the ring rotated by half a lap onto itself saturates like CRGB +=
+    uint32_t other = offsetQ8 + ((uint32_t)N << 7);
+    ring.add(mock, other);
+    for (int i = 0; i < N; ++i)
+    {
+      CRGB sum = expected(i, offsetQ8);
+      sum += expected(i, other);
+      assert(mock.buffer[i] == sum);
+    }
+  }
+}
+
+// Recolouring keeps the driver positions: the ring matches one fed the new
+// colours at the same positions (as the layout stores them)
+template <PortalConfig::Effects::RingLayout Layout>
+static void checkRecolor()
+{
+  using Ring = typename EffectRing<N, Layout, MAX_POINTS>::type;
+  static Ring ring, fresh;
+  feedPoints(ring, 3);
+  int count = ring.pointCount();
+  assert(count > 10);
+  fresh.beginPoints();
+  for (int i = 0; i < count; ++i)
+  {
+    CRGB color((uint8_t)(i * 7), (uint8_t)(255 - i), 40);
+    if (Layout == PortalConfig::Effects::RingLayout::RGB565)
+      color = Rgb565(color).toCRGB();
+    ring.setPointColor(i, color);
+    assert(ring.pointColor(i) == color);
+    fresh.addPoint(ring.pointPosition(i), color);
+  }
+  ring.commitColors();
+  fresh.closePoints();
+  assert(ring.pointCount() == count);
+  for (int i = count - 1; i >= 0; --i) // Out of order too
+    assert(ring.pointPosition(i) == fresh.pointPosition(i));
+  static CRGB a[N], b[N];
+  ring.render(a, N, 300);
+  fresh.render(b, N, 300);
+  for (int i = 0; i < N; ++i)
+    assert(a[i] == b[i]);
+}
+
+int main()
+{
+  // Rasterizer segments end on the next driver's colour, and the ring closes on the first
+  CRGB line[10];
+  GradientRasterizer raster(line, 10);
+  raster.beginPoints();
+  raster.addPoint(0, CRGB(0, 0, 0));
+  raster.addPoint(5, CRGB(200, 100, 40));
+  assert(!raster.addPoint(5, CRGB(1, 1, 1))); // Positions must increase
+  raster.closePoints();
+  assert(line[0] == CRGB(0, 0, 0) && line[4] == CRGB(200, 100, 40) && line[5] == CRGB(200, 100, 40));
+  assert(line[7] == CRGB(100, 50, 20) && line[9] == CRGB(0, 0, 0));
+
+  // Mirrored window: any rotation is a contiguous run of N + 1 pixels
+  static MirroredRing<N> mirrored;
+  feedPoints(mirrored, 1);
+  for (int offset = 0; offset < N; ++offset)
+    for (int i = 0; i <= N; ++i)
+      assert(mirrored.window(offset)[i] == mirrored.data()[(offset + i) % N]);
+
+  // Every layout matches the modulo reference, whole and sub-pixel
+  static WrappedRing<N> wrapped;
+  static GradientRing<N, MAX_POINTS> procedural;
+  static Rgb565Ring<N> compact;
+  for (unsigned seed = 1; seed <= 20; ++seed)
+  {
+    checkRing(mirrored, seed);
+    checkRing(wrapped, seed);
+    checkRing(procedural, seed);
+    checkRing(compact, seed, true);
+  }
+
+  // Rgb565 keeps the extremes exact and every level within 4 (green: 2)
+  for (int v = 0; v < 256; ++v)
+  {
+    CRGB back = Rgb565(CRGB(v, v, v)).toCRGB();
+    assert(abs(back.r - v) <= 4 && abs(back.g - v) <= 2 && abs(back.b - v) <= 4);
+  }
+  assert(Rgb565(CRGB(255, 255, 255)).toCRGB() == CRGB(255, 255, 255));
+  assert(Rgb565(CRGB(0, 0, 0)).value == 0);
+
+  checkRecolor<PortalConfig::Effects::RingLayout::PROCEDURAL>();
+  checkRecolor<PortalConfig::Effects::RingLayout::MIRRORED>();
+  checkRecolor<PortalConfig::Effects::RingLayout::WRAPPED>();
+  checkRecolor<PortalConfig::Effects::RingLayout::RGB565>();
+
+  // A crossfade ends exactly on the new colours
+  static GradientRing<N, MAX_POINTS> faded;
+  feedPoints(faded, 4);
+  DriverCrossfade<MAX_POINTS> crossfade;
+  crossfade.begin(faded, [](int i)
+                  { return CRGB(255, (uint8_t)i, 0); });
+  CRGB start = faded.pointColor(1);
+  crossfade.apply(faded, 0);
+  assert(faded.pointColor(1) == start);
+  crossfade.apply(faded, 128);
+  assert(faded.pointColor(1) == lerpPixel(start, CRGB(255, 1, 0), 128));
+  crossfade.apply(faded, 255);
+  assert(faded.pointColor(1) == CRGB(255, 1, 0) && faded.pointColor(0) == CRGB(255, 0, 0));
+
+  // A full-length single segment and a ring with no points
+  GradientRing<N, MAX_POINTS> single;
+  single.beginPoints();
+  single.addPoint(0, CRGB(255, 0, 0));
+  single.closePoints();
+  assert(single.size() == 2);
+  static CRGB pixels[N];
+  single.render(pixels, N, 0);
+  for (int i = 0; i < N; ++i)
+    assert(pixels[i] == CRGB(255, 0, 0));
+  GradientRing<N, MAX_POINTS> empty;
+  empty.render(pixels, N, 300);
+  assert(pixels[0] == CRGB(0, 0, 0) && pixels[N - 1] == CRGB(0, 0, 0));
+
+  // Points beyond capacity are dropped, keeping room for the closing point
+  GradientRing<N, 4> small;
+  small.beginPoints();
+  for (int pos = 0; pos < 10; ++pos)
+    small.addPoint(pos, CRGB(pos, pos, pos));
+  small.closePoints();
+  assert(small.size() == 4);
+
+  // DriverPoints is bounded: pushes past capacity are refused, not written
+  DriverPoints<3> points;
+  assert(points.empty() && points.push(0, CRGB(1, 1, 1)) && points.push(700, CRGB(2, 2, 2)) && points.push(65535, CRGB(3, 3, 3)));
+  assert(points.full() && !points.push(1, CRGB(4, 4, 4)) && points.size() == 3);
+  assert(points.position(2) == 65535 && points.color(1) == CRGB(2, 2, 2));
+  points.clear();
+  assert(points.empty());
+
+  // Storage: driver points cost far less than a pixel array
+  constexpr int STRIP = PortalConfig::Hardware::NUM_LEDS;
+  static_assert(sizeof(GradientRing<STRIP, PortalConfig::Effects::MAX_DRIVER_POINTS>) * 2 < sizeof(WrappedRing<STRIP>),
+                "driver points take under half the pixel array");
+  static_assert(sizeof(Rgb565Ring<STRIP>) * 3 <= sizeof(WrappedRing<STRIP>) * 2 + 64,
+                "16-bit pixels take two thirds of the RGB array");
+
+  std::cout << "Ring buffer tests passed" << std::endl;
+  return 0;
+}
@@ -0,0 +1,74 @@
+// Stack high-water marks for generation and rendering on a full-size strip.
+// The ESP8266 Arduino loop() runs on a 4 KB stack shared with WiFi callbacks,
+// so per-pixel arrays on the stack (e.g. int driverIndices[NUM_LEDS]) must
+// never come back.
+#include <cassert>
+#include <iostream>
+#include "bench_harness.h"
+#include "mock_led_driver.h"
+#include "../src/portal_effect.h"
+
+static unsigned long simulated_time = 0;
+extern "C" unsigned long millis() { return simulated_time; }
+
+constexpr int N = PortalConfig::Hardware::NUM_LEDS;
+constexpr size_t STACK_BUDGET_BYTES = 1024; // Per call, unoptimised host build
+
+using Portal = PortalEffectTemplate<N, PortalConfig::Effects::GRADIENT_STEP_DEFAULT, PortalConfig::Effects::GRADIENT_MOVE_DEFAULT>;
+
+static MockLEDDriver<N> mock;
+static Portal *portal = nullptr;
+
+// Deepest stack use of one call, after a warm-up call so lazy symbol binding
+// in the host runtime is not counted
+template <typename F>
+static size_t stackOf(F fn)
+{
+  fn();
+  return Bench::measureStack(fn);
+}
+
+static void check(const char *name, size_t bytes)
+{
+  std::cout << name << ": " << bytes << " bytes" << std::endl;
+  assert(bytes < STACK_BUDGET_BYTES);
+}
+
+int main()
+{
+  ConfigManager::begin();
+  static Portal instance(&mock);
+  portal = &instance;
+
+  static CRGB pattern[N];
+  check("generatePortalEffect", stackOf([]
+                                           { portal->testGeneratePortalEffect(pattern); }));
+  check("generateVirtualGradients", stackOf([]
+                                            {
+    ConfigManager::setHueMin(ConfigManager::getHueMin() ^ 1);
+    portal->testGenerateVirtualGradients(); }));
+  check("serviceGeneration step", stackOf([]
+                                          {
+    ConfigManager::setHueMin(ConfigManager::getHueMin() ^ 1);
+    portal->serviceGeneration(); }));
+  static CRGB driverColors[PortalConfig::Effects::MAX_DRIVER_POINTS];
+  static DriverPoints<PortalConfig::Effects::MAX_DRIVER_POINTS> driverPoints;
+  check("generateDriverColors", stackOf([]
+                                        { int numDrivers; portal->generateDriverColors(driverColors, driverPoints, numDrivers); }));
+
+  const char *frameNames[] = {"classic frame", "virtual frame"};
+  for (int mode = 0; mode <= 1; ++mode)
+  {
+    ConfigManager::setPortalMode(mode);
+    ConfigManager::setRotationSpeed(2);
+    simulated_time = 1;
+    portal->stop();
+    portal->start();
+    check(frameNames[mode], stackOf([]
+                                    { simulated_time += PortalConfig::Timing::UPDATE_INTERVAL_MS;
+                                      portal->renderFrame(simulated_time); }));
+  }
+
+  std::cout << "Stack tests passed" << std::endl;
+  return 0;
+}
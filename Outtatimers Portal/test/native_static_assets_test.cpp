@@ -0,0 +1,55 @@
+// Web assets: gzipped files are found by request path and revalidations
+// are answered from their ETags
+#include <cassert>
+#include <cstring>
+#include <iostream>
+#include "static_assets.h"
+
+int main()
+{
+  StaticAssets assets;
+  assert(assets.add("/index.html.gz", 4465, 0x1234abcdUL));
+  assert(assets.add("/app.js.gz", 100, 7));
+  assert(!assets.add("/index.html", 10, 1) && !assets.add(".gz", 1, 1)); // Not gzipped
+  assert(!assets.add("/a-name-much-too-long-for-the-table.css.gz", 1, 1));
+  assert(assets.count() == 2);
+
+  // "/" is the index page; unknown paths are not assets
+  const StaticAssets::Asset *index = assets.find("/");
+  assert(index && strcmp(index->path, "/index.html") == 0 && index->size == 4465);
+  assert(assets.find("/index.html") == index);
+  assert(assets.find("/app.js")->etag == 7);
+  assert(!assets.find("/app.js.gz") && !assets.find("/status"));
+  char file[StaticAssets::PATH_LENGTH + 3];
+  assert(strcmp(StaticAssets::fileName(*index, file), "/index.html.gz") == 0);
+
+  // ETags are the quoted CRC, matched in any If-None-Match form
+  char etag[StaticAssets::ETAG_LENGTH];
+  assert(strcmp(StaticAssets::formatEtag(0x1234abcdUL, etag), "\"1234abcd\"") == 0);
+  assert(strcmp(StaticAssets::formatEtag(7, etag), "\"00000007\"") == 0);
+  assert(StaticAssets::etagMatches("\"1234abcd\"", 0x1234abcdUL));
+  assert(StaticAssets::etagMatches("W/\"1234abcd\"", 0x1234abcdUL));
+  assert(StaticAssets::etagMatches("\"00000001\", \"1234abcd\"", 0x1234abcdUL));
+  assert(StaticAssets::etagMatches("*", 5));
+  assert(!StaticAssets::etagMatches("", 0x1234abcdUL));
+  assert(!StaticAssets::etagMatches("\"1234abce\"", 0x1234abcdUL));
+  assert(!StaticAssets::etagMatches("\"1234abcd", 0x1234abcdUL));
+  assert(!StaticAssets::etagMatches("\"1234abcd\"x", 0x1234abcdUL));
+
+  assert(strcmp(StaticAssets::contentType("/index.html"), "text/html") == 0);
+  assert(strcmp(StaticAssets::contentType("/app.js"), "application/javascript") == 0);
+  assert(strcmp(StaticAssets::contentType("/data.bin"), "application/octet-stream") == 0);
+
+  // The table is bounded
+  StaticAssets full;
+  char name[16];
+  for (int i = 0; i < StaticAssets::MAX_ASSETS; i++)
+  {
+    snprintf(name, sizeof(name), "/%d.css.gz", i);
+    assert(full.add(name, 1, i));
+  }
+  assert(!full.add("/extra.css.gz", 1, 1) && full.count() == StaticAssets::MAX_ASSETS);
+
+  std::cout << "Static asset tests passed" << std::endl;
+  return 0;
+}
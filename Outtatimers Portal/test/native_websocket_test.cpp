@@ -0,0 +1,234 @@
+// WebSocket: the handshake and framing, and AsyncHttpServer's upgraded
+// connections, their messages, keepalive and limits
+#include <cassert>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "async_http_server.h"
+
+// Scripted transport, as in native_async_http_test
+class MockTransport : public ITcpTransport
+{
+public:
+  ITcpHandler *handler = nullptr;
+  std::string sent[AsyncHttpServer::MAX_CONNECTIONS];
+  size_t window[AsyncHttpServer::MAX_CONNECTIONS];
+  bool closed[AsyncHttpServer::MAX_CONNECTIONS] = {};
+  bool aborted[AsyncHttpServer::MAX_CONNECTIONS] = {};
+
+  MockTransport()
+  {
+    for (size_t &w : window)
+      w = 1 << 20;
+  }
+
+  bool begin(uint16_t, ITcpHandler *h) override
+  {
+    handler = h;
+    return true;
+  }
+  size_t write(int id, const char *data, size_t length) override
+  {
+    size_t n = length < window[id] ? length : window[id];
+    sent[id].append(data, n);
+    window[id] -= n;
+    return n;
+  }
+  void close(int id) override { closed[id] = true; }
+  void abort(int id) override { aborted[id] = true; }
+
+  void connect(int id)
+  {
+    sent[id].clear();
+    closed[id] = aborted[id] = false;
+    handler->onConnect(id);
+  }
+  void receive(int id, const std::string &data) { handler->onData(id, (const uint8_t *)data.data(), data.size()); }
+};
+
+class MockHandler : public IWebSocketHandler
+{
+public:
+  std::vector<std::string> messages;
+  int opens = 0, closes = 0;
+
+  void onOpen(int) override { opens++; }
+  void onMessage(int id, char *data, size_t length) override
+  {
+    assert(strlen(data) == length);
+    messages.push_back(std::to_string(id) + ":" + data);
+  }
+  void onClose(int) override { closes++; }
+};
+
+// A client frame: always masked
+static std::string clientFrame(uint8_t opcode, const std::string &payload, bool fin = true)
+{
+  static const uint8_t mask[4] = {0x37, 0xfa, 0x21, 0x3d};
+  std::string frame(1, (char)((fin ? 0x80 : 0) | opcode));
+  if (payload.size() < 126)
+    frame += (char)(0x80 | payload.size());
+  else
+  {
+    frame += (char)(0x80 | 126);
+    frame += (char)(payload.size() >> 8);
+    frame += (char)payload.size();
+  }
+  frame.append((const char *)mask, 4);
+  for (size_t i = 0; i < payload.size(); i++)
+    frame += (char)(payload[i] ^ mask[i & 3]);
+  return frame;
+}
+
+// A short server frame: opcode byte, length byte, payload
+static std::string serverFrame(uint8_t opcode, const std::string &payload)
+{
+  return std::string(1, (char)(0x80 | opcode)) + (char)payload.size() + payload;
+}
+
+static const char UPGRADE[] = "GET /ws HTTP/1.1\r\nHost: x\r\nUpgrade: websocket\r\nConnection: Upgrade\r\n"
+                              "Sec-WebSocket-Key: dGhlIHNhbXBsZSBub25jZQ==\r\nSec-WebSocket-Version: 13\r\n\r\n";
+
+int main()
+{
+  // RFC 6455's handshake example
+  char accept[WebSocket::ACCEPT_LENGTH];
+  assert(strcmp(WebSocket::acceptKey("dGhlIHNhbXBsZSBub25jZQ==", accept), "s3pPLMBiTxaQ9kYGzzhZRbK+xOo=") == 0);
+
+  // RFC 6455's masked "Hello", whole and in pieces
+  {
+    uint8_t hello[] = {0x81, 0x85, 0x37, 0xfa, 0x21, 0x3d, 0x7f, 0x9f, 0x4d, 0x51, 0x58};
+    WebSocket::Frame frame;
+    for (size_t n = 0; n < sizeof(hello); n++)
+      assert(WebSocket::parse(hello, n, 125, frame) == WebSocket::INCOMPLETE);
+    assert(WebSocket::parse(hello, sizeof(hello), 125, frame) == WebSocket::COMPLETE);
+    assert(frame.fin && frame.opcode == WebSocket::TEXT && frame.headerLength == 6 && frame.payloadLength == 5);
+    WebSocket::unmask(hello + 6, 5, frame.mask);
+    assert(memcmp(hello + 6, "Hello", 5) == 0);
+    assert(WebSocket::parse(hello, sizeof(hello), 4, frame) == WebSocket::TOO_BIG);
+
+    uint8_t unmasked[] = {0x81, 0x05, 'H', 'e', 'l', 'l', 'o'};
+    assert(WebSocket::parse(unmasked, sizeof(unmasked), 125, frame) == WebSocket::INVALID);
+    std::string longer = clientFrame(WebSocket::BINARY, std::string(300, 'x'));
+    assert(WebSocket::parse((const uint8_t *)longer.data(), longer.size(), 300, frame) == WebSocket::COMPLETE);
+    assert(frame.headerLength == 8 && frame.payloadLength == 300);
+
+    uint8_t header[WebSocket::MAX_HEADER];
+    assert(WebSocket::header(WebSocket::TEXT, 5, header) == 2 && header[0] == 0x81 && header[1] == 5);
+    assert(WebSocket::header(WebSocket::TEXT, 300, header) == 4 && header[1] == 126 && header[2] == 1 && header[3] == 44);
+  }
+
+  MockTransport tcp;
+  AsyncHttpServer server(&tcp);
+  MockHandler handler;
+  server.onWebSocket("/ws", &handler);
+  server.begin(80);
+  unsigned long now = 1000;
+
+  // The upgrade is answered 101 and the connection stays open
+  tcp.connect(0);
+  tcp.receive(0, UPGRADE);
+  server.service(now);
+  assert(tcp.sent[0].find("HTTP/1.1 101 Switching Protocols\r\nUpgrade: websocket\r\nConnection: Upgrade\r\n") == 0);
+  assert(tcp.sent[0].find("Sec-WebSocket-Accept: s3pPLMBiTxaQ9kYGzzhZRbK+xOo=\r\n\r\n") != std::string::npos);
+  assert(handler.opens == 1 && !tcp.closed[0] && server.webSocketClients() == 1);
+
+  // Anything else on the path is refused, as is a client over the limit
+  tcp.connect(1);
+  tcp.receive(1, "GET /ws HTTP/1.1\r\n\r\n");
+  tcp.connect(2);
+  tcp.receive(2, UPGRADE);
+  tcp.connect(3);
+  tcp.receive(3, UPGRADE);
+  server.service(now);
+  assert(tcp.sent[1].find("HTTP/1.1 426 Upgrade Required\r\n") == 0 && tcp.closed[1]);
+  assert(tcp.sent[2].find("HTTP/1.1 101") == 0);
+  assert(tcp.sent[3].find("HTTP/1.1 503") == 0 && tcp.closed[3]);
+  assert(server.webSocketClients() == PortalConfig::WiFi::WS_MAX_CLIENTS && handler.opens == 2);
+
+  // Messages are handed over from service(), whole, however they arrive
+  tcp.sent[0].clear();
+  std::string two = clientFrame(WebSocket::TEXT, "speed=5&hueMax=90") + clientFrame(WebSocket::TEXT, "cmd=toggle");
+  tcp.receive(0, two.substr(0, 9));
+  server.service(now);
+  assert(handler.messages.empty());
+  tcp.receive(0, two.substr(9));
+  assert(handler.messages.empty()); // Not from the transport's callback
+  server.service(now);
+  assert(handler.messages.size() == 2 && handler.messages[0] == "0:speed=5&hueMax=90" && handler.messages[1] == "0:cmd=toggle");
+
+  // Pings are answered with their payload
+  tcp.receive(0, clientFrame(WebSocket::PING, "hi"));
+  server.service(now);
+  assert(tcp.sent[0] == serverFrame(WebSocket::PONG, "hi"));
+
+  // Messages out: to one client, to all, or refused when a client's
+  // transmit buffer has no room, not waited for
+  tcp.sent[0].clear();
+  tcp.sent[2].clear();
+  assert(server.sendText(0, "one", 3) && !server.sendText(1, "one", 3));
+  assert(server.broadcastText("all", 3) == 0);
+  assert(tcp.sent[0] == serverFrame(WebSocket::TEXT, "one") + serverFrame(WebSocket::TEXT, "all"));
+  assert(tcp.sent[2] == serverFrame(WebSocket::TEXT, "all"));
+  tcp.window[2] = 0;
+  std::string large(AsyncHttpServer::TX_BUFFER / 2, 'x');
+  assert(server.broadcastText(large.data(), large.size()) == 0);
+  assert(server.broadcastText(large.data(), large.size()) == 1); // Client 2's buffer is full
+  tcp.window[2] = 1 << 20;
+  tcp.handler->onWritable(2);
+  assert(tcp.sent[2].size() == 5 + 4 + large.size());
+
+  // A ResponseWriter body becomes one message
+  {
+    char buffer[64];
+    tcp.sent[0].clear();
+    WebSocketSink sink(server, 0);
+    ResponseWriter(sink, buffer, sizeof(buffer), 200, "application/json").beginObject().field(F("fps"), 60).endObject();
+    assert(sink.missed() == 0 && tcp.sent[0] == serverFrame(WebSocket::TEXT, "{\"fps\":60}"));
+    WebSocketSink all(server);
+    {
+      ResponseWriter out(all, buffer, sizeof(buffer), 200, "application/json");
+      out.print(std::string(100, 'x').c_str()); // Outgrows the buffer
+    }
+    assert(all.missed() == 2);
+  }
+
+  // Quiet clients are pinged, then dropped
+  server.service(now + PortalConfig::WiFi::WS_PING_INTERVAL_MS);
+  tcp.sent[0].clear();
+  server.service(now + PortalConfig::WiFi::WS_PING_INTERVAL_MS + 1);
+  assert(tcp.sent[0] == serverFrame(WebSocket::PING, ""));
+  server.service(now + PortalConfig::WiFi::WS_PING_INTERVAL_MS + 2);
+  assert(tcp.sent[0] == serverFrame(WebSocket::PING, "")); // Only once
+  tcp.receive(2, clientFrame(WebSocket::PONG, ""));
+  server.service(now + 2 * PortalConfig::WiFi::WS_PING_INTERVAL_MS + 1);
+  assert(tcp.aborted[0] && !tcp.aborted[2] && handler.closes == 1 && server.webSocketClients() == 1);
+
+  // A client's close is echoed, then the connection is closed
+  tcp.sent[2].clear();
+  tcp.receive(2, clientFrame(WebSocket::CLOSE, std::string("\x03\xe8", 2)));
+  server.service(now + 2 * PortalConfig::WiFi::WS_PING_INTERVAL_MS + 2);
+  assert(tcp.sent[2] == serverFrame(WebSocket::CLOSE, std::string("\x03\xe8", 2)));
+  assert(tcp.closed[2] && handler.closes == 2 && server.activeConnections() == 0);
+
+  // Protocol errors close with a status: oversized, unmasked, fragmented
+  const std::string errors[][2] = {
+      {clientFrame(WebSocket::TEXT, std::string(PortalConfig::WiFi::WS_MESSAGE_MAX + 1, 'x')), "\x03\xf1"}, // 1009
+      {std::string("\x81\x02hi", 4), "\x03\xea"},                                                              // 1002
+      {clientFrame(WebSocket::TEXT, "part", false), "\x03\xeb"}};                                              // 1003
+  for (const std::string *error : errors)
+  {
+    tcp.connect(1);
+    tcp.receive(1, UPGRADE);
+    server.service(now);
+    tcp.sent[1].clear();
+    tcp.receive(1, error[0]);
+    server.service(now);
+    assert(tcp.sent[1] == serverFrame(WebSocket::CLOSE, error[1]) && tcp.closed[1]);
+  }
+  assert(handler.closes == 5 && handler.messages.size() == 2);
+
+  std::cout << "WebSocket tests passed" << std::endl;
+  return 0;
+}
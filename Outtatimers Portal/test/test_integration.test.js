@@ -46,23 +46,29 @@ class MockSystem {
   }
 }
 
+// Like ConfigManager, colorVersion moves on only when a value actually changes
 class MockConfigManager {
   constructor() {
     this.satMin = 128
     this.satMax = 255
-    this.effectNeedsRegeneration = false
+    this.colorVersion = 0
   }
 
-  setSatMin(value) {
+  assign(field, value) {
     const constrained = Math.max(0, Math.min(255, value))
-    this.satMin = isNaN(constrained) ? 0 : constrained
-    this.effectNeedsRegeneration = true
+    const next = isNaN(constrained) ? 0 : constrained
+    if (this[field] !== next) {
+      this[field] = next
+      this.colorVersion++
+    }
+  }
+
+  setSatMin(value) {
+    this.assign('satMin', value)
   }
 
   setSatMax(value) {
-    const constrained = Math.max(0, Math.min(255, value))
-    this.satMax = isNaN(constrained) ? 0 : constrained
-    this.effectNeedsRegeneration = true
+    this.assign('satMax', value)
   }
 
   getSatMin() {
@@ -71,11 +77,8 @@ class MockConfigManager {
   getSatMax() {
     return this.satMax
   }
-  needsEffectRegeneration() {
-    return this.effectNeedsRegeneration
-  }
-  clearEffectRegenerationFlag() {
-    this.effectNeedsRegeneration = false
+  snapshot() {
+    return { satMin: this.satMin, satMax: this.satMax, colorVersion: this.colorVersion }
   }
 }
 
@@ -203,6 +206,26 @@ function testDataConsistency() {
   console.log('✓ Data consistency test passed')
 }
 
+function testColorVersion() {
+  console.log('Testing Color Version...')
+
+  const config = new MockConfigManager()
+  const built = config.snapshot().colorVersion
+
+  // Setting the values already held leaves the patterns as built
+  config.setSatMin(128)
+  config.setSatMax(300)
+  assertEqual(config.snapshot().colorVersion, built)
+
+  // A real change moves the version once per value changed
+  config.setSatMin(100)
+  assertEqual(config.snapshot().colorVersion, built + 1)
+  config.setSatMax(200)
+  assertEqual(config.snapshot().colorVersion, built + 2)
+
+  console.log('✓ Color version test passed')
+}
+
 function testErrorHandlingIntegration() {
   console.log('Testing Error Handling Integration...')
 
@@ -257,12 +280,14 @@ function testEndToEndWorkflow() {
 try {
   testCompleteIntegrationFlow()
   testDataConsistency()
+  testColorVersion()
   testErrorHandlingIntegration()
   testEndToEndWorkflow()
 
   console.log('\n🎉 All Integration tests passed successfully!')
   console.log('✅ Complete Flow: PASSED')
   console.log('✅ Data Consistency: PASSED')
+  console.log('✅ Color Version: PASSED')
   console.log('✅ Error Handling: PASSED')
   console.log('✅ End-to-End Workflow: PASSED')
 } catch (error) {
@@ -43,12 +43,13 @@ int main()
   // Check gradient generation
   int numDrivers = 0;
   CRGB driverColors[N];
-  portal.generateDriverColors(driverColors, numDrivers);
+  DriverPoints<PortalConfig::Effects::MAX_DRIVER_POINTS> driverPoints;
+  portal.generateDriverColors(driverColors, driverPoints, numDrivers);
 
   for (int d = 0; d < numDrivers - 1; d++)
   {
-    int start = portal.testGetDriverIndex(d);
-    int end = portal.testGetDriverIndex(d + 1);
+    int start = driverPoints.position(d);
+    int end = driverPoints.position(d + 1);
     CRGB c1 = driverColors[d];
     CRGB c2 = driverColors[d + 1];
 
@@ -10,12 +10,13 @@
 
 const assert = require('assert')
 
-// Mock the ConfigManager for testing
+// Mock the ConfigManager for testing: colorVersion moves on only when a
+// value actually changes, and effects rebuild when it differs from theirs
 class MockConfigManager {
   constructor() {
     this.satMin = 128
     this.satMax = 255
-    this.effectNeedsRegeneration = false
+    this.colorVersion = 0
   }
 
   static getSatMin() {
@@ -26,22 +27,25 @@ class MockConfigManager {
     return MockConfigManager.instance.satMax
   }
 
-  static setSatMin(value) {
-    MockConfigManager.instance.satMin = Math.max(0, Math.min(255, value))
-    MockConfigManager.instance.effectNeedsRegeneration = true
+  static assign(field, value) {
+    const next = Math.max(0, Math.min(255, value))
+    if (MockConfigManager.instance[field] !== next) {
+      MockConfigManager.instance[field] = next
+      MockConfigManager.instance.colorVersion++
+    }
   }
 
-  static setSatMax(value) {
-    MockConfigManager.instance.satMax = Math.max(0, Math.min(255, value))
-    MockConfigManager.instance.effectNeedsRegeneration = true
+  static setSatMin(value) {
+    MockConfigManager.assign('satMin', value)
   }
 
-  static needsEffectRegeneration() {
-    return MockConfigManager.instance.effectNeedsRegeneration
+  static setSatMax(value) {
+    MockConfigManager.assign('satMax', value)
   }
 
-  static clearEffectRegenerationFlag() {
-    MockConfigManager.instance.effectNeedsRegeneration = false
+  static snapshot() {
+    const { satMin, satMax, colorVersion } = MockConfigManager.instance
+    return { satMin, satMax, colorVersion }
   }
 }
 
@@ -52,7 +56,6 @@ describe('Saturation Control System', () => {
     // Reset to default values before each test
     MockConfigManager.setSatMin(128)
     MockConfigManager.setSatMax(255)
-    MockConfigManager.clearEffectRegenerationFlag()
   })
 
   describe('ConfigManager Saturation Methods', () => {
@@ -88,17 +91,18 @@ describe('Saturation Control System', () => {
       assert.strictEqual(MockConfigManager.getSatMax(), 255)
     })
 
-    it('should set regeneration flag when saturation values change', () => {
-      assert.strictEqual(MockConfigManager.needsEffectRegeneration(), false)
+    it('should move the color version only when saturation values change', () => {
+      const built = MockConfigManager.snapshot().colorVersion
 
-      MockConfigManager.setSatMin(100)
-      assert.strictEqual(MockConfigManager.needsEffectRegeneration(), true)
+      MockConfigManager.setSatMin(128)
+      MockConfigManager.setSatMax(255)
+      assert.strictEqual(MockConfigManager.snapshot().colorVersion, built)
 
-      MockConfigManager.clearEffectRegenerationFlag()
-      assert.strictEqual(MockConfigManager.needsEffectRegeneration(), false)
+      MockConfigManager.setSatMin(100)
+      assert.strictEqual(MockConfigManager.snapshot().colorVersion, built + 1)
 
       MockConfigManager.setSatMax(200)
-      assert.strictEqual(MockConfigManager.needsEffectRegeneration(), true)
+      assert.strictEqual(MockConfigManager.snapshot().colorVersion, built + 2)
     })
 
     it('should handle edge cases correctly', () => {
@@ -163,6 +167,7 @@ describe('Saturation Control System', () => {
       // Simulate the complete flow: API -> ConfigManager -> Effect
       const apiMin = 100
       const apiMax = 220
+      let effectVersion = MockConfigManager.snapshot().colorVersion
 
       // API processing
       MockConfigManager.setSatMin(apiMin)
@@ -172,17 +177,15 @@ describe('Saturation Control System', () => {
       assert.strictEqual(MockConfigManager.getSatMin(), apiMin)
       assert.strictEqual(MockConfigManager.getSatMax(), apiMax)
 
-      // Verify regeneration flag is set
-      assert.strictEqual(MockConfigManager.needsEffectRegeneration(), true)
-
-      // Simulate effect regeneration
-      const needsUpdate = MockConfigManager.needsEffectRegeneration()
-      if (needsUpdate) {
-        // Effect would regenerate here using the new saturation values
-        MockConfigManager.clearEffectRegenerationFlag()
-      }
+      // The effect sees a new color version and rebuilds for it
+      const config = MockConfigManager.snapshot()
+      assert.notStrictEqual(config.colorVersion, effectVersion)
+      effectVersion = config.colorVersion
 
-      assert.strictEqual(MockConfigManager.needsEffectRegeneration(), false)
+      // Sending the same values again does not rebuild it
+      MockConfigManager.setSatMin(apiMin)
+      MockConfigManager.setSatMax(apiMax)
+      assert.strictEqual(MockConfigManager.snapshot().colorVersion, effectVersion)
     })
   })
 
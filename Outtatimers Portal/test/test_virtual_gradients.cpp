@@ -16,8 +16,8 @@ int main()
 
   portal.begin();
 
-  // Initially sequences should not be initialized
-  assert(!portal.testIsSequenceInitialized());
+  // begin() pre-generates the sequences
+  assert(portal.testIsSequenceInitialized());
 
   // Trigger generation
   portal.testGenerateVirtualGradients();
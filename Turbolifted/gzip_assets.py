@@ -0,0 +1,39 @@
+"""
+PlatformIO pre-build script: gzip the web assets for the LittleFS image.
+
+Every file under data/ is compressed into $BUILD_DIR/data_gz as <name>.gz,
+and the filesystem image (pio run -t buildfs / uploadfs) is built from
+there instead of data/. The device serves the .gz files as they are, with
+Content-Encoding: gzip (see StaticAssets in src/static_assets.h).
+
+Output is reproducible (no timestamp in the gzip header), so an unchanged
+asset keeps its ETag across uploads.
+"""
+
+import gzip
+import os
+import shutil
+
+Import("env")  # noqa: F821 - provided by PlatformIO
+
+
+def gzip_assets(source, target):
+    if os.path.isdir(target):
+        shutil.rmtree(target)
+    for root, _, files in os.walk(source):
+        for name in files:
+            path = os.path.join(root, name)
+            out = os.path.join(target, os.path.relpath(path, source) + ".gz")
+            os.makedirs(os.path.dirname(out), exist_ok=True)
+            with open(path, "rb") as f:
+                data = f.read()
+            with open(out, "wb") as f:
+                with gzip.GzipFile(filename="", mode="wb", fileobj=f, compresslevel=9, mtime=0) as gz:
+                    gz.write(data)
+            print("gzip_assets: %s %d -> %d bytes" % (name, len(data), os.path.getsize(out)))
+
+
+data_dir = env.subst("$PROJECT_DATA_DIR")  # noqa: F821
+gz_dir = os.path.join(env.subst("$BUILD_DIR"), "data_gz")  # noqa: F821
+gzip_assets(data_dir, gz_dir)
+env.Replace(PROJECT_DATA_DIR=gz_dir)  # noqa: F821
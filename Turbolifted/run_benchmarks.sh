@@ -0,0 +1,51 @@
+#!/bin/bash
+
+# Turbolift LED Controller Benchmark Runner
+# Builds the host benchmarks with the same -DUNIT_TEST path as run_tests.sh
+# and prints per-frame cost for each effect mode on a full-size strip, then
+# load-tests the HTTP server and streams realtime frames on loopback sockets.
+
+echo "⏱️  Running Turbolift LED Controller Benchmarks"
+echo "============================================"
+
+STATUS=0
+
+if ! (g++ -std=c++17 -O2 \
+    -DUNIT_TEST \
+    -I src \
+    -I test/mocks \
+    "test/bench_turbolift_effect.cpp" \
+    src/effects.cpp \
+    src/config_manager.cpp \
+    -o /tmp/bench_turbolift_effect && /tmp/bench_turbolift_effect); then
+    echo "❌ bench_turbolift_effect FAILED"
+    STATUS=1
+fi
+
+# HTTP server load test over loopback sockets (takes about six seconds:
+# it waits out the stalled clients' timeouts)
+if ! (g++ -std=c++17 -O2 \
+    -DUNIT_TEST \
+    -I src \
+    -I test/mocks \
+    "test/bench_http_load.cpp" \
+    -pthread \
+    -o /tmp/bench_http_load && /tmp/bench_http_load); then
+    echo "❌ bench_http_load FAILED"
+    STATUS=1
+fi
+
+# Realtime E1.31 input over a loopback UDP socket (takes about five seconds)
+if ! (g++ -std=c++17 -O2 \
+    -DUNIT_TEST \
+    -I src \
+    -I test/mocks \
+    "test/bench_realtime.cpp" \
+    src/config_manager.cpp \
+    -pthread \
+    -o /tmp/bench_realtime && /tmp/bench_realtime); then
+    echo "❌ bench_realtime FAILED"
+    STATUS=1
+fi
+
+exit $STATUS
@@ -1,5 +1,13 @@
 #include "config_manager.h"
 
+// Change versions; they start at 1 so work tagged 0 is always stale
+uint32_t ConfigManager::version = 1;
+uint32_t ConfigManager::colorVersion = 1;
+uint32_t ConfigManager::motionVersion = 1;
+uint32_t ConfigManager::brightnessVersion = 1;
+uint32_t ConfigManager::modeVersion = 1;
+uint32_t ConfigManager::liftVersion = 1;
+
 // Legacy gradient effect parameters
 int ConfigManager::rotationSpeed = 2;
 uint8_t ConfigManager::maxBrightness = 255;
@@ -7,7 +15,6 @@ uint8_t ConfigManager::hueMin = 160;
 uint8_t ConfigManager::hueMax = 200;
 uint8_t ConfigManager::satMin = 128;
 uint8_t ConfigManager::satMax = 255;
-bool ConfigManager::effectNeedsRegeneration = false;
 int ConfigManager::turboliftMode = 0;
 
 // New lift animation parameters
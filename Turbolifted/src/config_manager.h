@@ -4,6 +4,51 @@
 #include <Arduino.h>
 #include "config.h"
 
+/**
+ * @brief Immutable copy of every runtime parameter
+ *
+ * Taken once per frame (see FrameContext) so an effect reads consistent
+ * values however often it consults them. Each parameter group carries the
+ * value of the global version counter at its last change: comparing a
+ * group version with the one a piece of work was built from tells whether
+ * that work is stale, without a shared flag that one consumer could clear
+ * before another saw it.
+ */
+struct ConfigSnapshot
+{
+  uint32_t version;           // Bumped by every change; never decreases
+  uint32_t colorVersion;      // hueMin, hueMax, satMin, satMax
+  uint32_t motionVersion;     // rotationSpeed
+  uint32_t brightnessVersion; // maxBrightness
+  uint32_t modeVersion;       // effectMode, turboliftMode
+  uint32_t liftVersion;       // lift* (also the single colour)
+
+  int rotationSpeed;
+  uint8_t maxBrightness;
+  uint8_t hueMin;
+  uint8_t hueMax;
+  uint8_t satMin;
+  uint8_t satMax;
+  uint8_t effectMode;
+  int turboliftMode;
+
+  uint8_t liftSpeed;
+  uint8_t liftWidth;
+  uint8_t liftSpacing;
+  uint8_t liftHue;
+  uint8_t liftSaturation;
+  uint8_t liftBrightness;
+};
+
+/**
+ * @brief Per-frame inputs: the frame time and the configuration it renders
+ */
+struct FrameContext
+{
+  unsigned long now;
+  ConfigSnapshot config;
+};
+
 /**
  * @brief Configuration manager for runtime parameters
  *
@@ -26,7 +71,6 @@ public:
     satMin = 128;        // Default minimum saturation
     satMax = 255;        // Default maximum saturation
     turboliftMode = 0;   // Default to classic mode
-    effectNeedsRegeneration = false;
 
     // Initialize new lift animation parameters with defaults from config.h
     liftSpeed = TurboliftConfig::Effects::DEFAULT_SPEED;
@@ -36,6 +80,20 @@ public:
     liftSaturation = TurboliftConfig::Effects::DEFAULT_SATURATION;
     liftBrightness = TurboliftConfig::Effects::DEFAULT_BRIGHTNESS;
     effectMode = static_cast<uint8_t>(TurboliftConfig::Effects::EffectMode::SINGLE_COLOR);
+
+    // Everything may have changed: patterns built before begin() are stale
+    version++;
+    colorVersion = motionVersion = brightnessVersion = modeVersion = liftVersion = version;
+  }
+
+  /**
+   * @brief Copy the current configuration, with its versions
+   */
+  static ConfigSnapshot snapshot()
+  {
+    return {version, colorVersion, motionVersion, brightnessVersion, modeVersion, liftVersion,
+            rotationSpeed, maxBrightness, hueMin, hueMax, satMin, satMax, effectMode, turboliftMode,
+            liftSpeed, liftWidth, liftSpacing, liftHue, liftSaturation, liftBrightness};
   }
 
   // =====================================================
@@ -57,7 +115,7 @@ public:
    */
   static void setRotationSpeed(int speed)
   {
-    rotationSpeed = constrain(speed, 0, 10);
+    assign(rotationSpeed, constrain(speed, 0, 10), motionVersion);
   }
 
   /**
@@ -75,7 +133,7 @@ public:
    */
   static void setMaxBrightness(uint8_t brightness)
   {
-    maxBrightness = constrain(brightness, 0, 255);
+    assign(maxBrightness, brightness, brightnessVersion);
   }
 
   /**
@@ -93,8 +151,7 @@ public:
    */
   static void setHueMin(uint8_t minHue)
   {
-    hueMin = constrain(minHue, 0, 255);
-    effectNeedsRegeneration = true;
+    assign(hueMin, minHue, colorVersion);
   }
 
   /**
@@ -112,8 +169,7 @@ public:
    */
   static void setHueMax(uint8_t maxHue)
   {
-    hueMax = constrain(maxHue, 0, 255);
-    effectNeedsRegeneration = true;
+    assign(hueMax, maxHue, colorVersion);
   }
 
   /**
@@ -131,8 +187,7 @@ public:
    */
   static void setSatMin(uint8_t minSat)
   {
-    satMin = constrain(minSat, 0, 255);
-    effectNeedsRegeneration = true;
+    assign(satMin, minSat, colorVersion);
   }
 
   /**
@@ -150,25 +205,7 @@ public:
    */
   static void setSatMax(uint8_t maxSat)
   {
-    satMax = constrain(maxSat, 0, 255);
-    effectNeedsRegeneration = true;
-  }
-
-  /**
-   * @brief Check if effect regeneration is needed
-   * @return true if regeneration is required
-   */
-  static bool needsEffectRegeneration()
-  {
-    return effectNeedsRegeneration;
-  }
-
-  /**
-   * @brief Clear the effect regeneration flag
-   */
-  static void clearEffectRegenerationFlag()
-  {
-    effectNeedsRegeneration = false;
+    assign(satMax, maxSat, colorVersion);
   }
 
   /**
@@ -186,8 +223,7 @@ public:
    */
   static void setTurboliftMode(int mode)
   {
-    turboliftMode = constrain(mode, 0, 1);
-    effectNeedsRegeneration = true;
+    assign(turboliftMode, constrain(mode, 0, 1), modeVersion);
   }
 
   // =====================================================
@@ -209,7 +245,7 @@ public:
    */
   static void setLiftSpeed(uint8_t speed)
   {
-    liftSpeed = constrain(speed, 0, 10);
+    assign(liftSpeed, constrain(speed, 0, 10), liftVersion);
   }
 
   /**
@@ -227,7 +263,7 @@ public:
    */
   static void setLiftWidth(uint8_t width)
   {
-    liftWidth = constrain(width, 1, 20);
+    assign(liftWidth, constrain(width, 1, 20), liftVersion);
   }
 
   /**
@@ -245,7 +281,7 @@ public:
    */
   static void setLiftSpacing(uint8_t spacing)
   {
-    liftSpacing = constrain(spacing, 0, 50);
+    assign(liftSpacing, constrain(spacing, 0, 50), liftVersion);
   }
 
   /**
@@ -263,7 +299,7 @@ public:
    */
   static void setLiftHue(uint8_t hue)
   {
-    liftHue = hue;
+    assign(liftHue, hue, liftVersion);
   }
 
   /**
@@ -281,7 +317,7 @@ public:
    */
   static void setLiftSaturation(uint8_t saturation)
   {
-    liftSaturation = saturation;
+    assign(liftSaturation, saturation, liftVersion);
   }
 
   /**
@@ -299,12 +335,12 @@ public:
    */
   static void setLiftBrightness(uint8_t brightness)
   {
-    liftBrightness = constrain(brightness, 0, 255);
+    assign(liftBrightness, brightness, liftVersion);
   }
 
   /**
    * @brief Get the current effect mode
-   * @return Effect mode (0: single color, 1: lift animation, 2: classic, 3: virtual gradient)
+   * @return Effect mode (0: single color, 1: lift animation, 2: classic, 3: virtual gradient, 4: realtime)
    */
   static uint8_t getEffectMode()
   {
@@ -313,12 +349,11 @@ public:
 
   /**
    * @brief Set the current effect mode
-   * @param mode Effect mode (0: single color, 1: lift animation, 2: classic, 3: virtual gradient)
+   * @param mode Effect mode (0: single color, 1: lift animation, 2: classic, 3: virtual gradient, 4: realtime)
    */
   static void setEffectMode(uint8_t mode)
   {
-    effectMode = constrain(mode, 0, 3);
-    effectNeedsRegeneration = true;
+    assign(effectMode, constrain(mode, 0, 4), modeVersion);
   }
 
   /**
@@ -335,6 +370,24 @@ public:
   }
 
 private:
+  // Store a setting, bumping its group's version only when the value changes
+  template <typename T, typename V>
+  static void assign(T &field, V value, uint32_t &groupVersion)
+  {
+    if (field == (T)value)
+      return;
+    field = (T)value;
+    groupVersion = ++version;
+  }
+
+  // Change versions (see ConfigSnapshot)
+  static uint32_t version;
+  static uint32_t colorVersion;
+  static uint32_t motionVersion;
+  static uint32_t brightnessVersion;
+  static uint32_t modeVersion;
+  static uint32_t liftVersion;
+
   // Legacy gradient effect parameters
   static int rotationSpeed;
   static uint8_t maxBrightness;
@@ -342,7 +395,6 @@ private:
   static uint8_t hueMax;
   static uint8_t satMin;
   static uint8_t satMax;
-  static bool effectNeedsRegeneration;
   static int turboliftMode;
 
   // New lift animation parameters
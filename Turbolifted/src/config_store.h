@@ -0,0 +1,277 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include "config.h"
+#include "config_manager.h"
+#ifndef UNIT_TEST
+#include <LittleFS.h>
+#endif
+
+/**
+ * @brief Byte storage for the saved configuration blob
+ */
+class IConfigStorage
+{
+public:
+  /**
+   * @brief Read the stored blob
+   * @param data Destination, capacity bytes
+   * @return Bytes read (0 if there is none)
+   */
+  virtual size_t read(uint8_t *data, size_t capacity) = 0;
+  /**
+   * @brief Replace the stored blob
+   * @return true once the new blob is stored
+   */
+  virtual bool write(const uint8_t *data, size_t length) = 0;
+  virtual ~IConfigStorage() {}
+};
+
+#ifndef UNIT_TEST
+/**
+ * @brief Config blob in a LittleFS file
+ *
+ * Writes go to a temporary file that is then renamed over the blob, so a
+ * power cut mid-write leaves the previous settings readable. LittleFS is
+ * mounted on first use, which lets the blob be read before WiFi starts.
+ */
+class LittleFSConfigStorage : public IConfigStorage
+{
+public:
+  LittleFSConfigStorage(const char *path, const char *tempPath) : _path(path), _tempPath(tempPath), _mounted(false) {}
+
+  size_t read(uint8_t *data, size_t capacity) override
+  {
+    if (!mount())
+      return 0;
+    File file = LittleFS.open(_path, "r");
+    if (!file)
+      return 0;
+    size_t length = file.read(data, capacity);
+    file.close();
+    return length;
+  }
+
+  bool write(const uint8_t *data, size_t length) override
+  {
+    if (!mount())
+      return false;
+    File file = LittleFS.open(_tempPath, "w");
+    if (!file)
+      return false;
+    bool complete = file.write(data, length) == length;
+    file.close();
+    return complete && LittleFS.rename(_tempPath, _path);
+  }
+
+private:
+  const char *_path;
+  const char *_tempPath;
+  bool _mounted;
+
+  bool mount()
+  {
+    if (!_mounted)
+      _mounted = LittleFS.begin();
+    return _mounted;
+  }
+};
+#endif
+
+/**
+ * @brief Keeps ConfigManager settings across power cycles
+ *
+ * The settings are saved as one small binary blob: a header (magic,
+ * format version, payload length), one byte per parameter, and a CRC-32
+ * over both. load() applies a blob only if all of that checks out, and
+ * otherwise leaves the defaults from ConfigManager::begin().
+ *
+ * Saving is write-behind: service() notices a change through the config
+ * version and writes once nothing has changed for saveDelayMs, so a slider
+ * drag costs one flash write, not one per request. A blob identical to the
+ * one already stored is never rewritten.
+ *
+ * @example
+ * ```cpp
+ * LittleFSConfigStorage storage("/config.bin", "/config.tmp");
+ * ConfigStore store(&storage);
+ *
+ * void setup() {
+ *     ConfigManager::begin();
+ *     store.load(); // Before the first frame
+ * }
+ * void loop() {
+ *     store.service(millis()); // In idle time between frames
+ * }
+ * ```
+ */
+class ConfigStore
+{
+public:
+  static constexpr uint8_t MAGIC_0 = 'C';
+  static constexpr uint8_t MAGIC_1 = 'F';
+  static constexpr uint8_t FORMAT_VERSION = 1; // Bump when the payload changes
+  static constexpr size_t HEADER_SIZE = 4;
+  static constexpr size_t PAYLOAD_SIZE = 14;
+  static constexpr size_t CRC_SIZE = 4;
+  static constexpr size_t BLOB_SIZE = HEADER_SIZE + PAYLOAD_SIZE + CRC_SIZE;
+
+  explicit ConfigStore(IConfigStorage *storage, unsigned long saveDelayMs = TurboliftConfig::Timing::CONFIG_SAVE_DELAY_MS)
+      : _storage(storage), _saveDelayMs(saveDelayMs), _seenVersion(0), _changedAt(0), _dirty(false), _savedValid(false) {}
+
+  /**
+   * @brief Apply the stored settings to ConfigManager
+   * @return false if there is no valid blob (the current settings stay)
+   */
+  bool load()
+  {
+    uint8_t blob[BLOB_SIZE];
+    bool valid = _storage->read(blob, BLOB_SIZE) == BLOB_SIZE && decode(blob);
+    if (valid)
+    {
+      memcpy(_saved, blob, BLOB_SIZE);
+      _savedValid = true;
+    }
+    // Loading is not a change to save back
+    _seenVersion = ConfigManager::snapshot().version;
+    _dirty = false;
+    return valid;
+  }
+
+  /**
+   * @brief Save the settings once they have settled
+   * @param now Current millis()
+   * @return true if a blob was written
+   */
+  bool service(unsigned long now)
+  {
+    const ConfigSnapshot config = ConfigManager::snapshot();
+    if (config.version != _seenVersion)
+    {
+      _seenVersion = config.version;
+      _changedAt = now;
+      _dirty = true;
+      return false;
+    }
+    if (!_dirty || now - _changedAt < _saveDelayMs)
+      return false;
+
+    uint8_t blob[BLOB_SIZE];
+    encode(config, blob);
+    if (_savedValid && memcmp(blob, _saved, BLOB_SIZE) == 0)
+    {
+      _dirty = false; // Changed back to what flash holds
+      return false;
+    }
+    if (!_storage->write(blob, BLOB_SIZE))
+    {
+      _changedAt = now; // Try again after another delay
+      return false;
+    }
+    memcpy(_saved, blob, BLOB_SIZE);
+    _savedValid = true;
+    _dirty = false;
+    return true;
+  }
+
+  /**
+   * @brief True while a change is waiting to be saved
+   */
+  bool dirty() const
+  {
+    return _dirty;
+  }
+
+  static void encode(const ConfigSnapshot &config, uint8_t *blob)
+  {
+    blob[0] = MAGIC_0;
+    blob[1] = MAGIC_1;
+    blob[2] = FORMAT_VERSION;
+    blob[3] = PAYLOAD_SIZE;
+    uint8_t *p = blob + HEADER_SIZE;
+    *p++ = (uint8_t)config.rotationSpeed;
+    *p++ = config.maxBrightness;
+    *p++ = config.hueMin;
+    *p++ = config.hueMax;
+    *p++ = config.satMin;
+    *p++ = config.satMax;
+    *p++ = (uint8_t)config.turboliftMode;
+    *p++ = config.effectMode;
+    *p++ = config.liftSpeed;
+    *p++ = config.liftWidth;
+    *p++ = config.liftSpacing;
+    *p++ = config.liftHue;
+    *p++ = config.liftSaturation;
+    *p++ = config.liftBrightness;
+    uint32_t crc = crc32(blob, HEADER_SIZE + PAYLOAD_SIZE);
+    for (size_t i = 0; i < CRC_SIZE; i++)
+      p[i] = (uint8_t)(crc >> (8 * i));
+  }
+
+  /**
+   * @brief True if @p blob has this format and an intact CRC
+   */
+  static bool valid(const uint8_t *blob)
+  {
+    if (blob[0] != MAGIC_0 || blob[1] != MAGIC_1 || blob[2] != FORMAT_VERSION || blob[3] != PAYLOAD_SIZE)
+      return false;
+    uint32_t crc = 0;
+    for (size_t i = 0; i < CRC_SIZE; i++)
+      crc |= (uint32_t)blob[HEADER_SIZE + PAYLOAD_SIZE + i] << (8 * i);
+    return crc == crc32(blob, HEADER_SIZE + PAYLOAD_SIZE);
+  }
+
+  /**
+   * @brief Check a blob and apply it through the ConfigManager setters
+   * @return false (nothing applied) if the blob is not valid
+   */
+  static bool decode(const uint8_t *blob)
+  {
+    if (!valid(blob))
+      return false;
+
+    const uint8_t *p = blob + HEADER_SIZE;
+    ConfigManager::setRotationSpeed(*p++);
+    ConfigManager::setMaxBrightness(*p++);
+    ConfigManager::setHueMin(*p++);
+    ConfigManager::setHueMax(*p++);
+    ConfigManager::setSatMin(*p++);
+    ConfigManager::setSatMax(*p++);
+    ConfigManager::setTurboliftMode(*p++);
+    ConfigManager::setEffectMode(*p++);
+    ConfigManager::setLiftSpeed(*p++);
+    ConfigManager::setLiftWidth(*p++);
+    ConfigManager::setLiftSpacing(*p++);
+    ConfigManager::setLiftHue(*p++);
+    ConfigManager::setLiftSaturation(*p++);
+    ConfigManager::setLiftBrightness(*p++);
+    return true;
+  }
+
+  /**
+   * @brief CRC-32 (IEEE 802.3, as zlib), bitwise: the blob is a few bytes
+   * @param crc Result for the preceding bytes, to checksum data in pieces
+   */
+  static uint32_t crc32(const uint8_t *data, size_t length, uint32_t crc = 0)
+  {
+    crc = ~crc;
+    for (size_t i = 0; i < length; i++)
+    {
+      crc ^= data[i];
+      for (int bit = 0; bit < 8; bit++)
+        crc = (crc >> 1) ^ (0xEDB88320UL & (0UL - (crc & 1)));
+    }
+    return ~crc;
+  }
+
+private:
+  IConfigStorage *_storage;
+  unsigned long _saveDelayMs;
+  uint32_t _seenVersion;     // Config version service() last saw
+  unsigned long _changedAt;  // When that version was first seen
+  bool _dirty;
+  uint8_t _saved[BLOB_SIZE]; // Blob known to be in storage
+  bool _savedValid;
+};
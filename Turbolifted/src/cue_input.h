@@ -0,0 +1,323 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include "config.h"
+#include "input_manager.h"
+#include "latency_histogram.h"
+#ifndef UNIT_TEST
+#include <Arduino.h>
+#include <WiFiUdp.h>
+#else
+extern "C" unsigned long micros();
+#endif
+
+/**
+ * @brief Datagrams from cue senders, and replies to them
+ */
+class ICueLink
+{
+public:
+  virtual ~ICueLink() = default;
+  virtual bool begin(uint16_t port) = 0;
+
+  /**
+   * @brief Copy the next datagram into @p data
+   * @return Its length (at most @p length), 0 if nothing is waiting
+   */
+  virtual size_t receive(uint8_t *data, size_t length) = 0;
+
+  /**
+   * @brief Send @p data to whoever sent the datagram last received
+   */
+  virtual bool reply(const uint8_t *data, size_t length) = 0;
+};
+
+/**
+ * @brief Show commands over UDP, timed from receipt to the LEDs
+ *
+ * An HTTP request for /malfunction waits for a TCP connection and the web
+ * server's turn in the loop; a cue is one datagram, read every loop pass.
+ * Each carries an InputManager::Command and a sequence number. A cue whose
+ * number is up to Cues::DUPLICATE_WINDOW behind the last one (a resend
+ * after a lost ack) is not run again; anything further behind is taken as
+ * a restarted sender. If asked, every cue is acknowledged at once, before
+ * it runs, with what became of it.
+ *
+ * Every cue is timed with micros(): read from the socket, handed to the
+ * input manager, and the first frame transmitted after that (shown()).
+ * dispatchLatency() and showLatency() hold the spans from the read; a cue
+ * with no frame within Cues::SHOW_TIMEOUT_MS (fading out when already
+ * dark) is counted unshown instead.
+ *
+ * Cue and ack, 8 bytes, big-endian:
+ *   0  "CU"
+ *   2  version (1)
+ *   3  type (1: cue, 2: ack)
+ *   4  command (InputManager::Command)
+ *   5  cue: flags (bit 0: ack requested); ack: Status
+ *   6  sequence number
+ *
+ * @example
+ * ```cpp
+ * CueInputSource cues(&link);
+ * cues.begin();
+ * inputManager.addInputSource(&cues);
+ * // After each frame that transmitted:
+ * cues.shown(micros());
+ * ```
+ */
+class CueInputSource : public IInputSource
+{
+public:
+  static constexpr size_t PACKET_SIZE = 8;
+  static constexpr uint8_t VERSION = 1;
+  static constexpr uint8_t CUE = 1;
+  static constexpr uint8_t ACK = 2;
+  static constexpr uint8_t ACK_REQUESTED = 0x01;
+
+  enum class Status : uint8_t
+  {
+    Queued = 0,    ///< Will run
+    Duplicate = 1, ///< Already had; not run again
+    Unknown = 2,   ///< Not a command
+    Busy = 3,      ///< Queue full; not run
+  };
+
+  struct Cue
+  {
+    uint8_t command;
+    uint8_t flags; // Cue: ACK_REQUESTED; ack: Status
+    uint16_t sequence;
+  };
+
+  struct Stats
+  {
+    uint32_t received; // Queued to run
+    uint32_t duplicates;
+    uint32_t unknown;
+    uint32_t busy;
+    uint32_t invalid; // Not a cue
+    uint32_t acks;
+    uint32_t unshown; // Ran, but no frame followed in time
+  };
+
+  explicit CueInputSource(ICueLink *link)
+      : _link(link), _head(0), _tail(0), _awaitingCount(0), _haveLast(false), _last(0), _frameRequested(false),
+        _stats() {}
+
+  bool begin() { return _link->begin(TurboliftConfig::Cues::PORT); }
+
+  const Stats &stats() const { return _stats; }
+  const LatencyHistogram &dispatchLatency() const { return _dispatch; }
+  const LatencyHistogram &showLatency() const { return _show; }
+
+  void resetLatency()
+  {
+    _dispatch.reset();
+    _show.reset();
+  }
+
+  static size_t encode(uint8_t type, const Cue &cue, uint8_t *out)
+  {
+    out[0] = 'C';
+    out[1] = 'U';
+    out[2] = VERSION;
+    out[3] = type;
+    out[4] = cue.command;
+    out[5] = cue.flags;
+    out[6] = (uint8_t)(cue.sequence >> 8);
+    out[7] = (uint8_t)cue.sequence;
+    return PACKET_SIZE;
+  }
+
+  static bool decode(const uint8_t *data, size_t length, uint8_t type, Cue &cue)
+  {
+    if (length != PACKET_SIZE || data[0] != 'C' || data[1] != 'U' || data[2] != VERSION || data[3] != type)
+      return false;
+    cue.command = data[4];
+    cue.flags = data[5];
+    cue.sequence = (uint16_t)(data[6] << 8 | data[7]);
+    return true;
+  }
+
+  /**
+   * @brief A frame was transmitted: cues run before it are now on the LEDs
+   * @param nowUs micros() after the transmit
+   */
+  void shown(unsigned long nowUs)
+  {
+    for (int i = 0; i < _awaitingCount; i++)
+      _show.record((uint32_t)(nowUs - _awaitingShow[i]));
+    _awaitingCount = 0;
+  }
+
+  /**
+   * @brief true once after a cue has run, so the next frame need not wait its turn
+   */
+  bool takeFrameRequest()
+  {
+    bool requested = _frameRequested;
+    _frameRequested = false;
+    return requested;
+  }
+
+  // ---- IInputSource ----
+
+  bool update(unsigned long) override
+  {
+    uint8_t packet[PACKET_SIZE + 1]; // One over, so longer datagrams fail to decode
+    for (int budget = TurboliftConfig::Cues::MAX_PACKETS_PER_UPDATE; budget > 0; budget--)
+    {
+      size_t length = _link->receive(packet, sizeof(packet));
+      if (length == 0)
+        break;
+      handle(packet, length, micros());
+    }
+    expireUnshown(micros());
+    return hasEvents();
+  }
+
+  bool hasEvents() const override { return _head != _tail; }
+
+  InputEvent getNextEvent() override
+  {
+    if (!hasEvents())
+      return {0, EventType::Released, 0, "none"};
+    Queued &queued = _queue[_head];
+    _head = (_head + 1) % QUEUE_SLOTS;
+
+    // The input manager runs the command as soon as this returns
+    unsigned long nowUs = micros();
+    _dispatch.record((uint32_t)(nowUs - queued.receivedUs));
+    if (_awaitingCount < TurboliftConfig::Cues::QUEUE)
+      _awaitingShow[_awaitingCount++] = queued.receivedUs;
+    else
+      _stats.unshown++;
+    _frameRequested = true;
+    return {queued.command, EventType::Pressed, queued.receivedUs / 1000, "UdpCue"};
+  }
+
+  const char *getSourceName() const override { return "UdpCue"; }
+
+private:
+  static constexpr int QUEUE_SLOTS = TurboliftConfig::Cues::QUEUE + 1; // One slot left empty
+
+  struct Queued
+  {
+    uint8_t command;
+    unsigned long receivedUs;
+  };
+
+  ICueLink *_link;
+  Queued _queue[QUEUE_SLOTS];
+  int _head;
+  int _tail;
+  unsigned long _awaitingShow[TurboliftConfig::Cues::QUEUE]; // Receipt times of cues run but not yet shown
+  int _awaitingCount;
+  bool _haveLast;
+  uint16_t _last;
+  bool _frameRequested;
+  Stats _stats;
+  LatencyHistogram _dispatch;
+  LatencyHistogram _show;
+
+  static bool isCommand(uint8_t command)
+  {
+    return command >= (uint8_t)InputManager::Command::ToggleTurbolift &&
+           command <= (uint8_t)InputManager::Command::NextPreset;
+  }
+
+  // A resend: the last sequence number or a little behind it
+  bool duplicate(uint16_t sequence) const
+  {
+    int16_t ahead = (int16_t)(sequence - _last);
+    return _haveLast && ahead <= 0 && ahead > -TurboliftConfig::Cues::DUPLICATE_WINDOW;
+  }
+
+  void handle(const uint8_t *packet, size_t length, unsigned long receivedUs)
+  {
+    Cue cue;
+    if (!decode(packet, length, CUE, cue))
+    {
+      _stats.invalid++;
+      return;
+    }
+    Status status = Status::Queued;
+    int nextTail = (_tail + 1) % QUEUE_SLOTS;
+    if (!isCommand(cue.command))
+    {
+      status = Status::Unknown;
+      _stats.unknown++;
+    }
+    else if (duplicate(cue.sequence))
+    {
+      status = Status::Duplicate;
+      _stats.duplicates++;
+    }
+    else if (nextTail == _head)
+    {
+      status = Status::Busy; // Not remembered, so a resend can still run
+      _stats.busy++;
+    }
+    else
+    {
+      _queue[_tail] = {cue.command, receivedUs};
+      _tail = nextTail;
+      _haveLast = true;
+      _last = cue.sequence;
+      _stats.received++;
+    }
+    if (cue.flags & ACK_REQUESTED)
+    {
+      uint8_t ack[PACKET_SIZE];
+      encode(ACK, {cue.command, (uint8_t)status, cue.sequence}, ack);
+      if (_link->reply(ack, sizeof(ack)))
+        _stats.acks++;
+    }
+  }
+
+  void expireUnshown(unsigned long nowUs)
+  {
+    int kept = 0;
+    for (int i = 0; i < _awaitingCount; i++)
+    {
+      if (nowUs - _awaitingShow[i] >= TurboliftConfig::Cues::SHOW_TIMEOUT_MS * 1000UL)
+        _stats.unshown++;
+      else
+        _awaitingShow[kept++] = _awaitingShow[i];
+    }
+    _awaitingCount = kept;
+  }
+};
+
+#ifndef UNIT_TEST
+/**
+ * @brief ICueLink on WiFiUDP
+ */
+class WiFiCueLink : public ICueLink
+{
+public:
+  bool begin(uint16_t port) override { return _udp.begin(port) == 1; }
+
+  size_t receive(uint8_t *data, size_t length) override
+  {
+    if (_udp.parsePacket() <= 0)
+      return 0;
+    int n = _udp.read(data, length);
+    return n > 0 ? (size_t)n : 0;
+  }
+
+  bool reply(const uint8_t *data, size_t length) override
+  {
+    if (!_udp.beginPacket(_udp.remoteIP(), _udp.remotePort()))
+      return false;
+    _udp.write(data, length);
+    return _udp.endPacket() == 1;
+  }
+
+private:
+  WiFiUDP _udp;
+};
+#endif
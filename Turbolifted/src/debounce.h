@@ -85,3 +85,87 @@ private:
   int _stableState;            ///< Current stable state
   int _lastRead;               ///< Last raw reading
 };
+
+/**
+ * @brief Debounces a pin from the times of its edges rather than from samples
+ *
+ * Debounce only sees the pin when the loop samples it, so a slow loop pass
+ * stretches the interval and a glitch between two samples can go unseen or
+ * be taken for a press. EdgeDebounce is fed every edge with the time its
+ * interrupt saw it (see EdgeRing): the level is stable once no edge has
+ * come for the interval, judged from those times however late settle() is
+ * called. changedAtUs() gives the first edge of the burst that led to the
+ * new level, i.e. when the button was actually pressed or released.
+ * Times are micros(), compared wrap-safely.
+ *
+ * @example
+ * ```cpp
+ * EdgeDebounce button(50000, HIGH);
+ * while (edges.pop(edge))
+ *   button.edge(edge.level, edge.atUs);
+ * if (button.settle(micros()))
+ *   handle(button.getState(), button.changedAtUs());
+ * ```
+ */
+class EdgeDebounce
+{
+public:
+  /**
+   * @param intervalUs Time without edges after which the level is stable
+   * @param level Level to start from
+   */
+  explicit EdgeDebounce(uint32_t intervalUs = TurboliftConfig::Timing::DEBOUNCE_INTERVAL_MS * 1000UL, int level = HIGH)
+      : _intervalUs(intervalUs), _lastEdgeUs(0), _burstStartUs(0), _changedAtUs(0), _stableState(level),
+        _lastRead(level), _settling(false) {}
+
+  /**
+   * @brief An edge: the pin read @p level at @p atUs
+   */
+  void edge(int level, uint32_t atUs)
+  {
+    if (!_settling)
+    {
+      _burstStartUs = atUs;
+      _settling = true;
+    }
+    _lastRead = level;
+    _lastEdgeUs = atUs;
+  }
+
+  /**
+   * @brief Settle the level if no edge has come for the interval before @p nowUs
+   * @return true if the stable level changed
+   */
+  bool settle(uint32_t nowUs)
+  {
+    if (!_settling || nowUs - _lastEdgeUs < _intervalUs)
+      return false;
+    _settling = false;
+    if (_lastRead == _stableState)
+      return false; // A glitch: back where it started
+    _stableState = _lastRead;
+    _changedAtUs = _burstStartUs;
+    return true;
+  }
+
+  /**
+   * @brief true while edges have come within the interval
+   */
+  bool settling() const { return _settling; }
+
+  int getState() const { return _stableState; }
+
+  /**
+   * @brief Time of the first edge of the last stable change
+   */
+  uint32_t changedAtUs() const { return _changedAtUs; }
+
+private:
+  uint32_t _intervalUs;
+  uint32_t _lastEdgeUs;
+  uint32_t _burstStartUs; ///< First edge since the level was last stable
+  uint32_t _changedAtUs;
+  int _stableState;
+  int _lastRead;
+  bool _settling;
+};
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <stdint.h>
+#include <atomic>
+
+#ifndef IRAM_ATTR
+#define IRAM_ATTR // Host builds: no instruction RAM
+#endif
+
+/**
+ * @brief A pin level change, as seen by its interrupt
+ */
+struct PinEdge
+{
+  uint8_t pin;
+  uint8_t level; // Level read in the interrupt, after the edge
+  uint32_t atUs; // micros() in the interrupt
+};
+
+/**
+ * @brief Lock-free single-producer, single-consumer queue of pin edges
+ *
+ * The GPIO interrupt pushes, the loop pops. Each index is written by one
+ * side only (tail by push(), head by pop()) and published with release
+ * ordering after the slot it covers, so neither side ever waits or
+ * disables interrupts. When the loop falls behind and the ring fills, new
+ * edges are dropped and counted; the consumer sees dropped() change and
+ * reads the pins afresh instead of trusting the queue.
+ *
+ * @tparam Capacity Slots; a power of two, at most 32768
+ *
+ * @example
+ * ```cpp
+ * static EdgeRing<32> edges;
+ * void IRAM_ATTR onEdge() { edges.push({PIN, (uint8_t)digitalRead(PIN), (uint32_t)micros()}); }
+ * // loop():
+ * PinEdge edge;
+ * while (edges.pop(edge))
+ *   debouncer.edge(edge.level, edge.atUs);
+ * ```
+ */
+template <int Capacity>
+class EdgeRing
+{
+  static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0 && Capacity <= 32768,
+                "EdgeRing capacity must be a power of two up to 32768");
+
+public:
+  EdgeRing() : _head(0), _tail(0), _dropped(0) {}
+
+  /**
+   * @brief Producer side: queue @p edge, or count it dropped if full
+   */
+  IRAM_ATTR bool push(const PinEdge &edge)
+  {
+    uint16_t tail = _tail.load(std::memory_order_relaxed);
+    if ((uint16_t)(tail - _head.load(std::memory_order_acquire)) >= Capacity)
+    {
+      _dropped.store(_dropped.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+      return false;
+    }
+    _edges[tail & MASK] = edge;
+    _tail.store((uint16_t)(tail + 1), std::memory_order_release);
+    return true;
+  }
+
+  /**
+   * @brief Consumer side: take the oldest edge
+   * @return false if the ring is empty
+   */
+  bool pop(PinEdge &edge)
+  {
+    uint16_t head = _head.load(std::memory_order_relaxed);
+    if (head == _tail.load(std::memory_order_acquire))
+      return false;
+    edge = _edges[head & MASK];
+    _head.store((uint16_t)(head + 1), std::memory_order_release);
+    return true;
+  }
+
+  bool empty() const { return _head.load(std::memory_order_relaxed) == _tail.load(std::memory_order_acquire); }
+
+  /**
+   * @brief Edges dropped on a full ring since construction (wraps)
+   */
+  uint32_t dropped() const { return _dropped.load(std::memory_order_acquire); }
+
+private:
+  static constexpr uint16_t MASK = Capacity - 1;
+
+  // Free-running 16-bit indices: their difference is the fill level
+  std::atomic<uint16_t> _head;
+  std::atomic<uint16_t> _tail;
+  std::atomic<uint32_t> _dropped;
+  PinEdge _edges[Capacity];
+};
@@ -1,5 +1,6 @@
 #include "effects.h"
 #include "config.h"
+#include "color_math.h"
 #include <algorithm>
 
 bool getLEDPosition(int ledIndex, int numLeds, float radius, float &x, float &y)
@@ -29,9 +30,5 @@ CRGB interpolateColor(const CRGB &c1, const CRGB &c2, float ratio)
 {
   // Clamp ratio to valid range using standard library
   ratio = std::clamp(ratio, 0.0f, 1.0f);
-
-  uint8_t r = (uint8_t)(c1.r + (c2.r - c1.r) * ratio);
-  uint8_t g = (uint8_t)(c1.g + (c2.g - c1.g) * ratio);
-  uint8_t b = (uint8_t)(c1.b + (c2.b - c1.b) * ratio);
-  return CRGB(r, g, b);
+  return ColorMath::lerpColor(c1, c2, (ColorMath::q16_t)(ratio * 65536.0f));
 }
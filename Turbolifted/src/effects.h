@@ -17,6 +17,16 @@ struct CRGB
     g = (uint8_t)((g * scale) / 255);
     b = (uint8_t)((b * scale) / 255);
   }
+  // Saturating add, matching FastLED's CRGB::operator+=
+  CRGB &operator+=(const CRGB &o)
+  {
+    r = (uint8_t)(r + o.r > 255 ? 255 : r + o.r);
+    g = (uint8_t)(g + o.g > 255 ? 255 : g + o.g);
+    b = (uint8_t)(b + o.b > 255 ? 255 : b + o.b);
+    return *this;
+  }
+  bool operator==(const CRGB &o) const { return r == o.r && g == o.g && b == o.b; }
+  bool operator!=(const CRGB &o) const { return !(*this == o); }
   static CRGB Red() { return CRGB(255, 0, 0); }
   static CRGB Green() { return CRGB(0, 255, 0); }
   static CRGB Blue() { return CRGB(0, 0, 255); }
@@ -50,5 +60,7 @@ float getCircleDistance(float x, float y);
  * @param c2 Second color
  * @param ratio Interpolation ratio (0.0 = c1, 1.0 = c2, automatically clamped)
  * @return Interpolated color
+ * @note Converts the ratio once and defers to ColorMath::lerpColor; per-pixel
+ *       code should use the Q16 helpers in color_math.h directly.
  */
 CRGB interpolateColor(const CRGB &c1, const CRGB &c2, float ratio);
@@ -0,0 +1,141 @@
+#pragma once
+
+#include "config.h"
+
+/**
+ * @brief Chooses a sustainable frame interval from measured frame cost
+ *
+ * A 756-pixel WS2812B transmit alone takes longer than the nominal 10 ms
+ * update interval, so a fixed interval leaves the main loop rendering
+ * back-to-back with no time for buttons or the web server. The pacer times
+ * each frame (render plus show()) and spaces frames so that every interval
+ * also leaves a reserved slice for input handling.
+ *
+ * Frame cost is tracked with a fast-attack, slow-decay average: one expensive
+ * frame widens the interval immediately, while cheap frames (e.g. skipped
+ * static frames) only narrow it gradually.
+ *
+ * @example
+ * ```cpp
+ * FramePacer pacer(FramePacer::wireTimeUs(NUM_LEDS));
+ *
+ * void loop() {
+ *     inputManager.update(millis());
+ *     if (pacer.frameDue(micros())) {
+ *         pacer.beginFrame(micros());
+ *         effect.update(millis());
+ *         pacer.endFrame(micros());
+ *     }
+ * }
+ * ```
+ *
+ * @note Timestamps are micros() values; wrap-around is handled by unsigned
+ *       subtraction
+ */
+class FramePacer
+{
+public:
+  /**
+   * @brief Modelled WS2812B transmit time for a strip
+   * @param numLeds Pixel count
+   * @return Microseconds on the wire: 24 bits per pixel plus the latch gap
+   */
+  static constexpr unsigned long wireTimeUs(int numLeds)
+  {
+    return (unsigned long)numLeds * 24UL * TurboliftConfig::Hardware::WS2812_BIT_NS / 1000UL +
+           TurboliftConfig::Hardware::WS2812_LATCH_US;
+  }
+
+  /**
+   * @brief Construct a new FramePacer
+   * @param initialCostUs Frame cost assumed until the first measurement
+   * @param minIntervalMs Shortest frame interval (caps the frame rate)
+   * @param inputSliceMs Time reserved per frame for input and HTTP handling
+   */
+  explicit FramePacer(unsigned long initialCostUs,
+                      unsigned long minIntervalMs = TurboliftConfig::Timing::UPDATE_INTERVAL_MS,
+                      unsigned long inputSliceMs = TurboliftConfig::Timing::FRAME_INPUT_SLICE_MS)
+      : _minIntervalUs(minIntervalMs * 1000UL), _inputSliceUs(inputSliceMs * 1000UL),
+        _costUs(initialCostUs), _frameStartUs(0), _windowStartUs(0), _framesInWindow(0),
+        _fps(0), _started(false) {}
+
+  /**
+   * @brief Check whether the next frame should be rendered
+   * @param nowUs Current time in microseconds
+   */
+  bool frameDue(unsigned long nowUs) const
+  {
+    return !_started || nowUs - _frameStartUs >= frameIntervalUs();
+  }
+
+  /**
+   * @brief Mark the start of a frame
+   * @param nowUs Current time in microseconds
+   */
+  void beginFrame(unsigned long nowUs)
+  {
+    if (!_started)
+    {
+      _started = true;
+      _windowStartUs = nowUs;
+    }
+    _frameStartUs = nowUs;
+
+    // Achieved rate over roughly one-second windows
+    unsigned long windowUs = nowUs - _windowStartUs;
+    if (windowUs >= 1000000UL)
+    {
+      _fps = (uint16_t)((_framesInWindow * 1000000UL + windowUs / 2) / windowUs);
+      _framesInWindow = 0;
+      _windowStartUs = nowUs;
+    }
+    _framesInWindow++;
+  }
+
+  /**
+   * @brief Mark the end of a frame and fold its cost into the estimate
+   * @param nowUs Current time in microseconds
+   */
+  void endFrame(unsigned long nowUs)
+  {
+    unsigned long sample = nowUs - _frameStartUs;
+    if (sample > _costUs)
+      _costUs = sample;
+    else
+      _costUs -= (_costUs - sample) >> COST_DECAY_SHIFT;
+  }
+
+  /**
+   * @brief Current frame interval: frame cost plus the input slice, clamped
+   */
+  unsigned long frameIntervalUs() const
+  {
+    unsigned long interval = _costUs + _inputSliceUs;
+    const unsigned long maxIntervalUs = TurboliftConfig::Timing::FRAME_MAX_INTERVAL_MS * 1000UL;
+    if (interval < _minIntervalUs)
+      return _minIntervalUs;
+    return interval > maxIntervalUs ? maxIntervalUs : interval;
+  }
+
+  /**
+   * @brief Estimated cost of one frame (render plus transmit) in microseconds
+   */
+  unsigned long frameCostUs() const { return _costUs; }
+
+  /**
+   * @brief Frames started per second over the last complete window
+   */
+  uint16_t achievedFps() const { return _fps; }
+
+private:
+  static constexpr int COST_DECAY_SHIFT = 3; // Cheap frames pull the estimate down by 1/8 per frame
+
+  unsigned long _minIntervalUs;
+  unsigned long _inputSliceUs;
+  unsigned long _costUs;
+  unsigned long _frameStartUs;
+  unsigned long _windowStartUs;
+  unsigned long _framesInWindow;
+  uint16_t _fps;
+  bool _started;
+};
@@ -217,9 +217,10 @@ public:
     ToggleTurbolift = 1,       ///< Start/stop turbolift effect
     TriggerMalfunction = 2, ///< Trigger malfunction effect
     FadeOut = 3,            ///< Fade out current effect
+    NextPreset = 4,         ///< Recall the next stored preset
                             // Future commands can be added here
-                            // SetBrightness = 4,
-                            // ChangeColor = 5,
+                            // SetBrightness = 5,
+                            // ChangeColor = 6,
                             // etc.
   };
 
@@ -288,6 +289,8 @@ public:
       return Command::TriggerMalfunction;
     case 3:
       return Command::FadeOut;
+    case 4:
+      return Command::NextPreset;
     default:
       return Command::ToggleTurbolift; // Default fallback
     }
@@ -308,13 +311,15 @@ public:
       return "TriggerMalfunction";
     case Command::FadeOut:
       return "FadeOut";
+    case Command::NextPreset:
+      return "NextPreset";
     default:
       return "Unknown";
     }
   }
 
 private:
-  static constexpr int MAX_SOURCES = 4;
+  static constexpr int MAX_SOURCES = 6;
 
   IInputSource *sources_[MAX_SOURCES];
   int sourceCount_ = 0;
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <stdint.h>
+
+/**
+ * @brief Counts of latencies in power-of-two millisecond buckets
+ *
+ * Bucket 0 holds latencies under 1 ms, bucket i (1 <= i < BUCKETS - 1)
+ * those in [2^(i-1), 2^i) ms, and the last bucket everything longer. The
+ * bounds are fixed, so recording is a few shifts and no allocation, and
+ * the mean and maximum are kept exactly alongside.
+ *
+ * @example
+ * ```cpp
+ * LatencyHistogram latency;
+ * latency.record(micros() - receivedUs);
+ * for (int i = 0; i < LatencyHistogram::BUCKETS; i++)
+ *   Serial.println(latency.bucket(i));
+ * ```
+ */
+class LatencyHistogram
+{
+public:
+  static constexpr int BUCKETS = 10; // <1, 1-2, 2-4, ... 128-256, >=256 ms
+
+  LatencyHistogram() { reset(); }
+
+  void reset()
+  {
+    for (int i = 0; i < BUCKETS; i++)
+      _counts[i] = 0;
+    _count = 0;
+    _totalUs = 0;
+    _maxUs = 0;
+  }
+
+  void record(uint32_t latencyUs)
+  {
+    _counts[bucketOf(latencyUs)]++;
+    _count++;
+    _totalUs += latencyUs;
+    if (latencyUs > _maxUs)
+      _maxUs = latencyUs;
+  }
+
+  uint32_t count() const { return _count; }
+  uint32_t bucket(int i) const { return _counts[i]; }
+  uint32_t maxUs() const { return _maxUs; }
+  uint32_t meanUs() const { return _count ? (uint32_t)(_totalUs / _count) : 0; }
+
+  /**
+   * @brief Lower bound of bucket @p i in ms
+   */
+  static uint32_t bucketStartMs(int i) { return i == 0 ? 0 : 1UL << (i - 1); }
+
+  /**
+   * @brief Bucket holding @p latencyUs
+   */
+  static int bucketOf(uint32_t latencyUs)
+  {
+    uint32_t ms = latencyUs / 1000;
+    int i = 0;
+    while (ms && i < BUCKETS - 1)
+    {
+      ms >>= 1;
+      i++;
+    }
+    return i;
+  }
+
+  /**
+   * @brief Upper bound in ms of the bucket holding the @p percent th percentile
+   * @return 0 if nothing is recorded; for the last bucket, its lower bound
+   */
+  uint32_t percentileMs(int percent) const
+  {
+    if (_count == 0)
+      return 0;
+    uint64_t rank = ((uint64_t)_count * percent + 99) / 100;
+    uint64_t seen = 0;
+    for (int i = 0; i < BUCKETS - 1; i++)
+    {
+      seen += _counts[i];
+      if (seen >= rank)
+        return bucketStartMs(i + 1);
+    }
+    return bucketStartMs(BUCKETS - 1);
+  }
+
+private:
+  uint32_t _counts[BUCKETS];
+  uint32_t _count;
+  uint64_t _totalUs;
+  uint32_t _maxUs;
+};
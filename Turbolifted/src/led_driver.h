@@ -1,6 +1,171 @@
 #pragma once
 
 #include "config.h"
+#include <string.h>
+
+/**
+ * @brief Clip a span [start, start + count) to a buffer of length n
+ * @return Number of pixels left in the span (0 if it lies outside)
+ */
+static inline int clipSpan(int &start, int &count, int n)
+{
+  if (start < 0)
+  {
+    count += start;
+    start = 0;
+  }
+  if (start + count > n)
+    count = n - start;
+  return count > 0 ? count : 0;
+}
+
+/**
+ * @brief Normalize a rotation offset into [0, ringLength)
+ */
+static inline int wrapOffset(int offset, int ringLength)
+{
+  offset %= ringLength;
+  return offset < 0 ? offset + ringLength : offset;
+}
+
+/**
+ * @brief dst[i] = ring[(i + offset) % ringLength] for i < min(n, ringLength)
+ *
+ * Done as two contiguous copies, so the per-pixel modulo disappears.
+ */
+template <typename Pixel>
+static inline void rotatedCopy(Pixel *dst, int n, const Pixel *ring, int ringLength, int offset)
+{
+  int count = ringLength < n ? ringLength : n;
+  if (count <= 0)
+    return;
+  offset = wrapOffset(offset, ringLength);
+  int head = ringLength - offset;
+  if (head >= count)
+  {
+    memcpy(dst, ring + offset, count * sizeof(Pixel));
+    return;
+  }
+  memcpy(dst, ring + offset, head * sizeof(Pixel));
+  memcpy(dst + head, ring, (count - head) * sizeof(Pixel));
+}
+
+/**
+ * @brief dst[i] += ring[(i + offset) % ringLength] (saturating) for i < min(n, ringLength)
+ */
+template <typename Pixel>
+static inline void rotatedAdd(Pixel *dst, int n, const Pixel *ring, int ringLength, int offset)
+{
+  int count = ringLength < n ? ringLength : n;
+  if (count <= 0)
+    return;
+  offset = wrapOffset(offset, ringLength);
+  int head = ringLength - offset;
+  if (head > count)
+    head = count;
+  const Pixel *src = ring + offset;
+  for (int i = 0; i < head; i++)
+    dst[i] += src[i];
+  for (int i = head; i < count; i++)
+    dst[i] += ring[i - head];
+}
+
+/**
+ * @brief a + (b - a) * frac / 256, truncated
+ */
+static inline uint8_t lerpChannel(uint8_t a, uint8_t b, uint8_t frac)
+{
+  return (uint8_t)((((int)a << 8) + ((int)b - (int)a) * frac) >> 8);
+}
+
+template <typename Pixel>
+static inline Pixel lerpPixel(const Pixel &a, const Pixel &b, uint8_t frac)
+{
+  return Pixel(lerpChannel(a.r, b.r, frac), lerpChannel(a.g, b.g, frac), lerpChannel(a.b, b.b, frac));
+}
+
+/**
+ * @brief Sub-pixel rotatedCopy: dst[i] blends ring[j] and ring[j + 1] (wrapping)
+ *        by the fractional part of offsetQ8, where j = (i + offset) % ringLength
+ * @param offsetQ8 Rotation in 1/256 pixel units; whole pixels are an exact copy
+ */
+template <typename Pixel>
+static inline void rotatedBlend(Pixel *dst, int n, const Pixel *ring, int ringLength, uint32_t offsetQ8)
+{
+  uint8_t frac = (uint8_t)(offsetQ8 & 0xFF);
+  int offset = wrapOffset((int)(offsetQ8 >> 8), ringLength);
+  if (frac == 0)
+  {
+    rotatedCopy(dst, n, ring, ringLength, offset);
+    return;
+  }
+  int count = ringLength < n ? ringLength : n;
+  int j = offset;
+  for (int i = 0; i < count; i++)
+  {
+    int next = j + 1 == ringLength ? 0 : j + 1;
+    dst[i] = lerpPixel(ring[j], ring[next], frac);
+    j = next;
+  }
+}
+
+/**
+ * @brief Sub-pixel rotatedAdd, blending neighbours like rotatedBlend
+ */
+template <typename Pixel>
+static inline void rotatedBlendAdd(Pixel *dst, int n, const Pixel *ring, int ringLength, uint32_t offsetQ8)
+{
+  uint8_t frac = (uint8_t)(offsetQ8 & 0xFF);
+  int offset = wrapOffset((int)(offsetQ8 >> 8), ringLength);
+  if (frac == 0)
+  {
+    rotatedAdd(dst, n, ring, ringLength, offset);
+    return;
+  }
+  int count = ringLength < n ? ringLength : n;
+  int j = offset;
+  for (int i = 0; i < count; i++)
+  {
+    int next = j + 1 == ringLength ? 0 : j + 1;
+    dst[i] += lerpPixel(ring[j], ring[next], frac);
+    j = next;
+  }
+}
+
+/**
+ * @brief dst[i] = src[i] blended toward src[i + 1] by frac, for i < n
+ *
+ * For ring layouts that already hold the rotation contiguously (see
+ * MirroredRing): a straight linear read with no wrap test per pixel.
+ * src must hold n + 1 pixels when frac is non-zero.
+ */
+template <typename Pixel>
+static inline void linearBlend(Pixel *dst, int n, const Pixel *src, uint8_t frac)
+{
+  if (frac == 0)
+  {
+    memcpy(dst, src, n * sizeof(Pixel));
+    return;
+  }
+  for (int i = 0; i < n; i++)
+    dst[i] = lerpPixel(src[i], src[i + 1], frac);
+}
+
+/**
+ * @brief Saturating-add variant of linearBlend
+ */
+template <typename Pixel>
+static inline void linearBlendAdd(Pixel *dst, int n, const Pixel *src, uint8_t frac)
+{
+  if (frac == 0)
+  {
+    for (int i = 0; i < n; i++)
+      dst[i] += src[i];
+    return;
+  }
+  for (int i = 0; i < n; i++)
+    dst[i] += lerpPixel(src[i], src[i + 1], frac);
+}
 
 // When building unit tests on the host, FastLED is not available. Provide a
 // minimal CRGB type and avoid including FastLED.h. For device builds, include
@@ -13,12 +178,27 @@ class ILEDDriver
 {
 public:
   virtual void begin() = 0;
-  virtual void setBrightness(uint8_t b) = 0;
   virtual void setPixel(int idx, const CRGB &color) = 0;
   virtual void fillSolid(const CRGB &color) = 0;
   virtual void clear() = 0;
+  // Output-stage scale applied while pixels are clocked out (no buffer pass)
+  virtual void setBrightness(uint8_t b) = 0;
+  // Transmits only if the buffer or brightness changed since the last show()
   virtual void show() = 0;
+  // Raw buffer access; the frame is treated as modified from this call on
   virtual CRGB *getBuffer() = 0;
+  // Span operations: one virtual call per frame instead of one per pixel
+  virtual void writeSpan(int start, const CRGB *src, int count) = 0;
+  virtual void addSpan(int start, const CRGB *src, int count) = 0;
+  virtual void blitRotated(const CRGB *ring, int ringLength, int offset) = 0;
+  virtual void addRotated(const CRGB *ring, int ringLength, int offset) = 0;
+  virtual void scaleSpan(int start, int count, uint8_t scale) = 0;
+  // Sub-pixel variants: offsetQ8 is in 1/256 pixels, neighbours are blended
+  virtual void blitRotatedSubpixel(const CRGB *ring, int ringLength, uint32_t offsetQ8) = 0;
+  virtual void addRotatedSubpixel(const CRGB *ring, int ringLength, uint32_t offsetQ8) = 0;
+  // Pre-rotated windows (see MirroredRing): src holds count + 1 pixels
+  virtual void blitSubpixel(const CRGB *src, int count, uint8_t frac) = 0;
+  virtual void addSubpixel(const CRGB *src, int count, uint8_t frac) = 0;
   virtual ~ILEDDriver() {}
 };
 
@@ -31,12 +211,27 @@ class ILEDDriver
 {
 public:
   virtual void begin() = 0;
-  virtual void setBrightness(uint8_t b) = 0;
   virtual void setPixel(int idx, const CRGB &color) = 0;
   virtual void fillSolid(const CRGB &color) = 0;
   virtual void clear() = 0;
+  // Output-stage scale applied while pixels are clocked out (no buffer pass)
+  virtual void setBrightness(uint8_t b) = 0;
+  // Transmits only if the buffer or brightness changed since the last show()
   virtual void show() = 0;
+  // Raw buffer access; the frame is treated as modified from this call on
   virtual CRGB *getBuffer() = 0;
+  // Span operations: one virtual call per frame instead of one per pixel
+  virtual void writeSpan(int start, const CRGB *src, int count) = 0;
+  virtual void addSpan(int start, const CRGB *src, int count) = 0;
+  virtual void blitRotated(const CRGB *ring, int ringLength, int offset) = 0;
+  virtual void addRotated(const CRGB *ring, int ringLength, int offset) = 0;
+  virtual void scaleSpan(int start, int count, uint8_t scale) = 0;
+  // Sub-pixel variants: offsetQ8 is in 1/256 pixels, neighbours are blended
+  virtual void blitRotatedSubpixel(const CRGB *ring, int ringLength, uint32_t offsetQ8) = 0;
+  virtual void addRotatedSubpixel(const CRGB *ring, int ringLength, uint32_t offsetQ8) = 0;
+  // Pre-rotated windows (see MirroredRing): src holds count + 1 pixels
+  virtual void blitSubpixel(const CRGB *src, int count, uint8_t frac) = 0;
+  virtual void addSubpixel(const CRGB *src, int count, uint8_t frac) = 0;
   virtual ~ILEDDriver() {}
 };
 
@@ -52,20 +247,123 @@ public:
     FastLED.setBrightness(255);
     FastLED.clear();
     FastLED.show();
+    _dirty = false;
+  }
+  void setBrightness(uint8_t b) override
+  {
+    if (b != FastLED.getBrightness())
+    {
+      FastLED.setBrightness(b);
+      _dirty = true;
+    }
   }
-  void setBrightness(uint8_t b) override { FastLED.setBrightness(b); }
   void setPixel(int idx, const CRGB &color) override
   {
     if (idx >= 0 && idx < N)
+    {
       buffer[idx] = color;
+      _dirty = true;
+    }
+  }
+  void fillSolid(const CRGB &color) override
+  {
+    fill_solid(buffer, N, color);
+    _dirty = true;
+  }
+  void clear() override
+  {
+    FastLED.clear();
+    _dirty = true;
+  }
+  void show() override
+  {
+    // A WS2812B frame costs ~30 us per pixel with interrupts off, so an
+    // unchanged frame is not worth resending
+    if (!_dirty)
+      return;
+    FastLED.show();
+    _dirty = false;
+    _transmits++;
+  }
+
+  // Frames actually sent; show() calls skipped as unchanged do not count
+  uint32_t transmits() const { return _transmits; }
+  CRGB *getBuffer() override
+  {
+    _dirty = true;
+    return buffer;
+  }
+
+  void writeSpan(int start, const CRGB *src, int count) override
+  {
+    int first = start;
+    if (clipSpan(first, count, N))
+    {
+      memcpy(buffer + first, src + (first - start), count * sizeof(CRGB));
+      _dirty = true;
+    }
+  }
+
+  void addSpan(int start, const CRGB *src, int count) override
+  {
+    int first = start;
+    if (clipSpan(first, count, N))
+    {
+      for (int i = 0; i < count; i++)
+        buffer[first + i] += src[first - start + i];
+      _dirty = true;
+    }
+  }
+
+  void blitRotated(const CRGB *ring, int ringLength, int offset) override
+  {
+    rotatedCopy(buffer, N, ring, ringLength, offset);
+    _dirty = true;
+  }
+
+  void addRotated(const CRGB *ring, int ringLength, int offset) override
+  {
+    rotatedAdd(buffer, N, ring, ringLength, offset);
+    _dirty = true;
+  }
+
+  void scaleSpan(int start, int count, uint8_t scale) override
+  {
+    if (clipSpan(start, count, N))
+    {
+      nscale8(buffer + start, count, scale);
+      _dirty = true;
+    }
+  }
+
+  void blitRotatedSubpixel(const CRGB *ring, int ringLength, uint32_t offsetQ8) override
+  {
+    rotatedBlend(buffer, N, ring, ringLength, offsetQ8);
+    _dirty = true;
+  }
+
+  void addRotatedSubpixel(const CRGB *ring, int ringLength, uint32_t offsetQ8) override
+  {
+    rotatedBlendAdd(buffer, N, ring, ringLength, offsetQ8);
+    _dirty = true;
+  }
+
+  void blitSubpixel(const CRGB *src, int count, uint8_t frac) override
+  {
+    linearBlend(buffer, count < N ? count : N, src, frac);
+    _dirty = true;
+  }
+
+  void addSubpixel(const CRGB *src, int count, uint8_t frac) override
+  {
+    linearBlendAdd(buffer, count < N ? count : N, src, frac);
+    _dirty = true;
   }
-  void fillSolid(const CRGB &color) override { fill_solid(buffer, N, color); }
-  void clear() override { FastLED.clear(); }
-  void show() override { FastLED.show(); }
-  CRGB *getBuffer() override { return buffer; }
 
 private:
   uint8_t _pin;
+  bool _dirty = true; // Buffer or brightness changed since the last transmit
+  uint32_t _transmits = 0;
   static CRGB buffer[N];
 };
 
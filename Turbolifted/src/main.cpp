@@ -6,10 +6,17 @@
 #include "config.h"
 #include "startup_sequence.h"
 #include "input_manager.h"
+#include "interrupt_buttons.h"
 #include "status_led.h"
 #include "config_manager.h"
+#include "config_store.h"
+#include "preset_store.h"
+#include "frame_pacer.h"
 #if ENABLE_WIFI_CONTROL
 #include "wifi_input_source.h"
+#include "realtime_input.h"
+#include "show_sync.h"
+#include "cue_input.h"
 #endif
 
 // LED Strip Configuration - using config constants
@@ -18,16 +25,34 @@
 // Static driver and turbolift effect using template-based class
 static FastLEDDriver<TurboliftConfig::Hardware::NUM_LEDS> fastDriver(TurboliftConfig::Hardware::LED_PIN);
 static TurboliftEffectTemplate<TurboliftConfig::Hardware::NUM_LEDS, TurboliftConfig::Effects::GRADIENT_STEP_DEFAULT, TurboliftConfig::Effects::GRADIENT_MOVE_DEFAULT> turbolift(&fastDriver);
+// Frame pacing, seeded with the modelled transmit time until frames are measured
+static FramePacer framePacer(FramePacer::wireTimeUs(TurboliftConfig::Hardware::NUM_LEDS));
+// Settings saved in flash, restored at boot
+static LittleFSConfigStorage configStorage("/config.bin", "/config.tmp");
+static ConfigStore configStore(&configStorage);
+// Scene presets: settings plus the patterns on show
+static LittleFSPresetStorage presetStorage;
+static PresetStore presets(&presetStorage, &turbolift);
 // Application state
 bool turboliftRunning = false;
 
 // System components
 StartupSequence startupSequence;
 InputManager inputManager;
-ButtonInputSource buttonInput(nullptr, 0); // Will be initialized in setup()
 
 #if ENABLE_WIFI_CONTROL
 WiFiInputSource wifiInput(TurboliftConfig::WiFi::HTTP_PORT);
+// E1.31 / Art-Net frames for the realtime effect mode, received straight into the LED buffer
+static WiFiUdpReceiver sacnReceiver((TurboliftConfig::Hardware::NUM_LEDS + TurboliftConfig::Realtime::PIXELS_PER_UNIVERSE - 1) / TurboliftConfig::Realtime::PIXELS_PER_UNIVERSE);
+static WiFiUdpReceiver artnetReceiver;
+static RealtimeInputSource realtimeInput(&fastDriver, TurboliftConfig::Hardware::NUM_LEDS, &sacnReceiver, &artnetReceiver);
+// Show time shared with the other units of a set, so their rotation and patterns match
+static ShowClock showClock;
+static WiFiSyncLink syncLink;
+static ShowSync showSync(&syncLink, &showClock, (uint16_t)ESP.getChipId());
+// Show commands over UDP, timed from receipt to the first frame that shows them
+static WiFiCueLink cueLink;
+static CueInputSource cueInput(&cueLink);
 #endif
 
 // Button configuration
@@ -46,7 +71,14 @@ const ButtonInputSource::ButtonConfig buttonConfigs[] = {
      .inputId = static_cast<int>(InputManager::Command::FadeOut),
      .activeLow = true,
      .debounceMs = TurboliftConfig::Timing::DEBOUNCE_INTERVAL_MS,
-     .name = "Button3_FadeOut"}};
+     .name = "Button3_FadeOut"},
+    {.pin = TurboliftConfig::Hardware::BUTTON4_PIN,
+     .inputId = static_cast<int>(InputManager::Command::NextPreset),
+     .activeLow = true,
+     .debounceMs = TurboliftConfig::Timing::DEBOUNCE_INTERVAL_MS,
+     .name = "Button4_NextPreset"}};
+// Buttons are read by pin-change interrupts, debounced on the edges' own times
+InterruptButtonInputSource buttonInput(buttonConfigs, 4);
 
 // TurboliftEffect encapsulates malfunction and gradient logic now.
 
@@ -88,6 +120,19 @@ void handleInputCommand(InputManager::Command command, const char *source)
     turbolift.triggerFadeOut();
     break;
 
+  case InputManager::Command::NextPreset:
+  {
+    int slot = presets.recallNext();
+    if (slot < 0)
+      Serial.println("No presets stored");
+    else
+    {
+      Serial.print("Preset recalled: slot ");
+      Serial.println(slot);
+    }
+    break;
+  }
+
   default:
     Serial.print("Unknown command: ");
     Serial.println(static_cast<int>(command));
@@ -104,23 +149,39 @@ void setup()
   // Initialize status LED
   StatusLED::begin();
 
+  // Initialize configuration manager, then restore the saved settings so
+  // the patterns generated below already use them
+  ConfigManager::begin();
+  if (configStore.load())
+    Serial.println("Saved settings restored");
+
   // Initialize turbolift effect (which initializes LEDs)
   turbolift.begin();
 
   // Initialize startup sequence
   startupSequence.begin(&fastDriver);
 
-  // Initialize configuration manager
-  ConfigManager::begin();
-
   // Initialize input system
-  buttonInput = ButtonInputSource(buttonConfigs, 3);
+  buttonInput.begin();
   inputManager.addInputSource(&buttonInput);
 
 #if ENABLE_WIFI_CONTROL
   // Initialize WiFi input source (non-blocking)
   wifiInput.begin(TurboliftConfig::WiFi::DEFAULT_SSID, TurboliftConfig::WiFi::DEFAULT_PASSWORD);
   inputManager.addInputSource(&wifiInput);
+  wifiInput.setFramePacer(&framePacer);
+  wifiInput.setPresetStore(&presets);
+  realtimeInput.begin();
+  inputManager.addInputSource(&realtimeInput);
+  turbolift.setRealtimeFrames(&realtimeInput);
+  showClock.setLeader(TurboliftConfig::Sync::LEADER);
+  showSync.begin(ESP.random());
+  inputManager.addInputSource(&showSync);
+  turbolift.setShowClock(&showClock);
+  wifiInput.setShowClock(&showClock);
+  cueInput.begin();
+  inputManager.addInputSource(&cueInput);
+  wifiInput.setCueInput(&cueInput);
   Serial.println("WiFi input source initialized - attempting connection in background");
   Serial.println("WiFi commands available:");
   Serial.println("  http://[ip]/toggle - Toggle turbolift effect");
@@ -128,6 +189,9 @@ void setup()
   Serial.println("  http://[ip]/fadeout - Fade out effect");
   Serial.println("  http://[ip]/status - View status");
   Serial.println("  http://[ip]/config - View configuration");
+  Serial.println("  http://[ip]/presets - List presets");
+  Serial.println("  http://[ip]/cues - Cue latency (cues on UDP port 5572)");
+  Serial.println("  http://[ip]/set?effect=4 - Show E1.31 (port 5568) / Art-Net (port 6454) frames");
 #endif
 
   inputManager.setInputCallback(handleInputCommand);
@@ -137,6 +201,7 @@ void setup()
   Serial.println("  Button 1: Toggle turbolift effect");
   Serial.println("  Button 2: Trigger malfunction");
   Serial.println("  Button 3: Fade out");
+  Serial.println("  Button 4: Next preset");
   Serial.print("Total LEDs: ");
   Serial.println(TurboliftConfig::Hardware::NUM_LEDS);
   Serial.print("Circle radius: ");
@@ -166,8 +231,32 @@ void loop()
   }
 
   // Process all input sources (buttons, WiFi, etc.)
+  uint32_t transmits = fastDriver.transmits();
   inputManager.update(now);
+#if ENABLE_WIFI_CONTROL
+  // A cue is rendered at once rather than when the next frame falls due
+  bool cued = cueInput.takeFrameRequest();
+#else
+  bool cued = false;
+#endif
 
-  // Run effects
-  turbolift.update(now);
+  // Run effects when the pacer says a frame fits; the rest of the interval
+  // is left for input and HTTP handling
+  if (cued || framePacer.frameDue(micros()))
+  {
+    framePacer.beginFrame(micros());
+    turbolift.renderFrame(millis());
+    framePacer.endFrame(micros());
+  }
+  else
+  {
+    // Idle until the next frame: build pending patterns in the background
+    // and save settings that have settled
+    turbolift.serviceGeneration();
+    configStore.service(now);
+  }
+#if ENABLE_WIFI_CONTROL
+  if (fastDriver.transmits() != transmits)
+    cueInput.shown(micros());
+#endif
 }
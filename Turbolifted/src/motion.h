@@ -0,0 +1,121 @@
+#pragma once
+
+#include <stdint.h>
+
+/**
+ * @brief Time-based position on a ring, with 1/256 sub-pixel precision
+ *
+ * Effects used to move a fixed number of LEDs per update, so the visible
+ * speed dropped whenever the frame rate did. RingMotion instead advances by
+ * elapsed time: a speed is given as ring positions per period, and the
+ * position is kept in Q8 fixed point (256 == one LED) so slow or low-frame-
+ * rate motion can be rendered between pixels instead of stepping.
+ *
+ * The division remainder is carried between calls, so the distance covered
+ * over any span of time is exact regardless of how it was split into frames.
+ *
+ * @example
+ * ```cpp
+ * RingMotion gradient(NUM_LEDS);
+ *
+ * void renderFrame(unsigned long elapsedMs) {
+ *     gradient.advance(speed, elapsedMs, TurboliftConfig::Timing::MOTION_TICK_MS);
+ *     driver->blitRotatedSubpixel(ring, NUM_LEDS, gradient.positionQ8());
+ * }
+ * ```
+ *
+ * @note units * elapsedMs must stay below 2^24 to avoid overflow; callers
+ *       clamp elapsed time per frame
+ */
+class RingMotion
+{
+public:
+  /**
+   * @brief Construct a new RingMotion
+   * @param length Ring length in whole positions (e.g. LEDs)
+   */
+  explicit RingMotion(int length)
+      : _lengthQ8((uint32_t)length << 8), _posQ8(0), _remainder(0), _backwards(false) {}
+
+  /**
+   * @brief Return to position 0 and drop any fractional carry
+   */
+  void reset()
+  {
+    _posQ8 = 0;
+    _remainder = 0;
+  }
+
+  /**
+   * @brief Advance at @p units positions per @p periodMs for @p elapsedMs
+   * @param units Speed in ring positions per period; negative moves backwards
+   * @param elapsedMs Time since the previous advance
+   * @param periodMs Period the speed is expressed in
+   */
+  void advance(int units, unsigned long elapsedMs, unsigned long periodMs)
+  {
+    if (units == 0 || periodMs == 0 || _lengthQ8 == 0)
+      return;
+
+    bool backwards = units < 0;
+    if (backwards != _backwards)
+    {
+      _remainder = 0; // Carry from the other direction does not apply
+      _backwards = backwards;
+    }
+
+    uint32_t magnitude = (uint32_t)(backwards ? -units : units);
+    uint32_t scaled = magnitude * (uint32_t)elapsedMs * 256UL + _remainder;
+    uint32_t delta = (scaled / periodMs) % _lengthQ8;
+    _remainder = scaled % periodMs;
+
+    _posQ8 = backwards ? (_posQ8 + _lengthQ8 - delta) % _lengthQ8 : (_posQ8 + delta) % _lengthQ8;
+  }
+
+  /**
+   * @brief Pull the position towards where constant motion at @p units per
+   *        @p periodMs would have it at @p timeMs
+   *
+   * With a clock shared between units (see ShowClock), every unit then
+   * shows the same position whatever its start time and frame rate. The
+   * error is closed an eighth per call, so a speed change sweeps to the new
+   * phase over a few frames instead of jumping. Call after advance().
+   */
+  void lock(int units, uint32_t timeMs, unsigned long periodMs)
+  {
+    if (periodMs == 0 || _lengthQ8 == 0)
+      return;
+    uint32_t magnitude = (uint32_t)(units < 0 ? -units : units);
+    uint32_t phase = (uint32_t)((uint64_t)magnitude * timeMs * 256 / periodMs % _lengthQ8);
+    if (units < 0)
+      phase = (_lengthQ8 - phase) % _lengthQ8;
+    int32_t error = (int32_t)((phase + _lengthQ8 - _posQ8) % _lengthQ8);
+    if (error > (int32_t)(_lengthQ8 / 2))
+      error -= (int32_t)_lengthQ8; // The shorter way round
+    int32_t step = error / LOCK_DIVISOR != 0 ? error / LOCK_DIVISOR : error;
+    _posQ8 = (uint32_t)((int32_t)_posQ8 + step + (int32_t)_lengthQ8) % _lengthQ8;
+  }
+
+  /**
+   * @brief Position in 1/256 units, in [0, length * 256)
+   */
+  uint32_t positionQ8() const { return _posQ8; }
+
+  /**
+   * @brief Whole-position part of the current position
+   */
+  int whole() const { return (int)(_posQ8 >> 8); }
+
+  /**
+   * @brief Sub-position fraction of the current position (0-255)
+   */
+  uint8_t fraction() const { return (uint8_t)(_posQ8 & 0xFF); }
+
+private:
+  static constexpr int32_t LOCK_DIVISOR = 8;
+
+  uint32_t _lengthQ8;
+  uint32_t _posQ8;
+  uint32_t _remainder;
+  bool _backwards;
+};
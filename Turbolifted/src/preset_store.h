@@ -0,0 +1,453 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include "config.h"
+#include "config_manager.h"
+#include "config_store.h"
+#include "effects.h"
+#ifndef UNIT_TEST
+#include <LittleFS.h>
+#endif
+
+/**
+ * @brief Streamed storage for numbered preset slots
+ *
+ * One slot is open at a time, for reading or writing. A write replaces the
+ * slot's preset only when commit() succeeds; close() drops an unfinished
+ * write and ends a read.
+ */
+class IPresetStorage
+{
+public:
+  virtual bool openRead(int slot) = 0;
+  virtual bool openWrite(int slot) = 0;
+  /**
+   * @return Bytes read, 0 at the end of the preset
+   */
+  virtual size_t read(uint8_t *data, size_t length) = 0;
+  virtual bool write(const uint8_t *data, size_t length) = 0;
+  virtual bool commit() = 0;
+  virtual void close() = 0;
+  virtual bool remove(int slot) = 0;
+  virtual ~IPresetStorage() {}
+};
+
+#ifndef UNIT_TEST
+/**
+ * @brief Preset slots as LittleFS files, /preset<slot>.bin
+ *
+ * Writes go to /preset.tmp and are renamed over the slot's file on commit,
+ * as for LittleFSConfigStorage.
+ */
+class LittleFSPresetStorage : public IPresetStorage
+{
+public:
+  LittleFSPresetStorage() : _slot(-1), _writing(false), _mounted(false) {}
+
+  bool openRead(int slot) override
+  {
+    close();
+    char path[16];
+    if (!mount() || !LittleFS.exists(slotPath(slot, path)))
+      return false;
+    _file = LittleFS.open(path, "r");
+    return (bool)_file;
+  }
+
+  bool openWrite(int slot) override
+  {
+    close();
+    if (!mount())
+      return false;
+    _file = LittleFS.open(tempPath(), "w");
+    if (!_file)
+      return false;
+    _slot = slot;
+    _writing = true;
+    return true;
+  }
+
+  size_t read(uint8_t *data, size_t length) override
+  {
+    return _file ? _file.read(data, length) : 0;
+  }
+
+  bool write(const uint8_t *data, size_t length) override
+  {
+    return _writing && _file.write(data, length) == length;
+  }
+
+  bool commit() override
+  {
+    if (!_writing)
+      return false;
+    _file.close();
+    _writing = false;
+    char path[16];
+    return LittleFS.rename(tempPath(), slotPath(_slot, path));
+  }
+
+  void close() override
+  {
+    if (_file)
+      _file.close();
+    if (_writing)
+      LittleFS.remove(tempPath());
+    _writing = false;
+  }
+
+  bool remove(int slot) override
+  {
+    char path[16];
+    return mount() && LittleFS.remove(slotPath(slot, path));
+  }
+
+private:
+  File _file;
+  int _slot;
+  bool _writing;
+  bool _mounted;
+
+  static const char *tempPath() { return "/preset.tmp"; }
+
+  static const char *slotPath(int slot, char *path)
+  {
+    snprintf(path, 16, "/preset%d.bin", slot);
+    return path;
+  }
+
+  bool mount()
+  {
+    if (!_mounted)
+      _mounted = LittleFS.begin();
+    return _mounted;
+  }
+};
+#endif
+
+/**
+ * @brief Buffered reads from the open preset, with a running CRC-32
+ *
+ * Holds Presets::STREAM_CHUNK bytes, so a preset is never in RAM whole.
+ * beginPattern() and point() read the pattern records written by
+ * PresetWriter.
+ */
+class PresetReader
+{
+public:
+  explicit PresetReader(IPresetStorage *storage) : _storage(storage), _length(0), _pos(0), _crc(0) {}
+
+  bool get(uint8_t *data, size_t length)
+  {
+    while (length > 0)
+    {
+      if (_pos == _length)
+      {
+        _length = _storage->read(_buffer, sizeof(_buffer));
+        _pos = 0;
+        if (_length == 0)
+          return false;
+      }
+      size_t n = _length - _pos < length ? _length - _pos : length;
+      memcpy(data, _buffer + _pos, n);
+      _crc = ConfigStore::crc32(_buffer + _pos, n, _crc);
+      _pos += n;
+      data += n;
+      length -= n;
+    }
+    return true;
+  }
+
+  // CRC-32 of every byte read so far
+  uint32_t crc() const { return _crc; }
+
+  /**
+   * @return The pattern's driver point count, or -1 on a read error
+   */
+  int beginPattern()
+  {
+    uint8_t count[2];
+    return get(count, 2) ? count[0] | count[1] << 8 : -1;
+  }
+
+  bool point(uint16_t &pos, CRGB &color)
+  {
+    uint8_t record[POINT_SIZE];
+    if (!get(record, POINT_SIZE))
+      return false;
+    pos = record[0] | record[1] << 8;
+    color = CRGB(record[2], record[3], record[4]);
+    return true;
+  }
+
+  static constexpr size_t POINT_SIZE = 5; // Position (little-endian), r, g, b
+
+private:
+  IPresetStorage *_storage;
+  uint8_t _buffer[TurboliftConfig::Presets::STREAM_CHUNK];
+  size_t _length;
+  size_t _pos;
+  uint32_t _crc;
+};
+
+/**
+ * @brief Buffered writes to the open preset, with a running CRC-32
+ */
+class PresetWriter
+{
+public:
+  explicit PresetWriter(IPresetStorage *storage) : _storage(storage), _length(0), _crc(0), _ok(true) {}
+
+  bool put(const uint8_t *data, size_t length)
+  {
+    _crc = ConfigStore::crc32(data, length, _crc);
+    while (length > 0 && _ok)
+    {
+      size_t n = sizeof(_buffer) - _length < length ? sizeof(_buffer) - _length : length;
+      memcpy(_buffer + _length, data, n);
+      _length += n;
+      data += n;
+      length -= n;
+      if (_length == sizeof(_buffer))
+        flush();
+    }
+    return _ok;
+  }
+
+  bool beginPattern(int count)
+  {
+    uint8_t record[2] = {(uint8_t)count, (uint8_t)(count >> 8)};
+    return put(record, 2);
+  }
+
+  bool point(uint16_t pos, const CRGB &color)
+  {
+    uint8_t record[PresetReader::POINT_SIZE] = {(uint8_t)pos, (uint8_t)(pos >> 8), color.r, color.g, color.b};
+    return put(record, sizeof(record));
+  }
+
+  /**
+   * @brief Append the CRC-32 of everything put so far and flush
+   * @return false if any write failed
+   */
+  bool finish()
+  {
+    uint32_t crc = _crc;
+    uint8_t record[4];
+    for (int i = 0; i < 4; i++)
+      record[i] = (uint8_t)(crc >> (8 * i));
+    put(record, 4);
+    flush();
+    return _ok;
+  }
+
+private:
+  IPresetStorage *_storage;
+  uint8_t _buffer[TurboliftConfig::Presets::STREAM_CHUNK];
+  size_t _length;
+  uint32_t _crc;
+  bool _ok;
+
+  void flush()
+  {
+    if (_length > 0 && _ok)
+      _ok = _storage->write(_buffer, _length);
+    _length = 0;
+  }
+};
+
+/**
+ * @brief Source and target of the generated patterns a preset can carry
+ *
+ * writePatterns() writes patternCount() patterns, each as
+ * PresetWriter::beginPattern(count) followed by its driver points (a count
+ * of 0 for a pattern not generated). recallPatterns() reads them back in
+ * the same order and shows them without regenerating.
+ */
+class IPresetPatterns
+{
+public:
+  virtual int patternCount() const = 0;
+  virtual bool writePatterns(PresetWriter &writer) = 0;
+  virtual bool recallPatterns(PresetReader &reader, const ConfigSnapshot &config) = 0;
+  virtual ~IPresetPatterns() {}
+};
+
+/**
+ * @brief Named scene presets kept in flash for instant recall
+ *
+ * A preset holds the runtime parameters, as a ConfigStore blob, and
+ * optionally the driver points of the patterns on show, so recalling it
+ * brings back the same look rather than a new random one. Layout:
+ * a header (magic, format version, pattern count, name), the config blob,
+ * the pattern records, and a CRC-32 over all of them.
+ *
+ * Presets are streamed through PresetReader and PresetWriter. recall()
+ * reads a preset twice: once to check its CRC and driver positions, once
+ * to apply it, so a damaged preset changes nothing. Applying takes a few
+ * milliseconds between frames; the next frame shows the recalled look.
+ *
+ * @example
+ * ```cpp
+ * LittleFSPresetStorage storage;
+ * PresetStore presets(&storage, &turbolift);
+ * presets.save(0, "Bridge");
+ * presets.recall(0);
+ * ```
+ */
+class PresetStore
+{
+public:
+  static constexpr uint8_t MAGIC_0 = 'P';
+  static constexpr uint8_t MAGIC_1 = 'S';
+  static constexpr uint8_t FORMAT_VERSION = 1; // Bump when the layout changes
+  static constexpr int SLOTS = TurboliftConfig::Presets::SLOTS;
+  static constexpr int NAME_LENGTH = TurboliftConfig::Presets::NAME_LENGTH;
+  static constexpr size_t HEADER_SIZE = 4 + NAME_LENGTH + 1;
+  static constexpr int MAX_PATTERNS = 4;
+
+  PresetStore(IPresetStorage *storage, IPresetPatterns *patterns) : _storage(storage), _patterns(patterns), _current(-1) {}
+
+  /**
+   * @brief Store the current settings, and the patterns if asked, in a slot
+   * @param name 1 to NAME_LENGTH printable characters, no quotes or backslashes
+   * @return false if the slot or name is invalid or the write failed (the
+   *         slot's previous preset is kept)
+   */
+  bool save(int slot, const char *name, bool withPatterns = true)
+  {
+    if (!validSlot(slot) || !validName(name) || !_storage->openWrite(slot))
+      return false;
+    uint8_t header[HEADER_SIZE] = {MAGIC_0, MAGIC_1, FORMAT_VERSION, (uint8_t)(withPatterns ? _patterns->patternCount() : 0)};
+    strncpy((char *)header + 4, name, NAME_LENGTH);
+    uint8_t config[ConfigStore::BLOB_SIZE];
+    ConfigStore::encode(ConfigManager::snapshot(), config);
+
+    PresetWriter writer(_storage);
+    bool ok = writer.put(header, HEADER_SIZE) && writer.put(config, sizeof(config)) &&
+              (!header[3] || _patterns->writePatterns(writer)) && writer.finish() && _storage->commit();
+    _storage->close();
+    return ok;
+  }
+
+  /**
+   * @brief Apply a slot's preset
+   * @return false (nothing changed) if the slot holds no valid preset
+   */
+  bool recall(int slot)
+  {
+    if (!check(slot) || !_storage->openRead(slot))
+      return false;
+    PresetReader reader(_storage);
+    uint8_t header[HEADER_SIZE];
+    uint8_t config[ConfigStore::BLOB_SIZE];
+    bool ok = reader.get(header, HEADER_SIZE) && reader.get(config, sizeof(config)) && ConfigStore::decode(config);
+    if (ok && header[3])
+      ok = _patterns->recallPatterns(reader, ConfigManager::snapshot());
+    _storage->close();
+    if (ok)
+      _current = slot;
+    return ok;
+  }
+
+  /**
+   * @brief Recall the next valid preset after the last one recalled
+   * @return The slot recalled, or -1 if there is none
+   */
+  int recallNext()
+  {
+    for (int i = 1; i <= SLOTS; i++)
+    {
+      int slot = (_current + i) % SLOTS;
+      if (recall(slot))
+        return slot;
+    }
+    return -1;
+  }
+
+  /**
+   * @brief Read a slot's name from its header, without checking the CRC
+   * @param name At least NAME_LENGTH + 1 bytes
+   * @return false if the slot is empty
+   */
+  bool readName(int slot, char *name)
+  {
+    if (!validSlot(slot) || !_storage->openRead(slot))
+      return false;
+    PresetReader reader(_storage);
+    uint8_t header[HEADER_SIZE];
+    bool ok = reader.get(header, HEADER_SIZE) && validHeader(header);
+    _storage->close();
+    if (ok)
+      memcpy(name, header + 4, NAME_LENGTH + 1);
+    return ok;
+  }
+
+  bool remove(int slot)
+  {
+    return validSlot(slot) && _storage->remove(slot);
+  }
+
+  // Slot last recalled, -1 before the first
+  int current() const { return _current; }
+
+  static bool validSlot(int slot) { return slot >= 0 && slot < SLOTS; }
+
+  static bool validName(const char *name)
+  {
+    size_t length = strlen(name);
+    if (length == 0 || length > (size_t)NAME_LENGTH)
+      return false;
+    for (size_t i = 0; i < length; i++)
+      if (name[i] < ' ' || name[i] > '~' || name[i] == '"' || name[i] == '\\')
+        return false;
+    return true;
+  }
+
+private:
+  IPresetStorage *_storage;
+  IPresetPatterns *_patterns;
+  int _current;
+
+  static bool validHeader(const uint8_t *header)
+  {
+    return header[0] == MAGIC_0 && header[1] == MAGIC_1 && header[2] == FORMAT_VERSION &&
+           header[3] <= MAX_PATTERNS && header[HEADER_SIZE - 1] == '\0';
+  }
+
+  // Walk a slot's preset, checking its points and CRC, applying nothing
+  bool check(int slot)
+  {
+    if (!validSlot(slot) || !_storage->openRead(slot))
+      return false;
+    PresetReader reader(_storage);
+    uint8_t header[HEADER_SIZE];
+    uint8_t config[ConfigStore::BLOB_SIZE];
+    bool ok = reader.get(header, HEADER_SIZE) && validHeader(header) &&
+              header[3] <= _patterns->patternCount() &&
+              reader.get(config, sizeof(config)) && ConfigStore::valid(config);
+    for (int i = 0; ok && i < header[3]; i++)
+    {
+      int count = reader.beginPattern();
+      ok = count >= 0 && count < TurboliftConfig::Effects::MAX_DRIVER_POINTS;
+      // Positions start at 0 and increase within the ring, as the rings require
+      uint16_t pos, last = 0;
+      CRGB color;
+      for (int j = 0; ok && j < count; j++)
+      {
+        ok = reader.point(pos, color) && pos < TurboliftConfig::Hardware::NUM_LEDS &&
+             (j == 0 ? pos == 0 : pos > last);
+        last = pos;
+      }
+    }
+    uint32_t crc = reader.crc();
+    uint8_t stored[4];
+    ok = ok && reader.get(stored, 4) &&
+         crc == ((uint32_t)stored[0] | (uint32_t)stored[1] << 8 | (uint32_t)stored[2] << 16 | (uint32_t)stored[3] << 24);
+    _storage->close();
+    return ok;
+  }
+};
@@ -0,0 +1,402 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include "config.h"
+#include "config_manager.h"
+#include "input_manager.h"
+#include "led_driver.h"
+#ifndef UNIT_TEST
+#include <ESP8266WiFi.h>
+#include <WiFiUdp.h>
+#include <lwip/igmp.h>
+#endif
+
+/**
+ * @brief Datagrams from one UDP port, read without copying them whole
+ *
+ * peek() shows the start of the next datagram so its destination can be
+ * chosen; take() then copies the rest of it straight there.
+ */
+class IUdpReceiver
+{
+public:
+  virtual ~IUdpReceiver() = default;
+  virtual bool begin(uint16_t port) = 0;
+
+  /**
+   * @brief Copy up to @p length bytes from the start of the next datagram
+   * @return Bytes copied, 0 if nothing is waiting; the datagram stays next
+   *         until take()
+   */
+  virtual size_t peek(uint8_t *header, size_t length) = 0;
+
+  /**
+   * @brief Consume the peeked datagram: skip @p skip bytes, then copy up to
+   *        @p length bytes into @p data (nothing when @p data is nullptr)
+   * @return Bytes copied
+   */
+  virtual size_t take(size_t skip, uint8_t *data, size_t length) = 0;
+};
+
+/**
+ * @brief Frames that must only be shown whole; see RealtimeInputSource
+ */
+class IRealtimeFrames
+{
+public:
+  virtual ~IRealtimeFrames() = default;
+
+  /**
+   * @brief true once per frame whose universes have all arrived
+   */
+  virtual bool takeFrame() = 0;
+
+  /**
+   * @brief true while part of the next frame is already in the buffer
+   */
+  virtual bool midFrame() const = 0;
+};
+
+/**
+ * @brief E1.31 (sACN) and Art-Net DMX receiver writing into the LED buffer
+ *
+ * Universes map onto the strip in order, Realtime::PIXELS_PER_UNIVERSE RGB
+ * pixels each, from E1.31 universe Realtime::E131_FIRST_UNIVERSE or Art-Net
+ * Port-Address Realtime::ARTNET_FIRST_UNIVERSE. Each datagram's DMX data is
+ * read from the UDP receiver straight into the driver's buffer at its
+ * universe's offset: there is no frame buffer in between.
+ *
+ * A frame is complete once every universe has arrived. Then nothing more
+ * is read, leaving the next frame's datagrams queued in lwIP, until the
+ * effect has shown it (takeFrame()), so a frame is never shown half
+ * overwritten; one not taken within Realtime::FRAME_HOLD_MS, as while the
+ * effect is stopped, is given up. If a universe repeats before the others
+ * arrive, or they have not arrived within FRAME_HOLD_MS, the frame is shown
+ * as it is. Datagrams up to 19 behind a universe's last sequence
+ * number are late and dropped (E1.31 section 6.7.2; Art-Net sequence 0
+ * means unsequenced). Nothing is written unless the effect mode is
+ * EffectMode::REALTIME; otherwise datagrams are read and discarded.
+ *
+ * An IInputSource so InputManager polls it every loop; it raises no events.
+ *
+ * @example
+ * ```cpp
+ * RealtimeInputSource realtime(&driver, NUM_LEDS, &sacnReceiver, &artnetReceiver);
+ * realtime.begin();
+ * inputManager.addInputSource(&realtime);
+ * effect.setRealtimeFrames(&realtime);
+ * ```
+ */
+class RealtimeInputSource : public IInputSource, public IRealtimeFrames
+{
+public:
+  static constexpr int MAX_UNIVERSES = 16;
+  static constexpr size_t UNIVERSE_CHANNELS = TurboliftConfig::Realtime::PIXELS_PER_UNIVERSE * 3;
+  static constexpr size_t E131_HEADER = 126;  // Root, framing and DMP layers up to the first channel
+  static constexpr size_t ARTNET_HEADER = 18; // ArtDmx up to the first channel
+
+  enum Protocol : uint8_t
+  {
+    E131,
+    ARTNET
+  };
+
+  struct DmxPacket
+  {
+    uint16_t universe;
+    uint8_t sequence;
+    bool sequenced;      // false for Art-Net sequence 0
+    size_t dataOffset;   // First channel's offset in the datagram
+    size_t dataLength;   // Channels present
+  };
+
+  struct Stats
+  {
+    uint32_t packets; // Written into the buffer
+    uint32_t frames;  // Taken by the effect
+    uint32_t partial; // Of those, shown with universes missing
+    uint32_t late;    // Dropped by sequence number
+    uint32_t ignored; // Not DMX, other universes, preview data
+    uint32_t dropped; // Whole frames never taken, overwritten after Realtime::FRAME_HOLD_MS
+  };
+
+  RealtimeInputSource(ILEDDriver *driver, int pixels, IUdpReceiver *e131, IUdpReceiver *artnet)
+      : _driver(driver), _pixels(pixels), _universes((pixels + TurboliftConfig::Realtime::PIXELS_PER_UNIVERSE - 1) / TurboliftConfig::Realtime::PIXELS_PER_UNIVERSE),
+        _e131(e131), _artnet(artnet), _received(0), _frameReady(false), _readyAt(0), _startedAt(0), _stats()
+  {
+    static_assert(sizeof(CRGB) == 3, "DMX channels are written over CRGB as r, g, b bytes");
+    if (_universes > MAX_UNIVERSES)
+      _universes = MAX_UNIVERSES;
+    _complete = (uint16_t)((1u << _universes) - 1);
+    _sequenced[E131] = _sequenced[ARTNET] = 0;
+  }
+
+  bool begin()
+  {
+    bool ok = true;
+    if (_e131)
+      ok &= _e131->begin(TurboliftConfig::Realtime::E131_PORT);
+    if (_artnet)
+      ok &= _artnet->begin(TurboliftConfig::Realtime::ARTNET_PORT);
+    return ok;
+  }
+
+  int universes() const { return _universes; }
+  const Stats &stats() const { return _stats; }
+
+  // ---- IInputSource ----
+
+  bool update(unsigned long now) override
+  {
+    bool enabled = ConfigManager::getEffectMode() == (uint8_t)TurboliftConfig::Effects::EffectMode::REALTIME;
+    if (!enabled)
+      _received = 0;
+    if (_frameReady && (!enabled || now - _readyAt >= TurboliftConfig::Realtime::FRAME_HOLD_MS))
+    {
+      // Nobody is showing frames: let the next one overwrite this one
+      _frameReady = false;
+      _received = 0;
+      _stats.dropped++;
+    }
+    else if (!_frameReady && _received && now - _startedAt >= TurboliftConfig::Realtime::FRAME_HOLD_MS)
+    {
+      // The rest of the frame is not coming: show what there is
+      _frameReady = true;
+      _readyAt = now;
+    }
+    bool wasReady = _frameReady;
+    bool wasEmpty = _received == 0;
+    for (int budget = TurboliftConfig::Realtime::MAX_PACKETS_PER_UPDATE; budget > 0 && !_frameReady; budget--)
+    {
+      if (!receive(_e131, E131, enabled) && !receive(_artnet, ARTNET, enabled))
+        break;
+    }
+    if (_frameReady && !wasReady)
+      _readyAt = now;
+    if (wasEmpty && _received)
+      _startedAt = now;
+    return false;
+  }
+
+  bool hasEvents() const override { return false; }
+  InputEvent getNextEvent() override { return {0, EventType::Released, 0, "none"}; }
+  const char *getSourceName() const override { return "Realtime"; }
+
+  // ---- IRealtimeFrames ----
+
+  bool takeFrame() override
+  {
+    if (!_frameReady)
+      return false;
+    _stats.frames++;
+    _stats.partial += _received != _complete;
+    _frameReady = false;
+    _received = 0;
+    return true;
+  }
+
+  bool midFrame() const override { return _received != 0; }
+
+  // ---- Protocols ----
+
+  /**
+   * @brief Read an E1.31 data packet's header (ANSI E1.31-2018 section 4.1)
+   * @return false if it is not DMX data, or is preview data
+   */
+  static bool parseE131(const uint8_t *data, size_t length, DmxPacket &packet)
+  {
+    static const uint8_t ACN_ID[12] = {'A', 'S', 'C', '-', 'E', '1', '.', '1', '7', 0, 0, 0};
+    if (length < E131_HEADER || data[0] != 0x00 || data[1] != 0x10 || memcmp(data + 4, ACN_ID, sizeof(ACN_ID)) != 0)
+      return false;
+    if (read32(data + 18) != 0x00000004 || read32(data + 40) != 0x00000002 || data[117] != 0x02 || data[125] != 0x00)
+      return false; // Not root/framing/DMP data, or not the null start code
+    if (data[112] & 0x80)
+      return false; // Preview data, not for live output
+    size_t count = read16(data + 123); // Start code plus channels
+    if (count < 1)
+      return false;
+    packet.universe = read16(data + 113);
+    packet.sequence = data[111];
+    packet.sequenced = true;
+    packet.dataOffset = E131_HEADER;
+    packet.dataLength = count - 1;
+    return true;
+  }
+
+  /**
+   * @brief Read an ArtDmx packet's header (Art-Net 4)
+   * @return false if it is not ArtDmx
+   */
+  static bool parseArtNet(const uint8_t *data, size_t length, DmxPacket &packet)
+  {
+    if (length < ARTNET_HEADER || memcmp(data, "Art-Net", 8) != 0 || data[8] != 0x00 || data[9] != 0x50)
+      return false; // OpDmx is 0x5000, sent low byte first
+    packet.universe = (uint16_t)(data[14] | (data[15] & 0x7F) << 8);
+    packet.sequence = data[12];
+    packet.sequenced = data[12] != 0;
+    packet.dataOffset = ARTNET_HEADER;
+    packet.dataLength = read16(data + 16);
+    return true;
+  }
+
+  /**
+   * @brief true if @p sequence is up to 19 behind @p last (E1.31 6.7.2)
+   */
+  static bool late(uint8_t sequence, uint8_t last)
+  {
+    int8_t ahead = (int8_t)(sequence - last);
+    return ahead <= 0 && ahead > -20;
+  }
+
+private:
+  ILEDDriver *_driver;
+  int _pixels;
+  int _universes;
+  IUdpReceiver *_e131;
+  IUdpReceiver *_artnet;
+  uint16_t _complete; // Bit per universe
+  uint16_t _received; // Universes of the frame being assembled
+  bool _frameReady;
+  unsigned long _readyAt;   // When the ready frame was completed
+  unsigned long _startedAt; // When the frame being assembled got its first universe
+  uint16_t _sequenced[2]; // Universes with a last sequence, per protocol
+  uint8_t _lastSequence[2][MAX_UNIVERSES];
+  Stats _stats;
+
+  static uint16_t read16(const uint8_t *p) { return (uint16_t)(p[0] << 8 | p[1]); }
+  static uint32_t read32(const uint8_t *p) { return (uint32_t)p[0] << 24 | (uint32_t)p[1] << 16 | (uint32_t)p[2] << 8 | p[3]; }
+
+  /**
+   * @brief Handle the next datagram on @p rx
+   * @return false if there was none, or it belongs to the next frame and
+   *         was left queued
+   */
+  bool receive(IUdpReceiver *rx, Protocol protocol, bool enabled)
+  {
+    if (!rx || _frameReady)
+      return false;
+    uint8_t header[E131_HEADER];
+    size_t length = rx->peek(header, protocol == E131 ? E131_HEADER : ARTNET_HEADER);
+    if (length == 0)
+      return false;
+    DmxPacket packet;
+    bool dmx = protocol == E131 ? parseE131(header, length, packet) : parseArtNet(header, length, packet);
+    int first = protocol == E131 ? TurboliftConfig::Realtime::E131_FIRST_UNIVERSE : TurboliftConfig::Realtime::ARTNET_FIRST_UNIVERSE;
+    int index = dmx ? packet.universe - first : -1;
+    if (!enabled || index < 0 || index >= _universes)
+    {
+      rx->take(0, nullptr, 0);
+      _stats.ignored++;
+      return true;
+    }
+    uint16_t bit = (uint16_t)(1u << index);
+    if (packet.sequenced && (_sequenced[protocol] & bit) && late(packet.sequence, _lastSequence[protocol][index]))
+    {
+      rx->take(0, nullptr, 0);
+      _stats.late++;
+      return true;
+    }
+    if (_received & bit)
+    {
+      // Start of the next frame: show this one as it is first
+      _frameReady = true;
+      return false;
+    }
+    if (packet.sequenced)
+    {
+      _lastSequence[protocol][index] = packet.sequence;
+      _sequenced[protocol] |= bit;
+    }
+    size_t offset = (size_t)index * UNIVERSE_CHANNELS;
+    size_t room = (size_t)_pixels * 3 - offset;
+    size_t channels = packet.dataLength < UNIVERSE_CHANNELS ? packet.dataLength : UNIVERSE_CHANNELS;
+    channels = channels < room ? channels : room;
+    rx->take(packet.dataOffset, reinterpret_cast<uint8_t *>(_driver->getBuffer()) + offset, channels);
+    _stats.packets++;
+    _received |= bit;
+    if (_received == _complete)
+      _frameReady = true;
+    return true;
+  }
+};
+
+#ifndef UNIT_TEST
+/**
+ * @brief IUdpReceiver on WiFiUDP
+ *
+ * peek() reads the header out of lwIP's pbuf; take() reads the rest from
+ * the same pbuf, so the pixel data is copied once, into its destination.
+ * With @p multicastUniverses, the E1.31 multicast groups 239.255.u.u for
+ * that many universes from Realtime::E131_FIRST_UNIVERSE are joined once
+ * the station is connected; unicast works from the start.
+ */
+class WiFiUdpReceiver : public IUdpReceiver
+{
+public:
+  explicit WiFiUdpReceiver(int multicastUniverses = 0)
+      : _multicastUniverses(multicastUniverses), _joined(false), _pending(false), _read(0) {}
+
+  bool begin(uint16_t port) override { return _udp.begin(port) == 1; }
+
+  size_t peek(uint8_t *header, size_t length) override
+  {
+    if (!_joined && _multicastUniverses && WiFi.status() == WL_CONNECTED)
+      joinGroups();
+    if (!_pending)
+    {
+      // parsePacket() drops whatever is left of the last datagram
+      if (_udp.parsePacket() <= 0)
+        return 0;
+      int n = _udp.read(_header, length < sizeof(_header) ? length : sizeof(_header));
+      _read = n > 0 ? (size_t)n : 0;
+      _pending = _read > 0;
+    }
+    size_t n = _read < length ? _read : length;
+    memcpy(header, _header, n);
+    return n;
+  }
+
+  size_t take(size_t skip, uint8_t *data, size_t length) override
+  {
+    _pending = false;
+    if (!data)
+      return 0;
+    size_t n = 0;
+    if (skip < _read)
+    {
+      // The header read went past the skip: those bytes come from it
+      n = _read - skip < length ? _read - skip : length;
+      memcpy(data, _header + skip, n);
+    }
+    else
+    {
+      for (size_t i = _read; i < skip; i++)
+        _udp.read();
+    }
+    int more = _udp.read(data + n, length - n);
+    return n + (more > 0 ? (size_t)more : 0);
+  }
+
+private:
+  WiFiUDP _udp;
+  int _multicastUniverses;
+  bool _joined;
+  bool _pending; // Header read, rest of the datagram not yet taken
+  size_t _read;
+  uint8_t _header[RealtimeInputSource::E131_HEADER];
+
+  void joinGroups()
+  {
+    for (int i = 0; i < _multicastUniverses; i++)
+    {
+      uint16_t universe = TurboliftConfig::Realtime::E131_FIRST_UNIVERSE + i;
+      ip4_addr_t group;
+      IP4_ADDR(&group, 239, 255, universe >> 8, universe & 0xFF);
+      igmp_joingroup(IP4_ADDR_ANY4, &group);
+    }
+    _joined = true;
+  }
+};
+#endif
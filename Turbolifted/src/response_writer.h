@@ -0,0 +1,236 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#ifndef UNIT_TEST
+#include <Arduino.h>
+#else
+// Host stand-ins for the ESP8266 flash string helpers: flash is plain memory
+class __FlashStringHelper;
+#define FPSTR(p) (reinterpret_cast<const __FlashStringHelper *>(p))
+#define F(text) FPSTR(text)
+#define PROGMEM
+#define PGM_P const char *
+#define memcpy_P memcpy
+#define strlen_P strlen
+#endif
+
+/**
+ * @brief Destination of a ResponseWriter: status line and headers, then body
+ *
+ * begin() is called once, with the body length if the whole response fitted
+ * in the writer's buffer, or UNKNOWN_LENGTH if it is sent in pieces.
+ */
+class IResponseSink
+{
+public:
+  static constexpr size_t UNKNOWN_LENGTH = (size_t)-1;
+
+  virtual ~IResponseSink() = default;
+  virtual void begin(int code, const char *contentType, size_t length) = 0;
+  virtual void write(const char *data, size_t length) = 0;
+  virtual void end() = 0;
+};
+
+/**
+ * @brief Builds an HTTP response body in a fixed buffer, without String
+ *
+ * Text, numbers and JSON are formatted straight into a caller-owned buffer;
+ * F() text is copied from flash as it is written. A body that fits is sent
+ * in one piece with its Content-Length. One that does not is sent in
+ * buffer-sized pieces as it is built, so the buffer bounds the memory a
+ * response takes however long it grows. Nothing is allocated either way.
+ *
+ * The JSON helpers place the commas: key() and the value calls separate
+ * themselves from whatever came before them in the same object or array.
+ *
+ * @example
+ * ```cpp
+ * ResponseWriter out(sink, buffer, sizeof(buffer), 200, "application/json");
+ * out.beginObject().field(F("speed"), 5).field(F("name"), "Bridge").endObject();
+ * out.end(); // {"speed":5,"name":"Bridge"}
+ * ```
+ */
+class ResponseWriter
+{
+public:
+  ResponseWriter(IResponseSink &sink, char *buffer, size_t capacity, int code, const char *contentType)
+      : _sink(sink), _buffer(buffer), _capacity(capacity), _length(0), _code(code), _contentType(contentType),
+        _streaming(false), _ended(false), _needComma(false) {}
+
+  ResponseWriter(const ResponseWriter &) = delete;
+  ResponseWriter &operator=(const ResponseWriter &) = delete;
+
+  ~ResponseWriter() { end(); }
+
+  ResponseWriter &print(const char *text) { return append(text, strlen(text), false); }
+  ResponseWriter &print(const __FlashStringHelper *text)
+  {
+    PGM_P p = reinterpret_cast<PGM_P>(text);
+    return append(p, strlen_P(p), true);
+  }
+  ResponseWriter &print(char c) { return append(&c, 1, false); }
+  ResponseWriter &print(int value) { return print((long)value); }
+  ResponseWriter &print(unsigned int value) { return print((unsigned long)value); }
+  ResponseWriter &print(long value)
+  {
+    if (value < 0)
+    {
+      print('-');
+      return print(0UL - (unsigned long)value);
+    }
+    return print((unsigned long)value);
+  }
+  ResponseWriter &print(unsigned long value)
+  {
+    char digits[20];
+    int n = 0;
+    do
+    {
+      digits[n++] = (char)('0' + value % 10);
+      value /= 10;
+    } while (value);
+    while (n)
+      print(digits[--n]);
+    return *this;
+  }
+
+  ResponseWriter &beginObject() { return open('{'); }
+  ResponseWriter &endObject() { return close('}'); }
+  ResponseWriter &beginArray() { return open('['); }
+  ResponseWriter &endArray() { return close(']'); }
+
+  /**
+   * @brief Start an object member: "name": (the value follows)
+   */
+  ResponseWriter &key(const __FlashStringHelper *name)
+  {
+    separate();
+    print('"').print(name).print(F("\":"));
+    _needComma = false;
+    return *this;
+  }
+
+  ResponseWriter &value(long number)
+  {
+    separate();
+    print(number);
+    _needComma = true;
+    return *this;
+  }
+  ResponseWriter &value(int number) { return value((long)number); }
+
+  /**
+   * @brief A JSON string, with quotes, backslashes and control characters escaped
+   */
+  ResponseWriter &value(const char *text)
+  {
+    separate();
+    print('"');
+    for (; *text; ++text)
+    {
+      unsigned char c = (unsigned char)*text;
+      if (c == '"' || c == '\\')
+        print('\\').print((char)c);
+      else if (c < 0x20)
+      {
+        static const char hex[] = "0123456789abcdef";
+        print(F("\\u00")).print(hex[c >> 4]).print(hex[c & 0x0f]);
+      }
+      else
+        print((char)c);
+    }
+    print('"');
+    _needComma = true;
+    return *this;
+  }
+
+  template <typename T>
+  ResponseWriter &field(const __FlashStringHelper *name, T v)
+  {
+    key(name);
+    return value(v);
+  }
+
+  /**
+   * @brief Send what is left and finish the response; later calls do nothing
+   */
+  void end()
+  {
+    if (_ended)
+      return;
+    if (!_streaming)
+      _sink.begin(_code, _contentType, _length);
+    if (_length)
+      _sink.write(_buffer, _length);
+    _sink.end();
+    _ended = true;
+  }
+
+private:
+  IResponseSink &_sink;
+  char *_buffer;
+  size_t _capacity;
+  size_t _length;
+  int _code;
+  const char *_contentType;
+  bool _streaming; // Headers sent without a length; the body goes in pieces
+  bool _ended;
+  bool _needComma; // A JSON value precedes the next one at this level
+
+  ResponseWriter &append(const char *data, size_t length, bool flash)
+  {
+    if (_ended)
+      return *this;
+    while (length)
+    {
+      if (_length == _capacity)
+        flush();
+      size_t n = length < _capacity - _length ? length : _capacity - _length;
+      if (flash)
+        memcpy_P(_buffer + _length, data, n);
+      else
+        memcpy(_buffer + _length, data, n);
+      _length += n;
+      data += n;
+      length -= n;
+    }
+    return *this;
+  }
+
+  /**
+   * @brief Send the full buffer; the first time, the headers go first
+   */
+  void flush()
+  {
+    if (!_streaming)
+    {
+      _sink.begin(_code, _contentType, IResponseSink::UNKNOWN_LENGTH);
+      _streaming = true;
+    }
+    _sink.write(_buffer, _length);
+    _length = 0;
+  }
+
+  void separate()
+  {
+    if (_needComma)
+      print(',');
+  }
+
+  ResponseWriter &open(char bracket)
+  {
+    separate();
+    print(bracket);
+    _needComma = false;
+    return *this;
+  }
+
+  ResponseWriter &close(char bracket)
+  {
+    print(bracket);
+    _needComma = true;
+    return *this;
+  }
+};
@@ -0,0 +1,663 @@
+#pragma once
+
+#include "led_driver.h"
+#include "color_math.h"
+#include "driver_points.h"
+
+/**
+ * @file ring_buffer.h
+ * @brief Storage layouts for the rotating gradient patterns
+ *
+ * Every layout takes the pattern as a stream of driver points
+ * (beginPoints / addPoint / closePoints) and draws it rotated by a Q8 offset
+ * (blit / add / render). Effects pick a layout with
+ * TurboliftConfig::Effects::RING_LAYOUT:
+ * - GradientRing keeps only the driver points and evaluates the gradient
+ *   while blitting: 768 bytes at 756 LEDs instead of a 2268-byte RGB array
+ * - MirroredRing keeps the pattern twice back to back, so every rotation is
+ *   a linear read
+ * - WrappedRing keeps it once and wraps with one branch per pixel
+ * - Rgb565Ring keeps it once as 16-bit pixels, expanded back to CRGB in
+ *   the blit: two thirds of WrappedRing's RAM, at most 4 steps off per channel
+ *
+ * Driver points must start at position 0 and increase; closePoints() joins
+ * the last point back to the first across the end of the ring.
+ *
+ * Effect rings also expose their driver points (pointCount / pointPosition /
+ * pointColor), so a pattern can be recoloured with its positions unchanged:
+ * setPointColor() for each driver, then commitColors(). The pixel layouts
+ * keep only the positions, as a bitmap (Recolorable).
+ */
+
+/**
+ * @brief Streams driver points into a pixel array, filling each segment
+ *        with ColorMath::fillGradient as soon as its end point arrives
+ * @tparam Pixel Stored pixel type, assignable from CRGB
+ */
+template <typename Pixel>
+class BasicGradientRasterizer
+{
+public:
+  BasicGradientRasterizer(Pixel *dst, int length) : _dst(dst), _length(length), _count(0), _lastPos(0) {}
+
+  void beginPoints() { _count = 0; }
+
+  bool addPoint(int pos, const CRGB &color)
+  {
+    if (pos > _length || (_count > 0 && pos <= _lastPos))
+      return false;
+    if (_count == 0)
+      _first = color;
+    else
+      ColorMath::fillGradient(_dst + _lastPos, pos - _lastPos, _last, color);
+    _lastPos = pos;
+    _last = color;
+    _count++;
+    return true;
+  }
+
+  void closePoints()
+  {
+    if (_count > 0)
+      addPoint(_length, _first);
+  }
+
+private:
+  Pixel *_dst;
+  int _length;
+  int _count;
+  int _lastPos;
+  CRGB _first;
+  CRGB _last;
+};
+
+using GradientRasterizer = BasicGradientRasterizer<CRGB>;
+
+/**
+ * @brief 16-bit 5-6-5 pixel
+ *
+ * Packing rounds to the nearest level and unpacking replicates the top bits
+ * into the low ones, so 0 and 255 survive exactly and every channel is
+ * within 4 (green: 2) of the original.
+ */
+struct Rgb565
+{
+  uint16_t value;
+
+  Rgb565() : value(0) {}
+  Rgb565(const CRGB &c)
+      : value((uint16_t)(((c.r * 31 + 127) / 255) << 11 | ((c.g * 63 + 127) / 255) << 5 | (c.b * 31 + 127) / 255)) {}
+
+  CRGB toCRGB() const
+  {
+    uint8_t r = value >> 11, g = (value >> 5) & 0x3F, b = value & 0x1F;
+    return CRGB((uint8_t)(r << 3 | r >> 2), (uint8_t)(g << 2 | g >> 4), (uint8_t)(b << 3 | b >> 2));
+  }
+};
+
+/**
+ * @brief Hand the first @p n pixels produced by reader.fill() to the driver
+ *        in stack-sized spans, written or added (saturating)
+ */
+template <typename Reader>
+static inline void emitSpans(ILEDDriver &driver, int n, Reader &reader, bool add)
+{
+  constexpr int CHUNK_PIXELS = 32; // Stack staging per driver span call
+  CRGB chunk[CHUNK_PIXELS];
+  for (int start = 0; start < n; start += CHUNK_PIXELS)
+  {
+    int count = n - start < CHUNK_PIXELS ? n - start : CHUNK_PIXELS;
+    reader.fill(chunk, count);
+    if (add)
+      driver.addSpan(start, chunk, count);
+    else
+      driver.writeSpan(start, chunk, count);
+  }
+}
+
+/**
+ * @brief Ring of N pixels stored twice back to back
+ *
+ * With the pattern mirrored into a second copy, the pixels for any rotation
+ * sit contiguously at window(offset), so a frame is one linear read (a memcpy
+ * for whole-pixel offsets) with no division or wrap test. Costs N extra
+ * pixels over WrappedRing.
+ *
+ * Pixels may also be written directly through data(); call commit() after.
+ */
+template <int N>
+class MirroredRing
+{
+public:
+  static constexpr int length = N;
+
+  MirroredRing() : _raster(_pixels, N) {}
+
+  void beginPoints() { _raster.beginPoints(); }
+  bool addPoint(int pos, const CRGB &color) { return _raster.addPoint(pos, color); }
+  void closePoints()
+  {
+    _raster.closePoints();
+    commit();
+  }
+
+  CRGB *data() { return _pixels; }
+  const CRGB *data() const { return _pixels; }
+
+  /**
+   * @brief Copy the pattern into the mirror half; call after writing data()
+   */
+  void commit() { memcpy(_pixels + N, _pixels, N * sizeof(CRGB)); }
+
+  /**
+   * @brief Contiguous view of the ring rotated by @p offset whole pixels
+   * @return window(o)[i] == data()[(o + i) % N] for 0 <= i <= N
+   */
+  const CRGB *window(int offset) const { return _pixels + wrapOffset(offset, N); }
+
+  /**
+   * @brief Write the ring, rotated by @p offsetQ8 (1/256 pixels), to the driver
+   */
+  void blit(ILEDDriver &driver, uint32_t offsetQ8) const
+  {
+    driver.blitSubpixel(window((int)(offsetQ8 >> 8)), N, (uint8_t)(offsetQ8 & 0xFF));
+  }
+
+  /**
+   * @brief Add the rotated ring onto the driver buffer (saturating)
+   */
+  void add(ILEDDriver &driver, uint32_t offsetQ8) const
+  {
+    driver.addSubpixel(window((int)(offsetQ8 >> 8)), N, (uint8_t)(offsetQ8 & 0xFF));
+  }
+
+  /**
+   * @brief Write the first @p n rotated pixels (at most N) to @p dst
+   */
+  void render(CRGB *dst, int n, uint32_t offsetQ8) const
+  {
+    linearBlend(dst, n < N ? n : N, window((int)(offsetQ8 >> 8)), (uint8_t)(offsetQ8 & 0xFF));
+  }
+
+private:
+  CRGB _pixels[2 * N];
+  GradientRasterizer _raster;
+};
+
+/**
+ * @brief Ring of N pixels stored once, wrapping with a single branch per
+ *        pixel (rotatedBlend) instead of reading a mirrored copy
+ */
+template <int N>
+class WrappedRing
+{
+public:
+  static constexpr int length = N;
+
+  WrappedRing() : _raster(_pixels, N) {}
+
+  void beginPoints() { _raster.beginPoints(); }
+  bool addPoint(int pos, const CRGB &color) { return _raster.addPoint(pos, color); }
+  void closePoints() { _raster.closePoints(); }
+
+  CRGB *data() { return _pixels; }
+  const CRGB *data() const { return _pixels; }
+
+  void commit() {} // Nothing mirrored
+
+  void blit(ILEDDriver &driver, uint32_t offsetQ8) const
+  {
+    driver.blitRotatedSubpixel(_pixels, N, offsetQ8);
+  }
+
+  void add(ILEDDriver &driver, uint32_t offsetQ8) const
+  {
+    driver.addRotatedSubpixel(_pixels, N, offsetQ8);
+  }
+
+  void render(CRGB *dst, int n, uint32_t offsetQ8) const
+  {
+    rotatedBlend(dst, n, _pixels, N, offsetQ8);
+  }
+
+private:
+  CRGB _pixels[N];
+  GradientRasterizer _raster;
+};
+
+/**
+ * @brief Ring of N pixels stored once as Rgb565
+ *
+ * The gradient is rasterised straight into 16-bit pixels; the blit expands
+ * them to CRGB (with the sub-pixel blend) in chunks handed to the driver as
+ * spans, so no full-size CRGB copy ever exists.
+ */
+template <int N>
+class Rgb565Ring
+{
+public:
+  static constexpr int length = N;
+
+  Rgb565Ring() : _raster(_pixels, N) {}
+
+  void beginPoints() { _raster.beginPoints(); }
+  bool addPoint(int pos, const CRGB &color) { return _raster.addPoint(pos, color); }
+  void closePoints() { _raster.closePoints(); }
+
+  Rgb565 *data() { return _pixels; }
+  const Rgb565 *data() const { return _pixels; }
+
+  void blit(ILEDDriver &driver, uint32_t offsetQ8) const { emit(driver, offsetQ8, false); }
+
+  void add(ILEDDriver &driver, uint32_t offsetQ8) const { emit(driver, offsetQ8, true); }
+
+  void render(CRGB *dst, int n, uint32_t offsetQ8) const
+  {
+    Reader reader(*this, offsetQ8);
+    reader.fill(dst, n < N ? n : N);
+  }
+
+private:
+  Rgb565 _pixels[N];
+  BasicGradientRasterizer<Rgb565> _raster;
+
+  void emit(ILEDDriver &driver, uint32_t offsetQ8, bool add) const
+  {
+    Reader reader(*this, offsetQ8);
+    emitSpans(driver, N, reader, add);
+  }
+
+  // Expands the rotated ring, carrying the wrap index from chunk to chunk
+  class Reader
+  {
+  public:
+    Reader(const Rgb565Ring &ring, uint32_t offsetQ8)
+        : _pixels(ring._pixels), _index(wrapOffset((int)(offsetQ8 >> 8), N)), _frac((uint8_t)(offsetQ8 & 0xFF)),
+          _current(ring._pixels[_index].toCRGB()) {}
+
+    void fill(CRGB *dst, int count)
+    {
+      for (int i = 0; i < count; i++)
+      {
+        if (++_index == N)
+          _index = 0;
+        CRGB following = _pixels[_index].toCRGB();
+        dst[i] = _frac ? lerpPixel(_current, following, _frac) : _current;
+        _current = following;
+      }
+    }
+
+  private:
+    const Rgb565 *_pixels;
+    int _index;
+    uint8_t _frac;
+    CRGB _current;
+  };
+};
+
+/**
+ * @brief Ring of N pixels kept as its driver points only
+ *
+ * The piecewise-linear gradient is evaluated during the blit by a segment
+ * walker that steps the same Q16 ratio and error term as fillGradient, so the
+ * output is bit-identical to rasterising the points first. Only the segment
+ * under the first pixel costs a division; pixels are produced in chunks and
+ * handed to the driver as spans.
+ *
+ * @tparam MaxPoints Capacity including the closing point; extra points are
+ *         dropped (addPoint returns false)
+ */
+template <int N, int MaxPoints>
+class GradientRing
+{
+public:
+  static constexpr int length = N;
+
+  void beginPoints() { _points.clear(); }
+
+  bool addPoint(int pos, const CRGB &color)
+  {
+    // The last slot is reserved for the closing point
+    int count = _points.size();
+    if (count >= MaxPoints - 1 || pos < 0 || pos >= N || (count > 0 && pos <= _points.position(count - 1)))
+      return false;
+    return _points.push((uint16_t)pos, color);
+  }
+
+  void closePoints()
+  {
+    if (!_points.empty())
+      _points.push((uint16_t)N, _points.color(0));
+  }
+
+  /**
+   * @brief Number of stored points, including the closing point
+   */
+  int size() const { return _points.size(); }
+
+  /**
+   * @brief Number of driver points, excluding the closing point
+   */
+  int pointCount() const { return _points.size() > 1 && _points.position(_points.size() - 1) == N ? _points.size() - 1 : _points.size(); }
+  uint16_t pointPosition(int i) const { return _points.position(i); }
+  const CRGB &pointColor(int i) const { return _points.color(i); }
+
+  void setPointColor(int i, const CRGB &color)
+  {
+    _points.color(i) = color;
+    if (i == 0 && pointCount() < _points.size())
+      _points.color(_points.size() - 1) = color; // The closing point repeats the first
+  }
+
+  void commitColors() {} // Colours are read at blit time
+
+  void blit(ILEDDriver &driver, uint32_t offsetQ8) const { emit(driver, offsetQ8, false); }
+
+  void add(ILEDDriver &driver, uint32_t offsetQ8) const { emit(driver, offsetQ8, true); }
+
+  void render(CRGB *dst, int n, uint32_t offsetQ8) const
+  {
+    Walker walker(*this, offsetQ8);
+    walker.fill(dst, n < N ? n : N);
+  }
+
+private:
+  DriverPoints<MaxPoints> _points;
+
+  void emit(ILEDDriver &driver, uint32_t offsetQ8, bool add) const
+  {
+    Walker walker(*this, offsetQ8);
+    emitSpans(driver, N, walker, add);
+  }
+
+  // Walks the rotated ring pixel by pixel, one gradient segment at a time
+  class Walker
+  {
+  public:
+    Walker(const GradientRing &ring, uint32_t offsetQ8)
+        : _ring(ring), _frac((uint8_t)(offsetQ8 & 0xFF))
+    {
+      if (ring._points.size() < 2)
+        return;
+      int whole = wrapOffset((int)(offsetQ8 >> 8), N);
+      // Last segment starting at or before the first pixel
+      int lo = 0, hi = ring._points.size() - 2;
+      while (lo < hi)
+      {
+        int mid = (lo + hi + 1) / 2;
+        if (ring._points.position(mid) <= whole)
+          lo = mid;
+        else
+          hi = mid - 1;
+      }
+      enter(lo, whole - ring._points.position(lo));
+      _current = next();
+    }
+
+    void fill(CRGB *dst, int count)
+    {
+      if (_ring._points.size() < 2)
+      {
+        for (int i = 0; i < count; i++)
+          dst[i] = CRGB(0, 0, 0);
+        return;
+      }
+      for (int i = 0; i < count; i++)
+      {
+        CRGB following = next();
+        dst[i] = _frac ? lerpPixel(_current, following, _frac) : _current;
+        _current = following;
+      }
+    }
+
+  private:
+    const GradientRing &_ring;
+    uint8_t _frac;
+    int _segment = 0;
+    int _remaining = 0;
+    uint32_t _err = 0;
+    uint32_t _rem = 0;
+    uint32_t _den = 1;
+    // Per channel: (a << 16) + (b - a) * t, i.e. lerp8 before its final shift,
+    // advanced by (b - a) * step per pixel plus (b - a) on each error carry
+    int32_t _acc[3];
+    int32_t _accStep[3];
+    int32_t _delta[3];
+    CRGB _current;
+
+    // Start segment s at its k-th pixel, as fillGradient would have reached it
+    void enter(int s, int k)
+    {
+      _segment = s;
+      const DriverPoints<MaxPoints> &points = _ring._points;
+      int len = points.position(s + 1) - points.position(s);
+      const CRGB &a = points.color(s);
+      const CRGB &b = points.color(s + 1);
+      _den = len > 1 ? (uint32_t)(len - 1) : 1;
+      ColorMath::q16_t step = len > 1 ? ColorMath::Q16_ONE / _den : 0;
+      _rem = len > 1 ? ColorMath::Q16_ONE % _den : 0;
+      ColorMath::q16_t t = (ColorMath::q16_t)k * step + (uint32_t)k * _rem / _den;
+      _err = (uint32_t)k * _rem % _den;
+      _remaining = len - k;
+
+      const uint8_t from[3] = {a.r, a.g, a.b};
+      const uint8_t to[3] = {b.r, b.g, b.b};
+      for (int c = 0; c < 3; c++)
+      {
+        _delta[c] = (int32_t)to[c] - (int32_t)from[c];
+        _acc[c] = ((int32_t)from[c] << 16) + _delta[c] * (int32_t)t;
+        _accStep[c] = _delta[c] * (int32_t)step;
+      }
+    }
+
+    CRGB next()
+    {
+      if (_remaining == 0)
+        enter(_segment + 1 < _ring._points.size() - 1 ? _segment + 1 : 0, 0);
+      CRGB c((uint8_t)(_acc[0] >> 16), (uint8_t)(_acc[1] >> 16), (uint8_t)(_acc[2] >> 16));
+      _err += _rem;
+      bool carry = _err >= _den;
+      if (carry)
+        _err -= _den;
+      for (int i = 0; i < 3; i++)
+        _acc[i] += _accStep[i] + (carry ? _delta[i] : 0);
+      _remaining--;
+      return c;
+    }
+  };
+};
+
+/**
+ * @brief Pixel ring that can be recoloured with its driver positions unchanged
+ *
+ * Only the positions are kept, one bit per pixel. A driver's colour is the
+ * pixel at its position, where the rasterised segment starts exactly on it
+ * (colours are rounded to Rgb565 first for that layout), so setPointColor() writes that pixel and
+ * commitColors() rasterises the ring again from the driver pixels. That is
+ * N / 8 bytes over the bare ring, instead of a point list.
+ *
+ * @tparam MaxPoints Capacity including the closing point, as for GradientRing
+ */
+template <typename Ring, int MaxPoints>
+class Recolorable : public Ring
+{
+public:
+  Recolorable() : _count(0), _cursor(-1), _cursorPos(0) { memset(_marks, 0, sizeof(_marks)); }
+
+  void beginPoints()
+  {
+    memset(_marks, 0, sizeof(_marks));
+    _count = 0;
+    _cursor = -1;
+    Ring::beginPoints();
+  }
+
+  bool addPoint(int pos, const CRGB &color)
+  {
+    // The last slot is reserved for the closing point
+    if (_count >= MaxPoints - 1 || pos < 0 || pos >= Ring::length || !Ring::addPoint(pos, held(color, Ring::data())))
+      return false;
+    _marks[pos >> 3] |= (uint8_t)(1 << (pos & 7));
+    _count++;
+    return true;
+  }
+
+  int pointCount() const { return _count; }
+
+  /**
+   * @brief Position of driver @p i; constant time per step when walked in order
+   */
+  uint16_t pointPosition(int i) const
+  {
+    if (_cursor < 0 || i < _cursor)
+    {
+      _cursor = 0;
+      _cursorPos = nextMark(0);
+    }
+    for (; _cursor < i; _cursor++)
+      _cursorPos = nextMark(_cursorPos + 1);
+    return _cursorPos;
+  }
+
+  CRGB pointColor(int i) const { return toCRGB(Ring::data()[pointPosition(i)]); }
+  void setPointColor(int i, const CRGB &color) { Ring::data()[pointPosition(i)] = color; }
+
+  /**
+   * @brief Rasterise the ring again from the driver pixels
+   */
+  void commitColors()
+  {
+    // Each driver pixel is read before the segment ending on it is filled
+    Ring::beginPoints();
+    for (int i = 0; i < _count; i++)
+    {
+      uint16_t pos = pointPosition(i);
+      Ring::addPoint(pos, toCRGB(Ring::data()[pos]));
+    }
+    Ring::closePoints();
+  }
+
+private:
+  uint8_t _marks[(Ring::length + 7) / 8]; // Bit per pixel: a driver starts there
+  int _count;
+  mutable int _cursor; // Driver last found by pointPosition()
+  mutable uint16_t _cursorPos;
+
+  uint16_t nextMark(int pos) const
+  {
+    while (pos < Ring::length && !(_marks[pos >> 3] & (1 << (pos & 7))))
+      pos++;
+    return (uint16_t)pos;
+  }
+
+  static CRGB toCRGB(const CRGB &pixel) { return pixel; }
+  static CRGB toCRGB(const Rgb565 &pixel) { return pixel.toCRGB(); }
+
+  // The colour as a pixel holds it, so the driver pixel reads back what was added
+  static CRGB held(const CRGB &color, const CRGB *) { return color; }
+  static CRGB held(const CRGB &color, const Rgb565 *) { return Rgb565(color).toCRGB(); }
+};
+
+/**
+ * @brief Fades a ring's driver colours to new ones, positions unchanged
+ *
+ * begin() records the current colours and the targets; apply() writes the
+ * blend for a 0-255 progress back into the ring. Recolouring touches one
+ * colour per driver (about 75 per pattern) instead of regenerating it.
+ */
+template <int Capacity>
+class DriverCrossfade
+{
+public:
+  DriverCrossfade() : _count(0) {}
+
+  /**
+   * @brief Start a fade from @p ring's colours to newColor(driverIndex)
+   */
+  template <typename Ring, typename ColorFn>
+  void begin(const Ring &ring, ColorFn newColor)
+  {
+    _count = ring.pointCount() < Capacity ? ring.pointCount() : Capacity;
+    for (int i = 0; i < _count; i++)
+    {
+      _from[i] = ring.pointColor(i);
+      _to[i] = newColor(i);
+    }
+  }
+
+  /**
+   * @brief Recolour @p ring at @p progress (255 == the new colours exactly)
+   */
+  template <typename Ring>
+  void apply(Ring &ring, uint8_t progress) const
+  {
+    for (int i = 0; i < _count; i++)
+      ring.setPointColor(i, progress == 255 ? _to[i] : lerpPixel(_from[i], _to[i], progress));
+    ring.commitColors();
+  }
+
+private:
+  CRGB _from[Capacity];
+  CRGB _to[Capacity];
+  int _count;
+};
+
+/**
+ * @brief A front ring for drawing and a back ring for building the next
+ *        pattern a few points at a time
+ *
+ * swap() exchanges the two by pointer between frames, so a new pattern
+ * appears with no copy and a half-built one is never drawn.
+ */
+template <typename Ring>
+class DoubleRing
+{
+public:
+  DoubleRing() : _front(&_rings[0]), _back(&_rings[1]) {}
+  DoubleRing(const DoubleRing &) = delete;
+  DoubleRing &operator=(const DoubleRing &) = delete;
+
+  Ring &front() { return *_front; }
+  const Ring &front() const { return *_front; }
+  Ring &back() { return *_back; }
+  const Ring &back() const { return *_back; }
+
+  void swap()
+  {
+    Ring *shown = _back;
+    _back = _front;
+    _front = shown;
+  }
+
+private:
+  Ring _rings[2];
+  Ring *_front;
+  Ring *_back;
+};
+
+/**
+ * @brief Maps a RingLayout onto its ring type, recolourable in place
+ */
+template <int N, TurboliftConfig::Effects::RingLayout Layout, int MaxPoints>
+struct EffectRing
+{
+  using type = GradientRing<N, MaxPoints>;
+};
+
+template <int N, int MaxPoints>
+struct EffectRing<N, TurboliftConfig::Effects::RingLayout::MIRRORED, MaxPoints>
+{
+  using type = Recolorable<MirroredRing<N>, MaxPoints>;
+};
+
+template <int N, int MaxPoints>
+struct EffectRing<N, TurboliftConfig::Effects::RingLayout::WRAPPED, MaxPoints>
+{
+  using type = Recolorable<WrappedRing<N>, MaxPoints>;
+};
+
+template <int N, int MaxPoints>
+struct EffectRing<N, TurboliftConfig::Effects::RingLayout::RGB565, MaxPoints>
+{
+  using type = Recolorable<Rgb565Ring<N>, MaxPoints>;
+};
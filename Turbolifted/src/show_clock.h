@@ -0,0 +1,254 @@
+#pragma once
+
+#include <stdint.h>
+#include "config.h"
+
+/**
+ * @brief Show time shared between units: the leader's clock, followed
+ *
+ * Each unit's millis() runs from its own boot on its own crystal, so two
+ * rigs rotating at the same speed drift apart. Show time is one clock for
+ * the whole set: the leader's local time plus a fixed offset, and on a
+ * follower its local time plus an offset estimated from the leader's
+ * beacons (see ShowSync). All arithmetic is integer; times wrap like
+ * millis().
+ *
+ * A beacon gives the leader's show time when sent. Network and loop delay
+ * only make it arrive late, so of the last Sync::WINDOW beacons the one
+ * implying the largest offset (the least delayed) is taken, each projected
+ * to now with the drift estimate. Drift is the slope between the best
+ * beacons of blocks of Sync::WINDOW, a few blocks apart, smoothed.
+ *
+ * The offset is not stepped to each estimate. The first, and any error over
+ * Sync::STEP_MS, is stepped; smaller errors are slewed out with time
+ * constant Sync::SLEW_TIME_MS, at most Sync::MAX_SLEW_PPM, so show time
+ * never jumps or runs backwards while in sync. After Sync::TIMEOUT_MS
+ * without a beacon the follower is no longer locked() and free-runs at the
+ * estimated drift.
+ *
+ * @example
+ * ```cpp
+ * ShowClock clock;
+ * clock.onBeacon(leaderShowMs, millis(), seed); // Followers, per beacon
+ * clock.update(millis());                       // Every loop
+ * motion.lock(speed, clock.now(millis()), MOTION_TICK_MS);
+ * ```
+ */
+class ShowClock
+{
+public:
+  static constexpr int WINDOW = TurboliftConfig::Sync::WINDOW;
+  static constexpr int ANCHORS = 4; // Blocks spanned by the drift estimate
+
+  ShowClock()
+      : _leader(false), _acquired(false), _locked(false), _seed(0), _offsetQ8(0), _base(0), _rateQ24(0),
+        _driftQ24(0), _haveDrift(false), _count(0), _next(0), _lastBeacon(0), _blockCount(0), _blockBest(0),
+        _blockAt(0), _anchorCount(0), _nextAnchor(0), _steps(0) {}
+
+  /**
+   * @brief Lead the set: show time runs on from where it is, at the local rate
+   */
+  void setLeader(bool leader)
+  {
+    _leader = leader;
+    _locked = false;
+    _rateQ24 = 0;
+  }
+
+  bool leader() const { return _leader; }
+
+  /**
+   * @brief true while a follower has had a beacon within Sync::TIMEOUT_MS
+   */
+  bool locked() const { return _locked; }
+
+  /**
+   * @brief true if show time is the set's: leading, or locked to the leader
+   */
+  bool synced() const { return _leader || _locked; }
+
+  /**
+   * @brief Pattern seed of the set: the leader's own, or the last one beaconed
+   */
+  uint32_t seed() const { return _seed; }
+  void setSeed(uint32_t seed) { _seed = seed; }
+
+  /**
+   * @brief Show time in ms at local time @p localMs
+   */
+  uint32_t now(uint32_t localMs) const { return localMs + (uint32_t)(offsetQ8(localMs) >> 8); }
+
+  /**
+   * @brief Show time minus local time, in ms
+   */
+  int32_t offsetMs() const { return (int32_t)(_offsetQ8 >> 8); }
+
+  /**
+   * @brief Estimated rate of the leader's clock against this one's, in ppm
+   */
+  int32_t driftPpm() const { return (int32_t)(((int64_t)_driftQ24 * 1000000) >> 24); }
+
+  /**
+   * @brief Times the offset was stepped rather than slewed
+   */
+  uint32_t steps() const { return _steps; }
+
+  /**
+   * @brief A leader's beacon: its show time when sent, and local time now
+   */
+  void onBeacon(uint32_t leaderShowMs, uint32_t localMs, uint32_t seed)
+  {
+    if (_leader)
+      return;
+    int32_t offset = (int32_t)(leaderShowMs - localMs);
+    if (!_locked)
+    {
+      // (Re)acquiring: samples against another leader, or from before a
+      // gap, say nothing about this one. The drift estimate is kept.
+      _count = _next = 0;
+      _blockCount = _anchorCount = _nextAnchor = 0;
+      if (!_acquired)
+      {
+        rebase(localMs);
+        _offsetQ8 = (int64_t)offset << 8;
+        _steps++;
+      }
+      _acquired = _locked = true;
+    }
+    _samples[_next] = {localMs, offset};
+    _next = (_next + 1) % WINDOW;
+    if (_count < WINDOW)
+      _count++;
+    addToBlock(localMs, offset);
+    _lastBeacon = localMs;
+    _seed = seed;
+    update(localMs);
+  }
+
+  /**
+   * @brief Steer show time towards the estimate; call every loop
+   */
+  void update(uint32_t localMs)
+  {
+    if (_leader || !_acquired)
+      return;
+    rebase(localMs);
+    if (_locked && localMs - _lastBeacon >= TurboliftConfig::Sync::TIMEOUT_MS)
+      _locked = false;
+    if (!_locked)
+    {
+      _rateQ24 = _driftQ24; // Free-run at the leader's estimated rate
+      return;
+    }
+    // Offsets wrap with the 32-bit clocks: keep the error's low 40 bits, signed
+    int64_t error = (int64_t)((uint64_t)(target(localMs) - _offsetQ8) << 24) >> 24;
+    if (error > STEP_Q8 || error < -STEP_Q8)
+    {
+      _offsetQ8 += error;
+      _rateQ24 = _driftQ24;
+      _steps++;
+      return;
+    }
+    int64_t slew = (error << 16) / (int64_t)TurboliftConfig::Sync::SLEW_TIME_MS;
+    if (slew > MAX_SLEW_Q24)
+      slew = MAX_SLEW_Q24;
+    else if (slew < -MAX_SLEW_Q24)
+      slew = -MAX_SLEW_Q24;
+    _rateQ24 = _driftQ24 + (int32_t)slew;
+  }
+
+private:
+  struct Sample
+  {
+    uint32_t at;    // Local receive time
+    int32_t offset; // Leader's show time minus it
+  };
+
+  static constexpr int64_t STEP_Q8 = (int64_t)TurboliftConfig::Sync::STEP_MS << 8;
+  static constexpr int64_t MAX_SLEW_Q24 = ((int64_t)TurboliftConfig::Sync::MAX_SLEW_PPM << 24) / 1000000;
+  static constexpr int64_t MAX_DRIFT_Q24 = ((int64_t)TurboliftConfig::Sync::MAX_DRIFT_PPM << 24) / 1000000;
+  static constexpr uint32_t MIN_DRIFT_SPAN_MS = 2000; // Shorter spans are mostly jitter
+
+  bool _leader;
+  bool _acquired; // Offset set from a beacon at least once
+  bool _locked;
+  uint32_t _seed;
+
+  // Offset (1/256 ms) at local time _base, changing _rateQ24 / 2^24 ms per ms
+  int64_t _offsetQ8;
+  uint32_t _base;
+  int32_t _rateQ24;
+  int32_t _driftQ24;
+  bool _haveDrift;
+
+  Sample _samples[WINDOW];
+  int _count;
+  int _next;
+  uint32_t _lastBeacon;
+
+  // Best sample of the current block of WINDOW, and past blocks' best
+  int _blockCount;
+  int32_t _blockBest;
+  uint32_t _blockAt;
+  Sample _anchors[ANCHORS];
+  int _anchorCount;
+  int _nextAnchor;
+  uint32_t _steps;
+
+  int64_t offsetQ8(uint32_t localMs) const
+  {
+    int64_t elapsed = (int32_t)(localMs - _base);
+    return _offsetQ8 + ((elapsed * _rateQ24) >> 16);
+  }
+
+  void rebase(uint32_t localMs)
+  {
+    _offsetQ8 = offsetQ8(localMs);
+    _base = localMs;
+  }
+
+  // Least-delayed offset of the window, projected to @p localMs
+  int64_t target(uint32_t localMs) const
+  {
+    const Sample &newest = _samples[(_next + WINDOW - 1) % WINDOW];
+    int64_t best = INT64_MIN;
+    for (int i = 0; i < _count; i++)
+    {
+      int64_t projected = ((int64_t)(int32_t)((uint32_t)_samples[i].offset - (uint32_t)newest.offset) << 8) +
+                          (((int64_t)(int32_t)(localMs - _samples[i].at) * _driftQ24) >> 16);
+      if (projected > best)
+        best = projected;
+    }
+    return ((int64_t)newest.offset << 8) + best;
+  }
+
+  void addToBlock(uint32_t localMs, int32_t offset)
+  {
+    if (_blockCount == 0 || (int32_t)((uint32_t)offset - (uint32_t)_blockBest) > 0)
+    {
+      _blockBest = offset;
+      _blockAt = localMs;
+    }
+    if (++_blockCount < WINDOW)
+      return;
+    _blockCount = 0;
+
+    // Drift from the oldest block still held to this one
+    const Sample &oldest = _anchors[_anchorCount < ANCHORS ? 0 : _nextAnchor];
+    uint32_t span = _blockAt - oldest.at;
+    if (_anchorCount > 0 && span >= MIN_DRIFT_SPAN_MS)
+    {
+      int64_t measured = ((int64_t)(int32_t)((uint32_t)_blockBest - (uint32_t)oldest.offset) << 24) / (int64_t)span;
+      if (measured > MAX_DRIFT_Q24)
+        measured = MAX_DRIFT_Q24;
+      else if (measured < -MAX_DRIFT_Q24)
+        measured = -MAX_DRIFT_Q24;
+      _driftQ24 = _haveDrift ? _driftQ24 + (int32_t)((measured - _driftQ24) / 4) : (int32_t)measured;
+      _haveDrift = true;
+    }
+    _anchors[_nextAnchor] = {_blockAt, _blockBest};
+    _nextAnchor = (_nextAnchor + 1) % ANCHORS;
+    if (_anchorCount < ANCHORS)
+      _anchorCount++;
+  }
+};
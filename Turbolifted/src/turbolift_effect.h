@@ -1,9 +1,16 @@
 #pragma once
 
 #include "effects.h"
+#include "color_math.h"
+#include "motion.h"
+#include "driver_points.h"
+#include "ring_buffer.h"
 #include "led_driver.h"
 #include "config.h"
 #include "config_manager.h"
+#include "preset_store.h"
+#include "realtime_input.h"
+#include "show_clock.h"
 #ifndef UNIT_TEST
 #include <Arduino.h>
 #include <math.h>
@@ -54,15 +61,14 @@ static inline long arduino_random(long min, long max)
 
 // Template TurboliftEffect uses a driver and static buffers sized at compile time
 template <int N, int GRADIENT_STEP, int GRADIENT_MOVE>
-class TurboliftEffectTemplate
+class TurboliftEffectTemplate : public IPresetPatterns
 {
 public:
-  TurboliftEffectTemplate(ILEDDriver *driver) : _driver(driver)
+  TurboliftEffectTemplate(ILEDDriver *driver)
+      : _driver(driver), gradientMotion(N), gradientMotion1(N), gradientMotion2(N), liftMotion(LIFT_STEPS + 1)
   {
     NUM_LEDS = N;
-    gradientPosition = 0;
-    gradientPos1 = 0;
-    gradientPos2 = 0;
+    lastMotion = 0;
     animationActive = false;
     fadeInActive = false;
     fadeInStart = 0;
@@ -72,33 +78,67 @@ public:
     lastUpdate = 0;
     numGradientPoints = 0;
     sequenceInitialized = false;
+    lastFrameValid = false;
+    job = GenerationJob::NONE;
+    recolorStart = 0;
+    classicFading = false;
+    virtualFading = false;
+    classicBackReady = false;
+    classicGenerated = false;
+    classicHeld = false;
+    classicFrontVersion = 0;
+    classicBackVersion = 0;
+    appliedColorVersion = 0;
+    sequenceColorVersion = 0;
     // Lift animation state
-    liftPosition = 0.0f;
-    liftLastMove = 0;
     previousColor = CRGB(0, 0, 0);
     targetColor = CRGB(0, 0, 0);
-    colorBlendFactor = 0.0f;
+    targetVersion = 0;
+    colorChangeStart = 0;
+    _realtime = nullptr;
+    _showClock = nullptr;
+    showSeed = 0;
+    showSeedCount = 0;
   }
 
   void begin()
   {
     _driver->begin();
     _leds = _driver->getBuffer();
-    // effectLeds are static arrays
+    // Pre-generate both patterns so the first start() lights at once; the
+    // next classic pattern is then built in the background
+    const ConfigSnapshot config = ConfigManager::snapshot();
+    generateTurboliftEffect(effectLeds.front(), config);
+    classicGenerated = true;
+    classicFrontVersion = appliedColorVersion = config.colorVersion;
+    generateVirtualGradients(config);
   }
 
-  void setBrightness(uint8_t b) { _driver->setBrightness(b); }
+  void setBrightness(uint8_t b)
+  {
+    _driver->setBrightness(b);
+    invalidateFrame();
+  }
   void fillSolid(const CRGB &c)
   {
     _driver->fillSolid(c);
     _driver->show();
+    invalidateFrame();
   }
   void clear()
   {
     _driver->clear();
     _driver->show();
+    invalidateFrame();
   }
 
+  // Source of EffectMode::REALTIME frames (see RealtimeInputSource)
+  void setRealtimeFrames(IRealtimeFrames *frames) { _realtime = frames; }
+
+  // Show time shared with other units (see ShowClock); while it is in sync,
+  // gradient rotation and pattern seeds follow it
+  void setShowClock(const ShowClock *clock) { _showClock = clock; }
+
   void start()
   {
     if (!animationActive)
@@ -106,8 +146,27 @@ public:
       animationActive = true;
       fadeInActive = true;
       fadeInStart = millis();
-      gradientPosition = 0;
-      generateTurboliftEffect(effectLeds);
+      gradientMotion.reset();
+      lastMotion = millis();
+      // Show the pattern prepared in the background (see serviceGeneration),
+      // else the current one; generate inline only if there is none yet.
+      // A pattern recalled from a preset is kept for the next start()
+      if (classicBackReady && !classicHeld)
+      {
+        effectLeds.swap();
+        classicFrontVersion = classicBackVersion;
+        classicBackReady = false;
+        classicFading = false; // The fade belonged to the pattern swapped out
+      }
+      else if (!classicGenerated)
+      {
+        const ConfigSnapshot config = ConfigManager::snapshot();
+        generateTurboliftEffect(effectLeds.front(), config);
+        classicFrontVersion = config.colorVersion;
+      }
+      classicGenerated = true;
+      classicHeld = false;
+      invalidateFrame();
     }
   }
 
@@ -116,6 +175,7 @@ public:
     animationActive = false;
     _driver->clear();
     _driver->show();
+    invalidateFrame();
   }
 
   void triggerFadeOut()
@@ -140,80 +200,211 @@ public:
   }
 
   void update(unsigned long now)
+  {
+    if (now - lastUpdate >= TurboliftConfig::Timing::UPDATE_INTERVAL_MS)
+      renderFrame(now);
+  }
+
+  // Render one frame without update()'s minimum-interval check, for callers
+  // that pace frames themselves (see FramePacer)
+  void renderFrame(unsigned long now)
   {
     if (fadeOutActive || malfunctionActive || animationActive)
     {
-      if (now - lastUpdate >= 10)
+      // Settings are read once per frame; everything below renders this copy
+      const FrameContext frame{now, ConfigManager::snapshot()};
+      // Motion follows elapsed time, so dropped frames do not slow it down
+      unsigned long elapsed = motionStep(now);
+
+      // Colour changes fade in and new patterns are built in the background
+      serviceGeneration(frame.config);
+      advanceRecolor(now);
+
+      // Dispatch to appropriate effect based on mode; malfunction replaces
+      // the mode effect so each tick transmits at most one frame
+      if (fadeOutActive || animationActive)
       {
-        uint8_t mode = ConfigManager::getEffectMode();
-        
-        // Handle effect regeneration for legacy modes
-        if (animationActive && ConfigManager::needsEffectRegeneration())
-        {
-          if (mode == (uint8_t)TurboliftConfig::Effects::EffectMode::CLASSIC)
-          {
-            generateTurboliftEffect(effectLeds);
-          }
-          else if (mode == (uint8_t)TurboliftConfig::Effects::EffectMode::VIRTUAL_GRADIENT)
-          {
-            generateVirtualGradients();
-          }
-          ConfigManager::clearEffectRegenerationFlag();
-        }
-
-        // Dispatch to appropriate effect based on mode
-        switch (mode)
+        switch (frame.config.effectMode)
         {
         case (uint8_t)TurboliftConfig::Effects::EffectMode::SINGLE_COLOR:
-          singleColorEffect(now);
+          singleColorEffect(frame);
           break;
         case (uint8_t)TurboliftConfig::Effects::EffectMode::LIFT_ANIMATION:
-          liftAnimationEffect(now);
+          liftAnimationEffect(frame, elapsed);
           break;
         case (uint8_t)TurboliftConfig::Effects::EffectMode::CLASSIC:
-        {
-          int speed = ConfigManager::getRotationSpeed();
-          gradientPosition = (gradientPosition + speed) % NUM_LEDS;
-          turboliftEffect();
+          gradientMotion.advance(frame.config.rotationSpeed, elapsed, TurboliftConfig::Timing::MOTION_TICK_MS);
+          lockToShow(gradientMotion, frame.config.rotationSpeed, now);
+          turboliftEffect(frame);
           break;
-        }
         case (uint8_t)TurboliftConfig::Effects::EffectMode::VIRTUAL_GRADIENT:
-        {
-          int speed = ConfigManager::getRotationSpeed();
-          gradientPos1 = (gradientPos1 + speed) % NUM_LEDS;
-          gradientPos2 = (gradientPos2 - speed + NUM_LEDS) % NUM_LEDS;
-          virtualGradientEffect();
+          gradientMotion1.advance(frame.config.rotationSpeed, elapsed, TurboliftConfig::Timing::MOTION_TICK_MS);
+          gradientMotion2.advance(-frame.config.rotationSpeed, elapsed, TurboliftConfig::Timing::MOTION_TICK_MS);
+          lockToShow(gradientMotion1, frame.config.rotationSpeed, now);
+          lockToShow(gradientMotion2, -frame.config.rotationSpeed, now);
+          virtualGradientEffect(frame);
+          break;
+        case (uint8_t)TurboliftConfig::Effects::EffectMode::REALTIME:
+          realtimeEffect(frame);
           break;
         }
-        }
-        
-        if (malfunctionActive)
-          turboliftMalfunctionEffect();
-          
-        lastUpdate = now;
       }
+      else if (malfunctionActive)
+        turboliftMalfunctionEffect(frame, elapsed);
+
+      lastUpdate = now;
+    }
+  }
+
+  /**
+   * @brief Advance background pattern work by one step
+   *
+   * A hue or saturation change recolours the existing patterns, keeping
+   * their driver positions (see recolorPatterns). The next classic pattern
+   * for start() is built into a back ring GENERATION_POINTS_PER_STEP driver
+   * points at a time, so it is ready without stalling a frame.
+   * renderFrame() runs one step per frame; call this from idle time as well
+   * to finish sooner.
+   *
+   * @return true while work remains
+   */
+  bool serviceGeneration(int maxPoints = TurboliftConfig::Effects::GENERATION_POINTS_PER_STEP)
+  {
+    return serviceGeneration(ConfigManager::snapshot(), maxPoints);
+  }
+
+  // As above, against a snapshot the caller already holds
+  bool serviceGeneration(const ConfigSnapshot &config, int maxPoints = TurboliftConfig::Effects::GENERATION_POINTS_PER_STEP)
+  {
+    if (config.colorVersion != appliedColorVersion)
+    {
+      appliedColorVersion = config.colorVersion;
+      recolorPatterns(config);
     }
+    if (job == GenerationJob::CLASSIC ? classicBackVersion != config.colorVersion : job == GenerationJob::NONE && !classicBackReady)
+      beginClassicJob(config);
+    return advanceJob(config, maxPoints);
+  }
+
+  // Presets (see preset_store.h): the classic pattern, then virtual
+  // sequences 1 and 2
+  int patternCount() const override { return 3; }
+
+  bool writePatterns(PresetWriter &writer) override
+  {
+    return writePattern(writer, classicGenerated, effectLeds.front()) &&
+           writePattern(writer, sequenceInitialized, sequence1.front()) &&
+           writePattern(writer, sequenceInitialized, sequence2.front());
+  }
+
+  /**
+   * @brief Show patterns read from a preset, in place of the current ones
+   *
+   * Each is read into its back ring and swapped in whole. They are marked
+   * as built for @p config, the settings recalled with them, so the
+   * recall neither recolours nor regenerates them.
+   */
+  bool recallPatterns(PresetReader &reader, const ConfigSnapshot &config) override
+  {
+    abandonJob();
+    classicBackReady = false; // The back ring is overwritten
+    int classic, virtual1, virtual2;
+    if (!readPattern(reader, effectLeds.back(), classic))
+      return false;
+    if (classic > 0)
+    {
+      effectLeds.swap();
+      classicGenerated = true;
+      classicHeld = true;
+      classicFrontVersion = config.colorVersion;
+      classicFading = false;
+    }
+    if (!readPattern(reader, sequence1.back(), virtual1) || !readPattern(reader, sequence2.back(), virtual2))
+      return false;
+    if (virtual1 > 0 && virtual2 > 0)
+    {
+      sequence1.swap();
+      sequence2.swap();
+      sequenceInitialized = true;
+      sequenceColorVersion = config.colorVersion;
+      virtualFading = false;
+    }
+    invalidateFrame();
+    return true;
   }
 
 private:
   ILEDDriver *_driver;
   CRGB *_leds;
+  IRealtimeFrames *_realtime; // Frames for EffectMode::REALTIME, written into the driver buffer
+  const ShowClock *_showClock;
+  uint32_t showSeed;      // Set's seed the current pattern seeds count up from
+  uint32_t showSeedCount; // Patterns seeded from it so far
+
+  // In sync, rotation follows show time so units side by side match
+  void lockToShow(RingMotion &motion, int speed, unsigned long now)
+  {
+    if (_showClock && _showClock->synced())
+      motion.lock(speed, _showClock->now(now), TurboliftConfig::Timing::MOTION_TICK_MS);
+  }
+
+  // In sync, patterns are seeded from the set's seed, counting up, so units
+  // with the same settings build the same patterns in turn. False if not
+  bool seedFromShow()
+  {
+    if (!_showClock || !_showClock->synced())
+      return false;
+    if (_showClock->seed() != showSeed)
+    {
+      showSeed = _showClock->seed();
+      showSeedCount = 0;
+    }
+    randomSeed(showSeed + showSeedCount++);
+    return true;
+  }
 #ifdef UNIT_TEST
 public:
-  CRGB *testGenerateTurboliftEffect(CRGB *effectLeds) { return generateTurboliftEffect(effectLeds); }
-  int testGetDriverIndex(int i) { return driverIndices[i]; }
-  void testGenerateVirtualGradients() { generateVirtualGradients(); }
-  CRGB *testGetSequence1() { return sequence1; }
-  CRGB *testGetSequence2() { return sequence2; }
+  CRGB *testGenerateTurboliftEffect(CRGB *effectLeds)
+  {
+    GradientRasterizer raster(effectLeds, N);
+    generateTurboliftEffect(raster, ConfigManager::snapshot());
+    return effectLeds;
+  }
+  void testGenerateVirtualGradients() { generateVirtualGradients(ConfigManager::snapshot()); }
+  CRGB *testGetSequence1()
+  {
+    static CRGB pixels[TurboliftConfig::Hardware::NUM_LEDS];
+    sequence1.front().render(pixels, TurboliftConfig::Hardware::NUM_LEDS, 0);
+    return pixels;
+  }
+  CRGB *testGetSequence2()
+  {
+    static CRGB pixels[TurboliftConfig::Hardware::NUM_LEDS];
+    sequence2.front().render(pixels, TurboliftConfig::Hardware::NUM_LEDS, 0);
+    return pixels;
+  }
   bool testIsSequenceInitialized() { return sequenceInitialized; }
+  CRGB *testGetEffectLeds(bool back = false)
+  {
+    static CRGB pixels[N];
+    (back ? effectLeds.back() : effectLeds.front()).render(pixels, N, 0);
+    return pixels;
+  }
+  bool testClassicBackReady() { return classicBackReady; }
+  const auto &testClassicPattern() { return effectLeds.front(); }
+  const auto &testSequencePattern(int which) { return which == 1 ? sequence1.front() : sequence2.front(); }
 #endif
-  CRGB effectLeds[N]; // Changed from static to instance storage
+  // Rotating patterns, stored per TurboliftConfig::Effects::RING_LAYOUT
+  template <int L>
+  using Ring = typename EffectRing<L, TurboliftConfig::Effects::RING_LAYOUT, TurboliftConfig::Effects::MAX_DRIVER_POINTS>::type;
+  DoubleRing<Ring<N>> effectLeds; // Front is drawn, back is built by serviceGeneration()
   int numGradientPoints;
 
   int NUM_LEDS;
-  int gradientPosition;
-  int gradientPos1;
-  int gradientPos2;
+  RingMotion gradientMotion;  // Classic gradient rotation
+  RingMotion gradientMotion1; // Virtual gradient sequence 1 (forward)
+  RingMotion gradientMotion2; // Virtual gradient sequence 2 (backward)
+  unsigned long lastMotion;   // Time of the previous motion step
   bool animationActive;
   bool fadeInActive;
   unsigned long fadeInStart;
@@ -222,153 +413,378 @@ public:
   bool malfunctionActive;
   unsigned long lastUpdate;
   // Virtual gradient sequences (instance storage)
-  CRGB sequence1[TurboliftConfig::Hardware::NUM_LEDS];
-  CRGB sequence2[TurboliftConfig::Hardware::NUM_LEDS];
+  DoubleRing<Ring<TurboliftConfig::Hardware::NUM_LEDS>> sequence1;
+  DoubleRing<Ring<TurboliftConfig::Hardware::NUM_LEDS>> sequence2;
   bool sequenceInitialized;
-  uint8_t lastHueMin; // Track hue values to detect changes
-  uint8_t lastHueMax;
-  uint8_t lastSatMin; // Track saturation values to detect changes
-  uint8_t lastSatMax;
+  uint32_t sequenceColorVersion; // ConfigSnapshot::colorVersion the sequences were built with
 
-  // Lift animation state
-  float liftPosition;        // Current position (0.0 to 1.0)
-  unsigned long liftLastMove;// Last time position was updated
-  CRGB previousColor;        // For smooth color transitions
-  CRGB targetColor;          // Target color for smooth transitions
-  float colorBlendFactor;    // Current blend factor for color transition
+  // Everything a frame's pixels depend on. When the key matches the frame
+  // already in the buffer, rendering is skipped; brightness lives in the
+  // output stage, so fades and flicker never re-render.
+  struct FrameKey
+  {
+    uint8_t mode;
+    uint32_t posA;   // Q8 gradient offset or lift position
+    uint32_t posB;   // Second Q8 gradient offset, or lift beam brightness
+    uint32_t params; // Packed mode-specific settings
+
+    bool operator==(const FrameKey &o) const
+    {
+      return mode == o.mode && posA == o.posA && posB == o.posB && params == o.params;
+    }
+  };
+  FrameKey lastFrame;
+  bool lastFrameValid;
 
-  void generateVirtualGradients()
+  // True if @p key is already on the strip; otherwise records it as the new frame
+  bool frameUnchanged(const FrameKey &key)
   {
-    // Generate and seed virtual gradient sequences used by virtualGradientEffect
-    uint8_t currentHueMin = ConfigManager::getHueMin();
-    uint8_t currentHueMax = ConfigManager::getHueMax();
-    uint8_t currentSatMin = ConfigManager::getSatMin();
-    uint8_t currentSatMax = ConfigManager::getSatMax();
+    if (lastFrameValid && key == lastFrame)
+      return true;
+    lastFrame = key;
+    lastFrameValid = true;
+    return false;
+  }
+
+  // Force the next frame to render, e.g. after the buffer was overwritten
+  void invalidateFrame() { lastFrameValid = false; }
 
-    // Check if hue or saturation values have changed since last generation
-    if (sequenceInitialized && currentHueMin == lastHueMin && currentHueMax == lastHueMax &&
-        currentSatMin == lastSatMin && currentSatMax == lastSatMax)
+  // Background generation (see serviceGeneration): one pattern at a time is
+  // built into back rings, virtual sequence 1 then 2
+  enum class GenerationJob : uint8_t
+  {
+    NONE,
+    CLASSIC,
+    VIRTUAL_1,
+    VIRTUAL_2
+  };
+
+  // Driver positions at random spacing from 0 up to length - MIN_DRIVER_DISTANCE,
+  // resumable so a pattern can be built a few points at a time
+  struct DriverWalk
+  {
+    int idx;
+    int count;
+    int length;
+    int maxCount;
+    bool done;
+  };
+
+  GenerationJob job;
+  DriverWalk jobWalk;
+  bool classicBackReady; // effectLeds.back() holds a finished pattern
+  bool classicGenerated; // effectLeds.front() holds a pattern
+  bool classicHeld;      // effectLeds.front() was recalled from a preset
+  uint32_t classicFrontVersion; // ConfigSnapshot::colorVersion each classic pattern was built with
+  uint32_t classicBackVersion;
+  uint32_t appliedColorVersion; // Last colorVersion handed to recolorPatterns()
+
+  // Driver colour crossfades after a hue/saturation change (see recolorPatterns)
+  DriverCrossfade<TurboliftConfig::Effects::MAX_DRIVER_POINTS> classicFade;
+  DriverCrossfade<TurboliftConfig::Effects::MAX_DRIVER_POINTS> sequence1Fade;
+  DriverCrossfade<TurboliftConfig::Effects::MAX_DRIVER_POINTS> sequence2Fade;
+  unsigned long recolorStart;
+  bool classicFading;
+  bool virtualFading;
+
+  // Max brightness, fade and flicker combined into the single scale FastLED
+  // applies as pixels are clocked out, instead of a scaling pass per frame.
+  // show() still transmits when only this value changed.
+  void setOutputScale(uint8_t brightness, uint8_t scale)
+  {
+    _driver->setBrightness(ColorMath::scale8(brightness, scale));
+  }
+
+  // Real time since the previous frame, capped so a stall cannot make motion jump
+  unsigned long motionStep(unsigned long now)
+  {
+    unsigned long elapsed = now - lastMotion;
+    lastMotion = now;
+    return elapsed > TurboliftConfig::Timing::MOTION_MAX_STEP_MS ? TurboliftConfig::Timing::MOTION_MAX_STEP_MS : elapsed;
+  }
+
+  // Lift animation state
+  static constexpr uint8_t LIFT_STEPS = 100; // Position steps from end to center
+  RingMotion liftMotion;                      // Beam travel in steps; LIFT_STEPS + 1 holds at center
+  CRGB previousColor;                         // For smooth color transitions
+  CRGB targetColor;                           // Target color for smooth transitions
+  uint32_t targetVersion;                     // ConfigSnapshot::liftVersion targetColor was computed from
+  unsigned long colorChangeStart;             // When targetColor last changed
+
+  // Generate the virtual gradient sequences now rather than in the background
+  void generateVirtualGradients(const ConfigSnapshot &config)
+  {
+    if (beginVirtualJob(config))
+      while (advanceJob(config, TurboliftConfig::Hardware::NUM_LEDS))
+        ;
+  }
+
+  // Start building new virtual gradient sequences, unless hue and saturation
+  // are unchanged since the last ones
+  bool beginVirtualJob(const ConfigSnapshot &config)
+  {
+    if (sequenceInitialized && sequenceColorVersion == config.colorVersion)
     {
       Serial.println("Virtual gradient: No changes detected, skipping regeneration");
-      return;
+      return false;
     }
 
-    Serial.print("Virtual gradient: Regenerating sequences - ");
-    if (currentHueMin != lastHueMin || currentHueMax != lastHueMax)
-      Serial.print("hue changed ");
-    if (currentSatMin != lastSatMin || currentSatMax != lastSatMax)
-      Serial.print("saturation changed ");
-    Serial.println();
-
-    // Update tracked values
-    lastHueMin = currentHueMin;
-    lastHueMax = currentHueMax;
-    lastSatMin = currentSatMin;
-    lastSatMax = currentSatMax;
+    Serial.println("Virtual gradient: Regenerating sequences");
+    sequenceColorVersion = config.colorVersion;
 
     // Seed random once per regeneration cycle
-    randomSeed(millis());
+    if (!seedFromShow())
+      randomSeed(millis());
+
+    abandonJob();
+    job = GenerationJob::VIRTUAL_1;
+    beginVirtualSequence(sequence1.back());
+    return true;
+  }
+
+  // Build the next classic pattern into effectLeds.back()
+  void beginClassicJob(const ConfigSnapshot &config)
+  {
+    abandonJob();
+    job = GenerationJob::CLASSIC;
+    classicBackReady = false;
+    classicBackVersion = config.colorVersion;
+    seedFromShow();
+    beginWalk(jobWalk, NUM_LEDS, N - 1);
+    effectLeds.back().beginPoints();
+  }
+
+  // A virtual job cut short leaves its sequences to be generated on demand
+  void abandonJob()
+  {
+    if (job == GenerationJob::VIRTUAL_1 || job == GenerationJob::VIRTUAL_2)
+      sequenceInitialized = false;
+    job = GenerationJob::NONE;
+  }
+
+  // Add up to maxPoints driver points to the job's pattern; finished virtual
+  // sequences are swapped in. True while the job is unfinished
+  bool advanceJob(const ConfigSnapshot &config, int maxPoints)
+  {
+    switch (job)
+    {
+    case GenerationJob::CLASSIC:
+      if (!addTurboliftPoints(effectLeds.back(), jobWalk, maxPoints, config))
+        return true;
+      job = GenerationJob::NONE;
+      classicBackReady = true;
+      return false;
+    case GenerationJob::VIRTUAL_1:
+      if (!addVirtualPoints(sequence1.back(), jobWalk, maxPoints, config))
+        return true;
+      job = GenerationJob::VIRTUAL_2;
+      beginVirtualSequence(sequence2.back());
+      return true;
+    case GenerationJob::VIRTUAL_2:
+      if (!addVirtualPoints(sequence2.back(), jobWalk, maxPoints, config))
+        return true;
+      job = GenerationJob::NONE;
+      sequence1.swap();
+      sequence2.swap();
+      sequenceInitialized = true;
+      invalidateFrame();
+      return false;
+    default:
+      return false;
+    }
+  }
+
+  // New hue/saturation: patterns keep their driver positions, and the shown
+  // ones fade their driver colours to new ones over RECOLOR_FADE_MS
+  void recolorPatterns(const ConfigSnapshot &config)
+  {
+    recolorStart = millis();
+    if (classicGenerated && classicFrontVersion != config.colorVersion)
+    {
+      classicFade.begin(effectLeds.front(), [this, &config](int)
+                        { return getRandomDriverColorInternal(config); });
+      classicFrontVersion = config.colorVersion;
+      classicFading = true;
+    }
+    if (classicBackReady && classicBackVersion != config.colorVersion)
+    {
+      // Not shown yet, so recoloured at once
+      Ring<N> &back = effectLeds.back();
+      for (int i = 0; i < back.pointCount(); i++)
+        back.setPointColor(i, getRandomDriverColorInternal(config));
+      back.commitColors();
+      classicBackVersion = config.colorVersion;
+    }
+    if (sequenceInitialized && sequenceColorVersion != config.colorVersion)
+    {
+      sequence1Fade.begin(sequence1.front(), [this, &config](int driverIndex)
+                          { return virtualDriverColor(config, driverIndex); });
+      sequence2Fade.begin(sequence2.front(), [this, &config](int driverIndex)
+                          { return virtualDriverColor(config, driverIndex); });
+      sequenceColorVersion = config.colorVersion;
+      virtualFading = true;
+    }
+  }
 
-    // Generate sequence 1 using driver-based approach
-    generateVirtualSequence(sequence1, currentHueMin);
+  // Step the crossfades started by recolorPatterns()
+  void advanceRecolor(unsigned long now)
+  {
+    if (!classicFading && !virtualFading)
+      return;
+    uint8_t progress = ColorMath::fadeInScale(now - recolorStart, TurboliftConfig::Timing::RECOLOR_FADE_MS);
+    if (classicFading)
+      classicFade.apply(effectLeds.front(), progress);
+    if (virtualFading)
+    {
+      sequence1Fade.apply(sequence1.front(), progress);
+      sequence2Fade.apply(sequence2.front(), progress);
+    }
+    if (progress == 255)
+      classicFading = virtualFading = false;
+    invalidateFrame();
+  }
 
-    // Generate sequence 2 using driver-based approach with different hue
-    generateVirtualSequence(sequence2, currentHueMax);
+  template <typename Ring>
+  static bool writePattern(PresetWriter &writer, bool generated, const Ring &ring)
+  {
+    int count = generated ? ring.pointCount() : 0;
+    if (!writer.beginPattern(count))
+      return false;
+    for (int i = 0; i < count; i++)
+      if (!writer.point(ring.pointPosition(i), ring.pointColor(i)))
+        return false;
+    return true;
+  }
 
-    sequenceInitialized = true;
+  // Read one preset pattern into @p ring; count is 0 if the preset has none.
+  // False if the points do not start at 0 or the ring refuses one
+  template <typename Ring>
+  static bool readPattern(PresetReader &reader, Ring &ring, int &count)
+  {
+    count = reader.beginPattern();
+    if (count <= 0)
+      return count == 0;
+    ring.beginPoints();
+    for (int i = 0; i < count; i++)
+    {
+      uint16_t pos;
+      CRGB color;
+      if (!reader.point(pos, color) || (i == 0 && pos != 0) || !ring.addPoint(pos, color))
+        return false;
+    }
+    ring.closePoints();
+    return true;
   }
 
-  void generateVirtualSequence(CRGB *sequence, uint8_t hue)
+  static void beginWalk(DriverWalk &walk, int length, int maxCount)
+  {
+    walk = {0, 0, length, maxCount, false};
+  }
+
+  // Position for the next driver, or -1 once the walk has ended
+  static int walkPosition(const DriverWalk &walk)
+  {
+    if (walk.done || walk.idx >= walk.length - TurboliftConfig::Effects::MIN_DRIVER_DISTANCE || walk.count >= walk.maxCount)
+      return -1;
+    return walk.idx;
+  }
+
+  // Step past the driver just placed
+  static void walkAdvance(DriverWalk &walk)
   {
     const int minDist = TurboliftConfig::Effects::MIN_DRIVER_DISTANCE;
     const int maxDist = TurboliftConfig::Effects::MAX_DRIVER_DISTANCE;
+    walk.count++;
+    int step = minDist + random(maxDist - minDist + 1);
+    if (walk.idx + step > walk.length - minDist)
+      walk.done = true;
+    else
+      walk.idx += step;
+  }
 
-    // Create driver positions at random distances
-    int driverIndices[TurboliftConfig::Hardware::NUM_LEDS / minDist + 2]; // Conservative size
-    CRGB driverColors[TurboliftConfig::Hardware::NUM_LEDS / minDist + 2];
-    int numDrivers = 0;
-    int idx = 0;
+  // Add up to maxPoints drivers from walk, coloured by color(driverIndex),
+  // and close the ring when the walk ends; true once closed
+  template <typename Sink, typename ColorFn>
+  static bool addWalkPoints(Sink &sink, DriverWalk &walk, int maxPoints, ColorFn color)
+  {
+    for (int i = 0; i < maxPoints; i++)
+    {
+      int pos = walkPosition(walk);
+      if (pos < 0)
+      {
+        sink.closePoints();
+        return true;
+      }
+      sink.addPoint(pos, color(walk.count));
+      walkAdvance(walk);
+    }
+    return false;
+  }
+
+  template <typename Sink>
+  void beginVirtualSequence(Sink &sequence)
+  {
+    beginWalk(jobWalk, TurboliftConfig::Hardware::NUM_LEDS, TurboliftConfig::Hardware::NUM_LEDS / TurboliftConfig::Effects::MIN_DRIVER_DISTANCE);
+    sequence.beginPoints();
+  }
+
+  // Virtual sequence drivers: every 3rd one coloured, the rest black
+  template <typename Sink>
+  bool addVirtualPoints(Sink &sequence, DriverWalk &walk, int maxPoints, const ConfigSnapshot &config)
+  {
+    return addWalkPoints(sequence, walk, maxPoints, [this, &config](int driverIndex)
+                         { return virtualDriverColor(config, driverIndex); });
+  }
 
-    while (idx < TurboliftConfig::Hardware::NUM_LEDS - minDist && numDrivers < TurboliftConfig::Hardware::NUM_LEDS / minDist)
+  CRGB virtualDriverColor(const ConfigSnapshot &config, int driverIndex)
+  {
+    CRGB driverColor;
+    // Only every 3rd driver gets color, others are black
+    if (driverIndex % 3 == 0)
     {
-      driverIndices[numDrivers] = idx;
+      // Randomly select hue from min to max range for more dynamic effect
+      uint8_t hueMin = config.hueMin;
+      uint8_t hueMax = config.hueMax;
+      uint8_t randomHue;
 
-      // Only every 3rd driver gets color, others are black
-      if (numDrivers % 3 == 0)
+      if (hueMin <= hueMax)
       {
-        // Randomly select hue from min to max range for more dynamic effect
-        uint8_t hueMin = ConfigManager::getHueMin();
-        uint8_t hueMax = ConfigManager::getHueMax();
-        uint8_t randomHue;
-
-        if (hueMin <= hueMax)
+        randomHue = hueMin + random(hueMax - hueMin + 1);
+      }
+      else
+      {
+        // Handle wrap-around (e.g., min=250, max=10)
+        uint8_t range1 = 256 - hueMin;
+        uint8_t range2 = hueMax + 1;
+        if (random(range1 + range2) < range1)
         {
-          randomHue = hueMin + random(hueMax - hueMin + 1);
+          randomHue = hueMin + random(range1);
         }
         else
         {
-          // Handle wrap-around (e.g., min=250, max=10)
-          uint8_t range1 = 256 - hueMin;
-          uint8_t range2 = hueMax + 1;
-          if (random(range1 + range2) < range1)
-          {
-            randomHue = hueMin + random(range1);
-          }
-          else
-          {
-            randomHue = random(range2);
-          }
+          randomHue = random(range2);
         }
-
-        uint8_t satMin = ConfigManager::getSatMin();
-        uint8_t satMax = ConfigManager::getSatMax();
-        uint8_t satRange = satMax - satMin;
-        uint8_t sat = satMin + random(satRange + 1);
-        uint8_t val = TurboliftConfig::Effects::TURBOLIFT_VAL_BASE + random(TurboliftConfig::Effects::TURBOLIFT_VAL_RANGE);
-        driverColors[numDrivers] = CHSV(randomHue, sat, val);
-      }
-      else
-      {
-        driverColors[numDrivers] = CRGB(0, 0, 0); // Black for breaks
       }
 
-      numDrivers++;
-      int step = minDist + random(maxDist - minDist + 1);
-      if (idx + step > TurboliftConfig::Hardware::NUM_LEDS - minDist)
-        break;
-      idx += step;
+      uint8_t satMin = config.satMin;
+      uint8_t satMax = config.satMax;
+      uint8_t satRange = satMax - satMin;
+      uint8_t sat = satMin + random(satRange + 1);
+      uint8_t val = TurboliftConfig::Effects::TURBOLIFT_VAL_BASE + random(TurboliftConfig::Effects::TURBOLIFT_VAL_RANGE);
+      driverColor = CHSV(randomHue, sat, val);
     }
-
-    // Close the loop
-    driverIndices[numDrivers] = TurboliftConfig::Hardware::NUM_LEDS;
-    driverColors[numDrivers] = driverColors[0];
-    numDrivers++;
-
-    // Calculate gradients between drivers
-    for (int d = 0; d < numDrivers - 1; d++)
+    else
     {
-      int start = driverIndices[d];
-      int end = driverIndices[d + 1];
-      CRGB c1 = driverColors[d];
-      CRGB c2 = driverColors[d + 1];
-      int segLen = end - start;
-
-      for (int i = 0; i < segLen; i++)
-      {
-        float ratio = (segLen == 1) ? 0.0f : (float)i / (segLen - 1);
-        CRGB col = interpolateColor(c1, c2, ratio);
-        int pos = start + i;
-        if (pos >= 0 && pos < TurboliftConfig::Hardware::NUM_LEDS)
-          sequence[pos] = col;
-      }
+      driverColor = CRGB(0, 0, 0); // Black for breaks
     }
+    return driverColor;
   }
 
-  CRGB getRandomDriverColorInternal()
+  CRGB getRandomDriverColorInternal(const ConfigSnapshot &config)
   {
     // Handle hue range with wrap-around (e.g., min=250, max=10 for crossing 0/255)
-    uint8_t hueMin = ConfigManager::getHueMin();
-    uint8_t hueMax = ConfigManager::getHueMax();
+    uint8_t hueMin = config.hueMin;
+    uint8_t hueMax = config.hueMax;
     uint8_t length;
     if (hueMin <= hueMax)
     {
@@ -381,8 +797,8 @@ public:
     uint8_t offset = random(length);
     uint8_t hue = (hueMin + offset) % 256;
 
-    uint8_t satMin = ConfigManager::getSatMin();
-    uint8_t satMax = ConfigManager::getSatMax();
+    uint8_t satMin = config.satMin;
+    uint8_t satMax = config.satMax;
     uint8_t satRange = satMax - satMin;
     uint8_t sat = satMin + random(satRange + 1);
     if (random(10) == 0)    // 1 in 10 chance for low saturation
@@ -391,25 +807,30 @@ public:
     return CHSV(hue, sat, val);
   }
 
-  CRGB *generateDriverColors(CRGB *driverColors, int &numDrivers, bool useBlackDrivers = false, uint8_t hue = 0)
+  // Random driver colours at random distances; @p points receives their
+  // positions, ending with a closing point at NUM_LEDS
+  CRGB *generateDriverColors(CRGB *driverColors, DriverPoints<TurboliftConfig::Effects::MAX_DRIVER_POINTS> &points, int &numDrivers,
+                             bool useBlackDrivers = false, uint8_t hue = 0)
   {
     const int minDist = TurboliftConfig::Effects::MIN_DRIVER_DISTANCE;
     const int maxDist = TurboliftConfig::Effects::MAX_DRIVER_DISTANCE;
-    static int driverIndices[N];
+    const ConfigSnapshot config = ConfigManager::snapshot();
     numDrivers = 0;
     int idx = 0;
-    while (idx < NUM_LEDS - minDist && numDrivers < N - 1)
+    points.clear();
+    // Last slot is kept for the closing point
+    while (idx < NUM_LEDS - minDist && numDrivers < points.capacity - 1)
     {
-      driverIndices[numDrivers] = idx;
-      driverColors[numDrivers] = getRandomDriverColorInternal();
+      driverColors[numDrivers] = getRandomDriverColorInternal(config);
+      points.push((uint16_t)idx, driverColors[numDrivers]);
       numDrivers++;
       int step = minDist + random(maxDist - minDist + 1);
       if (idx + step > NUM_LEDS - minDist)
         break;
       idx += step;
     }
-    driverIndices[numDrivers] = NUM_LEDS;
     driverColors[numDrivers] = driverColors[0];
+    points.push((uint16_t)NUM_LEDS, driverColors[numDrivers]);
     numDrivers++;
 
     if (useBlackDrivers)
@@ -423,9 +844,10 @@ public:
         else
         {
           driverColors[i] = CHSV(hue,
-                                 ConfigManager::getSatMin() + random(ConfigManager::getSatMax() - ConfigManager::getSatMin() + 1),
+                                 config.satMin + random(config.satMax - config.satMin + 1),
                                  TurboliftConfig::Effects::TURBOLIFT_VAL_BASE + random(TurboliftConfig::Effects::TURBOLIFT_VAL_RANGE));
         }
+        points.color(i) = driverColors[i];
       }
     }
 
@@ -434,57 +856,32 @@ public:
 
   typedef CRGB (*DriverColorGenerator)(int driverIndex);
 
-  void generateTurboliftEffect(CRGB *effectLeds, DriverColorGenerator colorGen = nullptr)
+  // Stream driver points at random distances into a ring (see ring_buffer.h)
+  template <typename Sink>
+  void generateTurboliftEffect(Sink &effectLeds, const ConfigSnapshot &config, DriverColorGenerator colorGen = nullptr)
   {
-    const int minDist = TurboliftConfig::Effects::MIN_DRIVER_DISTANCE;
-    const int maxDist = TurboliftConfig::Effects::MAX_DRIVER_DISTANCE;
-    int driverIndices[N];
-    CRGB driverColors[N];
-    int numDrivers = 0;
-    int idx = 0;
-
-    while (idx < NUM_LEDS - minDist && numDrivers < N - 1)
-    {
-      driverIndices[numDrivers] = idx;
-      if (colorGen)
-        driverColors[numDrivers] = colorGen(numDrivers);
-      else
-        driverColors[numDrivers] = getRandomDriverColorInternal();
-      numDrivers++;
-      int step = minDist + random(maxDist - minDist + 1);
-      if (idx + step > NUM_LEDS - minDist)
-        break;
-      idx += step;
-    }
-    driverIndices[numDrivers] = NUM_LEDS;
-    driverColors[numDrivers] = driverColors[0];
-    numDrivers++;
+    DriverWalk walk;
+    beginWalk(walk, NUM_LEDS, N - 1);
+    effectLeds.beginPoints();
+    while (!addTurboliftPoints(effectLeds, walk, NUM_LEDS, config, colorGen))
+      ;
+    invalidateFrame();
+  }
 
-    for (int d = 0; d < numDrivers - 1; d++)
-    {
-      int start = driverIndices[d];
-      int end = driverIndices[d + 1];
-      CRGB c1 = driverColors[d];
-      CRGB c2 = driverColors[d + 1];
-      int segLen = end - start;
-      for (int i = 0; i < segLen; i++)
-      {
-        float ratio = (segLen == 1) ? 0.0f : (float)i / (segLen - 1);
-        CRGB col = interpolateColor(c1, c2, ratio);
-        int pos = start + i;
-        if (pos >= 0 && pos < NUM_LEDS)
-          effectLeds[pos] = col;
-      }
-    }
+  template <typename Sink>
+  bool addTurboliftPoints(Sink &effectLeds, DriverWalk &walk, int maxPoints, const ConfigSnapshot &config, DriverColorGenerator colorGen = nullptr)
+  {
+    return addWalkPoints(effectLeds, walk, maxPoints, [this, &config, colorGen](int driverIndex)
+                         { return colorGen ? colorGen(driverIndex) : getRandomDriverColorInternal(config); });
   }
 
   // Helper function for virtual gradient sequences with black drivers
-  CRGB virtualGradientColorGen(int driverIndex, uint8_t hue)
+  CRGB virtualGradientColorGen(const ConfigSnapshot &config, int driverIndex, uint8_t hue)
   {
     if (driverIndex % 3 == 0) // 1 color, 2 black pattern
     {
-      uint8_t satMin = ConfigManager::getSatMin();
-      uint8_t satMax = ConfigManager::getSatMax();
+      uint8_t satMin = config.satMin;
+      uint8_t satMax = config.satMax;
       uint8_t sat = satMin + random(satMax - satMin + 1);
       uint8_t val = TurboliftConfig::Effects::TURBOLIFT_VAL_BASE + random(TurboliftConfig::Effects::TURBOLIFT_VAL_RANGE);
       return CHSV(hue, sat, val);
@@ -495,75 +892,68 @@ public:
     }
   }
 
-  void turboliftEffect()
+  void turboliftEffect(const FrameContext &frame)
   {
-    float fadeScale = 1.0f;
+    uint8_t fadeScale = 255;
     if (fadeInActive)
     {
-      unsigned long now = millis();
-      float t = (now - fadeInStart) / (float)TurboliftConfig::Timing::FADE_IN_DURATION_MS;
-      fadeScale = constrain(t, 0.0f, 1.0f);
-      if (fadeScale >= 1.0f)
-      {
-        fadeInActive = false;
-        fadeScale = 1.0f;
-      }
+      fadeScale = calculateFade(true, fadeInStart, TurboliftConfig::Timing::FADE_IN_DURATION_MS);
     }
     else if (fadeOutActive)
     {
-      unsigned long now = millis();
-      float t = (now - fadeOutStart) / (float)TurboliftConfig::Timing::FADE_OUT_DURATION_MS;
-      fadeScale = 1.0f - constrain(t, 0.0f, 1.0f);
-      if (fadeScale <= 0.0f)
-      {
-        fadeOutActive = false;
-        fadeScale = 0.0f;
-        animationActive = false;
-        _driver->clear();
-        _driver->show();
-        return;
-      }
-    }
-    for (int i = 0; i < NUM_LEDS; i++)
-    {
-      _driver->setPixel(i, effectLeds[(i + gradientPosition) % NUM_LEDS]);
-      if (fadeScale < 1.0f)
-        _driver->getBuffer()[i].nscale8((uint8_t)(fadeScale * 255));
+      fadeScale = calculateFade(false, fadeOutStart, TurboliftConfig::Timing::FADE_OUT_DURATION_MS);
+      if (fadeScale == 0)
+        return; // Early exit on fade out completion
     }
-    _driver->setBrightness(ConfigManager::getMaxBrightness());
-    _driver->show();
+    if (!frameUnchanged({(uint8_t)TurboliftConfig::Effects::EffectMode::CLASSIC, gradientMotion.positionQ8(), 0, 0}))
+      effectLeds.front().blit(*_driver, gradientMotion.positionQ8());
+    setOutputScale(frame.config.maxBrightness, fadeScale);
+    _driver->show(); // No-op for a static scene at constant brightness
   }
 
-  void turboliftMalfunctionEffect()
+  void turboliftMalfunctionEffect(const FrameContext &frame, unsigned long elapsed)
   {
-    unsigned long now = millis();
+    using ColorMath::toQ8_8;
+    // Brightness envelope in Q8.8 (256 == nominal brightness)
+    constexpr int32_t targetMin = toQ8_8(TurboliftConfig::Effects::MALFUNCTION_BRIGHTNESS_MIN);
+    constexpr int32_t targetRange = toQ8_8(TurboliftConfig::Effects::MALFUNCTION_BRIGHTNESS_RANGE);
+    constexpr int32_t smoothingMin = toQ8_8(TurboliftConfig::Effects::MALFUNCTION_BRIGHTNESS_SMOOTHING_MIN);
+    constexpr int32_t smoothingRange = toQ8_8(TurboliftConfig::Effects::MALFUNCTION_BRIGHTNESS_SMOOTHING_RANGE);
+    constexpr int32_t clampMin = toQ8_8(TurboliftConfig::Effects::MALFUNCTION_BRIGHTNESS_CLAMP_MIN);
+    constexpr int32_t clampMax = toQ8_8(TurboliftConfig::Effects::MALFUNCTION_BRIGHTNESS_CLAMP_MAX);
+
+    unsigned long now = frame.now;
     static unsigned long lastJump = 0;
-    static float targetBrightness = 1.0f;
-    static float currentBrightness = 1.0f;
+    static int32_t targetBrightness = ColorMath::Q8_8_ONE;
+    static int32_t currentBrightness = ColorMath::Q8_8_ONE;
     static int jumpInterval = 100;
-    gradientPosition = (gradientPosition + GRADIENT_MOVE) % NUM_LEDS;
+    gradientMotion.advance(GRADIENT_MOVE, elapsed, TurboliftConfig::Timing::MOTION_TICK_MS);
 
     if (now - lastJump > (unsigned long)jumpInterval)
     {
-      targetBrightness = TurboliftConfig::Effects::MALFUNCTION_BRIGHTNESS_MIN +
-                         TurboliftConfig::Effects::MALFUNCTION_BRIGHTNESS_RANGE * (random(1000) / 1000.0f);
+      targetBrightness = targetMin + targetRange * random(1000) / 1000;
       jumpInterval = TurboliftConfig::Timing::MALFUNCTION_MIN_JUMP_MS +
                      random(TurboliftConfig::Timing::MALFUNCTION_MAX_JUMP_MS - TurboliftConfig::Timing::MALFUNCTION_MIN_JUMP_MS);
       lastJump = now;
     }
-    float delta = targetBrightness - currentBrightness;
-    currentBrightness += delta * (TurboliftConfig::Effects::MALFUNCTION_BRIGHTNESS_SMOOTHING_MIN +
-                                  TurboliftConfig::Effects::MALFUNCTION_BRIGHTNESS_SMOOTHING_RANGE * (random(1000) / 1000.0f));
-    currentBrightness += (random(-TurboliftConfig::Effects::MALFUNCTION_NOISE_OFFSET, TurboliftConfig::Effects::MALFUNCTION_NOISE_OFFSET + 1)) / 255.0f;
-    currentBrightness = constrain(currentBrightness,
-                                  TurboliftConfig::Effects::MALFUNCTION_BRIGHTNESS_CLAMP_MIN,
-                                  TurboliftConfig::Effects::MALFUNCTION_BRIGHTNESS_CLAMP_MAX);
-
-    for (int i = 0; i < NUM_LEDS; i++)
-    {
-      _driver->setPixel(i, effectLeds[(i + gradientPosition) % NUM_LEDS]);
-      _driver->getBuffer()[i].nscale8((uint8_t)(currentBrightness * TurboliftConfig::Effects::MALFUNCTION_BASE_BRIGHTNESS + TurboliftConfig::Effects::MALFUNCTION_BRIGHTNESS_OFFSET));
-    }
+    // Smoothing and noise are per motion tick, scaled by the time this frame covers
+    const int32_t tickMs = (int32_t)TurboliftConfig::Timing::MOTION_TICK_MS;
+    int32_t delta = targetBrightness - currentBrightness;
+    int32_t smoothing = (smoothingMin + smoothingRange * random(1000) / 1000) * (int32_t)elapsed / tickMs;
+    if (smoothing > ColorMath::Q8_8_ONE)
+      smoothing = ColorMath::Q8_8_ONE; // Never past the target
+    currentBrightness += delta * smoothing / ColorMath::Q8_8_ONE;
+    int32_t noise = random(-TurboliftConfig::Effects::MALFUNCTION_NOISE_OFFSET, TurboliftConfig::Effects::MALFUNCTION_NOISE_OFFSET + 1) * ColorMath::Q8_8_ONE / 255;
+    currentBrightness += noise * (int32_t)elapsed / tickMs;
+    currentBrightness = currentBrightness < clampMin ? clampMin : (currentBrightness > clampMax ? clampMax : currentBrightness);
+
+    // Map the envelope onto an 8-bit scale; overshoot above nominal saturates
+    uint8_t scale = ColorMath::saturate8(currentBrightness * TurboliftConfig::Effects::MALFUNCTION_BASE_BRIGHTNESS / ColorMath::Q8_8_ONE +
+                                         TurboliftConfig::Effects::MALFUNCTION_BRIGHTNESS_OFFSET);
+
+    if (!frameUnchanged({(uint8_t)TurboliftConfig::Effects::EffectMode::CLASSIC, gradientMotion.positionQ8(), 0, 0}))
+      effectLeds.front().blit(*_driver, gradientMotion.positionQ8());
+    setOutputScale(frame.config.maxBrightness, scale);
     _driver->show();
   }
 
@@ -591,67 +981,44 @@ public:
         dist = TurboliftConfig::Hardware::NUM_LEDS - dist;
       }
 
-      float ratio = (float)((ledIndex - pos + TurboliftConfig::Hardware::NUM_LEDS) % TurboliftConfig::Hardware::NUM_LEDS) / dist;
-      bright = (uint8_t)(sequence[pos].b * (1.0f - ratio) + sequence[nextDriver].b * ratio);
+      int offset = (ledIndex - pos + TurboliftConfig::Hardware::NUM_LEDS) % TurboliftConfig::Hardware::NUM_LEDS;
+      bright = (uint8_t)((sequence[pos].b * (dist - offset) + sequence[nextDriver].b * offset) / dist);
     }
 
     return bright;
   }
 
-  // Blend two colors additively, combining both sequences for brighter, more vibrant effect
-  CRGB blendByBrightness(CRGB color1, CRGB color2, uint8_t bright1, uint8_t bright2)
-  {
-    // Additive blending: add RGB components together with clamping
-    uint8_t r = min(255, (uint16_t)color1.r + (uint16_t)color2.r);
-    uint8_t g = min(255, (uint16_t)color1.g + (uint16_t)color2.g);
-    uint8_t b = min(255, (uint16_t)color1.b + (uint16_t)color2.b);
-    return CRGB(r, g, b);
-  }
-
-  // Unified fade calculation for both fade in and fade out
-  float calculateFade(bool isFadeIn, unsigned long startTime, float duration)
+  // Unified fade calculation for both fade in and fade out, as a 0-255 scale
+  uint8_t calculateFade(bool isFadeIn, unsigned long startTime, unsigned long duration)
   {
-    unsigned long now = millis();
-    float t = (now - startTime) / duration;
-    float fadeScale = constrain(t, 0.0f, 1.0f);
+    unsigned long elapsed = millis() - startTime;
 
     if (isFadeIn)
     {
-      if (fadeScale >= 1.0f)
-      {
+      uint8_t fadeScale = ColorMath::fadeInScale(elapsed, duration);
+      if (fadeScale == 255)
         fadeInActive = false;
-        return 1.0f;
-      }
       return fadeScale;
     }
     else // fade out
     {
-      fadeScale = 1.0f - fadeScale;
-      if (fadeScale <= 0.0f)
+      uint8_t fadeScale = ColorMath::fadeOutScale(elapsed, duration);
+      if (fadeScale == 0)
       {
         fadeOutActive = false;
         animationActive = false;
         _driver->clear();
         _driver->show();
-        return 0.0f;
+        invalidateFrame();
       }
       return fadeScale;
     }
   }
 
-  // Apply fade scaling to a color
-  void applyFade(CRGB &color, float fadeScale)
-  {
-    if (fadeScale < 1.0f)
-    {
-      color.nscale8((uint8_t)(fadeScale * 255));
-    }
-  }
-
-  void virtualGradientEffect()
+  void virtualGradientEffect(const FrameContext &frame)
   {
     // Handle fade transitions with unified function
-    float fadeScale = 1.0f;
+    uint8_t fadeScale = 255;
     if (fadeInActive)
     {
       fadeScale = calculateFade(true, fadeInStart, TurboliftConfig::Timing::FADE_IN_DURATION_MS);
@@ -659,46 +1026,58 @@ public:
     else if (fadeOutActive)
     {
       fadeScale = calculateFade(false, fadeOutStart, TurboliftConfig::Timing::FADE_OUT_DURATION_MS);
-      if (fadeScale == 0.0f)
+      if (fadeScale == 0)
         return; // Early exit on fade out completion
     }
 
     // Ensure virtual sequences are generated
     if (!sequenceInitialized)
-      generateVirtualGradients();
+      generateVirtualGradients(frame.config);
 
-    // Process each LED using functional composition
-    for (int i = 0; i < TurboliftConfig::Hardware::NUM_LEDS; i++)
+    if (!frameUnchanged({(uint8_t)TurboliftConfig::Effects::EffectMode::VIRTUAL_GRADIENT, gradientMotion1.positionQ8(), gradientMotion2.positionQ8(), 0}))
     {
-      // Get the actual LED values from both sequences
-      int pos1 = (i + gradientPos1) % TurboliftConfig::Hardware::NUM_LEDS;
-      int pos2 = (i + gradientPos2 + TurboliftConfig::Hardware::NUM_LEDS) % TurboliftConfig::Hardware::NUM_LEDS;
-
-      CRGB led1 = sequence1[pos1];
-      CRGB led2 = sequence2[pos2];
-
-      // Blend the actual LED values additively
-      CRGB blended = blendByBrightness(led1, led2, 0, 0); // brightness params not needed for additive blending
+      // Blend both rotated sequences additively straight into the driver buffer
+      sequence1.front().blit(*_driver, gradientMotion1.positionQ8());
+      sequence2.front().add(*_driver, gradientMotion2.positionQ8());
+    }
 
-      // Apply fade scaling
-      applyFade(blended, fadeScale);
+    setOutputScale(frame.config.maxBrightness, fadeScale);
+    _driver->show();
+  }
 
-      _driver->setPixel(i, blended);
+  // =====================================================
+  // REALTIME EFFECT - Latest frame received over E1.31 / Art-Net
+  // =====================================================
+  void realtimeEffect(const FrameContext &frame)
+  {
+    uint8_t fadeScale = 255;
+    if (fadeInActive)
+    {
+      fadeScale = calculateFade(true, fadeInStart, TurboliftConfig::Timing::FADE_IN_DURATION_MS);
+    }
+    else if (fadeOutActive)
+    {
+      fadeScale = calculateFade(false, fadeOutStart, TurboliftConfig::Timing::FADE_OUT_DURATION_MS);
+      if (fadeScale == 0)
+        return;
     }
 
-    _driver->setBrightness(ConfigManager::getMaxBrightness());
-    _driver->show();
+    // The pixels are already in the buffer; they are transmitted once a
+    // frame is whole, and the last frame holds while none is arriving
+    bool newFrame = _realtime && _realtime->takeFrame();
+    invalidateFrame(); // The buffer is not ours: other modes must redraw
+    setOutputScale(frame.config.maxBrightness, fadeScale);
+    if (newFrame || !(_realtime && _realtime->midFrame()))
+      _driver->show();
   }
 
   // =====================================================
   // SINGLE COLOR EFFECT - Static color display
   // =====================================================
-  void singleColorEffect(unsigned long now)
+  void singleColorEffect(const FrameContext &frame)
   {
-    (void)now; // Suppress unused parameter warning
-
     // Handle fade transitions
-    float fadeScale = 1.0f;
+    uint8_t fadeScale = 255;
     if (fadeInActive)
     {
       fadeScale = calculateFade(true, fadeInStart, TurboliftConfig::Timing::FADE_IN_DURATION_MS);
@@ -706,54 +1085,51 @@ public:
     else if (fadeOutActive)
     {
       fadeScale = calculateFade(false, fadeOutStart, TurboliftConfig::Timing::FADE_OUT_DURATION_MS);
-      if (fadeScale == 0.0f)
+      if (fadeScale == 0)
         return;
     }
 
-    // Get color from ConfigManager (using lift animation color settings)
-    uint8_t hue = ConfigManager::getLiftHue();
-    uint8_t sat = ConfigManager::getLiftSaturation();
-    uint8_t val = ConfigManager::getLiftBrightness();
-
-    // Update target color
-    targetColor = CHSV(hue, sat, val);
-
-    // Smooth color transition (blend towards target)
-    if (previousColor != targetColor)
+    // Colour from the lift animation settings, converted only when they change
+    uint8_t val = frame.config.liftBrightness;
+    if (targetVersion != frame.config.liftVersion)
     {
-      colorBlendFactor += 0.05f; // Gradual blend
-      if (colorBlendFactor >= 1.0f)
-      {
-        previousColor = targetColor;
-        colorBlendFactor = 0.0f;
-      }
+      // Blend on from the colour shown now, however far the last blend got
+      previousColor = ColorMath::lerpColor(previousColor, targetColor, liftColorBlend(frame.now));
+      targetColor = CHSV(frame.config.liftHue, frame.config.liftSaturation, val);
+      targetVersion = frame.config.liftVersion;
+      colorChangeStart = frame.now;
     }
 
+    // Smooth color transition over LIFT_COLOR_FADE_MS, whatever the frame rate
+    ColorMath::q16_t colorBlend = liftColorBlend(frame.now);
+    if (colorBlend >= ColorMath::Q16_ONE)
+      previousColor = targetColor;
+
     // Interpolate between previous and target color
-    CRGB currentColor = interpolateColor(previousColor, targetColor, colorBlendFactor);
+    CRGB currentColor = ColorMath::lerpColor(previousColor, targetColor, colorBlend);
 
     // Fill all LEDs with the current color
-    for (int i = 0; i < NUM_LEDS; i++)
-    {
-      CRGB ledColor = currentColor;
-      if (fadeScale < 1.0f)
-      {
-        ledColor.nscale8((uint8_t)(fadeScale * 255));
-      }
-      _driver->setPixel(i, ledColor);
-    }
+    uint32_t packedColor = ((uint32_t)currentColor.r << 16) | ((uint32_t)currentColor.g << 8) | currentColor.b;
+    if (!frameUnchanged({(uint8_t)TurboliftConfig::Effects::EffectMode::SINGLE_COLOR, 0, 0, packedColor}))
+      _driver->fillSolid(currentColor);
 
-    _driver->setBrightness(ConfigManager::getLiftBrightness());
+    setOutputScale(val, fadeScale);
     _driver->show();
   }
 
+  // How far the single colour has blended from previousColor to targetColor
+  ColorMath::q16_t liftColorBlend(unsigned long now) const
+  {
+    return ColorMath::ratioQ16(now - colorChangeStart, TurboliftConfig::Timing::LIFT_COLOR_FADE_MS);
+  }
+
   // =====================================================
   // LIFT ANIMATION EFFECT - Converging beams from both ends
   // =====================================================
-  void liftAnimationEffect(unsigned long now)
+  void liftAnimationEffect(const FrameContext &frame, unsigned long elapsed)
   {
     // Handle fade transitions
-    float fadeScale = 1.0f;
+    uint8_t fadeScale = 255;
     if (fadeInActive)
     {
       fadeScale = calculateFade(true, fadeInStart, TurboliftConfig::Timing::FADE_IN_DURATION_MS);
@@ -761,37 +1137,38 @@ public:
     else if (fadeOutActive)
     {
       fadeScale = calculateFade(false, fadeOutStart, TurboliftConfig::Timing::FADE_OUT_DURATION_MS);
-      if (fadeScale == 0.0f)
+      if (fadeScale == 0)
         return;
     }
 
     // Get configuration parameters
-    uint8_t speed = ConfigManager::getLiftSpeed();
-    uint8_t width = ConfigManager::getLiftWidth();
-    uint8_t spacing = ConfigManager::getLiftSpacing();
-    uint8_t hue = ConfigManager::getLiftHue();
-    uint8_t sat = ConfigManager::getLiftSaturation();
-    uint8_t brightness = ConfigManager::getLiftBrightness();
+    uint8_t speed = frame.config.liftSpeed;
+    uint8_t width = frame.config.liftWidth;
+    uint8_t spacing = frame.config.liftSpacing;
+    uint8_t hue = frame.config.liftHue;
+    uint8_t sat = frame.config.liftSaturation;
+    uint8_t brightness = frame.config.liftBrightness;
 
     // Calculate delay per LED based on speed
     unsigned long delayMs = ConfigManager::speedToDelay(speed);
 
-    // Update position based on time
-    if (now - liftLastMove >= delayMs)
+    // One step per delayMs, advanced continuously; the last step holds the
+    // beams at center before they restart from the ends
+    liftMotion.advance(1, elapsed, delayMs);
+    uint32_t liftQ8 = liftMotion.positionQ8();
+    if (liftQ8 > (uint32_t)LIFT_STEPS << 8)
+      liftQ8 = (uint32_t)LIFT_STEPS << 8;
+
+    uint32_t beamShape = ((uint32_t)width << 24) | ((uint32_t)spacing << 16) | ((uint32_t)hue << 8) | sat;
+    if (frameUnchanged({(uint8_t)TurboliftConfig::Effects::EffectMode::LIFT_ANIMATION, liftQ8, brightness, beamShape}))
     {
-      liftPosition += 0.01f; // Increment position
-      if (liftPosition >= 1.0f)
-      {
-        liftPosition = 0.0f; // Reset when reaching center
-      }
-      liftLastMove = now;
+      setOutputScale(brightness, fadeScale);
+      _driver->show();
+      return;
     }
 
     // Clear all LEDs first
-    for (int i = 0; i < NUM_LEDS; i++)
-    {
-      _driver->setPixel(i, CRGB(0, 0, 0));
-    }
+    _driver->fillSolid(CRGB(0, 0, 0));
 
     // Calculate center point (bottom of U)
     int centerLed = NUM_LEDS / 2;
@@ -799,83 +1176,67 @@ public:
     // Calculate beam positions
     // Left beam: starts at LED 0, moves toward center
     // Right beam: starts at LED N-1, moves toward center
-    float leftBeamPos = liftPosition * centerLed;
-    float rightBeamPos = (NUM_LEDS - 1) - (liftPosition * centerLed);
+    // Positions are Q8.8 LED indices so the beams move in sub-LED steps
+    int32_t leftBeamPos = (int32_t)(liftQ8 * centerLed / LIFT_STEPS);
+    int32_t rightBeamPos = (int32_t)(NUM_LEDS - 1) * ColorMath::Q8_8_ONE - leftBeamPos;
 
     // Draw left beam (from LED 0 toward center)
-    drawBeam(0, centerLed, leftBeamPos, width, spacing, hue, sat, brightness, fadeScale, true);
+    drawBeam(0, centerLed, leftBeamPos, width, spacing, hue, sat, brightness, true);
 
     // Draw right beam (from LED N-1 toward center)
-    drawBeam(NUM_LEDS - 1, centerLed, rightBeamPos, width, spacing, hue, sat, brightness, fadeScale, false);
+    drawBeam(NUM_LEDS - 1, centerLed, rightBeamPos, width, spacing, hue, sat, brightness, false);
 
-    _driver->setBrightness(brightness);
+    setOutputScale(brightness, fadeScale);
     _driver->show();
   }
 
-  // Draw a beam with fade trails
-  void drawBeam(int startLed, int endLed, float beamPos, uint8_t width, uint8_t spacing,
-                uint8_t hue, uint8_t sat, uint8_t brightness, float fadeScale, bool movingForward)
+  // Draw a beam with fade trails; beamPos is a Q8.8 LED index
+  void drawBeam(int startLed, int endLed, int32_t beamPos, uint8_t width, uint8_t spacing,
+                uint8_t hue, uint8_t sat, uint8_t brightness, bool movingForward)
   {
-    (void)spacing; // Suppress unused parameter warning
+    // 255 * FADE_TRAIL_FACTOR in Q8.8, the trail scale at the beam head
+    constexpr int32_t trailPeak = (int32_t)(255.0f * TurboliftConfig::Effects::FADE_TRAIL_FACTOR * 256.0f + 0.5f);
+    const int32_t trailLength = (int32_t)TurboliftConfig::Effects::FADE_TRAIL_LENGTH << 8;
+    const int32_t beamWidth = (int32_t)width << 8;
+    const int32_t beamGap = (int32_t)spacing << 8;
     int direction = movingForward ? 1 : -1;
 
     // Iterate from start toward end
     int led = startLed;
-    int limit = movingForward ? endLed : endLed;
-    
+    int limit = endLed;
+
     while ((movingForward && led <= limit) || (!movingForward && led >= limit))
     {
-      // Check if this LED is within the beam position
-      float distanceFromBeam;
-      if (movingForward)
-      {
-        distanceFromBeam = beamPos - led;
-      }
-      else
-      {
-        distanceFromBeam = led - beamPos;
-      }
+      // Distance behind the beam head, in Q8.8 LEDs
+      int32_t distanceFromBeam = movingForward ? beamPos - ((int32_t)led << 8) : ((int32_t)led << 8) - beamPos;
 
       // Calculate intensity based on distance from beam center
-      if (distanceFromBeam >= 0 && distanceFromBeam < width)
+      if (distanceFromBeam >= 0 && distanceFromBeam < beamWidth)
       {
         // Within the beam - full brightness at center, fading at edges
-        float intensity = 1.0f - (distanceFromBeam / (float)width);
-        CRGB color = CHSV(hue, sat, (uint8_t)(brightness * intensity));
-        
+        uint8_t val = (uint8_t)(brightness * (beamWidth - distanceFromBeam) / beamWidth);
+        CRGB color = CHSV(hue, sat, val);
+
         // Add fade trail behind the beam
-        int trailLength = TurboliftConfig::Effects::FADE_TRAIL_LENGTH;
         if (distanceFromBeam < trailLength)
         {
-          float trailFade = TurboliftConfig::Effects::FADE_TRAIL_FACTOR * 
-                           (1.0f - distanceFromBeam / (float)trailLength);
-          color.nscale8((uint8_t)(255 * trailFade));
+          color.nscale8((uint8_t)((trailPeak * (trailLength - distanceFromBeam) / trailLength) >> 8));
         }
 
-        if (fadeScale < 1.0f)
-        {
-          color.nscale8((uint8_t)(fadeScale * 255));
-        }
-        
         _driver->setPixel(led, color);
       }
-      else if (distanceFromBeam >= width && distanceFromBeam < width + spacing)
+      else if (distanceFromBeam >= beamWidth && distanceFromBeam < beamWidth + beamGap)
       {
         // In the spacing zone - dark
         _driver->setPixel(led, CRGB(0, 0, 0));
       }
-      else if (distanceFromBeam >= width + spacing && distanceFromBeam < 2 * width + spacing)
+      else if (distanceFromBeam >= beamWidth + beamGap && distanceFromBeam < 2 * beamWidth + beamGap)
       {
-        // Second beam segment (repeating pattern)
-        float localPos = distanceFromBeam - (width + spacing);
-        float intensity = 1.0f - (localPos / (float)width);
-        CRGB color = CHSV(hue, sat, (uint8_t)(brightness * intensity * 0.7f)); // Slightly dimmer second beam
-        
-        if (fadeScale < 1.0f)
-        {
-          color.nscale8((uint8_t)(fadeScale * 255));
-        }
-        
+        // Second beam segment (repeating pattern), slightly dimmer at 70%
+        int32_t localPos = distanceFromBeam - (beamWidth + beamGap);
+        uint8_t val = (uint8_t)(brightness * (beamWidth - localPos) * 7 / (beamWidth * 10));
+        CRGB color = CHSV(hue, sat, val);
+
         _driver->setPixel(led, color);
       }
 
@@ -886,3 +1247,4 @@ public:
 
 // Static storage definitions removed - now using instance storage
 // This eliminates the critical bug where multiple instances would share the same buffers
+
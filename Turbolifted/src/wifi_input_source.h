@@ -3,23 +3,27 @@
 #include "input_manager.h"
 #include "status_led.h"
 #include "config_manager.h"
+#include "config_batch.h"
+#include "frame_pacer.h"
+#include "preset_store.h"
+#include "show_clock.h"
+#include "cue_input.h"
+#include "static_assets.h"
+#include "response_writer.h"
+#include "async_http_server.h"
 
 #ifndef UNIT_TEST
 #include <ESP8266WiFi.h>
-#include <ESP8266WebServer.h>
 #include <LittleFS.h>
 #else
-// Mock classes for unit testing
-class ESP8266WebServer
+// Mock transport for unit testing: nothing ever connects
+class LwipTcpTransport : public ITcpTransport
 {
 public:
-  ESP8266WebServer(int port) {}
-  void begin() {}
-  void handleClient() {}
-  void on(const char *path, std::function<void()> handler) {}
-  void send(int code, const char *type, const char *content) {}
-  bool hasArg(const char *name) { return false; }
-  String arg(const char *name) { return ""; }
+  bool begin(uint16_t port, ITcpHandler *handler) override { return true; }
+  size_t write(int id, const char *data, size_t length) override { return length; }
+  void close(int id) override {}
+  void abort(int id) override {}
 };
 #endif
 
@@ -41,8 +45,13 @@ public:
  * // http://turbolift-ip/malfunction
  * // http://turbolift-ip/fadeout
  * ```
+ *
+ * The web UI also connects to ws://turbolift-ip/ws when it can. Each message
+ * from it is a /set query string ("speed=5&hueMax=90") or a command
+ * ("cmd=toggle"), and every client is sent the config when it changes and
+ * the frame rate and preset as they change.
  */
-class WiFiInputSource : public IInputSource
+class WiFiInputSource : public IInputSource, public IWebSocketHandler
 {
 public:
   /**
@@ -50,8 +59,9 @@ public:
    * @param port HTTP server port (default: 80)
    */
   explicit WiFiInputSource(int port = 80)
-      : server_(port), eventQueueHead_(0), eventQueueTail_(0), isConnected_(false),
-        connectionStartTime_(0), inAPMode_(false), apServerStarted_(false) {}
+      : port_(port), server_(&transport_), eventQueueHead_(0), eventQueueTail_(0), isConnected_(false),
+        connectionStartTime_(0), inAPMode_(false), apServerStarted_(false), framePacer_(nullptr), presets_(nullptr),
+        showClock_(nullptr), cues_(nullptr), pushedVersion_(0), pushedFps_(0), pushedPreset_(-1), statePushedAt_(0) {}
 
   /**
    * @brief Initialize WiFi and start web server
@@ -74,6 +84,8 @@ public:
     }
 
     Serial.println(F("LittleFS mounted successfully"));
+    Serial.print(F("Web assets: "));
+    Serial.println(assets_.loadFromLittleFS());
 
     // Start WiFi connection (non-blocking)
     WiFi.begin(ssid, password);
@@ -83,7 +95,7 @@ public:
     // Set up web server routes for both STA and AP modes
     setupWebServerRoutes();
 
-    server_.begin();
+    server_.begin(port_);
 #endif
 
     return true;
@@ -132,7 +144,6 @@ public:
         startAPServer();
       }
 
-      server_.handleClient();
 
       // Check if there are any connected clients
       int numClients = WiFi.softAPgetStationNum();
@@ -151,7 +162,6 @@ public:
     else
     {
       // WiFi is connected - handle web server
-      server_.handleClient();
 
       // Check if there are any connected clients (stations)
       int numClients = WiFi.softAPgetStationNum();
@@ -174,6 +184,14 @@ public:
       }
     }
 #endif
+    // Requests received while frames were rendering, and responses still
+    // going out
+    server_.service(currentTime);
+
+    // Changes staged by /set while frames were rendering
+    configCoalescer_.service(currentTime);
+
+    pushUpdates(currentTime);
     return hasEvents();
   }
 
@@ -238,11 +256,53 @@ public:
     return inAPMode_;
   }
 
+  /**
+   * @brief Attach the frame pacer whose statistics /status reports
+   * @param pacer Pacer driving the effect loop (may be nullptr)
+   */
+  void setFramePacer(const FramePacer *pacer)
+  {
+    framePacer_ = pacer;
+  }
+
+  /**
+   * @brief Attach the preset store behind the /preset routes
+   * @param presets Preset store (may be nullptr: the routes answer 503)
+   */
+  void setPresetStore(PresetStore *presets)
+  {
+    presets_ = presets;
+  }
+
+  /**
+   * @brief Attach the show clock whose sync state /status reports
+   * @param clock Show clock (may be nullptr)
+   */
+  void setShowClock(const ShowClock *clock)
+  {
+    showClock_ = clock;
+  }
+
+  /**
+   * @brief Attach the UDP cue source whose latency /cues reports
+   * @param cues Cue source (may be nullptr: /cues answers 503)
+   */
+  void setCueInput(CueInputSource *cues)
+  {
+    cues_ = cues;
+  }
+
   /**
    * @brief Set up web server routes for both STA and AP modes
    */
   void setupWebServerRoutes()
   {
+    // Needed to answer revalidations of the web assets with 304
+    static const char *const collected[] = {"If-None-Match"};
+    server_.collectHeaders(collected, 1);
+    server_.setDefaultHeaders("Access-Control-Allow-Origin: *\r\n"
+                              "Access-Control-Allow-Methods: GET, POST, PUT, DELETE, OPTIONS\r\n"
+                              "Access-Control-Allow-Headers: *\r\n");
     server_.on("/", [this]()
                { handleRoot(); });
     server_.on("/toggle", [this]()
@@ -265,24 +325,78 @@ public:
                { handleSetSaturation(); });
     server_.on("/set_mode", [this]()
                { handleSetMode(); });
-    server_.on("/options", HTTP_OPTIONS, [this]()
-               {
-         server_.sendHeader("Access-Control-Allow-Origin", "*");
-         server_.sendHeader("Access-Control-Allow-Methods", "GET, POST, PUT, DELETE, OPTIONS");
-         server_.sendHeader("Access-Control-Allow-Headers", "*");
-         server_.send(200, "text/plain", ""); });
+    server_.on("/set", [this]()
+               { handleSet(); });
+    server_.on("/presets", [this]()
+               { handlePresets(); });
+    server_.on("/preset/save", [this]()
+               { handlePresetSave(); });
+    server_.on("/preset/recall", [this]()
+               { handlePresetRecall(); });
+    server_.on("/preset/delete", [this]()
+               { handlePresetDelete(); });
+    server_.on("/cues", [this]()
+               { handleCues(); });
     server_.onNotFound([this]()
                        {
-         server_.sendHeader("Access-Control-Allow-Origin", "*");
-         server_.sendHeader("Access-Control-Allow-Methods", "GET, POST, PUT, DELETE, OPTIONS");
-         server_.sendHeader("Access-Control-Allow-Headers", "*");
-         server_.send(404, "text/plain", "Not Found"); });
+         if (!serveAsset(server_.uri()))
+           respond(404).print(F("Not Found")); });
+    server_.onWebSocket("/ws", this);
+  }
+
+  // ---- IWebSocketHandler ----
+
+  void onOpen(int id) override
+  {
+    pushConfig(id, ConfigManager::snapshot());
+    pushState(id);
   }
 
+  /**
+   * @brief Apply a message from the web UI: /set parameters, checked whole
+   *        and staged like a /set request, or cmd=toggle|malfunction|fadeout
+   */
+  void onMessage(int id, char *data, size_t length) override
+  {
+    ConfigBatch batch;
+    int command = 0;
+    for (char *name = data; name && *name;)
+    {
+      char *next = strchr(name, '&');
+      if (next)
+        *next++ = '\0';
+      char *value = strchr(name, '=');
+      if (value)
+        *value++ = '\0';
+      bool valid = value != nullptr;
+      if (valid && strcmp(name, "cmd") == 0)
+        valid = (command = commandNamed(value)) != 0;
+      else if (valid)
+        valid = batch.set(name, value);
+      if (!valid)
+      {
+        pushInvalid(id, name);
+        return;
+      }
+      name = next;
+    }
+    if (command)
+      queueEvent({.inputId = command,
+                  .type = EventType::Pressed,
+                  .timestamp = millis(),
+                  .sourceName = "WiFi"});
+    if (!batch.empty())
+      configCoalescer_.stage(batch); // Applied by update(), then pushed to every client
+  }
+
+  void onClose(int) override {}
+
 private:
   static constexpr int MAX_EVENTS = 8;
 
-  ESP8266WebServer server_;
+  int port_;
+  LwipTcpTransport transport_;
+  AsyncHttpServer server_;
   InputEvent eventQueue_[MAX_EVENTS];
   int eventQueueHead_;
   int eventQueueTail_;
@@ -290,40 +404,69 @@ private:
   unsigned long connectionStartTime_;
   bool inAPMode_;
   bool apServerStarted_;
+  const FramePacer *framePacer_;
+  PresetStore *presets_;
+  const ShowClock *showClock_;
+  CueInputSource *cues_;
+  StaticAssets assets_;
+  ConfigCoalescer configCoalescer_;
+  char responseBuffer_[TurboliftConfig::WiFi::RESPONSE_BUFFER];
+  uint32_t pushedVersion_; // Config version every WebSocket client has been sent
+  uint16_t pushedFps_;
+  int pushedPreset_;
+  unsigned long statePushedAt_;
+#ifndef UNIT_TEST
+  LittleFSAssetSource assetFiles_;
+#endif
 
   /**
-   * @brief Send CORS headers for all responses
+   * @brief Start a response; the CORS headers are the server's defaults
+   *
+   * The body is written to the returned writer, in responseBuffer_, and
+   * sent when the writer goes out of scope.
    */
-  void sendCORSHeaders()
+  ResponseWriter respond(int code, const char *contentType = "text/plain")
   {
-    server_.sendHeader("Access-Control-Allow-Origin", "*");
-    server_.sendHeader("Access-Control-Allow-Methods", "GET, POST, PUT, DELETE, OPTIONS");
-    server_.sendHeader("Access-Control-Allow-Headers", "*");
+    return ResponseWriter(server_, responseBuffer_, sizeof(responseBuffer_), code, contentType);
   }
 
   /**
-   * @brief Read file content from LittleFS
-   * @param path File path to read
-   * @return File content as String
+   * @brief Send a gzipped web asset, or 304 if the browser's copy is current
+   *
+   * The file is read as the connection drains, a transmit buffer at a
+   * time. Cache-Control: no-cache makes browsers revalidate each load,
+   * which the ETag answers from the asset table without opening the file.
+   *
+   * @param uri Request path
+   * @return false if there is no such asset (nothing sent)
    */
-  String readFile(const char *path)
+  bool serveAsset(const char *uri)
   {
 #ifndef UNIT_TEST
-    File file = LittleFS.open(path, "r");
-    if (!file)
+    const StaticAssets::Asset *asset = assets_.find(uri);
+    if (!asset)
+      return false;
+    char etag[StaticAssets::ETAG_LENGTH];
+    server_.sendHeader("ETag", StaticAssets::formatEtag(asset->etag, etag));
+    server_.sendHeader("Cache-Control", "no-cache");
+    const char *ifNoneMatch = server_.header("If-None-Match");
+    if (ifNoneMatch && StaticAssets::etagMatches(ifNoneMatch, asset->etag))
     {
-      return "File not found";
+      server_.send(304);
+      return true;
     }
 
-    String content = "";
-    while (file.available())
+    char path[StaticAssets::PATH_LENGTH + 3];
+    if (!assetFiles_.open(server_.connection(), StaticAssets::fileName(*asset, path)))
     {
-      content += (char)file.read();
+      respond(500).print(F("Asset unreadable"));
+      return true;
     }
-    file.close();
-    return content;
+    server_.sendHeader("Content-Encoding", "gzip");
+    server_.sendBody(200, StaticAssets::contentType(asset->path), asset->size, &assetFiles_);
+    return true;
 #else
-    return "File reading not supported in unit test mode";
+    return false;
 #endif
   }
 
@@ -333,13 +476,12 @@ private:
   void handleRoot()
   {
 #ifndef UNIT_TEST
-    // Serve the HTML file from the data directory
-    sendCORSHeaders();
-    server_.send(200, "text/html", readFile("/index.html"));
+    // index.html.gz, built from data/ by gzip_assets.py
+    if (!serveAsset("/"))
+      respond(404).print(F("Web interface not uploaded (pio run -t uploadfs)"));
 #else
     // In unit test mode, return a simple response
-    sendCORSHeaders();
-    server_.send(200, "text/plain", "Web interface not available in unit test mode");
+    respond(200).print(F("Web interface not available in unit test mode"));
 #endif
   }
 
@@ -355,12 +497,7 @@ private:
                 .timestamp = millis(),
                 .sourceName = "WiFi"});
 
-    // Send response
-    String response = "Command executed: ";
-    response += InputManager::getCommandName(command);
-
-    sendCORSHeaders();
-    server_.send(200, "text/plain", response);
+    respond(200).print(F("Command executed: ")).print(InputManager::getCommandName(command));
   }
 
   /**
@@ -368,23 +505,42 @@ private:
    */
   void handleStatus()
   {
-    String status = "Turbolift Controller Status\n";
-    status += "WiFi Connected: Yes\n";
-    status += "IP Address: ";
-    status += getIPAddress();
-    status += "\n";
-    status += "Available Commands:\n";
-    status += "  /toggle - Toggle turbolift effect\n";
-    status += "  /malfunction - Trigger malfunction\n";
-    status += "  /fadeout - Fade out effect\n";
-    status += "  /config - View current configuration\n";
-    status += "  /set_speed?speed=0-10 - Set rotation speed\n";
-    status += "  /set_brightness?brightness=0-255 - Set max brightness\n";
-    status += "  /set_hue?min=0-255&max=0-255 - Set color hue range\n";
-    status += "  /set_saturation?min=0-255&max=0-255 - Set color saturation range\n";
-
-    sendCORSHeaders();
-    server_.send(200, "text/plain", status);
+    ResponseWriter out = respond(200);
+    out.print(F("Turbolift Controller Status\nWiFi Connected: Yes\nIP Address: ")).print(getIPAddress()).print('\n');
+    if (framePacer_)
+    {
+      out.print(F("Frame Rate: ")).print(framePacer_->achievedFps());
+      out.print(F(" fps (interval ")).print(framePacer_->frameIntervalUs() / 1000UL);
+      out.print(F(" ms, frame cost ")).print(framePacer_->frameCostUs()).print(F(" us)\n"));
+    }
+    if (showClock_)
+    {
+      out.print(F("Show Sync: "));
+      if (showClock_->leader())
+        out.print(F("leader\n"));
+      else if (showClock_->locked())
+      {
+        out.print(F("locked, offset ")).print((long)showClock_->offsetMs());
+        out.print(F(" ms, drift ")).print((long)showClock_->driftPpm()).print(F(" ppm\n"));
+      }
+      else
+        out.print(F("free-running\n"));
+    }
+    out.print(F("Available Commands:\n"
+                "  /toggle - Toggle turbolift effect\n"
+                "  /malfunction - Trigger malfunction\n"
+                "  /fadeout - Fade out effect\n"
+                "  /config - View current configuration\n"
+                "  /set_speed?speed=0-10 - Set rotation speed\n"
+                "  /set_brightness?brightness=0-255 - Set max brightness\n"
+                "  /set_hue?min=0-255&max=0-255 - Set color hue range\n"
+                "  /set_saturation?min=0-255&max=0-255 - Set color saturation range\n"
+                "  /set?speed=&brightness=&hueMin=&hueMax=&satMin=&satMax=&mode=&effect= - Set any of these at once\n"
+                "  /presets - List stored presets\n"
+                "  /preset/save?slot=&name=[&patterns=0] - Store the current look\n"
+                "  /preset/recall?slot= - Recall a preset\n"
+                "  /preset/delete?slot= - Delete a preset\n"
+                "  /cues[?reset=1] - UDP cue counts and latency\n"));
   }
 
   /**
@@ -392,18 +548,107 @@ private:
    */
   void handleConfig()
   {
-    String json = "{";
-    json += "\"speed\":" + String(ConfigManager::getRotationSpeed()) + ",";
-    json += "\"brightness\":" + String(ConfigManager::getMaxBrightness()) + ",";
-    json += "\"hueMin\":" + String(ConfigManager::getHueMin()) + ",";
-    json += "\"hueMax\":" + String(ConfigManager::getHueMax()) + ",";
-    json += "\"satMin\":" + String(ConfigManager::getSatMin()) + ",";
-    json += "\"satMax\":" + String(ConfigManager::getSatMax()) + ",";
-    json += "\"mode\":" + String(ConfigManager::getTurboliftMode());
-    json += "}";
+    ResponseWriter out = respond(200, "application/json");
+    writeConfigFields(out.beginObject(), ConfigManager::snapshot()).endObject();
+  }
+
+  /**
+   * @brief The /config fields, also pushed to WebSocket clients
+   */
+  static ResponseWriter &writeConfigFields(ResponseWriter &out, const ConfigSnapshot &config)
+  {
+    return out.field(F("speed"), config.rotationSpeed)
+        .field(F("brightness"), config.maxBrightness)
+        .field(F("hueMin"), config.hueMin)
+        .field(F("hueMax"), config.hueMax)
+        .field(F("satMin"), config.satMin)
+        .field(F("satMax"), config.satMax)
+        .field(F("mode"), config.turboliftMode)
+        .field(F("effect"), config.effectMode);
+  }
+
+  /**
+   * @brief Push config and state changes to the WebSocket clients
+   *
+   * A config message that a client's full transmit buffer refused is sent
+   * again on the next call. State goes out at most every
+   * WiFi::WS_STATE_INTERVAL_MS, and only when it has changed.
+   */
+  void pushUpdates(unsigned long now)
+  {
+    if (server_.webSocketClients() == 0)
+      return;
+    ConfigSnapshot config = ConfigManager::snapshot();
+    if (config.version != pushedVersion_ && pushConfig(WebSocketSink::ALL, config) == 0)
+      pushedVersion_ = config.version;
+    if (now - statePushedAt_ >= TurboliftConfig::WiFi::WS_STATE_INTERVAL_MS &&
+        (currentFps() != pushedFps_ || currentPreset() != pushedPreset_) && pushState(WebSocketSink::ALL) == 0)
+    {
+      pushedFps_ = currentFps();
+      pushedPreset_ = currentPreset();
+      statePushedAt_ = now;
+    }
+  }
+
+  /**
+   * @brief Send {"type":"config",...} to one client or all of them
+   * @return Clients that missed it
+   */
+  int pushConfig(int client, const ConfigSnapshot &config)
+  {
+    WebSocketSink sink(server_, client);
+    {
+      ResponseWriter out(sink, responseBuffer_, sizeof(responseBuffer_), 200, "application/json");
+      writeConfigFields(out.beginObject().field(F("type"), "config"), config).endObject();
+    }
+    return sink.missed();
+  }
+
+  /**
+   * @brief Send {"type":"state","fps":...,"preset":...} to one client or all of them
+   * @return Clients that missed it
+   */
+  int pushState(int client)
+  {
+    WebSocketSink sink(server_, client);
+    ResponseWriter(sink, responseBuffer_, sizeof(responseBuffer_), 200, "application/json")
+        .beginObject()
+        .field(F("type"), "state")
+        .field(F("fps"), currentFps())
+        .field(F("preset"), currentPreset())
+        .endObject();
+    return sink.missed();
+  }
+
+  /**
+   * @brief Tell a client which part of its message was refused:
+   *        {"type":"error","invalid":"..."}
+   */
+  void pushInvalid(int client, const char *name)
+  {
+    WebSocketSink sink(server_, client);
+    ResponseWriter(sink, responseBuffer_, sizeof(responseBuffer_), 200, "application/json")
+        .beginObject()
+        .field(F("type"), "error")
+        .field(F("invalid"), name)
+        .endObject();
+  }
+
+  uint16_t currentFps() const { return framePacer_ ? framePacer_->achievedFps() : 0; }
+  int currentPreset() const { return presets_ ? presets_->current() : -1; }
 
-    sendCORSHeaders();
-    server_.send(200, "application/json", json);
+  /**
+   * @brief Command for a WebSocket cmd= value, 0 if there is none
+   */
+  static int commandNamed(const char *name)
+  {
+    if (strcmp(name, "toggle") == 0)
+      return static_cast<int>(InputManager::Command::ToggleTurbolift);
+    if (strcmp(name, "malfunction") == 0)
+      return static_cast<int>(InputManager::Command::TriggerMalfunction);
+    if (strcmp(name, "fadeout") == 0)
+      return static_cast<int>(InputManager::Command::FadeOut);
+    return 0;
   }
 
   /**
@@ -413,17 +658,12 @@ private:
   {
     if (server_.hasArg("speed"))
     {
-      int speed = server_.arg("speed").toInt();
+      int speed = atoi(server_.arg("speed"));
       ConfigManager::setRotationSpeed(speed);
-      String response = "Rotation speed set to: " + String(speed) + " (0-10)";
-      sendCORSHeaders();
-      server_.send(200, "text/plain", response);
+      respond(200).print(F("Rotation speed set to: ")).print(speed).print(F(" (0-10)"));
     }
     else
-    {
-      sendCORSHeaders();
-      server_.send(400, "text/plain", "Missing speed parameter");
-    }
+      respond(400).print(F("Missing speed parameter"));
   }
 
   /**
@@ -433,17 +673,12 @@ private:
   {
     if (server_.hasArg("brightness"))
     {
-      int brightness = server_.arg("brightness").toInt();
+      int brightness = atoi(server_.arg("brightness"));
       ConfigManager::setMaxBrightness(brightness);
-      String response = "Max brightness set to: " + String(brightness) + " (0-255)";
-      sendCORSHeaders();
-      server_.send(200, "text/plain", response);
+      respond(200).print(F("Max brightness set to: ")).print(brightness).print(F(" (0-255)"));
     }
     else
-    {
-      sendCORSHeaders();
-      server_.send(400, "text/plain", "Missing brightness parameter");
-    }
+      respond(400).print(F("Missing brightness parameter"));
   }
 
   /**
@@ -453,19 +688,14 @@ private:
   {
     if (server_.hasArg("min") && server_.hasArg("max"))
     {
-      int minHue = server_.arg("min").toInt();
-      int maxHue = server_.arg("max").toInt();
+      int minHue = atoi(server_.arg("min"));
+      int maxHue = atoi(server_.arg("max"));
       ConfigManager::setHueMin(minHue);
       ConfigManager::setHueMax(maxHue);
-      String response = "Color hue range set to: " + String(minHue) + " - " + String(maxHue) + " (0-255)";
-      sendCORSHeaders();
-      server_.send(200, "text/plain", response);
+      respond(200).print(F("Color hue range set to: ")).print(minHue).print(F(" - ")).print(maxHue).print(F(" (0-255)"));
     }
     else
-    {
-      sendCORSHeaders();
-      server_.send(400, "text/plain", "Missing min or max parameter");
-    }
+      respond(400).print(F("Missing min or max parameter"));
   }
 
   /**
@@ -475,25 +705,16 @@ private:
   {
     if (server_.hasArg("min") && server_.hasArg("max"))
     {
-      int minSat = server_.arg("min").toInt();
-      int maxSat = server_.arg("max").toInt();
+      int minSat = atoi(server_.arg("min"));
+      int maxSat = atoi(server_.arg("max"));
       ConfigManager::setSatMin(minSat);
       ConfigManager::setSatMax(maxSat);
-      String response = "Color saturation range set to: " + String(minSat) + " - " + String(maxSat) + " (0-255)";
-      sendCORSHeaders();
-      server_.send(200, "text/plain", response);
+      respond(200).print(F("Color saturation range set to: ")).print(minSat).print(F(" - ")).print(maxSat).print(F(" (0-255)"));
     }
     else
-    {
-      sendCORSHeaders();
-      server_.send(400, "text/plain", "Missing min or max parameter");
-    }
+      respond(400).print(F("Missing min or max parameter"));
   }
 
-  /**
-   * @brief Add event to queue
-   * @param event Event to queue
-   */
   /**
    * @brief Handle set mode request
    */
@@ -501,17 +722,191 @@ private:
   {
     if (server_.hasArg("mode"))
     {
-      int mode = server_.arg("mode").toInt();
+      int mode = atoi(server_.arg("mode"));
       ConfigManager::setTurboliftMode(mode);
-      String response = "Turbolift mode set to: " + String(mode == 0 ? "Classic" : "Virtual Gradients");
-      sendCORSHeaders();
-      server_.send(200, "text/plain", response);
+      respond(200).print(F("Turbolift mode set to: ")).print(mode == 0 ? F("Classic") : F("Virtual Gradients"));
+    }
+    else
+      respond(400).print(F("Missing mode parameter"));
+  }
+
+  /**
+   * @brief Handle batch config request
+   *
+   * Any subset of the /config parameters, as query or form arguments. The
+   * batch is checked whole before anything changes, then staged in
+   * configCoalescer_, which applies it now or, during a burst, together
+   * with the requests after it.
+   */
+  void handleSet()
+  {
+    ConfigBatch batch;
+    for (int i = 0; i < server_.args(); i++)
+    {
+      if (!batch.set(server_.argName(i), server_.arg(i)))
+      {
+        respond(400).print(F("Invalid parameter: ")).print(server_.argName(i));
+        return;
+      }
+    }
+    if (batch.empty())
+    {
+      respond(400).print(F("No parameters"));
+      return;
+    }
+
+    configCoalescer_.stage(batch);
+    bool applied = configCoalescer_.service(millis());
+    respond(200).print(applied ? F("Config updated") : F("Config queued"));
+  }
+
+  /**
+   * @brief Handle cue statistics request: counts, and latency from receipt
+   *        to the input manager and to the first frame shown; reset=1
+   *        clears the latency after reporting it
+   */
+  void handleCues()
+  {
+    if (!cues_)
+    {
+      respond(503).print(F("Cues not available"));
+      return;
+    }
+    const CueInputSource::Stats &stats = cues_->stats();
+    ResponseWriter out = respond(200, "application/json");
+    out.beginObject()
+        .field(F("received"), (long)stats.received)
+        .field(F("duplicates"), (long)stats.duplicates)
+        .field(F("unknown"), (long)stats.unknown)
+        .field(F("busy"), (long)stats.busy)
+        .field(F("invalid"), (long)stats.invalid)
+        .field(F("acks"), (long)stats.acks)
+        .field(F("unshown"), (long)stats.unshown);
+    writeLatency(out.key(F("dispatch")), cues_->dispatchLatency());
+    writeLatency(out.key(F("show")), cues_->showLatency());
+    out.endObject();
+    if (server_.hasArg("reset") && atoi(server_.arg("reset")))
+      cues_->resetLatency();
+  }
+
+  static void writeLatency(ResponseWriter &out, const LatencyHistogram &latency)
+  {
+    out.beginObject()
+        .field(F("count"), (long)latency.count())
+        .field(F("meanUs"), (long)latency.meanUs())
+        .field(F("maxUs"), (long)latency.maxUs())
+        .field(F("p50Ms"), (long)latency.percentileMs(50))
+        .field(F("p99Ms"), (long)latency.percentileMs(99));
+    out.key(F("fromMs")).beginArray();
+    for (int i = 0; i < LatencyHistogram::BUCKETS; i++)
+      out.value((long)LatencyHistogram::bucketStartMs(i));
+    out.endArray().key(F("counts")).beginArray();
+    for (int i = 0; i < LatencyHistogram::BUCKETS; i++)
+      out.value((long)latency.bucket(i));
+    out.endArray().endObject();
+  }
+
+  /**
+   * @brief Read the slot argument of a /preset request, answering 400 or
+   *        503 if there is no usable one
+   */
+  bool presetSlot(int &slot)
+  {
+    const __FlashStringHelper *error = nullptr;
+    int code = 400;
+    if (!presets_)
+    {
+      error = F("Presets not available");
+      code = 503;
+    }
+    else if (!server_.hasArg("slot"))
+      error = F("Missing slot parameter");
+    else
+    {
+      const char *text = server_.arg("slot");
+      char *end;
+      slot = (int)strtol(text, &end, 10);
+      if (*text == '\0' || *end != '\0' || !PresetStore::validSlot(slot))
+        error = F("Invalid slot");
+    }
+    if (!error)
+      return true;
+    respond(code).print(error);
+    return false;
+  }
+
+  /**
+   * @brief Handle preset list request
+   *
+   * Reads only each slot's header, so a damaged preset is listed but
+   * fails to recall.
+   */
+  void handlePresets()
+  {
+    ResponseWriter out = respond(200, "application/json");
+    out.beginObject().field(F("current"), presets_ ? presets_->current() : -1);
+    out.key(F("presets")).beginArray();
+    char name[PresetStore::NAME_LENGTH + 1];
+    for (int slot = 0; presets_ && slot < PresetStore::SLOTS; slot++)
+    {
+      if (presets_->readName(slot, name))
+        out.beginObject().field(F("slot"), slot).field(F("name"), name).endObject();
     }
+    out.endArray().endObject();
+  }
+
+  /**
+   * @brief Handle preset save request: the current settings and, unless
+   *        patterns=0, the patterns on show
+   */
+  void handlePresetSave()
+  {
+    int slot;
+    if (!presetSlot(slot))
+      return;
+    char name[PresetStore::NAME_LENGTH + 1];
+    if (!server_.hasArg("name"))
+      snprintf(name, sizeof(name), "Preset %d", slot);
+    else if (PresetStore::validName(server_.arg("name")))
+      strcpy(name, server_.arg("name"));
     else
     {
-      sendCORSHeaders();
-      server_.send(400, "text/plain", "Missing mode parameter");
+      respond(400).print(F("Invalid name"));
+      return;
     }
+    bool withPatterns = !server_.hasArg("patterns") || strcmp(server_.arg("patterns"), "0") != 0;
+    if (presets_->save(slot, name, withPatterns))
+      respond(200).print(F("Preset saved: ")).print(name);
+    else
+      respond(500).print(F("Preset save failed"));
+  }
+
+  /**
+   * @brief Handle preset recall request
+   *
+   * Changes staged by /set are applied first, so they cannot land on top
+   * of the recalled look.
+   */
+  void handlePresetRecall()
+  {
+    int slot;
+    if (!presetSlot(slot))
+      return;
+    configCoalescer_.flush();
+    bool recalled = presets_->recall(slot);
+    respond(recalled ? 200 : 404).print(recalled ? F("Preset recalled") : F("No valid preset in slot"));
+  }
+
+  /**
+   * @brief Handle preset delete request
+   */
+  void handlePresetDelete()
+  {
+    int slot;
+    if (!presetSlot(slot))
+      return;
+    bool removed = presets_->remove(slot);
+    respond(removed ? 200 : 404).print(removed ? F("Preset deleted") : F("No preset in slot"));
   }
 
   /**
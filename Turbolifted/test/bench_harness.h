@@ -0,0 +1,113 @@
+// Minimal host benchmark harness: wall-clock timing, heap allocation counting
+// and stack high-water measurement. Include from exactly one translation unit,
+// since it replaces the global allocation operators.
+#pragma once
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+namespace Bench
+{
+  static unsigned long allocationCount = 0;
+
+  constexpr size_t STACK_PROBE_BYTES = 64 * 1024;
+  constexpr size_t STACK_GUARD_BYTES = 256; // Left unpainted for measureStack()'s own frame
+  constexpr unsigned char STACK_PAINT = 0xA5;
+
+  /**
+   * @brief Result of one benchmark case
+   */
+  struct Result
+  {
+    double nsPerCall;          ///< Mean wall-clock time per call
+    double allocationsPerCall; ///< Mean operator new calls per call
+    size_t stackBytes;         ///< Deepest stack use of a single call
+  };
+
+  template <typename F>
+  __attribute__((noinline)) static void runOutOfLine(F &fn)
+  {
+    fn();
+  }
+
+  /**
+   * @brief Stack high-water mark of a single call, in bytes (host approximation)
+   *
+   * Paints STACK_PROBE_BYTES of free stack, starting STACK_GUARD_BYTES below
+   * this frame so its own locals are clear of it, runs @p fn, then finds the
+   * deepest painted byte that changed. Calls shallower than the guard read
+   * as STACK_GUARD_BYTES.
+   */
+  template <typename F>
+  __attribute__((noinline)) static size_t measureStack(F &fn)
+  {
+    unsigned char *frame = static_cast<unsigned char *>(__builtin_frame_address(0));
+    volatile unsigned char *region = frame - STACK_GUARD_BYTES - STACK_PROBE_BYTES;
+    for (size_t i = 0; i < STACK_PROBE_BYTES; ++i)
+      region[i] = STACK_PAINT;
+
+    runOutOfLine(fn);
+
+    size_t untouched = 0;
+    while (untouched < STACK_PROBE_BYTES && region[untouched] == STACK_PAINT)
+      ++untouched;
+    return STACK_GUARD_BYTES + STACK_PROBE_BYTES - untouched;
+  }
+
+  /**
+   * @brief Time @p iterations calls of @p fn after @p warmup untimed calls
+   */
+  template <typename F>
+  static Result run(F fn, int iterations, int warmup = 16)
+  {
+    for (int i = 0; i < warmup; ++i)
+      fn();
+
+    Result result;
+    result.stackBytes = measureStack(fn);
+
+    unsigned long allocsBefore = allocationCount;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i)
+      fn();
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    result.nsPerCall = std::chrono::duration<double, std::nano>(elapsed).count() / iterations;
+    result.allocationsPerCall = (double)(allocationCount - allocsBefore) / iterations;
+    return result;
+  }
+
+  inline void printHeader(const char *title)
+  {
+    printf("\n%s\n", title);
+    printf("%-28s %14s %14s %12s\n", "case", "ns/call", "allocs/call", "stack bytes");
+  }
+
+  inline void printResult(const char *name, const Result &r)
+  {
+    printf("%-28s %14.0f %14.2f %12zu\n", name, r.nsPerCall, r.allocationsPerCall, r.stackBytes);
+  }
+}
+
+void *operator new(size_t size)
+{
+  ++Bench::allocationCount;
+  if (void *p = malloc(size ? size : 1))
+    return p;
+  throw std::bad_alloc();
+}
+
+void *operator new[](size_t size)
+{
+  ++Bench::allocationCount;
+  if (void *p = malloc(size ? size : 1))
+    return p;
+  throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept { free(p); }
+void operator delete[](void *p) noexcept { free(p); }
+void operator delete(void *p, size_t) noexcept { free(p); }
+void operator delete[](void *p, size_t) noexcept { free(p); }
@@ -0,0 +1,198 @@
+// Host load test for AsyncHttpServer over real sockets (127.0.0.1).
+// Build and run with ./run_benchmarks.sh
+//
+// Client threads hammer /config while the main thread runs the server's
+// service() loop as the frame loop would, first alone, then next to clients
+// that stall mid-request or never read their response. Reports requests per
+// second, client latency, the mean and longest service() call and heap
+// allocations per request inside service(). The longest call includes any
+// time the host scheduler gave to the client threads.
+#include "bench_harness.h"
+#include "posix_tcp_transport.h"
+#include <algorithm>
+#include <arpa/inet.h>
+#include <atomic>
+#include <thread>
+
+extern "C" unsigned long millis()
+{
+  using namespace std::chrono;
+  return (unsigned long)duration_cast<milliseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+constexpr int CLIENTS = 8;
+constexpr int MAX_REQUESTS = 400;
+constexpr size_t BIG_BODY = 256 * 1024;
+
+static uint16_t port;
+static std::atomic<int> clientsDone(0);
+static std::atomic<unsigned long> retries(0);
+static double latencyUs[CLIENTS][MAX_REQUESTS];
+
+// Response body that is never read by its client
+class PatternSource : public IBodySource
+{
+public:
+  size_t read(int, uint8_t *data, size_t length) override
+  {
+    memset(data, 'x', length);
+    return length;
+  }
+  void close(int) override {}
+};
+
+static int connectClient()
+{
+  int fd = socket(AF_INET, SOCK_STREAM, 0);
+  sockaddr_in address = {};
+  address.sin_family = AF_INET;
+  address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  address.sin_port = htons(port);
+  if (connect(fd, (sockaddr *)&address, sizeof(address)) < 0)
+  {
+    close(fd);
+    return -1;
+  }
+  return fd;
+}
+
+// One request on its own connection; false if refused (connection limit)
+static bool get(const char *request)
+{
+  int fd = connectClient();
+  if (fd < 0)
+    return false;
+  send(fd, request, strlen(request), MSG_NOSIGNAL);
+  char response[2048];
+  size_t length = 0;
+  ssize_t n;
+  while ((n = recv(fd, response + length, sizeof(response) - 1 - length, 0)) > 0)
+    length += (size_t)n;
+  close(fd);
+  response[length] = '\0';
+  return strncmp(response, "HTTP/1.1 200 OK", 15) == 0 && strstr(response, "\"speed\":") != nullptr;
+}
+
+static void client(int index, int requests)
+{
+  for (int i = 0; i < requests; i++)
+  {
+    auto start = std::chrono::steady_clock::now();
+    while (!get("GET /config HTTP/1.1\r\nHost: bench\r\n\r\n"))
+    {
+      retries++;
+      std::this_thread::sleep_for(std::chrono::microseconds(200));
+    }
+    latencyUs[index][i] = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+  }
+  clientsDone++;
+}
+
+struct LoopStats
+{
+  unsigned long calls = 0;
+  double totalUs = 0;
+  double longestUs = 0;
+  unsigned long allocations = 0;
+};
+
+// Run service() until @p done, timing each call
+template <typename Done>
+static LoopStats serviceUntil(AsyncHttpServer &server, Done done)
+{
+  LoopStats stats;
+  while (!done())
+  {
+    unsigned long allocsBefore = Bench::allocationCount;
+    auto start = std::chrono::steady_clock::now();
+    server.service(millis());
+    double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+    stats.allocations += Bench::allocationCount - allocsBefore;
+    stats.totalUs += us;
+    stats.longestUs = std::max(stats.longestUs, us);
+    stats.calls++;
+  }
+  return stats;
+}
+
+static void runClients(AsyncHttpServer &server, const char *name, int requests)
+{
+  clientsDone = 0;
+  retries = 0;
+  std::thread threads[CLIENTS];
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < CLIENTS; i++)
+    threads[i] = std::thread(client, i, requests);
+  LoopStats stats = serviceUntil(server, []()
+                                 { return clientsDone == CLIENTS; });
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  for (std::thread &t : threads)
+    t.join();
+
+  static double all[CLIENTS * MAX_REQUESTS];
+  int count = 0;
+  for (int i = 0; i < CLIENTS; i++)
+    for (int j = 0; j < requests; j++)
+      all[count++] = latencyUs[i][j];
+  std::sort(all, all + count);
+  printf("%-24s %7.0f %8.0f %8.0f %9.1f %9.1f %10.2f %8lu\n", name, count / seconds, all[count / 2],
+         all[count * 99 / 100], stats.totalUs / stats.calls, stats.longestUs, (double)stats.allocations / count,
+         retries.load());
+}
+
+int main()
+{
+  PosixTcpTransport tcp;
+  AsyncHttpServer server(&tcp);
+  static char buffer[TurboliftConfig::WiFi::RESPONSE_BUFFER];
+  static PatternSource pattern;
+  server.setDefaultHeaders("Access-Control-Allow-Origin: *\r\n");
+  server.on("/config", [&]()
+            { ResponseWriter(server, buffer, sizeof(buffer), 200, "application/json")
+                  .beginObject()
+                  .field(F("speed"), 5)
+                  .field(F("brightness"), 200)
+                  .field(F("hueMin"), 0)
+                  .field(F("hueMax"), 255)
+                  .endObject(); });
+  server.on("/big", [&]()
+            { server.sendBody(200, "application/octet-stream", BIG_BODY, &pattern); });
+  if (!server.begin(0))
+  {
+    printf("Cannot listen on 127.0.0.1\n");
+    return 1;
+  }
+  port = tcp.port();
+
+  printf("\nAsyncHttpServer on POSIX sockets, %d clients (host build)\n", CLIENTS);
+  printf("%-24s %7s %8s %8s %9s %9s %10s %8s\n", "case", "req/s", "p50 us", "p99 us", "svc us", "svc max", "allocs/req",
+         "refused");
+
+  runClients(server, "GET /config", MAX_REQUESTS);
+
+  // Two clients stop mid-request and one never reads a large response:
+  // they hold three of the slots until their timeouts
+  int stalled[3];
+  for (int i = 0; i < 2; i++)
+  {
+    stalled[i] = connectClient();
+    send(stalled[i], "GET /config HTTP/1.1\r\nHo", 24, MSG_NOSIGNAL);
+  }
+  stalled[2] = connectClient();
+  int small = 4096;
+  setsockopt(stalled[2], SOL_SOCKET, SO_RCVBUF, &small, sizeof(small));
+  send(stalled[2], "GET /big HTTP/1.1\r\n\r\n", 21, MSG_NOSIGNAL);
+  serviceUntil(server, [&]()
+               { return server.activeConnections() == 3; });
+  unsigned long stallStart = millis();
+  runClients(server, "GET /config, 3 stalled", MAX_REQUESTS / 4);
+
+  serviceUntil(server, [&]()
+               { return server.activeConnections() == 0; });
+  printf("Stalled connections dropped after %lu ms (timeouts %lu / %lu ms); %lu connections refused at the limit\n",
+         millis() - stallStart, TurboliftConfig::WiFi::HTTP_REQUEST_TIMEOUT_MS, TurboliftConfig::WiFi::HTTP_SEND_TIMEOUT_MS,
+         tcp.refused());
+  for (int fd : stalled)
+    close(fd);
+  return 0;
+}
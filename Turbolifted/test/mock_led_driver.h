@@ -11,26 +11,110 @@ class MockLEDDriver : public ILEDDriver
 public:
   MockLEDDriver(int pin = 0) {}
   void begin() override {}
-  CRGB *getBuffer() override { return buffer; }
-  void show() override {}
-  void setBrightness(uint8_t b) override { brightness = b; }
+  CRGB *getBuffer() override
+  {
+    dirty = true;
+    return buffer;
+  }
+  // Mirrors FastLEDDriver: only changed frames count as transmitted
+  void show() override
+  {
+    if (!dirty)
+      return;
+    ++transmitCount;
+    dirty = false;
+  }
+  void setBrightness(uint8_t b) override
+  {
+    if (b != brightness)
+    {
+      brightness = b;
+      dirty = true;
+    }
+  }
   void fillSolid(const CRGB &c) override
   {
     for (int i = 0; i < N; ++i)
       buffer[i] = c;
+    dirty = true;
   }
   void clear() override
   {
     for (int i = 0; i < N; ++i)
       buffer[i] = CRGB();
+    dirty = true;
   }
   void setPixel(int i, const CRGB &c) override
   {
     if (i >= 0 && i < N)
+    {
       buffer[i] = c;
+      dirty = true;
+    }
+  }
+
+  void writeSpan(int start, const CRGB *src, int count) override
+  {
+    int first = start;
+    if (clipSpan(first, count, N))
+    {
+      memcpy(buffer + first, src + (first - start), count * sizeof(CRGB));
+      dirty = true;
+    }
+  }
+  void addSpan(int start, const CRGB *src, int count) override
+  {
+    int first = start;
+    if (clipSpan(first, count, N))
+    {
+      for (int i = 0; i < count; i++)
+        buffer[first + i] += src[first - start + i];
+      dirty = true;
+    }
+  }
+  void blitRotated(const CRGB *ring, int ringLength, int offset) override
+  {
+    rotatedCopy(buffer, N, ring, ringLength, offset);
+    dirty = true;
+  }
+  void addRotated(const CRGB *ring, int ringLength, int offset) override
+  {
+    rotatedAdd(buffer, N, ring, ringLength, offset);
+    dirty = true;
+  }
+  void scaleSpan(int start, int count, uint8_t scale) override
+  {
+    if (clipSpan(start, count, N))
+    {
+      for (int i = start; i < start + count; ++i)
+        buffer[i].nscale8(scale);
+      dirty = true;
+    }
+  }
+  void blitRotatedSubpixel(const CRGB *ring, int ringLength, uint32_t offsetQ8) override
+  {
+    rotatedBlend(buffer, N, ring, ringLength, offsetQ8);
+    dirty = true;
+  }
+  void addRotatedSubpixel(const CRGB *ring, int ringLength, uint32_t offsetQ8) override
+  {
+    rotatedBlendAdd(buffer, N, ring, ringLength, offsetQ8);
+    dirty = true;
+  }
+  void blitSubpixel(const CRGB *src, int count, uint8_t frac) override
+  {
+    linearBlend(buffer, count < N ? count : N, src, frac);
+    dirty = true;
+  }
+  void addSubpixel(const CRGB *src, int count, uint8_t frac) override
+  {
+    linearBlendAdd(buffer, count < N ? count : N, src, frac);
+    dirty = true;
   }
 
   CRGB buffer[N];
   uint8_t brightness = 255;
+  bool dirty = true;
+  int transmitCount = 0; // show() calls that actually sent a frame
 };
 #endif
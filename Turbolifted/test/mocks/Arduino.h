@@ -0,0 +1,43 @@
+#pragma once
+// Mock Arduino core for host-based testing (-DUNIT_TEST)
+//
+// Only the pieces used by the header-only effect and config code are provided.
+// random() and constrain() for floats are supplied by the effect headers
+// themselves, so they are intentionally not defined here.
+
+#include <stdint.h>
+#include <stdlib.h>
+
+extern "C" unsigned long millis();
+
+static inline void randomSeed(unsigned long seed) { srand((unsigned int)seed); }
+
+template <typename T, typename L, typename H>
+static inline T constrain(T x, L lo, H hi)
+{
+  return x < (T)lo ? (T)lo : (x > (T)hi ? (T)hi : x);
+}
+
+template <typename A, typename B>
+static inline auto min(A a, B b) -> decltype(a < b ? a : b)
+{
+  return a < b ? a : b;
+}
+
+template <typename A, typename B>
+static inline auto max(A a, B b) -> decltype(a > b ? a : b)
+{
+  return a > b ? a : b;
+}
+
+// Serial output is swallowed on the host so benchmarks and tests stay quiet
+struct MockSerial
+{
+  void begin(unsigned long) {}
+  template <typename T>
+  void print(const T &) {}
+  template <typename T>
+  void println(const T &) {}
+  void println() {}
+};
+static MockSerial Serial;
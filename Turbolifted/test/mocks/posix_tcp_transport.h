@@ -0,0 +1,182 @@
+#pragma once
+// ITcpTransport on non-blocking POSIX sockets, for running AsyncHttpServer
+// on the host (load tests against 127.0.0.1)
+//
+// Events are delivered from poll(), which AsyncHttpServer::service() calls.
+// Accepted sockets get a small send buffer so the send window fills up much
+// as the ESP8266's does (lwIP TCP_SND_BUF is about 2.9 KB).
+
+#include <errno.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include "async_http_server.h"
+
+class PosixTcpTransport : public ITcpTransport
+{
+public:
+  static constexpr int MAX_CONNECTIONS = TurboliftConfig::WiFi::HTTP_MAX_CONNECTIONS;
+  static constexpr int SEND_BUFFER = 4096;
+
+  PosixTcpTransport() : handler_(nullptr), listener_(-1), refused_(0)
+  {
+    for (int i = 0; i < MAX_CONNECTIONS; i++)
+    {
+      fds_[i] = -1;
+      blocked_[i] = false;
+    }
+  }
+
+  ~PosixTcpTransport() override
+  {
+    for (int i = 0; i < MAX_CONNECTIONS; i++)
+      if (fds_[i] >= 0)
+        ::close(fds_[i]);
+    if (listener_ >= 0)
+      ::close(listener_);
+  }
+
+  /**
+   * @brief Listen on 127.0.0.1; port 0 picks a free one (see port())
+   */
+  bool begin(uint16_t port, ITcpHandler *handler) override
+  {
+    handler_ = handler;
+    listener_ = socket(AF_INET, SOCK_STREAM, 0);
+    if (listener_ < 0)
+      return false;
+    int on = 1;
+    setsockopt(listener_, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+    sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = htons(port);
+    socklen_t length = sizeof(address);
+    if (bind(listener_, (sockaddr *)&address, sizeof(address)) < 0 || listen(listener_, 64) < 0 ||
+        getsockname(listener_, (sockaddr *)&address, &length) < 0)
+      return false;
+    port_ = ntohs(address.sin_port);
+    fcntl(listener_, F_SETFL, O_NONBLOCK);
+    return true;
+  }
+
+  size_t write(int id, const char *data, size_t length) override
+  {
+    ssize_t n = send(fds_[id], data, length, MSG_DONTWAIT | MSG_NOSIGNAL);
+    if (n < 0)
+      n = 0;
+    blocked_[id] = (size_t)n < length;
+    return (size_t)n;
+  }
+
+  void close(int id) override
+  {
+    ::close(fds_[id]);
+    fds_[id] = -1;
+  }
+
+  void abort(int id) override
+  {
+    linger reset = {1, 0};
+    setsockopt(fds_[id], SOL_SOCKET, SO_LINGER, &reset, sizeof(reset));
+    close(id);
+  }
+
+  void poll() override
+  {
+    pollfd fds[MAX_CONNECTIONS + 1];
+    int ids[MAX_CONNECTIONS + 1];
+    int count = 0;
+    fds[count] = {listener_, POLLIN, 0};
+    ids[count++] = -1;
+    for (int i = 0; i < MAX_CONNECTIONS; i++)
+    {
+      if (fds_[i] < 0)
+        continue;
+      fds[count] = {fds_[i], (short)(POLLIN | (blocked_[i] ? POLLOUT : 0)), 0};
+      ids[count++] = i;
+    }
+    if (::poll(fds, count, 0) <= 0)
+      return;
+
+    for (int k = 1; k < count; k++)
+    {
+      int id = ids[k];
+      if (fds_[id] != fds[k].fd)
+        continue; // Closed by a callback
+      if (fds[k].revents & (POLLIN | POLLHUP | POLLERR))
+        receive(id);
+      if (fds_[id] == fds[k].fd && blocked_[id] && (fds[k].revents & POLLOUT))
+      {
+        blocked_[id] = false;
+        handler_->onWritable(id);
+      }
+    }
+    if (fds[0].revents & POLLIN)
+      acceptAll();
+  }
+
+  uint16_t port() const { return port_; }
+  unsigned long refused() const { return refused_; }
+
+private:
+  ITcpHandler *handler_;
+  int listener_;
+  uint16_t port_;
+  int fds_[MAX_CONNECTIONS];
+  bool blocked_[MAX_CONNECTIONS];
+  unsigned long refused_;
+
+  void acceptAll()
+  {
+    int fd;
+    while ((fd = accept(listener_, nullptr, nullptr)) >= 0)
+    {
+      int id = 0;
+      while (id < MAX_CONNECTIONS && fds_[id] >= 0)
+        id++;
+      if (id == MAX_CONNECTIONS)
+      {
+        // Connection limit
+        linger reset = {1, 0};
+        setsockopt(fd, SOL_SOCKET, SO_LINGER, &reset, sizeof(reset));
+        ::close(fd);
+        refused_++;
+        continue;
+      }
+      fcntl(fd, F_SETFL, O_NONBLOCK);
+      int on = 1, size = SEND_BUFFER;
+      setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+      setsockopt(fd, SOL_SOCKET, SO_SNDBUF, &size, sizeof(size));
+      fds_[id] = fd;
+      blocked_[id] = false;
+      handler_->onConnect(id);
+    }
+  }
+
+  void receive(int id)
+  {
+    uint8_t buffer[1460];
+    for (;;)
+    {
+      ssize_t n = recv(fds_[id], buffer, sizeof(buffer), MSG_DONTWAIT);
+      if (n > 0)
+      {
+        handler_->onData(id, buffer, (size_t)n);
+        if (fds_[id] < 0)
+          return;
+        continue;
+      }
+      if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+        return;
+      // Peer closed or failed
+      ::close(fds_[id]);
+      fds_[id] = -1;
+      handler_->onClose(id);
+      return;
+    }
+  }
+};
@@ -0,0 +1,194 @@
+// Event-driven HTTP server: requests arriving in pieces, responses leaving
+// through a small send window, and the limits that keep memory fixed
+#include <cassert>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include "async_http_server.h"
+
+// Scripted transport: accepts at most `window` bytes per write until
+// opened again, and records what was sent and how each connection ended
+class MockTransport : public ITcpTransport
+{
+public:
+  ITcpHandler *handler = nullptr;
+  std::string sent[AsyncHttpServer::MAX_CONNECTIONS];
+  size_t window[AsyncHttpServer::MAX_CONNECTIONS];
+  bool closed[AsyncHttpServer::MAX_CONNECTIONS] = {};
+  bool aborted[AsyncHttpServer::MAX_CONNECTIONS] = {};
+
+  MockTransport()
+  {
+    for (size_t &w : window)
+      w = 1 << 20;
+  }
+
+  bool begin(uint16_t, ITcpHandler *h) override
+  {
+    handler = h;
+    return true;
+  }
+  size_t write(int id, const char *data, size_t length) override
+  {
+    size_t n = length < window[id] ? length : window[id];
+    sent[id].append(data, n);
+    window[id] -= n;
+    return n;
+  }
+  void close(int id) override { closed[id] = true; }
+  void abort(int id) override { aborted[id] = true; }
+
+  void connect(int id)
+  {
+    sent[id].clear();
+    closed[id] = aborted[id] = false;
+    handler->onConnect(id);
+  }
+  void receive(int id, const char *text) { handler->onData(id, (const uint8_t *)text, strlen(text)); }
+};
+
+// Body of a known length, read in whatever pieces the server asks for
+class MockSource : public IBodySource
+{
+public:
+  size_t length = 0, offset = 0, largestRead = 0;
+  int closes = 0;
+
+  size_t read(int, uint8_t *data, size_t n) override
+  {
+    n = n < length - offset ? n : length - offset;
+    for (size_t i = 0; i < n; i++)
+      data[i] = (uint8_t)('a' + (offset + i) % 26);
+    offset += n;
+    largestRead = n > largestRead ? n : largestRead;
+    return n;
+  }
+  void close(int) override { closes++; }
+};
+
+static std::string body(const std::string &response)
+{
+  size_t at = response.find("\r\n\r\n");
+  return at == std::string::npos ? "" : response.substr(at + 4);
+}
+
+int main()
+{
+  MockTransport tcp;
+  AsyncHttpServer server(&tcp);
+  static const char *collected[] = {"If-None-Match"};
+  server.collectHeaders(collected, 1);
+  server.setDefaultHeaders("Access-Control-Allow-Origin: *\r\n");
+  char buffer[64];
+  std::string seen;
+  server.on("/set", [&]()
+            {
+              seen = std::string(server.method() == AsyncHttpServer::POST ? "POST" : "GET");
+              for (int i = 0; i < server.args(); i++)
+                seen += std::string(" ") + server.argName(i) + "=" + server.arg(i);
+              const char *etag = server.header("if-none-match");
+              seen += etag ? std::string(" etag=") + etag : "";
+              ResponseWriter(server, buffer, sizeof(buffer), 200, "text/plain").print("ok ").print(server.arg("speed"));
+            });
+  MockSource file;
+  server.on("/file", [&]()
+            { server.sendHeader("Content-Encoding", "gzip");
+              server.sendBody(200, "text/html", file.length, &file); });
+  server.on("/silent", []() {});
+  server.begin(80);
+  unsigned long now = 1000;
+
+  // A request arriving in pieces is handled once complete, by service()
+  tcp.connect(0);
+  tcp.receive(0, "GET /set?speed=5&name=a%20b+c&flag HTTP/1.1\r\nHost: x\r\nIf-None-Match:  \"1\"\r\n");
+  server.service(now);
+  assert(tcp.sent[0].empty() && server.activeConnections() == 1);
+  tcp.receive(0, "\r\n");
+  assert(tcp.sent[0].empty()); // Not from the transport's callback
+  server.service(now);
+  assert(seen == "GET speed=5 name=a b c flag= etag=\"1\"");
+  assert(tcp.sent[0].find("HTTP/1.1 200 OK\r\nContent-Type: text/plain\r\nContent-Length: 4\r\n") == 0);
+  assert(tcp.sent[0].find("Access-Control-Allow-Origin: *\r\n") != std::string::npos);
+  assert(tcp.sent[0].find("Connection: close\r\n\r\n") != std::string::npos);
+  assert(body(tcp.sent[0]) == "ok 5");
+  assert(tcp.closed[0] && server.activeConnections() == 0);
+
+  // Form POST bodies are arguments too; the body may follow the headers later
+  tcp.connect(1);
+  tcp.receive(1, "POST /set HTTP/1.1\r\nContent-Type: application/x-www-form-urlencoded\r\nContent-Length: 16\r\n\r\nhueMin=");
+  server.service(now);
+  assert(tcp.sent[1].empty());
+  tcp.receive(1, "1&hueMax=90");
+  server.service(now);
+  assert(seen == "POST hueMin=1 hueMax=90");
+
+  // Unknown paths, handlers that do not answer, malformed requests, preflight
+  tcp.connect(0);
+  tcp.receive(0, "GET /nowhere HTTP/1.1\r\n\r\n");
+  tcp.connect(1);
+  tcp.receive(1, "GET /silent HTTP/1.1\r\n\r\n");
+  tcp.connect(2);
+  tcp.receive(2, "GET /set\r\n\r\n");
+  tcp.connect(3);
+  tcp.receive(3, "OPTIONS /set HTTP/1.1\r\n\r\n");
+  server.service(now);
+  assert(tcp.sent[0].find("HTTP/1.1 404 Not Found\r\n") == 0 && tcp.sent[1].find("HTTP/1.1 404") == 0);
+  assert(tcp.sent[2].find("HTTP/1.1 400 Bad Request\r\n") == 0);
+  assert(tcp.sent[3].find("HTTP/1.1 204 No Content\r\n") == 0);
+  assert(tcp.sent[3].find("Access-Control-Allow-Origin: *") != std::string::npos);
+  assert(tcp.sent[3].find("Content-Length") == std::string::npos);
+
+  // A request larger than the buffer is answered 431, whatever follows
+  tcp.connect(0);
+  std::string huge = "GET /set HTTP/1.1\r\nX-Filler: " + std::string(AsyncHttpServer::REQUEST_BUFFER, 'x');
+  tcp.receive(0, huge.c_str());
+  server.service(now);
+  assert(tcp.sent[0].find("HTTP/1.1 431") == 0 && tcp.closed[0]);
+
+  // A long response goes out as the window opens; the body source is read
+  // only then, a transmit buffer at a time
+  file.length = 5000;
+  tcp.connect(2);
+  tcp.window[2] = 100;
+  tcp.receive(2, "GET /file HTTP/1.1\r\n\r\n");
+  server.service(now);
+  assert(tcp.sent[2].size() == 100 && file.offset <= AsyncHttpServer::TX_BUFFER);
+  for (int i = 0; i < 200 && !tcp.closed[2]; i++)
+  {
+    tcp.window[2] = 700;
+    tcp.handler->onWritable(2);
+    server.service(now);
+  }
+  assert(tcp.closed[2] && file.closes == 1 && file.largestRead <= AsyncHttpServer::TX_BUFFER);
+  assert(tcp.sent[2].find("Content-Encoding: gzip\r\n") != std::string::npos);
+  assert(tcp.sent[2].find("Content-Length: 5000\r\n") != std::string::npos);
+  std::string received = body(tcp.sent[2]);
+  assert(received.size() == 5000 && received[26] == 'a' && received[4999] == 'a' + 4999 % 26);
+
+  // Stalled clients are dropped after their timeouts, freeing the slot
+  tcp.connect(0);
+  tcp.receive(0, "GET /set HTTP/1.1\r\n");
+  file.offset = 0;
+  tcp.connect(1);
+  tcp.window[1] = 10;
+  tcp.receive(1, "GET /file HTTP/1.1\r\n\r\n");
+  server.service(now);
+  server.service(now + TurboliftConfig::WiFi::HTTP_REQUEST_TIMEOUT_MS);
+  assert(!tcp.aborted[0] && !tcp.aborted[1]);
+  server.service(now + TurboliftConfig::WiFi::HTTP_REQUEST_TIMEOUT_MS + 1);
+  assert(tcp.aborted[0] && !tcp.aborted[1]);
+  server.service(now + TurboliftConfig::WiFi::HTTP_SEND_TIMEOUT_MS + 1);
+  assert(tcp.aborted[1] && file.closes == 2 && server.activeConnections() == 0);
+
+  // A client that goes away mid-response releases its body source
+  file.offset = 0;
+  tcp.connect(3);
+  tcp.window[3] = 10;
+  tcp.receive(3, "GET /file HTTP/1.1\r\n\r\n");
+  server.service(now);
+  tcp.handler->onClose(3);
+  assert(file.closes == 3 && server.activeConnections() == 0);
+
+  std::cout << "Async HTTP server tests passed" << std::endl;
+  return 0;
+}
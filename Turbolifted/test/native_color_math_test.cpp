@@ -0,0 +1,107 @@
+#include <cassert>
+#include <cstdlib>
+#include <iostream>
+#include "../src/color_math.h"
+
+// Golden references: the float implementations the fixed-point paths replaced
+static CRGB legacyInterpolate(const CRGB &c1, const CRGB &c2, float ratio)
+{
+  ratio = ratio < 0.0f ? 0.0f : (ratio > 1.0f ? 1.0f : ratio);
+  return CRGB((uint8_t)(c1.r + (c2.r - c1.r) * ratio),
+              (uint8_t)(c1.g + (c2.g - c1.g) * ratio),
+              (uint8_t)(c1.b + (c2.b - c1.b) * ratio));
+}
+
+static uint8_t legacyFadeIn(unsigned long elapsed, unsigned long duration)
+{
+  float t = elapsed / (float)duration;
+  t = t > 1.0f ? 1.0f : t;
+  return (uint8_t)(t * 255);
+}
+
+static uint8_t legacyFadeOut(unsigned long elapsed, unsigned long duration)
+{
+  float t = elapsed / (float)duration;
+  t = t > 1.0f ? 1.0f : t;
+  return (uint8_t)((1.0f - t) * 255);
+}
+
+static bool within1(int a, int b) { return abs(a - b) <= 1; }
+
+static bool within1(const CRGB &a, const CRGB &b)
+{
+  return within1(a.r, b.r) && within1(a.g, b.g) && within1(a.b, b.b);
+}
+
+int main()
+{
+  srand(1234);
+
+  // fillGradient tracks the per-pixel float interpolation for every segment length
+  int pixels = 0, exact = 0;
+  for (int trial = 0; trial < 500; ++trial)
+  {
+    CRGB a(rand() % 256, rand() % 256, rand() % 256);
+    CRGB b(rand() % 256, rand() % 256, rand() % 256);
+    if (trial == 0)
+      a = CRGB(0, 0, 0), b = CRGB(255, 255, 255);
+    if (trial == 1)
+      a = CRGB(255, 255, 255), b = CRGB(0, 0, 0);
+    for (int len = 1; len <= 40; ++len)
+    {
+      CRGB out[40];
+      ColorMath::fillGradient(out, len, a, b);
+      for (int i = 0; i < len; ++i)
+      {
+        float ratio = (len == 1) ? 0.0f : (float)i / (len - 1);
+        CRGB expected = legacyInterpolate(a, b, ratio);
+        assert(within1(out[i], expected));
+        exact += (out[i] == expected);
+        ++pixels;
+      }
+      // Segment endpoints are always exact
+      assert(out[0] == a);
+      if (len > 1)
+        assert(out[len - 1] == b);
+    }
+  }
+
+  // The float wrapper still honours clamping and matches the legacy output
+  for (int step = -10; step <= 110; ++step)
+  {
+    float ratio = step / 100.0f;
+    CRGB a(10, 200, 90), b(250, 0, 91);
+    assert(within1(interpolateColor(a, b, ratio), legacyInterpolate(a, b, ratio)));
+  }
+
+  // Fade curves match the float envelopes for the configured durations
+  const unsigned long durations[] = {200, 3000, 7};
+  for (unsigned long d : durations)
+  {
+    for (unsigned long e = 0; e <= d + 10; ++e)
+    {
+      assert(within1(ColorMath::fadeInScale(e, d), legacyFadeIn(e, d)));
+      assert(within1(ColorMath::fadeOutScale(e, d), legacyFadeOut(e, d)));
+    }
+    assert(ColorMath::fadeInScale(d, d) == 255);
+    assert(ColorMath::fadeOutScale(d, d) == 0);
+    assert(ColorMath::fadeOutScale(0, d) == 255);
+  }
+
+  // Scalar helpers
+  assert(ColorMath::scale8(255, 255) == 255);
+  assert(ColorMath::scale8(255, 0) == 0);
+  assert(ColorMath::scale8(200, 127) == 100);
+  assert(ColorMath::qadd8(200, 100) == 255);
+  assert(ColorMath::qadd8(20, 100) == 120);
+  assert(ColorMath::saturate8(340) == 255);
+  assert(ColorMath::saturate8(-3) == 0);
+  assert(ColorMath::ratioQ16(1, 2) == 0x8000);
+  assert(ColorMath::ratioQ16(5, 2) == ColorMath::Q16_ONE);
+  assert(ColorMath::lerp8(0, 255, ColorMath::Q16_ONE) == 255);
+  static_assert(ColorMath::toQ8_8(1.5f) == 384, "Q8.8 conversion");
+  static_assert(ColorMath::toQ8_8(-0.25f) == -64, "Q8.8 conversion");
+
+  std::cout << "Color math golden tests passed (" << exact << "/" << pixels << " pixels bit-exact)\n";
+  return 0;
+}
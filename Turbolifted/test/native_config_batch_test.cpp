@@ -0,0 +1,68 @@
+// Batched /set requests: a batch is validated whole, bursts are merged and
+// applied at most once per interval, and each apply is one config change
+// as far as a frame can tell
+#include <cassert>
+#include <iostream>
+#include "config_batch.h"
+
+extern "C" unsigned long millis() { return 0; }
+
+int main()
+{
+  ConfigManager::begin();
+
+  // Arguments use the /config names; anything else, or a bad value, is refused
+  ConfigBatch batch;
+  assert(batch.empty());
+  assert(batch.set("hueMin", "20") && batch.set("satMax", "200") && batch.set("speed", "4"));
+  assert(!batch.set("hue", "20") && !batch.set("hueMax", "") && !batch.set("hueMax", "12x"));
+  assert(!batch.set("hueMax", "256") && !batch.set("hueMax", "-1"));
+  assert(batch.has(ConfigBatch::HUE_MIN) && !batch.has(ConfigBatch::HUE_MAX) && batch.get(ConfigBatch::SAT_MAX) == 200);
+
+  // Applying sets exactly the parameters present, as one snapshot sees them
+  ConfigSnapshot before = ConfigManager::snapshot();
+  batch.apply();
+  ConfigSnapshot after = ConfigManager::snapshot();
+  assert(after.hueMin == 20 && after.satMax == 200 && after.rotationSpeed == 4);
+  assert(after.hueMax == before.hueMax && after.maxBrightness == before.maxBrightness);
+  assert(after.colorVersion > before.version && after.brightnessVersion == before.brightnessVersion);
+
+  // Merging keeps earlier parameters and takes newer values
+  ConfigBatch newer;
+  newer.set("hueMin", "30");
+  newer.set("brightness", "100");
+  batch.merge(newer);
+  assert(batch.get(ConfigBatch::HUE_MIN) == 30 && batch.get(ConfigBatch::SAT_MAX) == 200 && batch.get(ConfigBatch::BRIGHTNESS) == 100);
+
+  // The first batch applies at once; a burst waits for the interval and lands merged
+  const unsigned long interval = TurboliftConfig::WiFi::CONFIG_APPLY_INTERVAL_MS;
+  ConfigCoalescer coalescer(interval);
+  assert(!coalescer.service(1000));
+  ConfigBatch step;
+  step.set("hueMax", "100");
+  coalescer.stage(step);
+  assert(coalescer.service(1000) && ConfigManager::getHueMax() == 100);
+  int applies = 0;
+  for (unsigned long t = 1001; t < 1000 + interval; t += 5)
+  {
+    ConfigBatch drag;
+    drag.set("hueMax", t % 2 ? "110" : "120");
+    drag.set("satMin", "50");
+    coalescer.stage(drag);
+    applies += coalescer.service(t);
+  }
+  assert(applies == 0 && coalescer.pending() && ConfigManager::getHueMax() == 100);
+  uint32_t version = ConfigManager::snapshot().version;
+  assert(coalescer.service(1000 + interval) && !coalescer.pending());
+  assert(ConfigManager::getHueMax() == 120 && ConfigManager::getSatMin() == 50);
+  assert(ConfigManager::snapshot().version == version + 2); // hueMax and satMin, nothing replayed
+
+  // flush() applies a staged batch inside the interval
+  step.set("hueMax", "130");
+  coalescer.stage(step);
+  coalescer.flush();
+  assert(!coalescer.pending() && ConfigManager::getHueMax() == 130);
+
+  std::cout << "Config batch tests passed" << std::endl;
+  return 0;
+}
@@ -0,0 +1,101 @@
+// Saved settings: the blob round-trips, anything damaged is ignored, and
+// changes reach flash once, after they settle
+#include <cassert>
+#include <cstring>
+#include <iostream>
+#include "config_store.h"
+
+extern "C" unsigned long millis() { return 0; }
+
+// In-memory flash that counts writes
+class MockConfigStorage : public IConfigStorage
+{
+public:
+  uint8_t data[64];
+  size_t length = 0;
+  int writes = 0;
+  bool failWrites = false;
+
+  size_t read(uint8_t *dst, size_t capacity) override
+  {
+    size_t n = length < capacity ? length : capacity;
+    memcpy(dst, data, n);
+    return n;
+  }
+  bool write(const uint8_t *src, size_t n) override
+  {
+    if (failWrites)
+      return false;
+    memcpy(data, src, n);
+    length = n;
+    writes++;
+    return true;
+  }
+};
+
+int main()
+{
+  // CRC-32 check value for "123456789"
+  assert(ConfigStore::crc32((const uint8_t *)"123456789", 9) == 0xCBF43926UL);
+
+  // Nothing stored: load fails and the defaults stay
+  ConfigManager::begin();
+  MockConfigStorage flash;
+  ConfigStore store(&flash, 5000);
+  assert(!store.load() && ConfigManager::getHueMin() == 160);
+
+  // A change is written once, only after it has been left alone for the delay
+  ConfigManager::setHueMin(20);
+  assert(!store.service(1000) && store.dirty());
+  ConfigManager::setSatMax(90); // Still dragging: the delay restarts
+  assert(!store.service(4000));
+  assert(!store.service(8999) && flash.writes == 0);
+  assert(store.service(9000) && flash.writes == 1 && !store.dirty());
+  assert(flash.length == ConfigStore::BLOB_SIZE);
+  assert(!store.service(20000) && flash.writes == 1);
+
+  // A change undone before the delay leaves flash alone
+  ConfigManager::setHueMax(10);
+  store.service(21000);
+  ConfigManager::setHueMax(200);
+  store.service(22000);
+  assert(!store.service(30000) && flash.writes == 1 && !store.dirty());
+
+  // A failed write is retried after another delay
+  ConfigManager::setLiftHue(77);
+  store.service(31000);
+  flash.failWrites = true;
+  assert(!store.service(36000) && store.dirty());
+  flash.failWrites = false;
+  assert(!store.service(40000) && store.service(41000) && flash.writes == 2);
+
+  // The next boot restores every parameter, without saving it straight back
+  ConfigSnapshot saved = ConfigManager::snapshot();
+  ConfigManager::begin();
+  ConfigStore booted(&flash, 5000);
+  assert(booted.load());
+  ConfigSnapshot restored = ConfigManager::snapshot();
+  assert(restored.hueMin == 20 && restored.satMax == 90 && restored.liftHue == 77);
+  uint8_t a[ConfigStore::BLOB_SIZE], b[ConfigStore::BLOB_SIZE];
+  ConfigStore::encode(saved, a);
+  ConfigStore::encode(restored, b);
+  assert(memcmp(a, b, sizeof(a)) == 0);
+  assert(!booted.service(50000) && !booted.service(60000) && flash.writes == 2);
+
+  // Damaged, truncated or older-format blobs are ignored
+  for (size_t i = 0; i < ConfigStore::BLOB_SIZE; ++i)
+  {
+    MockConfigStorage damaged = flash;
+    damaged.data[i] ^= 0x10;
+    ConfigManager::begin();
+    ConfigStore store2(&damaged, 5000);
+    assert(!store2.load() && ConfigManager::getHueMin() == 160);
+  }
+  MockConfigStorage truncated = flash;
+  truncated.length = ConfigStore::BLOB_SIZE - 1;
+  ConfigStore store3(&truncated, 5000);
+  assert(!store3.load());
+
+  std::cout << "Config store tests passed" << std::endl;
+  return 0;
+}
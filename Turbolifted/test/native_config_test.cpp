@@ -0,0 +1,71 @@
+// Config snapshots: each setter bumps only its parameter group's version,
+// and every effect sees a change however many consumers there are
+#include <cassert>
+#include <iostream>
+#include "mock_led_driver.h"
+#include "../src/turbolift_effect.h"
+
+static unsigned long simulated_time = 0;
+extern "C" unsigned long millis() { return simulated_time; }
+
+constexpr int N = TurboliftConfig::Hardware::NUM_LEDS;
+using Turbolift = TurboliftEffectTemplate<N, TurboliftConfig::Effects::GRADIENT_STEP_DEFAULT, TurboliftConfig::Effects::GRADIENT_MOVE_DEFAULT>;
+
+int main()
+{
+  // begin() marks every group changed
+  ConfigSnapshot before = ConfigManager::snapshot();
+  ConfigManager::begin();
+  ConfigSnapshot a = ConfigManager::snapshot();
+  assert(a.version > before.version);
+  assert(a.colorVersion == a.version && a.motionVersion == a.version && a.brightnessVersion == a.version &&
+         a.modeVersion == a.version && a.liftVersion == a.version);
+
+  // A snapshot is a copy: later changes do not reach it
+  ConfigManager::setHueMin(a.hueMin + 10);
+  assert(a.hueMin == ConfigManager::getHueMin() - 10);
+
+  // Only the changed group moves, to the new global version
+  ConfigSnapshot b = ConfigManager::snapshot();
+  assert(b.version == a.version + 1 && b.colorVersion == b.version);
+  assert(b.motionVersion == a.motionVersion && b.modeVersion == a.modeVersion && b.liftVersion == a.liftVersion);
+  ConfigManager::setRotationSpeed(b.rotationSpeed + 1);
+  ConfigManager::setMaxBrightness(b.maxBrightness - 1);
+  ConfigManager::setEffectMode(b.effectMode + 1);
+  ConfigManager::setLiftWidth(b.liftWidth + 1);
+  ConfigSnapshot c = ConfigManager::snapshot();
+  assert(c.motionVersion > b.version && c.brightnessVersion > c.motionVersion && c.modeVersion > c.brightnessVersion &&
+         c.liftVersion == c.version && c.colorVersion == b.colorVersion);
+
+  // Setting the current value, including after clamping, is not a change
+  ConfigManager::setSatMax(c.satMax);
+  ConfigManager::setLiftSpeed(200);
+  uint32_t clamped = ConfigManager::snapshot().version;
+  ConfigManager::setLiftSpeed(10);
+  ConfigManager::setRotationSpeed(c.rotationSpeed);
+  assert(ConfigManager::snapshot().version == clamped);
+
+  // Two effects both pick up one colour change; neither consumes it for the other
+  ConfigManager::setEffectMode((uint8_t)TurboliftConfig::Effects::EffectMode::CLASSIC);
+  static MockLEDDriver<N> mockA, mockB;
+  static Turbolift first(&mockA), second(&mockB);
+  simulated_time = 1;
+  first.begin();
+  second.begin();
+  first.start();
+  second.start();
+  CRGB firstColor = first.testClassicPattern().pointColor(1);
+  CRGB secondColor = second.testClassicPattern().pointColor(1);
+  ConfigManager::setHueMin(ConfigManager::getHueMin() + 60);
+  simulated_time += TurboliftConfig::Timing::RECOLOR_FADE_MS;
+  first.renderFrame(simulated_time);
+  second.renderFrame(simulated_time);
+  simulated_time += TurboliftConfig::Timing::RECOLOR_FADE_MS;
+  first.renderFrame(simulated_time);
+  second.renderFrame(simulated_time);
+  assert(first.testClassicPattern().pointColor(1) != firstColor);
+  assert(second.testClassicPattern().pointColor(1) != secondColor);
+
+  std::cout << "Config snapshot tests passed" << std::endl;
+  return 0;
+}
@@ -0,0 +1,171 @@
+// CueInputSource: cue and ack encoding, sequence numbers, acks, commands
+// through the input manager, and latency from receipt to dispatch and to
+// the first frame shown
+#include <cassert>
+#include <deque>
+#include <iostream>
+#include <vector>
+#include "cue_input.h"
+
+static unsigned long simulated_us = 5000000;
+extern "C" unsigned long millis() { return simulated_us / 1000; }
+extern "C" unsigned long micros() { return simulated_us; }
+
+using Packet = std::vector<uint8_t>;
+using Status = CueInputSource::Status;
+
+class MockCueLink : public ICueLink
+{
+public:
+  std::deque<Packet> queue;
+  std::vector<Packet> replies;
+  uint16_t port = 0;
+
+  bool begin(uint16_t p) override
+  {
+    port = p;
+    return true;
+  }
+  size_t receive(uint8_t *data, size_t length) override
+  {
+    if (queue.empty())
+      return 0;
+    Packet packet = queue.front();
+    queue.pop_front();
+    size_t n = packet.size() < length ? packet.size() : length;
+    memcpy(data, packet.data(), n);
+    return n;
+  }
+  bool reply(const uint8_t *data, size_t length) override
+  {
+    replies.push_back(Packet(data, data + length));
+    return true;
+  }
+};
+
+static Packet cue(InputManager::Command command, uint16_t sequence, bool ack = true)
+{
+  Packet p(CueInputSource::PACKET_SIZE);
+  uint8_t flags = ack ? CueInputSource::ACK_REQUESTED : 0;
+  CueInputSource::encode(CueInputSource::CUE, {(uint8_t)command, flags, sequence}, p.data());
+  return p;
+}
+
+// The status of the last ack, which must be for @p sequence
+static Status lastAck(const MockCueLink &link, uint16_t sequence)
+{
+  CueInputSource::Cue ack;
+  assert(!link.replies.empty());
+  const Packet &p = link.replies.back();
+  assert(CueInputSource::decode(p.data(), p.size(), CueInputSource::ACK, ack) && ack.sequence == sequence);
+  return (Status)ack.flags;
+}
+
+int main()
+{
+  // Encoding
+  {
+    Packet p = cue(InputManager::Command::FadeOut, 0x0102);
+    const uint8_t expected[] = {'C', 'U', 1, 1, 3, 1, 0x01, 0x02};
+    assert(p.size() == sizeof(expected) && memcmp(p.data(), expected, sizeof(expected)) == 0);
+    CueInputSource::Cue c;
+    assert(CueInputSource::decode(p.data(), p.size(), CueInputSource::CUE, c));
+    assert(c.command == 3 && c.flags == CueInputSource::ACK_REQUESTED && c.sequence == 0x0102);
+    assert(!CueInputSource::decode(p.data(), p.size(), CueInputSource::ACK, c));
+    assert(!CueInputSource::decode(p.data(), p.size() - 1, CueInputSource::CUE, c));
+  }
+
+  // Latency buckets
+  {
+    assert(LatencyHistogram::bucketOf(999) == 0 && LatencyHistogram::bucketOf(1000) == 1);
+    assert(LatencyHistogram::bucketOf(3999) == 2 && LatencyHistogram::bucketOf(4000) == 3);
+    assert(LatencyHistogram::bucketOf(4000000000u) == LatencyHistogram::BUCKETS - 1);
+    LatencyHistogram h;
+    assert(h.percentileMs(50) == 0 && h.meanUs() == 0);
+    for (int i = 0; i < 98; i++)
+      h.record(500);
+    h.record(5000);
+    h.record(300000);
+    assert(h.count() == 100 && h.bucket(0) == 98 && h.bucket(3) == 1 && h.bucket(LatencyHistogram::BUCKETS - 1) == 1);
+    assert(h.percentileMs(50) == 1 && h.percentileMs(99) == 8 && h.percentileMs(100) == 256);
+    assert(h.maxUs() == 300000 && h.meanUs() == (98 * 500 + 5000 + 300000) / 100);
+  }
+
+  MockCueLink link;
+  CueInputSource cues(&link);
+  assert(cues.begin() && link.port == 5572);
+  InputManager manager;
+  manager.addInputSource(&cues);
+  std::vector<InputManager::Command> run;
+  manager.setInputCallback([&](InputManager::Command command, const char *source)
+                           {
+                             assert(strcmp(source, "UdpCue") == 0);
+                             run.push_back(command); });
+
+  // A cue is acked on receipt and runs in the same pass
+  link.queue.push_back(cue(InputManager::Command::TriggerMalfunction, 7));
+  manager.update(millis());
+  assert(run.size() == 1 && run[0] == InputManager::Command::TriggerMalfunction);
+  assert(lastAck(link, 7) == Status::Queued && cues.stats().received == 1 && cues.stats().acks == 1);
+  assert(cues.dispatchLatency().count() == 1 && cues.showLatency().count() == 0);
+  assert(cues.takeFrameRequest() && !cues.takeFrameRequest());
+
+  // Shown by the next frame out
+  simulated_us += 12000;
+  cues.shown(micros());
+  assert(cues.showLatency().count() == 1 && cues.showLatency().maxUs() == 12000);
+  cues.shown(micros() + 1000); // Only the first frame counts
+  assert(cues.showLatency().count() == 1);
+
+  // Resends are acked but not run again; a sender far behind has restarted
+  link.queue.push_back(cue(InputManager::Command::TriggerMalfunction, 7));
+  link.queue.push_back(cue(InputManager::Command::FadeOut, 6, false));
+  manager.update(millis());
+  assert(run.size() == 1 && cues.stats().duplicates == 2 && lastAck(link, 7) == Status::Duplicate);
+  assert(link.replies.size() == 2); // The second asked for no ack
+  link.queue.push_back(cue(InputManager::Command::FadeOut, 8));
+  link.queue.push_back(cue(InputManager::Command::ToggleTurbolift, 65535 - 100));
+  manager.update(millis());
+  assert(run.size() == 3 && run[1] == InputManager::Command::FadeOut && run[2] == InputManager::Command::ToggleTurbolift);
+
+  // Wrapping past 65535 is forward
+  link.queue.push_back(cue(InputManager::Command::NextPreset, 3));
+  manager.update(millis());
+  assert(run.size() == 4 && lastAck(link, 3) == Status::Queued);
+
+  // Unknown commands and junk run nothing
+  link.queue.push_back(cue((InputManager::Command)9, 4));
+  link.queue.push_back(Packet{'C', 'U', 1, 1, 1, 0, 0});
+  manager.update(millis());
+  assert(run.size() == 4 && lastAck(link, 4) == Status::Unknown && cues.stats().invalid == 1);
+
+  // No frame follows: counted unshown, not as a long latency
+  cues.shown(micros());
+  uint32_t shownBefore = cues.showLatency().count();
+  link.queue.push_back(cue(InputManager::Command::FadeOut, 5));
+  manager.update(millis());
+  simulated_us += TurboliftConfig::Cues::SHOW_TIMEOUT_MS * 1000;
+  manager.update(millis());
+  cues.shown(micros());
+  assert(cues.stats().unshown == 1 && cues.showLatency().count() == shownBefore);
+
+  // A burst beyond the queue is refused while the input manager is away
+  for (int i = 0; i < TurboliftConfig::Cues::QUEUE + 2; i++)
+  {
+    link.queue.push_back(cue(InputManager::Command::ToggleTurbolift, (uint16_t)(10 + i)));
+    cues.update(millis());
+  }
+  assert(cues.stats().busy == 2 && lastAck(link, 10 + TurboliftConfig::Cues::QUEUE + 1) == Status::Busy);
+  size_t before = run.size();
+  manager.update(millis());
+  assert(run.size() == before + TurboliftConfig::Cues::QUEUE);
+  link.queue.push_back(cue(InputManager::Command::ToggleTurbolift, (uint16_t)(10 + TurboliftConfig::Cues::QUEUE)));
+  manager.update(millis()); // The refused cue's resend runs
+  assert(run.size() == before + TurboliftConfig::Cues::QUEUE + 1);
+
+  cues.resetLatency();
+  assert(cues.dispatchLatency().count() == 0 && cues.showLatency().count() == 0);
+
+  std::cout << "Cue input tests passed" << std::endl;
+  return 0;
+}
@@ -0,0 +1,102 @@
+// Unchanged frames must not be retransmitted: static scenes skip show()
+#include <cassert>
+#include <iostream>
+#include "mock_led_driver.h"
+#include "../src/turbolift_effect.h"
+
+static unsigned long simulated_time = 0;
+extern "C" unsigned long millis() { return simulated_time; }
+
+constexpr int N = TurboliftConfig::Hardware::NUM_LEDS;
+using Turbolift = TurboliftEffectTemplate<N, TurboliftConfig::Effects::GRADIENT_STEP_DEFAULT, TurboliftConfig::Effects::GRADIENT_MOVE_DEFAULT>;
+using EffectMode = TurboliftConfig::Effects::EffectMode;
+
+static MockLEDDriver<N> mock;
+
+// Advance by @p ticks update intervals; returns the number of frames transmitted
+static int runTicks(Turbolift &turbolift, int ticks)
+{
+  int before = mock.transmitCount;
+  for (int i = 0; i < ticks; ++i)
+  {
+    simulated_time += TurboliftConfig::Timing::UPDATE_INTERVAL_MS;
+    turbolift.update(simulated_time);
+  }
+  return mock.transmitCount - before;
+}
+
+// Start @p mode from scratch and run it past the fade-in
+static void startMode(Turbolift &turbolift, EffectMode mode)
+{
+  const int fadeTicks = TurboliftConfig::Timing::FADE_IN_DURATION_MS / TurboliftConfig::Timing::UPDATE_INTERVAL_MS;
+  ConfigManager::setEffectMode((uint8_t)mode);
+  simulated_time = 1;
+  turbolift.begin();
+  turbolift.start();
+  int sent = runTicks(turbolift, fadeTicks + 10);
+  assert(sent > 0 && sent <= fadeTicks + 10);
+}
+
+int main()
+{
+  ConfigManager::begin();
+  ConfigManager::setRotationSpeed(0);
+  ConfigManager::setLiftSpeed(0);
+
+  // Static gradients and a held single colour transmit nothing
+  for (EffectMode mode : {EffectMode::CLASSIC, EffectMode::VIRTUAL_GRADIENT, EffectMode::SINGLE_COLOR})
+  {
+    Turbolift turbolift(&mock);
+    startMode(turbolift, mode);
+    assert(runTicks(turbolift, 200) == 0);
+  }
+
+  // Fades ramp only the output brightness; the pixels are rendered once
+  {
+    Turbolift turbolift(&mock);
+    ConfigManager::setEffectMode((uint8_t)EffectMode::CLASSIC);
+    simulated_time = 1;
+    turbolift.begin();
+    turbolift.start();
+    runTicks(turbolift, 1);
+    static CRGB firstFrame[N];
+    for (int i = 0; i < N; ++i)
+      firstFrame[i] = mock.buffer[i];
+    assert(mock.brightness < ConfigManager::getMaxBrightness());
+    runTicks(turbolift, TurboliftConfig::Timing::FADE_IN_DURATION_MS / TurboliftConfig::Timing::UPDATE_INTERVAL_MS + 10);
+    assert(mock.brightness == ConfigManager::getMaxBrightness());
+    for (int i = 0; i < N; ++i)
+      assert(mock.buffer[i] == firstFrame[i]);
+  }
+
+  // Single colour: a new colour transmits only while the blend is moving
+  {
+    Turbolift turbolift(&mock);
+    startMode(turbolift, EffectMode::SINGLE_COLOR);
+    ConfigManager::setLiftHue(ConfigManager::getLiftHue() + 40);
+    int sent = runTicks(turbolift, 100);
+    assert(sent > 0 && sent <= (int)(TurboliftConfig::Timing::LIFT_COLOR_FADE_MS / TurboliftConfig::Timing::UPDATE_INTERVAL_MS) + 1);
+    assert(runTicks(turbolift, 100) == 0);
+  }
+
+  // Lift beams glide between LEDs even at speed 0, so every tick is a new frame
+  {
+    Turbolift turbolift(&mock);
+    startMode(turbolift, EffectMode::LIFT_ANIMATION);
+    assert(runTicks(turbolift, 50) == 50);
+  }
+
+  // A moving gradient transmits every tick, malfunction replaces it rather than adding a second frame
+  {
+    Turbolift turbolift(&mock);
+    ConfigManager::setRotationSpeed(2);
+    startMode(turbolift, EffectMode::CLASSIC);
+    assert(runTicks(turbolift, 50) == 50);
+    turbolift.triggerMalfunction();
+    assert(runTicks(turbolift, 50) <= 50);
+    ConfigManager::setRotationSpeed(0);
+  }
+
+  std::cout << "Frame skip tests passed" << std::endl;
+  return 0;
+}
@@ -0,0 +1,133 @@
+// Pattern generation runs in the background: the next start() pattern is
+// built a few driver points per step and swapped in whole, and colour
+// changes crossfade the existing drivers instead of regenerating them
+#include <cassert>
+#include <cstring>
+#include <iostream>
+#include "mock_led_driver.h"
+#include "../src/turbolift_effect.h"
+
+static unsigned long simulated_time = 0;
+extern "C" unsigned long millis() { return simulated_time; }
+
+constexpr int N = TurboliftConfig::Hardware::NUM_LEDS;
+using Turbolift = TurboliftEffectTemplate<N, TurboliftConfig::Effects::GRADIENT_STEP_DEFAULT, TurboliftConfig::Effects::GRADIENT_MOVE_DEFAULT>;
+using EffectMode = TurboliftConfig::Effects::EffectMode;
+
+static MockLEDDriver<N> mock;
+
+static bool samePattern(const CRGB *a, const CRGB *b)
+{
+  for (int i = 0; i < N; ++i)
+    if (!(a[i] == b[i]))
+      return false;
+  return true;
+}
+
+static void renderTick(Turbolift &turbolift)
+{
+  simulated_time += TurboliftConfig::Timing::UPDATE_INTERVAL_MS;
+  turbolift.renderFrame(simulated_time);
+}
+
+int main()
+{
+  ConfigManager::begin();
+  ConfigManager::setRotationSpeed(0); // Offset 0: the strip shows the front pattern as is
+  ConfigManager::setEffectMode((uint8_t)EffectMode::CLASSIC);
+  simulated_time = 1;
+  static Turbolift turbolift(&mock);
+  static CRGB shown[N], prepared[N];
+
+  // begin() pre-generates both patterns
+  turbolift.begin();
+  assert(turbolift.testIsSequenceInitialized());
+  memcpy(shown, turbolift.testGetEffectLeds(), sizeof(shown));
+
+  // The next classic pattern is built over several steps
+  int steps = 1;
+  while (turbolift.serviceGeneration())
+    steps++;
+  assert(steps > 2 && turbolift.testClassicBackReady());
+  memcpy(prepared, turbolift.testGetEffectLeds(true), sizeof(prepared));
+  assert(!samePattern(shown, prepared));
+
+  // start() shows the prepared pattern straight away
+  turbolift.start();
+  assert(samePattern(turbolift.testGetEffectLeds(), prepared) && !turbolift.testClassicBackReady());
+  renderTick(turbolift);
+  assert(samePattern(mock.buffer, prepared));
+  while (turbolift.serviceGeneration())
+    ;
+
+  // Mode and lift changes keep the pattern and leave nothing to build
+  ConfigManager::setEffectMode((uint8_t)EffectMode::VIRTUAL_GRADIENT);
+  ConfigManager::setLiftHue(ConfigManager::getLiftHue() + 1);
+  ConfigManager::setEffectMode((uint8_t)EffectMode::CLASSIC);
+  assert(!turbolift.serviceGeneration());
+  assert(samePattern(turbolift.testGetEffectLeds(), prepared));
+
+  // A hue change keeps every driver and crossfades its colour to a new one
+  const int fadeTicks = TurboliftConfig::Timing::RECOLOR_FADE_MS / TurboliftConfig::Timing::UPDATE_INTERVAL_MS;
+  constexpr int MAX_POINTS = TurboliftConfig::Effects::MAX_DRIVER_POINTS;
+  static uint16_t positions[MAX_POINTS];
+  static CRGB before[MAX_POINTS], midway[MAX_POINTS];
+  const auto &classic = turbolift.testClassicPattern();
+  int count = classic.pointCount();
+  for (int i = 0; i < count; ++i)
+  {
+    positions[i] = classic.pointPosition(i);
+    before[i] = classic.pointColor(i);
+  }
+  ConfigManager::setHueMin(ConfigManager::getHueMin() + 40);
+  for (int i = 0; i < fadeTicks / 2; ++i)
+    renderTick(turbolift);
+  for (int i = 0; i < count; ++i)
+    midway[i] = classic.pointColor(i);
+  for (int i = 0; i <= fadeTicks / 2 + 1; ++i)
+    renderTick(turbolift);
+  assert(classic.pointCount() == count);
+  int blended = 0;
+  for (int i = 0; i < count; ++i)
+  {
+    assert(classic.pointPosition(i) == positions[i]);
+    if (!(midway[i] == before[i]) && !(midway[i] == classic.pointColor(i)))
+      blended++;
+  }
+  assert(blended > count / 2);
+  assert(samePattern(mock.buffer, turbolift.testGetEffectLeds()));
+
+  // Once faded, the colours hold still
+  memcpy(shown, mock.buffer, sizeof(shown));
+  for (int i = 0; i < 10; ++i)
+    renderTick(turbolift);
+  assert(samePattern(mock.buffer, shown));
+
+  // Virtual sequences keep their positions and black breaks too
+  ConfigManager::setEffectMode((uint8_t)EffectMode::VIRTUAL_GRADIENT);
+  while (turbolift.serviceGeneration())
+    ;
+  const auto &sequence = turbolift.testSequencePattern(1);
+  count = sequence.pointCount();
+  for (int i = 0; i < count; ++i)
+  {
+    positions[i] = sequence.pointPosition(i);
+    before[i] = sequence.pointColor(i);
+  }
+  ConfigManager::setHueMin(ConfigManager::getHueMin() + 40);
+  for (int i = 0; i <= fadeTicks + 1; ++i)
+    renderTick(turbolift);
+  int recoloured = 0;
+  for (int i = 0; i < count; ++i)
+  {
+    assert(sequence.pointPosition(i) == positions[i]);
+    if (i % 3 != 0)
+      assert(sequence.pointColor(i) == CRGB(0, 0, 0));
+    else if (!(sequence.pointColor(i) == before[i]))
+      recoloured++;
+  }
+  assert(recoloured > count / 6);
+
+  std::cout << "Generation tests passed" << std::endl;
+  return 0;
+}
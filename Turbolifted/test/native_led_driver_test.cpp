@@ -0,0 +1,101 @@
+#include <cassert>
+#include <iostream>
+#include "mock_led_driver.h"
+
+static bool same(const CRGB &a, const CRGB &b) { return a.r == b.r && a.g == b.g && a.b == b.b; }
+
+int main()
+{
+  const int N = 40;
+  const int RING = 37;
+  CRGB ring[RING];
+  for (int i = 0; i < RING; ++i)
+    ring[i] = CRGB((uint8_t)(i * 7), (uint8_t)(200 - i), (uint8_t)(i * 3 + 100));
+
+  MockLEDDriver<N> mock;
+
+  // blitRotated matches the per-pixel modulo reference for every offset
+  for (int offset = -RING; offset <= 2 * RING; ++offset)
+  {
+    mock.clear();
+    mock.blitRotated(ring, RING, offset);
+    int wrapped = ((offset % RING) + RING) % RING;
+    for (int i = 0; i < RING; ++i)
+      assert(same(mock.buffer[i], ring[(i + wrapped) % RING]));
+    for (int i = RING; i < N; ++i)
+      assert(same(mock.buffer[i], CRGB()));
+  }
+
+  // addRotated saturates like FastLED's CRGB::operator+=
+  for (int offset = 0; offset < RING; ++offset)
+  {
+    mock.fillSolid(CRGB(100, 100, 100));
+    mock.addRotated(ring, RING, offset);
+    for (int i = 0; i < RING; ++i)
+    {
+      const CRGB &src = ring[(i + offset) % RING];
+      assert(mock.buffer[i].r == (src.r + 100 > 255 ? 255 : src.r + 100));
+      assert(mock.buffer[i].g == (src.g + 100 > 255 ? 255 : src.g + 100));
+      assert(mock.buffer[i].b == (src.b + 100 > 255 ? 255 : src.b + 100));
+    }
+  }
+
+  // A ring longer than the strip is truncated to the strip
+  MockLEDDriver<16> small;
+  small.blitRotated(ring, RING, 30);
+  for (int i = 0; i < 16; ++i)
+    assert(same(small.buffer[i], ring[(i + 30) % RING]));
+
+  // writeSpan and scaleSpan clip to the buffer
+  mock.clear();
+  mock.writeSpan(-3, ring, 10);
+  for (int i = 0; i < 7; ++i)
+    assert(same(mock.buffer[i], ring[i + 3]));
+  assert(same(mock.buffer[7], CRGB()));
+  mock.writeSpan(N - 2, ring, 10);
+  assert(same(mock.buffer[N - 1], ring[1]));
+
+  mock.fillSolid(CRGB(200, 100, 50));
+  mock.scaleSpan(N - 5, 10, 128);
+  assert(same(mock.buffer[N - 6], CRGB(200, 100, 50)));
+  CRGB expected(200, 100, 50);
+  expected.nscale8(128);
+  for (int i = N - 5; i < N; ++i)
+    assert(same(mock.buffer[i], expected));
+
+  // Whole-pixel sub-pixel offsets are exactly blitRotated / addRotated
+  MockLEDDriver<N> reference;
+  for (int offset = 0; offset < RING; ++offset)
+  {
+    mock.clear();
+    reference.clear();
+    mock.blitRotatedSubpixel(ring, RING, (uint32_t)offset << 8);
+    reference.blitRotated(ring, RING, offset);
+    mock.addRotatedSubpixel(ring, RING, (uint32_t)(RING - offset) << 8);
+    reference.addRotated(ring, RING, RING - offset);
+    for (int i = 0; i < N; ++i)
+      assert(same(mock.buffer[i], reference.buffer[i]));
+  }
+
+  // Fractional offsets blend each pixel with its wrapped neighbour
+  for (uint32_t offsetQ8 : {1u, 128u, 255u, (uint32_t)(RING - 1) * 256 + 64})
+  {
+    mock.clear();
+    mock.blitRotatedSubpixel(ring, RING, offsetQ8);
+    int whole = (int)(offsetQ8 >> 8);
+    uint8_t frac = (uint8_t)(offsetQ8 & 0xFF);
+    for (int i = 0; i < RING; ++i)
+    {
+      const CRGB &a = ring[(i + whole) % RING];
+      const CRGB &b = ring[(i + whole + 1) % RING];
+      assert(mock.buffer[i].r == (a.r * 256 + ((int)b.r - a.r) * frac) / 256);
+      assert(mock.buffer[i].g == (a.g * 256 + ((int)b.g - a.g) * frac) / 256);
+      assert(mock.buffer[i].b == (a.b * 256 + ((int)b.b - a.b) * frac) / 256);
+    }
+  }
+  assert(lerpChannel(10, 20, 0) == 10 && lerpChannel(10, 20, 128) == 15 && lerpChannel(20, 10, 128) == 15);
+  assert(lerpChannel(0, 255, 255) == 254 && lerpChannel(255, 0, 255) == 0);
+
+  std::cout << "LED driver span tests passed\n";
+  return 0;
+}
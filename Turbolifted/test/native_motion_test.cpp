@@ -0,0 +1,115 @@
+#include <cassert>
+#include <iostream>
+#include "mock_led_driver.h"
+#include "motion.h"
+#include "../src/turbolift_effect.h"
+
+static unsigned long simulated_time = 0;
+extern "C" unsigned long millis() { return simulated_time; }
+
+constexpr int N = TurboliftConfig::Hardware::NUM_LEDS;
+using Turbolift = TurboliftEffectTemplate<N, TurboliftConfig::Effects::GRADIENT_STEP_DEFAULT, TurboliftConfig::Effects::GRADIENT_MOVE_DEFAULT>;
+
+// Render mode for durationMs at a fixed frame interval, leaving the last frame in driver
+static void renderAt(MockLEDDriver<N> &driver, uint8_t mode, unsigned long frameMs, unsigned long durationMs)
+{
+  srand(1);
+  Turbolift turbolift(&driver);
+  ConfigManager::setEffectMode(mode);
+  simulated_time = 1;
+  turbolift.begin();
+  turbolift.start();
+  // First frame at a common time: gradient generation seeds from millis()
+  turbolift.renderFrame(simulated_time);
+  unsigned long end = simulated_time + durationMs;
+  while (simulated_time < end)
+  {
+    simulated_time += frameMs;
+    turbolift.renderFrame(simulated_time);
+  }
+}
+
+int main()
+{
+  const unsigned long tick = TurboliftConfig::Timing::MOTION_TICK_MS;
+
+  // One position per tick is exactly 256 Q8 units per tick
+  RingMotion ring(100);
+  ring.advance(1, tick, tick);
+  assert(ring.positionQ8() == 256 && ring.whole() == 1 && ring.fraction() == 0);
+
+  // Distance is independent of how time is split into frames, including odd periods
+  RingMotion coarse(N), fine(N);
+  for (int i = 0; i < 30; ++i)
+    coarse.advance(3, 70, tick);
+  for (int i = 0; i < 2100; ++i)
+    fine.advance(3, 1, tick);
+  assert(coarse.positionQ8() == fine.positionQ8());
+  assert(coarse.positionQ8() == (3UL * 2100UL * 256UL / tick) % ((uint32_t)N << 8));
+
+  // Fractional steps accumulate between pixels instead of rounding away
+  RingMotion slow(N);
+  slow.advance(1, 5, tick);
+  assert(slow.whole() == 0 && slow.fraction() == 256 * 5 / tick);
+
+  // Backwards motion wraps below zero, and a full lap returns to the start
+  RingMotion back(10);
+  back.advance(-1, tick, tick);
+  assert(back.whole() == 9 && back.fraction() == 0);
+  back.advance(-10, tick, tick);
+  assert(back.whole() == 9);
+
+  // Speed 0 never moves
+  RingMotion still(N);
+  still.advance(0, 1000, tick);
+  assert(still.positionQ8() == 0);
+
+  // Whole effects: the frame at a given time does not depend on the frame rate
+  ConfigManager::begin();
+  ConfigManager::setRotationSpeed(3);
+  const unsigned long duration = TurboliftConfig::Timing::FADE_IN_DURATION_MS + 1000;
+  for (uint8_t mode : {(uint8_t)TurboliftConfig::Effects::EffectMode::CLASSIC,
+                       (uint8_t)TurboliftConfig::Effects::EffectMode::VIRTUAL_GRADIENT,
+                       (uint8_t)TurboliftConfig::Effects::EffectMode::LIFT_ANIMATION})
+  {
+    static MockLEDDriver<N> fast, slowDriver;
+    renderAt(fast, mode, 10, duration);
+    renderAt(slowDriver, mode, 40, duration);
+    for (int i = 0; i < N; ++i)
+      assert(fast.buffer[i] == slowDriver.buffer[i]);
+    assert(fast.brightness == slowDriver.brightness);
+  }
+
+  // Single colour: a new lift colour is as far through its blend at any frame rate
+  {
+    static MockLEDDriver<N> fast, slowDriver;
+    const uint8_t hue = ConfigManager::getLiftHue();
+    const unsigned long shown = TurboliftConfig::Timing::FADE_IN_DURATION_MS + 200;
+    const unsigned long halfBlend = TurboliftConfig::Timing::LIFT_COLOR_FADE_MS / 2;
+    CRGB before;
+    for (MockLEDDriver<N> *driver : {&fast, &slowDriver})
+    {
+      const unsigned long frameMs = driver == &fast ? 10 : 50;
+      ConfigManager::setLiftHue(hue);
+      ConfigManager::setEffectMode((uint8_t)TurboliftConfig::Effects::EffectMode::SINGLE_COLOR);
+      Turbolift turbolift(driver);
+      simulated_time = 1;
+      turbolift.begin();
+      turbolift.start();
+      for (unsigned long t = 0; t <= shown; t += frameMs)
+        turbolift.renderFrame(simulated_time = 1 + t);
+      before = driver->buffer[0];
+      // Both rates see the change on a frame at the same moment
+      ConfigManager::setLiftHue(hue + 80);
+      for (unsigned long t = 0; t <= halfBlend; t += frameMs)
+        turbolift.renderFrame(simulated_time = 1 + shown + t);
+    }
+    CRGB target = CHSV(hue + 80, ConfigManager::getLiftSaturation(), ConfigManager::getLiftBrightness());
+    assert(fast.buffer[0] == slowDriver.buffer[0]);
+    assert(fast.buffer[0] != before && fast.buffer[0] != target);
+    ConfigManager::setLiftHue(hue);
+  }
+
+  std::cout << "Motion tests passed" << std::endl;
+  return 0;
+}
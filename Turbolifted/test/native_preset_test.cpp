@@ -0,0 +1,238 @@
+// Scene presets: a recalled preset brings back its settings and the exact
+// patterns saved with it, without regenerating or recolouring them
+#include <cassert>
+#include <cstring>
+#include <iostream>
+#include <vector>
+#include "mock_led_driver.h"
+#include "../src/turbolift_effect.h"
+
+static unsigned long simulated_time = 0;
+extern "C" unsigned long millis() { return simulated_time; }
+
+constexpr int N = TurboliftConfig::Hardware::NUM_LEDS;
+using Turbolift = TurboliftEffectTemplate<N, TurboliftConfig::Effects::GRADIENT_STEP_DEFAULT, TurboliftConfig::Effects::GRADIENT_MOVE_DEFAULT>;
+using EffectMode = TurboliftConfig::Effects::EffectMode;
+
+// In-memory slots; a write lands only on commit(), as with LittleFS
+class MockPresetStorage : public IPresetStorage
+{
+public:
+  std::vector<uint8_t> slots[PresetStore::SLOTS];
+  bool present[PresetStore::SLOTS] = {};
+  size_t largestRead = 0;
+  bool failWrites = false;
+
+  bool openRead(int slot) override
+  {
+    if (!present[slot])
+      return false;
+    reading = &slots[slot];
+    pos = 0;
+    return true;
+  }
+  bool openWrite(int slot) override
+  {
+    pending.clear();
+    writing = slot;
+    return true;
+  }
+  size_t read(uint8_t *data, size_t length) override
+  {
+    largestRead = length > largestRead ? length : largestRead;
+    size_t n = reading ? std::min(length, reading->size() - pos) : 0;
+    memcpy(data, reading->data() + pos, n);
+    pos += n;
+    return n;
+  }
+  bool write(const uint8_t *data, size_t length) override
+  {
+    if (failWrites || writing < 0)
+      return false;
+    pending.insert(pending.end(), data, data + length);
+    return true;
+  }
+  bool commit() override
+  {
+    if (writing < 0)
+      return false;
+    slots[writing] = pending;
+    present[writing] = true;
+    writing = -1;
+    return true;
+  }
+  void close() override
+  {
+    reading = nullptr;
+    writing = -1;
+  }
+  bool remove(int slot) override
+  {
+    bool was = present[slot];
+    present[slot] = false;
+    return was;
+  }
+
+private:
+  std::vector<uint8_t> *reading = nullptr;
+  size_t pos = 0;
+  std::vector<uint8_t> pending;
+  int writing = -1;
+};
+
+static MockLEDDriver<N> mock;
+
+// Set the position of a slot's first-pattern point, resealing the CRC so
+// only the position check can reject it
+static void setPosition(std::vector<uint8_t> &slot, int point, uint16_t pos)
+{
+  size_t at = PresetStore::HEADER_SIZE + ConfigStore::BLOB_SIZE + 2 + point * PresetReader::POINT_SIZE;
+  slot[at] = (uint8_t)pos;
+  slot[at + 1] = (uint8_t)(pos >> 8);
+  uint32_t crc = ConfigStore::crc32(slot.data(), slot.size() - 4, 0);
+  for (int i = 0; i < 4; i++)
+    slot[slot.size() - 4 + i] = (uint8_t)(crc >> (8 * i));
+}
+
+static bool samePattern(const CRGB *a, const CRGB *b)
+{
+  for (int i = 0; i < N; ++i)
+    if (!(a[i] == b[i]))
+      return false;
+  return true;
+}
+
+int main()
+{
+  ConfigManager::begin();
+  ConfigManager::setRotationSpeed(0); // Offset 0: the strip shows the front pattern as is
+  ConfigManager::setEffectMode((uint8_t)EffectMode::CLASSIC);
+  simulated_time = 1;
+  static Turbolift turbolift(&mock);
+  turbolift.begin();
+  MockPresetStorage flash;
+  PresetStore presets(&flash, &turbolift);
+  static CRGB classic[N], sequence1[N], sequence2[N];
+
+  // Names are checked before anything is written
+  assert(!presets.save(0, "") && !presets.save(0, "much too long a name") && !presets.save(0, "say \"hi\""));
+  assert(!presets.save(PresetStore::SLOTS, "Bridge") && !flash.present[0]);
+
+  // Save a look, settings and patterns
+  ConfigManager::setHueMin(20);
+  ConfigManager::setHueMax(60);
+  ConfigManager::setRotationSpeed(4);
+  while (turbolift.serviceGeneration())
+    ; // Colour change applied to the shown patterns
+  turbolift.start();
+  simulated_time += 1000;
+  turbolift.renderFrame(simulated_time); // Recolour crossfade finished
+  memcpy(classic, turbolift.testGetEffectLeds(), sizeof(classic));
+  memcpy(sequence1, turbolift.testGetSequence1(), sizeof(sequence1));
+  memcpy(sequence2, turbolift.testGetSequence2(), sizeof(sequence2));
+  assert(presets.save(2, "Bridge"));
+  assert(presets.save(5, "Settings only", false));
+  assert(flash.slots[5].size() < flash.slots[2].size());
+  char name[PresetStore::NAME_LENGTH + 1];
+  assert(presets.readName(2, name) && strcmp(name, "Bridge") == 0 && !presets.readName(3, name));
+
+  // Move away: new settings, new patterns
+  ConfigManager::setHueMin(150);
+  ConfigManager::setHueMax(200);
+  ConfigManager::setRotationSpeed(9);
+  ConfigManager::setEffectMode((uint8_t)EffectMode::VIRTUAL_GRADIENT);
+  turbolift.stop();
+  while (turbolift.serviceGeneration())
+    ;
+  turbolift.start();
+  turbolift.testGenerateVirtualGradients();
+  assert(!samePattern(turbolift.testGetEffectLeds(), classic));
+
+  // Recall: settings and patterns come back at once, streamed in chunks
+  uint32_t before = ConfigManager::snapshot().version;
+  assert(presets.recall(2) && presets.current() == 2);
+  assert(flash.largestRead <= (size_t)TurboliftConfig::Presets::STREAM_CHUNK);
+  ConfigSnapshot config = ConfigManager::snapshot();
+  assert(config.version != before);
+  assert(config.hueMin == 20 && config.hueMax == 60 && config.rotationSpeed == 4);
+  assert(config.effectMode == (uint8_t)EffectMode::CLASSIC);
+  assert(samePattern(turbolift.testGetEffectLeds(), classic));
+  assert(samePattern(turbolift.testGetSequence1(), sequence1));
+  assert(samePattern(turbolift.testGetSequence2(), sequence2));
+
+  // ...and are not recoloured or replaced by the work that follows
+  ConfigManager::setRotationSpeed(0);
+  for (int i = 0; i < 50; ++i)
+  {
+    simulated_time += TurboliftConfig::Timing::UPDATE_INTERVAL_MS;
+    turbolift.renderFrame(simulated_time);
+    turbolift.serviceGeneration();
+  }
+  assert(samePattern(turbolift.testGetEffectLeds(), classic));
+  assert(samePattern(mock.buffer, classic) && turbolift.testClassicBackReady());
+  assert(samePattern(turbolift.testGetSequence1(), sequence1));
+
+  // A stopped effect starts on the recalled pattern, then on new ones again
+  turbolift.stop();
+  turbolift.start();
+  assert(samePattern(turbolift.testGetEffectLeds(), classic));
+  turbolift.stop();
+  turbolift.start();
+  assert(!samePattern(turbolift.testGetEffectLeds(), classic));
+
+  // A settings-only preset keeps the patterns and recolours them as usual
+  ConfigManager::setHueMin(100);
+  while (turbolift.serviceGeneration())
+    ;
+  memcpy(classic, turbolift.testGetEffectLeds(), sizeof(classic));
+  assert(presets.recall(5) && ConfigManager::getHueMin() == 20);
+  assert(samePattern(turbolift.testGetEffectLeds(), classic));
+  turbolift.serviceGeneration();
+  simulated_time += 1000;
+  turbolift.renderFrame(simulated_time);
+  assert(!samePattern(turbolift.testGetEffectLeds(), classic));
+
+  // recallNext() cycles through the stored slots only
+  assert(presets.recallNext() == 2 && presets.recallNext() == 5 && presets.recallNext() == 2);
+
+  // A damaged preset changes nothing, wherever the damage is
+  ConfigManager::setHueMin(99);
+  uint32_t unchanged = ConfigManager::snapshot().version;
+  memcpy(classic, turbolift.testGetEffectLeds(), sizeof(classic));
+  for (size_t i = 0; i < flash.slots[2].size(); i += 7)
+  {
+    MockPresetStorage damaged = flash;
+    damaged.slots[2][i] ^= 0x04;
+    PresetStore store(&damaged, &turbolift);
+    assert(!store.recall(2));
+  }
+  // So does one whose points the rings would refuse, though its CRC is good
+  for (int bad = 0; bad < 3; bad++)
+  {
+    MockPresetStorage misplaced = flash;
+    if (bad == 0)
+      setPosition(misplaced.slots[2], 0, 1); // First point not at 0
+    else if (bad == 1)
+      setPosition(misplaced.slots[2], 1, 0); // Not increasing
+    else
+      setPosition(misplaced.slots[2], 1, N); // Off the ring
+    PresetStore store(&misplaced, &turbolift);
+    assert(!store.recall(2));
+  }
+  MockPresetStorage truncated = flash;
+  truncated.slots[2].pop_back();
+  PresetStore store(&truncated, &turbolift);
+  assert(!store.recall(2) && !store.recall(3));
+  assert(ConfigManager::snapshot().version == unchanged && samePattern(turbolift.testGetEffectLeds(), classic));
+  assert(store.recallNext() == 5);
+  assert(presets.remove(5) && !presets.recall(5));
+
+  // A failed write keeps the slot's previous preset
+  flash.failWrites = true;
+  assert(!presets.save(2, "Broken"));
+  flash.failWrites = false;
+  assert(presets.readName(2, name) && strcmp(name, "Bridge") == 0 && presets.recall(2));
+
+  std::cout << "Preset tests passed" << std::endl;
+  return 0;
+}
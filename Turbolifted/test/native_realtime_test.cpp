@@ -0,0 +1,227 @@
+// RealtimeInputSource: E1.31 and Art-Net parsing, universes written into
+// the LED buffer, sequence numbers, whole frames, and the realtime effect
+#include <cassert>
+#include <cstring>
+#include <deque>
+#include <iostream>
+#include <vector>
+#include "mock_led_driver.h"
+#include "../src/turbolift_effect.h"
+
+static unsigned long simulated_time = 0;
+extern "C" unsigned long millis() { return simulated_time; }
+
+constexpr int N = TurboliftConfig::Hardware::NUM_LEDS;
+using Turbolift = TurboliftEffectTemplate<N, TurboliftConfig::Effects::GRADIENT_STEP_DEFAULT, TurboliftConfig::Effects::GRADIENT_MOVE_DEFAULT>;
+using EffectMode = TurboliftConfig::Effects::EffectMode;
+using Packet = std::vector<uint8_t>;
+
+// Scripted receiver: queued datagrams, consumed by take()
+class MockUdpReceiver : public IUdpReceiver
+{
+public:
+  std::deque<Packet> queue;
+  uint16_t port = 0;
+
+  bool begin(uint16_t p) override
+  {
+    port = p;
+    return true;
+  }
+  size_t peek(uint8_t *header, size_t length) override
+  {
+    if (queue.empty())
+      return 0;
+    size_t n = length < queue.front().size() ? length : queue.front().size();
+    memcpy(header, queue.front().data(), n);
+    return n;
+  }
+  size_t take(size_t skip, uint8_t *data, size_t length) override
+  {
+    Packet packet = queue.front();
+    queue.pop_front();
+    if (!data || skip >= packet.size())
+      return 0;
+    size_t n = packet.size() - skip < length ? packet.size() - skip : length;
+    memcpy(data, packet.data() + skip, n);
+    return n;
+  }
+};
+
+// Channels of universe @p u: every pixel (u, 2u, 3u)
+static Packet channels(int u, size_t count = RealtimeInputSource::UNIVERSE_CHANNELS)
+{
+  Packet data(count);
+  for (size_t i = 0; i < count; i++)
+    data[i] = (uint8_t)(u * (i % 3 + 1));
+  return data;
+}
+
+static Packet e131(uint16_t universe, uint8_t sequence, const Packet &data, uint8_t options = 0)
+{
+  static const uint8_t ACN_ID[12] = {'A', 'S', 'C', '-', 'E', '1', '.', '1', '7', 0, 0, 0};
+  Packet p(RealtimeInputSource::E131_HEADER, 0);
+  p[1] = 0x10;
+  memcpy(&p[4], ACN_ID, sizeof(ACN_ID));
+  p[21] = 0x04;  // VECTOR_ROOT_E131_DATA
+  p[43] = 0x02;  // VECTOR_E131_DATA_PACKET
+  p[108] = 100;  // Priority
+  p[111] = sequence;
+  p[112] = options;
+  p[113] = (uint8_t)(universe >> 8);
+  p[114] = (uint8_t)universe;
+  p[117] = 0x02; // VECTOR_DMP_SET_PROPERTY
+  p[118] = 0xa1;
+  p[122] = 1;
+  p[123] = (uint8_t)((data.size() + 1) >> 8);
+  p[124] = (uint8_t)(data.size() + 1);
+  p.insert(p.end(), data.begin(), data.end());
+  return p;
+}
+
+static Packet artnet(uint16_t universe, uint8_t sequence, const Packet &data)
+{
+  Packet p = {'A', 'r', 't', '-', 'N', 'e', 't', 0, 0x00, 0x50, 0, 14, sequence, 0,
+              (uint8_t)universe, (uint8_t)(universe >> 8), (uint8_t)(data.size() >> 8), (uint8_t)data.size()};
+  p.insert(p.end(), data.begin(), data.end());
+  return p;
+}
+
+static bool pixelIs(const CRGB &pixel, int u) { return pixel.r == u && pixel.g == 2 * u && pixel.b == 3 * u; }
+
+int main()
+{
+  ConfigManager::begin();
+
+  // Headers: what is DMX, where the channels are
+  {
+    RealtimeInputSource::DmxPacket packet;
+    Packet p = e131(3, 42, channels(3, 12));
+    assert(RealtimeInputSource::parseE131(p.data(), p.size(), packet));
+    assert(packet.universe == 3 && packet.sequence == 42 && packet.sequenced);
+    assert(packet.dataOffset == RealtimeInputSource::E131_HEADER && packet.dataLength == 12);
+    Packet preview = e131(3, 42, channels(3, 12), 0x80);
+    assert(!RealtimeInputSource::parseE131(preview.data(), preview.size(), packet));
+    Packet sync = p;
+    sync[21] = 0x08; // VECTOR_ROOT_E131_EXTENDED
+    assert(!RealtimeInputSource::parseE131(sync.data(), sync.size(), packet));
+    Packet startCode = p;
+    startCode[125] = 0xdd;
+    assert(!RealtimeInputSource::parseE131(startCode.data(), startCode.size(), packet));
+    assert(!RealtimeInputSource::parseE131(p.data(), 100, packet));
+
+    Packet a = artnet(0x0102, 0, channels(1, 6));
+    assert(RealtimeInputSource::parseArtNet(a.data(), a.size(), packet));
+    assert(packet.universe == 0x0102 && !packet.sequenced && packet.dataOffset == 18 && packet.dataLength == 6);
+    Packet poll = a;
+    poll[9] = 0x20; // OpPoll
+    assert(!RealtimeInputSource::parseArtNet(poll.data(), poll.size(), packet));
+
+    // Late: a repeat or up to 19 behind, across the wrap
+    assert(RealtimeInputSource::late(5, 5) && RealtimeInputSource::late(4, 5) && !RealtimeInputSource::late(6, 5));
+    assert(!RealtimeInputSource::late(0, 255) && RealtimeInputSource::late(236, 255) && !RealtimeInputSource::late(235, 255));
+  }
+
+  MockLEDDriver<N> driver;
+  MockUdpReceiver sacn, art;
+  RealtimeInputSource realtime(&driver, N, &sacn, &art);
+  assert(realtime.begin() && sacn.port == 5568 && art.port == 6454);
+  assert(realtime.universes() == 5); // 756 pixels at 170 per universe
+  unsigned long now = 1000;
+
+  // Outside the realtime mode datagrams are read and discarded
+  ConfigManager::setEffectMode((uint8_t)EffectMode::SINGLE_COLOR);
+  driver.fillSolid(CRGB(0, 0, 0));
+  sacn.queue.push_back(e131(1, 1, channels(1)));
+  realtime.update(now);
+  assert(sacn.queue.empty() && realtime.stats().ignored == 1 && !realtime.takeFrame() && driver.buffer[0].r == 0);
+
+  // The mode is selectable; higher values are clamped to it
+  ConfigManager::setEffectMode(9);
+  assert(ConfigManager::getEffectMode() == (uint8_t)EffectMode::REALTIME);
+
+  // Five universes make a frame, each at its offset; the last is cut to the strip
+  for (int u = 1; u <= 5; u++)
+    sacn.queue.push_back(e131(u, 10, channels(u)));
+  sacn.queue.push_back(e131(1, 11, channels(9))); // Next frame, left queued
+  realtime.update(now);
+  assert(sacn.queue.size() == 1 && realtime.stats().packets == 5);
+  assert(pixelIs(driver.buffer[0], 1) && pixelIs(driver.buffer[169], 1) && pixelIs(driver.buffer[170], 2));
+  assert(pixelIs(driver.buffer[680], 5) && pixelIs(driver.buffer[N - 1], 5));
+  realtime.update(now);
+  assert(sacn.queue.size() == 1 && pixelIs(driver.buffer[0], 1)); // Held until shown
+  assert(realtime.takeFrame() && !realtime.takeFrame() && !realtime.midFrame());
+
+  // Late datagrams are dropped; a repeated universe ends a partial frame
+  sacn.queue.push_back(e131(2, 5, channels(7)));  // Behind sequence 10
+  sacn.queue.push_back(e131(2, 11, channels(9)));
+  sacn.queue.push_back(e131(1, 12, channels(3)));
+  realtime.update(now);
+  assert(realtime.stats().late == 1 && pixelIs(driver.buffer[0], 9) && pixelIs(driver.buffer[170], 9));
+  assert(sacn.queue.size() == 1 && realtime.midFrame());
+  assert(realtime.takeFrame() && realtime.stats().partial == 1);
+  realtime.update(now);
+  assert(sacn.queue.empty() && pixelIs(driver.buffer[0], 3) && realtime.midFrame());
+  realtime.update(now + TurboliftConfig::Realtime::FRAME_HOLD_MS - 1);
+  assert(!realtime.takeFrame() && realtime.midFrame());
+  realtime.update(now + TurboliftConfig::Realtime::FRAME_HOLD_MS); // The rest is not coming
+  assert(realtime.takeFrame() && realtime.stats().partial == 2 && !realtime.midFrame());
+  now += TurboliftConfig::Realtime::FRAME_HOLD_MS;
+
+  // Art-Net numbers from 0 and may be unsequenced; other universes are ignored
+  art.queue.push_back(artnet(0, 0, channels(4)));
+  art.queue.push_back(artnet(0, 0, channels(6)));
+  art.queue.push_back(artnet(40, 0, channels(6)));
+  realtime.update(now);
+  assert(pixelIs(driver.buffer[0], 4) && art.queue.size() == 2); // Universe 0 repeated
+  assert(realtime.takeFrame());
+  realtime.update(now);
+  assert(pixelIs(driver.buffer[0], 6) && art.queue.empty() && realtime.stats().ignored == 2);
+  now += TurboliftConfig::Realtime::FRAME_HOLD_MS;
+  realtime.update(now);
+  assert(realtime.takeFrame());
+
+  // A frame nobody takes is given up, so reception does not stall
+  for (int u = 1; u <= 5; u++)
+    sacn.queue.push_back(e131(u, 20, channels(u)));
+  sacn.queue.push_back(e131(1, 21, channels(8)));
+  realtime.update(now);
+  realtime.update(now + TurboliftConfig::Realtime::FRAME_HOLD_MS);
+  assert(realtime.stats().dropped == 1 && sacn.queue.empty() && pixelIs(driver.buffer[0], 8));
+
+  // The effect transmits whole frames only, and holds the last one
+  {
+    MockLEDDriver<N> strip;
+    MockUdpReceiver rx;
+    RealtimeInputSource source(&strip, N, &rx, nullptr);
+    Turbolift effect(&strip);
+    effect.setRealtimeFrames(&source);
+    simulated_time = 1;
+    effect.begin();
+    effect.start();
+    for (int i = 0; i < 400; i++) // Past the fade-in
+    {
+      simulated_time += TurboliftConfig::Timing::UPDATE_INTERVAL_MS;
+      effect.update(simulated_time);
+    }
+    int sent = strip.transmitCount;
+    for (int u = 1; u <= 3; u++)
+      rx.queue.push_back(e131(u, 30, channels(u)));
+    source.update(simulated_time);
+    simulated_time += TurboliftConfig::Timing::UPDATE_INTERVAL_MS;
+    effect.update(simulated_time);
+    assert(strip.transmitCount == sent); // Three of five universes
+    for (int u = 4; u <= 5; u++)
+      rx.queue.push_back(e131(u, 30, channels(u)));
+    source.update(simulated_time);
+    simulated_time += TurboliftConfig::Timing::UPDATE_INTERVAL_MS;
+    effect.update(simulated_time);
+    assert(strip.transmitCount == sent + 1 && pixelIs(strip.buffer[0], 1) && pixelIs(strip.buffer[N - 1], 5));
+    simulated_time += TurboliftConfig::Timing::UPDATE_INTERVAL_MS;
+    effect.update(simulated_time);
+    assert(strip.transmitCount == sent + 1 && pixelIs(strip.buffer[0], 1)); // Held
+  }
+
+  std::cout << "Realtime input tests passed" << std::endl;
+  return 0;
+}
@@ -0,0 +1,238 @@
+// ShowClock and ShowSync: beacon encoding, a follower locking to a leader
+// over a lossy, jittery link while its crystal drifts, losing and regaining
+// the leader, and ring motions locked to show time
+#include <cassert>
+#include <cmath>
+#include <deque>
+#include <iostream>
+#include <random>
+#include <vector>
+#include "show_sync.h"
+#include "motion.h"
+
+using Packet = std::vector<uint8_t>;
+
+static uint32_t trueTime = 0; // ms, the simulation's reference
+constexpr uint32_t LOOP_MS = 5;
+
+// One way from leader to follower: each datagram is delayed, some are lost
+struct Channel
+{
+  struct InFlight
+  {
+    uint32_t deliverAt;
+    Packet data;
+  };
+  std::deque<InFlight> queue;
+  std::mt19937 random{1701};
+  double meanJitterMs = 4;
+  uint32_t minDelayMs = 2;
+  double loss = 0.1;
+  bool cut = false;
+
+  void send(const uint8_t *data, size_t length)
+  {
+    if (cut || std::uniform_real_distribution<double>(0, 1)(random) < loss)
+      return;
+    double jitter = std::exponential_distribution<double>(1 / meanJitterMs)(random);
+    queue.push_back({trueTime + minDelayMs + (uint32_t)jitter, Packet(data, data + length)});
+  }
+
+  // Datagrams can overtake each other
+  size_t receive(uint8_t *data, size_t length)
+  {
+    for (auto it = queue.begin(); it != queue.end(); ++it)
+    {
+      if ((int32_t)(trueTime - it->deliverAt) < 0)
+        continue;
+      size_t n = it->data.size() < length ? it->data.size() : length;
+      memcpy(data, it->data.data(), n);
+      queue.erase(it);
+      return n;
+    }
+    return 0;
+  }
+};
+
+class MockSyncLink : public ISyncLink
+{
+public:
+  Channel *out = nullptr;
+  Channel *in = nullptr;
+
+  bool begin() override { return true; }
+  bool send(const uint8_t *data, size_t length) override
+  {
+    if (out)
+      out->send(data, length);
+    return true;
+  }
+  size_t receive(uint8_t *data, size_t length) override { return in ? in->receive(data, length) : 0; }
+};
+
+// The leader's clock is the reference; the follower's booted later, runs
+// 200 ppm fast and wraps during the run
+static uint32_t leaderLocal() { return trueTime + 7000; }
+static uint32_t followerLocal() { return 0xFFFF0000u + trueTime + trueTime / 5000; }
+
+static Packet beacon(uint16_t unit, uint16_t sequence, uint32_t showMs, uint32_t seed)
+{
+  Packet p(ShowSync::BEACON_SIZE);
+  ShowSync::encode({unit, sequence, showMs, seed}, p.data());
+  return p;
+}
+
+int main()
+{
+  // Beacon encoding
+  {
+    Packet p = beacon(0x1234, 0xfffe, 0xdeadbeef, 42);
+    const uint8_t head[] = {'S', 'H', 'O', 'W', 1, 1, 0x12, 0x34, 0xff, 0xfe, 0xde, 0xad, 0xbe, 0xef};
+    assert(memcmp(p.data(), head, sizeof(head)) == 0);
+    ShowSync::Beacon b;
+    assert(ShowSync::decode(p.data(), p.size(), b));
+    assert(b.unit == 0x1234 && b.sequence == 0xfffe && b.showMs == 0xdeadbeef && b.seed == 42);
+    assert(!ShowSync::decode(p.data(), p.size() - 1, b));
+    Packet version = p;
+    version[4] = 2;
+    assert(!ShowSync::decode(version.data(), version.size(), b));
+    Packet magic = p;
+    magic[0] = 's';
+    assert(!ShowSync::decode(magic.data(), magic.size(), b));
+  }
+
+  // A follower locks to the leader through jitter, loss and drift
+  Channel channel;
+  MockSyncLink leaderLink, followerLink;
+  leaderLink.out = &channel;
+  followerLink.in = &channel;
+  ShowClock leaderClock, followerClock;
+  leaderClock.setLeader(true);
+  ShowSync leader(&leaderLink, &leaderClock, 1);
+  ShowSync follower(&followerLink, &followerClock, 2);
+  assert(leader.begin(0xc0ffee) && follower.begin(99));
+  assert(leaderClock.seed() == 0xc0ffee && followerClock.seed() == 0 && !followerClock.synced());
+
+  uint32_t lastShow = 0;
+  int32_t worst = 0;
+  auto step = [&](uint32_t ms)
+  {
+    trueTime += ms;
+    leader.update(leaderLocal());
+    follower.update(followerLocal());
+  };
+  for (uint32_t i = 0; i < 120000 / LOOP_MS; i++)
+  {
+    step(LOOP_MS);
+    if (!followerClock.locked())
+      continue;
+    uint32_t show = followerClock.now(followerLocal());
+    assert(lastShow == 0 || (int32_t)(show - lastShow) >= 0); // Never backwards once locked
+    lastShow = show;
+    int32_t error = (int32_t)(show - leaderClock.now(leaderLocal()));
+    if (trueTime >= 30000 && std::abs(error) > worst)
+      worst = std::abs(error);
+  }
+  // Behind by about the least delay of the link and loop, which one-way
+  // beacons cannot see
+  assert(followerClock.locked() && follower.following() == 1 && followerClock.seed() == 0xc0ffee);
+  assert(worst <= (int32_t)(channel.minDelayMs + LOOP_MS) + 1);
+  assert(std::abs(followerClock.driftPpm() + 200) <= 40);
+  assert(followerClock.steps() == 1); // Only the first beacon
+  assert(leader.stats().sent >= 470 && follower.stats().received >= 400 && follower.stats().invalid == 0);
+
+  // The leader goes quiet: the follower free-runs at the estimated drift
+  channel.cut = true;
+  for (uint32_t i = 0; i < 5000 / LOOP_MS; i++)
+    step(LOOP_MS);
+  assert(!followerClock.locked() && !followerClock.synced());
+  uint32_t show = followerClock.now(followerLocal());
+  assert((int32_t)(show - lastShow) > 0);
+  assert(std::abs((int32_t)(show - leaderClock.now(leaderLocal()))) <= (int32_t)(channel.minDelayMs + LOOP_MS) + 3);
+
+  // Back again: locked without a step
+  channel.cut = false;
+  for (uint32_t i = 0; i < 2000 / LOOP_MS; i++)
+    step(LOOP_MS);
+  assert(followerClock.locked() && followerClock.steps() == 1);
+
+  // While locked, other leaders and stale sequence numbers are dropped
+  {
+    ShowSync::Stats before = follower.stats();
+    Channel injected;
+    followerLink.in = &injected;
+    injected.loss = 0;
+    injected.meanJitterMs = 0.001;
+    injected.minDelayMs = 0;
+    Packet other = beacon(3, 1, 0, 5);
+    injected.send(other.data(), other.size());
+    Packet stale = beacon(1, 1, 0, 5);
+    injected.send(stale.data(), stale.size());
+    Packet own = beacon(2, 60000, 0, 5);
+    injected.send(own.data(), own.size());
+    Packet junk(ShowSync::BEACON_SIZE + 4, 0);
+    injected.send(junk.data(), junk.size());
+    follower.update(followerLocal());
+    assert(follower.stats().foreign == before.foreign + 1 && follower.stats().late == before.late + 1);
+    assert(follower.stats().invalid == before.invalid + 1 && follower.stats().received == before.received);
+    assert(followerClock.seed() == 0xc0ffee);
+    followerLink.in = &channel;
+  }
+
+  // A leader never follows
+  {
+    Packet other = beacon(3, 1, 0, 5);
+    Channel injected;
+    injected.loss = 0;
+    injected.meanJitterMs = 0.001;
+    injected.minDelayMs = 0;
+    injected.send(other.data(), other.size());
+    MockSyncLink link;
+    link.in = &injected;
+    ShowClock clock;
+    clock.setLeader(true);
+    ShowSync second(&link, &clock, 4);
+    second.begin(7);
+    uint32_t before = clock.now(leaderLocal());
+    second.update(leaderLocal());
+    assert(second.stats().foreign == 1 && clock.now(leaderLocal()) == before && clock.seed() == 7);
+  }
+
+  // Motions locked to the same show time line up, wherever they started
+  {
+    const int N = 756;
+    const int speed = 3;
+    RingMotion a(N), b(N);
+    b.advance(speed, 40000, 100); // Well away from a
+    uint32_t showA = 123456, showB = 123456;
+    for (int frame = 0; frame < 200; frame++)
+    {
+      unsigned long elapsedA = 16, elapsedB = frame % 2 ? 9 : 23; // Different frame rates, same span
+      showA += elapsedA;
+      showB += elapsedB;
+      a.advance(speed, elapsedA, 100);
+      b.advance(speed, elapsedB, 100);
+      a.lock(speed, showA, 100);
+      b.lock(speed, showB, 100);
+    }
+    assert(showA == showB);
+    int32_t apart = (int32_t)a.positionQ8() - (int32_t)b.positionQ8();
+    assert(std::abs(apart) <= 2);
+    uint32_t expected = (uint32_t)((uint64_t)speed * showA * 256 / 100 % ((uint32_t)N << 8));
+    assert(std::abs((int32_t)a.positionQ8() - (int32_t)expected) <= 2);
+
+    // Backwards, and across the end of the ring
+    RingMotion c(N);
+    for (int frame = 0; frame < 200; frame++)
+    {
+      c.advance(-speed, 16, 100);
+      c.lock(-speed, 1000 + frame * 16, 100);
+    }
+    uint32_t phase = (uint32_t)((uint64_t)speed * (1000 + 199 * 16) * 256 / 100 % ((uint32_t)N << 8));
+    uint32_t back = (((uint32_t)N << 8) - phase) % ((uint32_t)N << 8);
+    assert(std::abs((int32_t)c.positionQ8() - (int32_t)back) <= 2);
+  }
+
+  std::cout << "Show sync tests passed" << std::endl;
+  return 0;
+}
@@ -0,0 +1,75 @@
+// Stack high-water marks for generation and rendering on a full-size strip.
+// The ESP8266 Arduino loop() runs on a 4 KB stack shared with WiFi callbacks,
+// so per-pixel arrays on the stack (e.g. int driverIndices[NUM_LEDS]) must
+// never come back.
+#include <cassert>
+#include <iostream>
+#include "bench_harness.h"
+#include "mock_led_driver.h"
+#include "../src/turbolift_effect.h"
+
+static unsigned long simulated_time = 0;
+extern "C" unsigned long millis() { return simulated_time; }
+
+constexpr int N = TurboliftConfig::Hardware::NUM_LEDS;
+constexpr size_t STACK_BUDGET_BYTES = 1024; // Per call, unoptimised host build
+
+using Turbolift = TurboliftEffectTemplate<N, TurboliftConfig::Effects::GRADIENT_STEP_DEFAULT, TurboliftConfig::Effects::GRADIENT_MOVE_DEFAULT>;
+using EffectMode = TurboliftConfig::Effects::EffectMode;
+
+static MockLEDDriver<N> mock;
+static Turbolift *turbolift = nullptr;
+
+// Deepest stack use of one call, after a warm-up call so lazy symbol binding
+// in the host runtime is not counted
+template <typename F>
+static size_t stackOf(F fn)
+{
+  fn();
+  return Bench::measureStack(fn);
+}
+
+static void check(const char *name, size_t bytes)
+{
+  std::cout << name << ": " << bytes << " bytes" << std::endl;
+  assert(bytes < STACK_BUDGET_BYTES);
+}
+
+int main()
+{
+  ConfigManager::begin();
+  static Turbolift instance(&mock);
+  turbolift = &instance;
+
+  static CRGB pattern[N];
+  check("generateTurboliftEffect", stackOf([]
+                                           { turbolift->testGenerateTurboliftEffect(pattern); }));
+  check("generateVirtualGradients", stackOf([]
+                                            {
+    ConfigManager::setHueMin(ConfigManager::getHueMin() ^ 1);
+    turbolift->testGenerateVirtualGradients(); }));
+  check("serviceGeneration step", stackOf([]
+                                          {
+    ConfigManager::setHueMin(ConfigManager::getHueMin() ^ 1);
+    turbolift->serviceGeneration(); }));
+  static CRGB driverColors[TurboliftConfig::Effects::MAX_DRIVER_POINTS];
+  static DriverPoints<TurboliftConfig::Effects::MAX_DRIVER_POINTS> driverPoints;
+  check("generateDriverColors", stackOf([]
+                                        { int numDrivers; turbolift->generateDriverColors(driverColors, driverPoints, numDrivers); }));
+
+  const char *frameNames[] = {"SINGLE_COLOR frame", "LIFT_ANIMATION frame", "CLASSIC frame", "VIRTUAL_GRADIENT frame"};
+  for (EffectMode mode : {EffectMode::SINGLE_COLOR, EffectMode::LIFT_ANIMATION, EffectMode::CLASSIC, EffectMode::VIRTUAL_GRADIENT})
+  {
+    ConfigManager::setEffectMode((uint8_t)mode);
+    ConfigManager::setRotationSpeed(2);
+    simulated_time = 1;
+    turbolift->stop();
+    turbolift->start();
+    check(frameNames[(int)mode], stackOf([]
+                                 { simulated_time += TurboliftConfig::Timing::UPDATE_INTERVAL_MS;
+                                   turbolift->renderFrame(simulated_time); }));
+  }
+
+  std::cout << "Stack tests passed" << std::endl;
+  return 0;
+}
@@ -43,12 +43,13 @@ int main()
   // Check gradient generation
   int numDrivers = 0;
   CRGB driverColors[N];
-  turbolift.generateDriverColors(driverColors, numDrivers);
+  DriverPoints<TurboliftConfig::Effects::MAX_DRIVER_POINTS> driverPoints;
+  turbolift.generateDriverColors(driverColors, driverPoints, numDrivers);
 
   for (int d = 0; d < numDrivers - 1; d++)
   {
-    int start = turbolift.testGetDriverIndex(d);
-    int end = turbolift.testGetDriverIndex(d + 1);
+    int start = driverPoints.position(d);
+    int end = driverPoints.position(d + 1);
     CRGB c1 = driverColors[d];
     CRGB c2 = driverColors[d + 1];
 
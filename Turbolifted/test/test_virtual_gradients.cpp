@@ -16,8 +16,8 @@ int main()
 
   turbolift.begin();
 
-  // Initially sequences should not be initialized
-  assert(!turbolift.testIsSequenceInitialized());
+  // begin() pre-generates the sequences
+  assert(turbolift.testIsSequenceInitialized());
 
   // Trigger generation
   turbolift.testGenerateVirtualGradients();